@@ -12,6 +12,9 @@ set_target_properties(CMake_CKE_RN_Core_Shared_Config PROPERTIES
 	PROJECT_LABEL BuildConfig
 )
 
+# Headers shared by the tests of every module (benchmark helpers, etc.)
+set(CK_TESTS_INCLUDE_DIR "${CMAKE_CURRENT_SOURCE_DIR}/Code/Runtime/Tests/include")
+
 # Generic Runtime Module Definition
 # ------------------------------------------------------------------------------
 
@@ -181,6 +184,11 @@ function(CK_Module_Tests
 	    ${ModuleTarget}
 	)
 
+	target_include_directories(${TestTarget}
+	PRIVATE
+		${CK_TESTS_INCLUDE_DIR}
+	)
+
 	set_target_properties(${TestTarget} PROPERTIES 
 		LINKER_LANGUAGE CXX
 		FOLDER "CookieKat/Tests/${ModuleLayer}"
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Platform/PrimitiveTypes.h"
+
+namespace CKE {
+	// Fast lossless compression of byte streams
+	//
+	// LZ77 codec with the same block layout as LZ4: sequences of literals followed by a match
+	// against the previous 64KB of output. It trades compression ratio for decompression speed,
+	// decompressing is mostly memcpy so it runs at memory bandwidth
+	// Meant for the payloads of compiled resources, which are compressed once offline
+	// and decompressed every time they are loaded
+	class Compression
+	{
+	public:
+		// Returns the max size that the compressed data of a source of the given size can have
+		static u64 GetMaxCompressedSize(u64 srcSizeInBytes);
+
+		// Compresses the source into dst and returns the size of the compressed data
+		// dst must be at least GetMaxCompressedSize(src.size()) bytes
+		static u64 Compress(Span<u8 const> src, Span<u8> dst);
+
+		// Returns the compressed data of the source
+		static Vector<u8> Compress(Span<u8 const> src);
+
+		// Decompresses the source into dst, which must have the exact size of the original data
+		// Returns false if the compressed data is malformed or doesn't fill dst
+		static bool Decompress(Span<u8 const> src, Span<u8> dst);
+	};
+}
@@ -0,0 +1,244 @@
+#include "CookieKat/Core/Compression/Compression.h"
+
+#include "CookieKat/Core/Platform/Asserts.h"
+
+#include <bit>
+#include <cstring>
+
+namespace CKE {
+	namespace {
+		constexpr u64 MIN_MATCH = 4;
+		constexpr u64 MAX_OFFSET = 65535;
+		constexpr u64 LAST_LITERALS = 5;    // The last bytes of the input are always stored as literals
+		constexpr u64 MATCH_FIND_LIMIT = 12; // Matches can't start in the last bytes of the input
+		constexpr u64 RUN_MASK = 15;        // Literal and match lengths of the token saturate at 15
+		constexpr u64 WILD_COPY_SIZE = 16;
+
+		constexpr u32 HASH_BITS = 12;
+		constexpr u32 HASH_TABLE_SIZE = 1 << HASH_BITS;
+
+		inline u32 Read32(u8 const* pData) {
+			u32 value;
+			memcpy(&value, pData, sizeof(u32));
+			return value;
+		}
+
+		inline u64 Read64(u8 const* pData) {
+			u64 value;
+			memcpy(&value, pData, sizeof(u64));
+			return value;
+		}
+
+		inline u32 Hash(u32 sequence) {
+			return (sequence * 2654435761u) >> (32 - HASH_BITS);
+		}
+
+		inline u8* WriteLength(u8* pOut, u64 length) {
+			while (length >= 255) {
+				*pOut++ = 255;
+				length -= 255;
+			}
+			*pOut++ = static_cast<u8>(length);
+			return pOut;
+		}
+
+		inline bool ReadLength(u8 const*& pIn, u8 const* pInEnd, u64& length) {
+			u8 byte;
+			do {
+				if (pIn >= pInEnd) { return false; }
+				byte = *pIn++;
+				length += byte;
+			}
+			while (byte == 255);
+			return true;
+		}
+
+		inline u8* WriteLiterals(u8* pOut, u8& token, u8 const* pLiterals, u64 numLiterals) {
+			if (numLiterals >= RUN_MASK) {
+				token = RUN_MASK << 4;
+				pOut = WriteLength(pOut, numLiterals - RUN_MASK);
+			}
+			else {
+				token = static_cast<u8>(numLiterals << 4);
+			}
+			if (numLiterals > 0) { memcpy(pOut, pLiterals, numLiterals); }
+			return pOut + numLiterals;
+		}
+
+		// Returns the number of equal bytes of a and b, without going past pLimit
+		inline u64 CountMatchingBytes(u8 const* pA, u8 const* pB, u8 const* pLimit) {
+			u8 const* pStart = pA;
+			while (pA + sizeof(u64) <= pLimit) {
+				u64 diff = Read64(pA) ^ Read64(pB);
+				if (diff != 0) { return (pA - pStart) + (std::countr_zero(diff) >> 3); }
+				pA += sizeof(u64);
+				pB += sizeof(u64);
+			}
+			while (pA < pLimit && *pA == *pB) {
+				++pA;
+				++pB;
+			}
+			return pA - pStart;
+		}
+	}
+
+	u64 Compression::GetMaxCompressedSize(u64 srcSizeInBytes) {
+		return srcSizeInBytes + srcSizeInBytes / 255 + 16;
+	}
+
+	u64 Compression::Compress(Span<u8 const> src, Span<u8> dst) {
+		CKE_ASSERT(dst.size() >= GetMaxCompressedSize(src.size()));
+
+		u8 const* pSrc = src.data();
+		u64 const srcSize = src.size();
+		u8*       pOut = dst.data();
+
+		u64 anchor = 0; // Start of the literals that haven't been written yet
+		if (srcSize > MATCH_FIND_LIMIT) {
+			Array<u32, HASH_TABLE_SIZE> hashTable{};
+			u8 const* const             pMatchLimit = pSrc + srcSize - LAST_LITERALS;
+			u64 const                   searchLimit = srcSize - MATCH_FIND_LIMIT;
+
+			u64 pos = 1;
+			while (pos < searchLimit) {
+				// Find a previous position that starts with the same 4 bytes
+				u32 const sequence = Read32(pSrc + pos);
+				u32&      hashEntry = hashTable[Hash(sequence)];
+				u64       candidate = hashEntry;
+				hashEntry = static_cast<u32>(pos);
+
+				if (pos - candidate > MAX_OFFSET || Read32(pSrc + candidate) != sequence) {
+					// Skip faster through data that doesn't compress
+					pos += 1 + ((pos - anchor) >> 6);
+					continue;
+				}
+
+				// Extend the match backwards into the pending literals
+				while (pos > anchor && candidate > 0 && pSrc[pos - 1] == pSrc[candidate - 1]) {
+					--pos;
+					--candidate;
+				}
+
+				u64 const matchLength = MIN_MATCH + CountMatchingBytes(pSrc + pos + MIN_MATCH,
+				                                                       pSrc + candidate + MIN_MATCH,
+				                                                       pMatchLimit);
+
+				// Write sequence
+				u8* pToken = pOut++;
+				u8  token;
+				pOut = WriteLiterals(pOut, token, pSrc + anchor, pos - anchor);
+
+				u64 const offset = pos - candidate;
+				pOut[0] = static_cast<u8>(offset);
+				pOut[1] = static_cast<u8>(offset >> 8);
+				pOut += 2;
+
+				u64 const extraMatchLength = matchLength - MIN_MATCH;
+				if (extraMatchLength >= RUN_MASK) {
+					token |= RUN_MASK;
+					pOut = WriteLength(pOut, extraMatchLength - RUN_MASK);
+				}
+				else {
+					token |= static_cast<u8>(extraMatchLength);
+				}
+				*pToken = token;
+
+				pos += matchLength;
+				anchor = pos;
+
+				// Index a position inside the match to find more matches in repetitive data
+				if (pos < searchLimit) {
+					hashTable[Hash(Read32(pSrc + pos - 2))] = static_cast<u32>(pos - 2);
+				}
+			}
+		}
+
+		// The last sequence only has literals
+		u8* pToken = pOut++;
+		u8  token;
+		pOut = WriteLiterals(pOut, token, pSrc + anchor, srcSize - anchor);
+		*pToken = token;
+
+		return pOut - dst.data();
+	}
+
+	Vector<u8> Compression::Compress(Span<u8 const> src) {
+		Vector<u8> compressed(GetMaxCompressedSize(src.size()));
+		compressed.resize(Compress(src, compressed));
+		return compressed;
+	}
+
+	bool Compression::Decompress(Span<u8 const> src, Span<u8> dst) {
+		u8 const*       pIn = src.data();
+		u8 const* const pInEnd = pIn + src.size();
+		u8*             pOut = dst.data();
+		u8* const       pOutEnd = pOut + dst.size();
+
+		while (pIn < pInEnd) {
+			u8 const token = *pIn++;
+
+			// Literals
+			u64 numLiterals = token >> 4;
+			if (numLiterals == RUN_MASK && !ReadLength(pIn, pInEnd, numLiterals)) { return false; }
+			if (numLiterals > static_cast<u64>(pInEnd - pIn) || numLiterals > static_cast<u64>(pOutEnd - pOut)) {
+				return false;
+			}
+			if (pIn + WILD_COPY_SIZE <= pInEnd && pOut + WILD_COPY_SIZE <= pOutEnd && numLiterals <= WILD_COPY_SIZE) {
+				// Fixed size copy of the short runs, the extra bytes are overwritten by the next sequence
+				memcpy(pOut, pIn, WILD_COPY_SIZE);
+			}
+			else if (numLiterals > 0) {
+				memcpy(pOut, pIn, numLiterals);
+			}
+			pIn += numLiterals;
+			pOut += numLiterals;
+
+			// The last sequence doesn't have a match
+			if (pIn == pInEnd) { break; }
+
+			// Match
+			if (pInEnd - pIn < 2) { return false; }
+			u64 const offset = pIn[0] | (static_cast<u64>(pIn[1]) << 8);
+			pIn += 2;
+
+			u64 matchLength = token & RUN_MASK;
+			if (matchLength == RUN_MASK && !ReadLength(pIn, pInEnd, matchLength)) { return false; }
+			matchLength += MIN_MATCH;
+
+			if (offset == 0 || offset > static_cast<u64>(pOut - dst.data())
+					|| matchLength > static_cast<u64>(pOutEnd - pOut)) {
+				return false;
+			}
+
+			// The match can overlap the bytes it's writing, copying in blocks
+			// of at most the offset size always reads bytes that have already been written
+			u8 const* pMatch = pOut - offset;
+			u8* const pMatchEnd = pOut + matchLength;
+			if (offset >= sizeof(u64)) {
+				if (pMatchEnd + sizeof(u64) <= pOutEnd) {
+					// The last block can write past the match, the next sequence overwrites those bytes
+					do {
+						memcpy(pOut, pMatch, sizeof(u64));
+						pOut += sizeof(u64);
+						pMatch += sizeof(u64);
+					}
+					while (pOut < pMatchEnd);
+				}
+				else {
+					while (pOut + sizeof(u64) <= pMatchEnd) {
+						memcpy(pOut, pMatch, sizeof(u64));
+						pOut += sizeof(u64);
+						pMatch += sizeof(u64);
+					}
+					while (pOut < pMatchEnd) { *pOut++ = *pMatch++; }
+				}
+			}
+			else {
+				while (pOut < pMatchEnd) { *pOut++ = *pMatch++; }
+			}
+			pOut = pMatchEnd;
+		}
+
+		return pOut == pOutEnd;
+	}
+}
@@ -0,0 +1,81 @@
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Compression/Compression.h"
+
+#include <gtest/gtest.h>
+
+using namespace CKE;
+
+namespace {
+	void ExpectRoundTrip(Vector<u8> const& data) {
+		Vector<u8> compressed = Compression::Compress(data);
+		EXPECT_LE(compressed.size(), Compression::GetMaxCompressedSize(data.size()));
+
+		Vector<u8> decompressed(data.size());
+		ASSERT_TRUE(Compression::Decompress(compressed, decompressed));
+		EXPECT_EQ(decompressed, data);
+	}
+}
+
+TEST(Core_Compression, RoundTrip_Empty)
+{
+	ExpectRoundTrip(Vector<u8>{});
+}
+
+TEST(Core_Compression, RoundTrip_Small)
+{
+	for (u64 size = 1; size < 32; ++size) {
+		Vector<u8> data(size);
+		for (u64 i = 0; i < size; ++i) { data[i] = static_cast<u8>(i % 3); }
+		ExpectRoundTrip(data);
+	}
+}
+
+TEST(Core_Compression, RoundTrip_Incompressible)
+{
+	// Incompressible data must still fit in the max compressed size
+	Vector<u8> data(100000);
+	u32        state = 12345;
+	for (u8& byte : data) {
+		state = state * 1664525u + 1013904223u;
+		byte = static_cast<u8>(state >> 24);
+	}
+	ExpectRoundTrip(data);
+}
+
+TEST(Core_Compression, RoundTrip_Repetitive)
+{
+	// Long runs and short repeating patterns produce overlapping matches
+	Vector<u8> data(200000);
+	for (u64 i = 0; i < data.size(); ++i) {
+		if (i < 50000) { data[i] = 7; }
+		else if (i < 100000) { data[i] = static_cast<u8>(i % 3); }
+		else { data[i] = static_cast<u8>((i / 16) % 251); }
+	}
+	ExpectRoundTrip(data);
+
+	Vector<u8> compressed = Compression::Compress(data);
+	EXPECT_LT(compressed.size(), data.size() / 10);
+}
+
+TEST(Core_Compression, Decompress_RejectsMalformedData)
+{
+	Vector<u8> data(4096);
+	for (u64 i = 0; i < data.size(); ++i) { data[i] = static_cast<u8>(i % 64); }
+	Vector<u8> compressed = Compression::Compress(data);
+
+	// Destination of the wrong size
+	Vector<u8> smaller(data.size() - 1);
+	EXPECT_FALSE(Compression::Decompress(compressed, smaller));
+	Vector<u8> larger(data.size() + 1);
+	EXPECT_FALSE(Compression::Decompress(compressed, larger));
+
+	// Truncated data
+	Vector<u8> decompressed(data.size());
+	Vector<u8> truncated(compressed.begin(), compressed.begin() + compressed.size() / 2);
+	EXPECT_FALSE(Compression::Decompress(truncated, decompressed));
+
+	// Match that points before the start of the output
+	Vector<u8> invalidOffset{0x00, 0xFF, 0xFF};
+	Vector<u8> output(16);
+	EXPECT_FALSE(Compression::Decompress(invalidOffset, output));
+}
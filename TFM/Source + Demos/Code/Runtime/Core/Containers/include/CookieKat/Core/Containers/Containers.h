@@ -8,6 +8,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <span>
 
 namespace CKE {
 	template <typename T>
@@ -19,6 +20,9 @@ namespace CKE {
 	template <typename T, size_t Size>
 	using Array = std::array<T, Size>;
 
+	template <typename T>
+	using Span = std::span<T>;
+
 	template <typename T>
 	using Stack = std::stack<T>;
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CookieKat/Core/Platform/Asserts.h"
+#include "CookieKat/Core/Platform/PrimitiveTypes.h"
+#include "CookieKat/Core/Containers/Containers.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace CKE {
+	// Stable LSD radix sort of 64 bit keys, one pass per byte
+	//
+	// The scratch span is used as the destination of every other pass, it must be
+	// as big as the keys. The sorted keys always end up in the keys span
+	//
+	// The bits below firstBit (a multiple of 8) are not sorted, keys that are already ordered
+	// by them keep that order. Bytes that are the same in every key are skipped, so keys
+	// that only use a few bits only pay for the passes they need
+	inline void RadixSort(Span<u64> keys, Span<u64> scratch, u32 firstBit = 0);
+}
+
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	inline void RadixSort(Span<u64> keys, Span<u64> scratch, u32 firstBit) {
+		CKE_ASSERT(scratch.size() >= keys.size());
+		CKE_ASSERT(firstBit % 8 == 0 && firstBit <= 64);
+
+		constexpr u32 NUM_DIGITS = sizeof(u64);
+		constexpr u32 RADIX = 256;
+
+		u64 const numKeys = keys.size();
+		u32 const firstDigit = firstBit / 8;
+		if (numKeys < 2) { return; }
+
+		// The histograms of all of the bytes are built in a single read of the keys
+		u32 histograms[NUM_DIGITS][RADIX] = {};
+		for (u64 key : keys) {
+			for (u32 digit = firstDigit; digit < NUM_DIGITS; ++digit) {
+				histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+			}
+		}
+
+		u64* pSrc = keys.data();
+		u64* pDst = scratch.data();
+		for (u32 digit = firstDigit; digit < NUM_DIGITS; ++digit) {
+			u32*      histogram = histograms[digit];
+			u32 const shift = digit * 8;
+			if (histogram[(pSrc[0] >> shift) & 0xFF] == numKeys) { continue; }
+
+			// Histogram to offsets of each bucket
+			u32 offset = 0;
+			for (u32 bucket = 0; bucket < RADIX; ++bucket) {
+				u32 const count = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += count;
+			}
+
+			for (u64 i = 0; i < numKeys; ++i) {
+				u64 const key = pSrc[i];
+				pDst[histogram[(key >> shift) & 0xFF]++] = key;
+			}
+			std::swap(pSrc, pDst);
+		}
+
+		if (pSrc != keys.data()) {
+			std::copy(pSrc, pSrc + numKeys, keys.data());
+		}
+	}
+}
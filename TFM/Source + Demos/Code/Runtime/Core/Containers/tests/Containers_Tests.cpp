@@ -1,5 +1,6 @@
 #include "CookieKat/Core/Containers/Containers.h"
 #include "CookieKat/Core/Containers/String.h"
+#include "CookieKat/Core/Containers/RadixSort.h"
 
 #include <gtest/gtest.h>
 
@@ -64,4 +65,38 @@ TEST(Core_Containers, StringID)
 	EXPECT_NE(id.GetID(), 0);
 	EXPECT_EQ(id.GetID(), id2.GetID());
 	EXPECT_NE(id.GetID(), id3.GetID());
-}
\ No newline at end of file
+}
+
+TEST(Core_Containers, RadixSort)
+{
+	Vector<u64> keys;
+	u64         state = 12345;
+	for (u32 i = 0; i < 10'000; ++i)
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		keys.push_back(i % 3 == 0 ? state >> 40 : state); // Some short keys so a few bytes repeat
+	}
+	Vector<u64> expected = keys;
+	std::sort(expected.begin(), expected.end());
+
+	Vector<u64> scratch(keys.size());
+	RadixSort(keys, scratch);
+	EXPECT_EQ(keys, expected);
+
+	// Sorting sorted keys and keys that only differ in one byte
+	RadixSort(keys, scratch);
+	EXPECT_EQ(keys, expected);
+
+	Vector<u64> sameHighBytes = {0x0103, 0x0101, 0x0102, 0x0101};
+	RadixSort(sameHighBytes, scratch);
+	EXPECT_EQ(sameHighBytes, (Vector<u64>{0x0101, 0x0101, 0x0102, 0x0103}));
+}
+
+TEST(Core_Containers, RadixSort_IgnoredLowBits)
+{
+	// The low byte isn't sorted, keys with the same high bytes keep their order
+	Vector<u64> keys = {0x0205, 0x0101, 0x0203, 0x0104, 0x0102, 0x0201};
+	Vector<u64> scratch(keys.size());
+	RadixSort(keys, scratch, 8);
+	EXPECT_EQ(keys, (Vector<u64>{0x0101, 0x0104, 0x0102, 0x0205, 0x0203, 0x0201}));
+}
@@ -2,6 +2,12 @@
 
 #include "CookieKat/Core/Containers/String.h"
 #include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/Memory.h"
+
+namespace CKE {
+	class PackArchive;
+	struct PackArchiveEntry;
+}
 
 namespace CKE {
 	using Path = String;
@@ -11,9 +17,48 @@ namespace CKE {
 
 	//-----------------------------------------------------------------------------
 
+	// Read-only view of a whole file mapped into memory
+	// The OS pages the contents in on demand, so nothing is read or copied until it is accessed
+	// The file stays mapped until the object is destroyed or reset
+	//
+	// Files of mounted archives are views into the mapping of the archive, which must stay
+	// mounted while they are used. Compressed files are decompressed into memory owned by the view
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(MappedFile const&) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		// Unmaps the file or releases the view
+		void Reset();
+
+		inline bool      IsValid() const { return m_pData != nullptr; }
+		inline u8 const* GetData() const { return m_pData; }
+		inline u64       GetSizeInBytes() const { return m_SizeInBytes; }
+
+	private:
+		friend class FileSystem;
+
+		u8 const* m_pData = nullptr;
+		u64       m_SizeInBytes = 0;
+		void*     m_pFileHandle = nullptr;
+		void*     m_pMappingHandle = nullptr;
+		Blob      m_OwnedData; // Decompressed file of an archive
+	};
+
+	//-----------------------------------------------------------------------------
+
 	class FileSystem
 	{
 	public:
+		FileSystem();
+		~FileSystem();
+
 		// Text files
 		//-----------------------------------------------------------------------------
 
@@ -32,8 +77,40 @@ namespace CKE {
 		Blob ReadBinaryFile(Path const& path) const;
 		void WriteBinaryFile(Path const& path, void const* pData, i64 dataSizeInBytes);
 
+		// Maps the whole file into memory as read-only, the returned file is invalid if it couldn't be mapped
+		MappedFile MapFile(const char* pPath) const;
+		MappedFile MapFile(Path const& path) const;
+
 		bool RemoveFile(const char* pPath);
 		bool RemoveFile(Path const& path);
+
+		// Archives
+		//-----------------------------------------------------------------------------
+
+		// Mounts a pack archive, then the reads of <mountPath><path of a file in the archive> are served
+		// from the archive, the rest of files are still read from the disk
+		// Archives must be mounted before other threads start reading files
+		// Returns false if the archive couldn't be opened
+		bool MountArchive(Path const& archivePath, Path const& mountPath);
+
+		// Unmounts all of the archives, the views of their files must not be used anymore
+		void UnmountAllArchives();
+
+		// Returns the data of a file of a mounted archive in place, without copying it
+		// Returns an empty span if the file isn't in a mounted archive or if it is stored compressed
+		Span<u8 const> GetArchivedFileData(Path const& path) const;
+
+	private:
+		struct MountedArchive
+		{
+			UPtr<PackArchive> m_pArchive;
+			Path              m_MountPath;
+		};
+
+		// Returns the entry of a file in the mounted archives or nullptr if it isn't archived
+		PackArchiveEntry const* FindArchivedFile(Path const& path, PackArchive const*& pArchive) const;
+
+		Vector<MountedArchive> m_MountedArchives;
 	};
 
 	// Global File System Instance
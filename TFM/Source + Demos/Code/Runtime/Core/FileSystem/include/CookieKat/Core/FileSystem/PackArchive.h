@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/FileSystem/FileSystem.h"
+
+namespace CKE {
+	// Layout of a pack archive:
+	//   PackArchiveHeader
+	//   PackArchiveEntry[m_NumEntries]
+	//   u32[m_NumHashSlots]              Hash table of the entries, index of the entry + 1 or 0 if the slot is empty
+	//   Paths of the entries             Not null terminated
+	//   Data of each entry               Aligned to ENTRY_ALIGNMENT
+	struct PackArchiveHeader
+	{
+		static constexpr u32 MAGIC = 0x4B504B43; // "CKPK"
+		static constexpr u32 VERSION = 1;
+
+		// Entries start at page boundaries, so a view of an entry behaves like a mapped file
+		static constexpr u64 ENTRY_ALIGNMENT = 4096;
+
+		u32 m_Magic = MAGIC;
+		u32 m_Version = VERSION;
+		u32 m_NumEntries = 0;
+		u32 m_NumHashSlots = 0; // Power of two
+		u64 m_EntriesOffset = 0;
+		u64 m_HashSlotsOffset = 0;
+		u64 m_PathsOffset = 0;
+
+		inline bool IsValid() const { return m_Magic == MAGIC && m_Version == VERSION; }
+	};
+
+	struct PackArchiveEntry
+	{
+		u64 m_PathHash = 0;
+		u64 m_DataOffset = 0;              // From the start of the archive
+		u64 m_SizeInBytes = 0;             // Size of the data stored in the archive
+		u64 m_UncompressedSizeInBytes = 0; // Size of the original file
+		u32 m_PathOffset = 0;              // From the start of the paths
+		u32 m_PathLength = 0;
+		u32 m_IsCompressed = 0;            // Compressed with the Compression module
+		u32 m_Padding = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Read-only archive of files written by a PackArchiveBuilder
+	// The whole archive is mapped into memory, the files are looked up in a hash table
+	// and their data is accessed in place
+	class PackArchive
+	{
+	public:
+		// Maps the archive, returns false if it doesn't exist or it isn't a valid archive
+		// The ranges of the tables and of every entry are checked against the size of the file
+		bool Open(Path const& archivePath);
+		void Close();
+
+		inline bool IsOpen() const { return m_pHeader != nullptr; }
+		inline u32  GetNumEntries() const { return m_pHeader->m_NumEntries; }
+
+		// Returns the entry of a file or nullptr if it isn't in the archive
+		// The path is relative to the directory that was packed, with '/' or '\' separators
+		PackArchiveEntry const* FindEntry(String const& path) const;
+
+		// Returns the data of an entry as it is stored in the archive, compressed or not
+		// The entry must be one of this archive
+		Span<u8 const> GetEntryData(PackArchiveEntry const& entry) const;
+
+		// Copies the file of an entry, decompressing it if necessary
+		// Returns false and leaves the file empty if its compressed data is corrupted
+		bool ReadEntry(PackArchiveEntry const& entry, Blob& outFile) const;
+
+		// Converts a path to the form that is stored in the archives
+		static String NormalizePath(String const& path);
+
+	private:
+		MappedFile               m_File;
+		PackArchiveHeader const* m_pHeader = nullptr;
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Packs files into an archive that can be read with a PackArchive
+	//
+	// Example:
+	//   PackArchiveBuilder builder;
+	//   builder.AddFile("Textures/Wood.tex", g_FileSystem.ReadBinaryFile(...), true);
+	//   builder.WriteToFile("Data.pak");
+	class PackArchiveBuilder
+	{
+	public:
+		// Adds a file to the archive, it is stored compressed only if that makes it meaningfully smaller
+		void AddFile(String const& path, Span<u8 const> data, bool compress);
+
+		// Writes the archive, returns false if the file couldn't be written
+		bool WriteToFile(Path const& archivePath) const;
+
+		inline u64 GetNumFiles() const { return m_Files.size(); }
+
+	private:
+		struct PackedFile
+		{
+			String m_Path;
+			Blob   m_Data;
+			u64    m_UncompressedSizeInBytes = 0;
+			bool   m_IsCompressed = false;
+		};
+
+		Vector<PackedFile> m_Files;
+	};
+}
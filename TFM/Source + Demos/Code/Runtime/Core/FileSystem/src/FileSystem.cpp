@@ -1,5 +1,7 @@
 #include "CookieKat/Core/FileSystem/FileSystem.h"
+#include "CookieKat/Core/FileSystem/PackArchive.h"
 #include "CookieKat/Core/Containers/String.h"
+#include "CookieKat/Core/Platform/Platform_Win32.h"
 
 #include <iostream>
 #include <filesystem>
@@ -7,7 +9,20 @@
 #include <fstream>
 
 namespace CKE {
+	FileSystem::FileSystem() = default;
+	FileSystem::~FileSystem() = default;
+
 	String FileSystem::ReadTextFile(const char* path) const {
+		PackArchive const*            pArchive = nullptr;
+		PackArchiveEntry const* const pEntry = FindArchivedFile(path, pArchive);
+		if (pEntry != nullptr) {
+			Blob file;
+			if (!pArchive->ReadEntry(*pEntry, file)) {
+				printf("ERROR: Failed to read an archived file [%s]\n", path);
+			}
+			return String(file.begin(), file.end());
+		}
+
 		String              outputStr{};
 		const std::ifstream fs(path);
 		if (fs.is_open()) {
@@ -42,9 +57,25 @@ namespace CKE {
 	}
 
 	Blob FileSystem::ReadBinaryFile(const char* pPath) const {
-		std::ifstream ifs(pPath, std::ios::binary);
+		PackArchive const*            pArchive = nullptr;
+		PackArchiveEntry const* const pEntry = FindArchivedFile(pPath, pArchive);
+		if (pEntry != nullptr) {
+			Blob file;
+			if (!pArchive->ReadEntry(*pEntry, file)) {
+				printf("ERROR: Failed to read an archived file [%s]\n", pPath);
+			}
+			return file;
+		}
+
+		// Read the whole file at once instead of byte by byte
+		std::ifstream ifs(pPath, std::ios::binary | std::ios::ate);
 		CKE_ASSERT(!ifs.fail());
-		Blob blob(std::istreambuf_iterator(ifs), {});
+		std::streamsize const fileSize = ifs.tellg();
+		if (fileSize <= 0) { return Blob{}; }
+		ifs.seekg(0, std::ios::beg);
+
+		Blob blob(static_cast<u64>(fileSize));
+		ifs.read(reinterpret_cast<char*>(blob.data()), fileSize);
 		return blob;
 	}
 
@@ -68,4 +99,137 @@ namespace CKE {
 	Blob FileSystem::ReadBinaryFile(Path const& path) const {
 		return ReadBinaryFile(path.c_str());
 	}
+
+	MappedFile FileSystem::MapFile(const char* pPath) const {
+		MappedFile file{};
+
+		// Archived files are views of the archive mapping
+		PackArchive const*            pArchive = nullptr;
+		PackArchiveEntry const* const pEntry = FindArchivedFile(pPath, pArchive);
+		if (pEntry != nullptr) {
+			if (pEntry->m_IsCompressed) {
+				if (!pArchive->ReadEntry(*pEntry, file.m_OwnedData)) {
+					printf("ERROR: Failed to map an archived file [%s]\n", pPath);
+					return file;
+				}
+				file.m_pData = file.m_OwnedData.data();
+			}
+			else { file.m_pData = pArchive->GetEntryData(*pEntry).data(); }
+			file.m_SizeInBytes = pEntry->m_UncompressedSizeInBytes;
+			return file;
+		}
+
+		HANDLE hFile = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE) {
+			// TODO: Use logging system when implemented
+			printf("ERROR: Failed to map a file [%s]\n", pPath);
+			return file;
+		}
+
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(hFile, &fileSize);
+
+		// Empty files can't be mapped
+		if (fileSize.QuadPart == 0) {
+			CloseHandle(hFile);
+			return file;
+		}
+
+		HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (hMapping == nullptr) {
+			CloseHandle(hFile);
+			printf("ERROR: Failed to map a file [%s]\n", pPath);
+			return file;
+		}
+
+		void* pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (pView == nullptr) {
+			CloseHandle(hMapping);
+			CloseHandle(hFile);
+			printf("ERROR: Failed to map a file [%s]\n", pPath);
+			return file;
+		}
+
+		file.m_pData = static_cast<u8 const*>(pView);
+		file.m_SizeInBytes = fileSize.QuadPart;
+		file.m_pFileHandle = hFile;
+		file.m_pMappingHandle = hMapping;
+		return file;
+	}
+
+	MappedFile FileSystem::MapFile(Path const& path) const {
+		return MapFile(path.c_str());
+	}
+
+	//-----------------------------------------------------------------------------
+
+	bool FileSystem::MountArchive(Path const& archivePath, Path const& mountPath) {
+		auto pArchive = std::make_unique<PackArchive>();
+		if (!pArchive->Open(archivePath)) { return false; }
+		m_MountedArchives.emplace_back(MountedArchive{std::move(pArchive), PackArchive::NormalizePath(mountPath)});
+		return true;
+	}
+
+	void FileSystem::UnmountAllArchives() {
+		m_MountedArchives.clear();
+	}
+
+	Span<u8 const> FileSystem::GetArchivedFileData(Path const& path) const {
+		PackArchive const*            pArchive = nullptr;
+		PackArchiveEntry const* const pEntry = FindArchivedFile(path, pArchive);
+		if (pEntry == nullptr || pEntry->m_IsCompressed) { return {}; }
+		return pArchive->GetEntryData(*pEntry);
+	}
+
+	PackArchiveEntry const* FileSystem::FindArchivedFile(Path const& path, PackArchive const*& pArchive) const {
+		if (m_MountedArchives.empty()) { return nullptr; }
+
+		String const normalizedPath = PackArchive::NormalizePath(path);
+		for (MountedArchive const& mounted : m_MountedArchives) {
+			if (!normalizedPath.starts_with(mounted.m_MountPath)) { continue; }
+
+			PackArchiveEntry const* pEntry = mounted.m_pArchive->FindEntry(
+				normalizedPath.substr(mounted.m_MountPath.size()));
+			if (pEntry != nullptr) {
+				pArchive = mounted.m_pArchive.get();
+				return pEntry;
+			}
+		}
+		return nullptr;
+	}
+
+	//-----------------------------------------------------------------------------
+
+	MappedFile::~MappedFile() {
+		Reset();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept {
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			std::swap(m_pData, other.m_pData);
+			std::swap(m_SizeInBytes, other.m_SizeInBytes);
+			std::swap(m_pFileHandle, other.m_pFileHandle);
+			std::swap(m_pMappingHandle, other.m_pMappingHandle);
+			std::swap(m_OwnedData, other.m_OwnedData);
+		}
+		return *this;
+	}
+
+	void MappedFile::Reset() {
+		// Views of archived files don't own a mapping
+		if (m_pMappingHandle != nullptr) { UnmapViewOfFile(m_pData); }
+		if (m_pMappingHandle != nullptr) { CloseHandle(m_pMappingHandle); }
+		if (m_pFileHandle != nullptr) { CloseHandle(m_pFileHandle); }
+		m_pData = nullptr;
+		m_SizeInBytes = 0;
+		m_pFileHandle = nullptr;
+		m_pMappingHandle = nullptr;
+		m_OwnedData = Blob{};
+	}
 }
@@ -0,0 +1,235 @@
+#include "CookieKat/Core/FileSystem/PackArchive.h"
+
+#include "CookieKat/Core/Compression/Compression.h"
+#include "CookieKat/Core/Platform/Asserts.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+
+namespace CKE {
+	namespace {
+		// FNV-1a, the same hash is used when packing and when looking up the files
+		u64 HashPath(char const* pPath, u64 length) {
+			u64 hash{14695981039346656037u};
+			for (u64 i = 0; i < length; ++i) {
+				hash = hash ^ static_cast<u8>(pPath[i]);
+				hash = hash * 1099511628211;
+			}
+			return hash;
+		}
+
+		u64 AlignUp(u64 value, u64 alignment) {
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		bool IsRangeInFile(u64 offset, u64 size, u64 fileSize) {
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+
+		// Checks that the tables and every entry of the archive are inside the file, so that the
+		// lookups and the reads never have to check them again
+		bool HasValidTables(PackArchiveHeader const& header, u8 const* pBase, u64 fileSize) {
+			// The linear probing of the lookups relies on the table having empty slots
+			if (!std::has_single_bit(header.m_NumHashSlots) || header.m_NumHashSlots <= header.m_NumEntries) {
+				return false;
+			}
+
+			if (header.m_EntriesOffset % alignof(PackArchiveEntry) != 0 ||
+				header.m_HashSlotsOffset % alignof(u32) != 0) {
+				return false;
+			}
+			if (!IsRangeInFile(header.m_EntriesOffset, sizeof(PackArchiveEntry) * header.m_NumEntries, fileSize) ||
+				!IsRangeInFile(header.m_HashSlotsOffset, sizeof(u32) * header.m_NumHashSlots, fileSize) ||
+				!IsRangeInFile(header.m_PathsOffset, 0, fileSize)) {
+				return false;
+			}
+
+			auto const pSlots = reinterpret_cast<u32 const*>(pBase + header.m_HashSlotsOffset);
+			for (u32 slot = 0; slot < header.m_NumHashSlots; ++slot) {
+				if (pSlots[slot] > header.m_NumEntries) { return false; }
+			}
+
+			auto const pEntries = reinterpret_cast<PackArchiveEntry const*>(pBase + header.m_EntriesOffset);
+			u64 const  pathsSize = fileSize - header.m_PathsOffset;
+			for (u32 i = 0; i < header.m_NumEntries; ++i) {
+				PackArchiveEntry const& entry = pEntries[i];
+				if (!IsRangeInFile(entry.m_PathOffset, entry.m_PathLength, pathsSize) ||
+					!IsRangeInFile(entry.m_DataOffset, entry.m_SizeInBytes, fileSize)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+
+	bool PackArchive::Open(Path const& archivePath) {
+		Close();
+
+		m_File = g_FileSystem.MapFile(archivePath);
+		if (!m_File.IsValid() || m_File.GetSizeInBytes() < sizeof(PackArchiveHeader)) {
+			m_File.Reset();
+			return false;
+		}
+
+		auto pHeader = reinterpret_cast<PackArchiveHeader const*>(m_File.GetData());
+		if (!pHeader->IsValid() || !HasValidTables(*pHeader, m_File.GetData(), m_File.GetSizeInBytes())) {
+			printf("ERROR: Invalid pack archive [%s]\n", archivePath.c_str());
+			m_File.Reset();
+			return false;
+		}
+
+		m_pHeader = pHeader;
+		return true;
+	}
+
+	void PackArchive::Close() {
+		m_File.Reset();
+		m_pHeader = nullptr;
+	}
+
+	PackArchiveEntry const* PackArchive::FindEntry(String const& path) const {
+		CKE_ASSERT(IsOpen());
+		if (m_pHeader->m_NumEntries == 0) { return nullptr; }
+
+		String const normalizedPath = NormalizePath(path);
+		u64 const    hash = HashPath(normalizedPath.data(), normalizedPath.size());
+
+		u8 const*   pBase = m_File.GetData();
+		auto const  pEntries = reinterpret_cast<PackArchiveEntry const*>(pBase + m_pHeader->m_EntriesOffset);
+		auto const  pSlots = reinterpret_cast<u32 const*>(pBase + m_pHeader->m_HashSlotsOffset);
+		char const* pPaths = reinterpret_cast<char const*>(pBase + m_pHeader->m_PathsOffset);
+		u32 const   slotMask = m_pHeader->m_NumHashSlots - 1;
+
+		// Linear probing, the table always has empty slots
+		for (u32 slot = static_cast<u32>(hash) & slotMask; pSlots[slot] != 0; slot = (slot + 1) & slotMask) {
+			PackArchiveEntry const& entry = pEntries[pSlots[slot] - 1];
+			if (entry.m_PathHash == hash &&
+				normalizedPath.compare(0, String::npos, pPaths + entry.m_PathOffset, entry.m_PathLength) == 0) {
+				return &entry;
+			}
+		}
+		return nullptr;
+	}
+
+	Span<u8 const> PackArchive::GetEntryData(PackArchiveEntry const& entry) const {
+		CKE_ASSERT(IsOpen());
+		CKE_ASSERT(entry.m_DataOffset + entry.m_SizeInBytes <= m_File.GetSizeInBytes());
+		return Span<u8 const>{m_File.GetData() + entry.m_DataOffset, entry.m_SizeInBytes};
+	}
+
+	bool PackArchive::ReadEntry(PackArchiveEntry const& entry, Blob& outFile) const {
+		Span<u8 const> const data = GetEntryData(entry);
+		if (!entry.m_IsCompressed) {
+			outFile.assign(data.begin(), data.end());
+			return true;
+		}
+
+		outFile.resize(entry.m_UncompressedSizeInBytes);
+		if (!Compression::Decompress(data, outFile)) {
+			outFile.clear();
+			return false;
+		}
+		return true;
+	}
+
+	String PackArchive::NormalizePath(String const& path) {
+		String normalizedPath = path;
+		std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
+		return normalizedPath;
+	}
+
+	//-----------------------------------------------------------------------------
+
+	void PackArchiveBuilder::AddFile(String const& path, Span<u8 const> data, bool compress) {
+		PackedFile file{};
+		file.m_Path = PackArchive::NormalizePath(path);
+		file.m_UncompressedSizeInBytes = data.size();
+
+		// Already compressed data (e.g. textures) barely shrinks, it is better stored as it is
+		if (compress && !data.empty()) {
+			Blob compressed = Compression::Compress(data);
+			if (compressed.size() < data.size() - data.size() / 8) {
+				file.m_Data = std::move(compressed);
+				file.m_IsCompressed = true;
+			}
+		}
+		if (!file.m_IsCompressed) { file.m_Data.assign(data.begin(), data.end()); }
+
+		m_Files.emplace_back(std::move(file));
+	}
+
+	bool PackArchiveBuilder::WriteToFile(Path const& archivePath) const {
+		// Sort the files so the same input always produces the same archive
+		Vector<PackedFile const*> files;
+		for (PackedFile const& file : m_Files) { files.push_back(&file); }
+		std::sort(files.begin(), files.end(), [](PackedFile const* a, PackedFile const* b) {
+			return a->m_Path < b->m_Path;
+		});
+
+		PackArchiveHeader header{};
+		header.m_NumEntries = static_cast<u32>(files.size());
+		header.m_NumHashSlots = std::bit_ceil(std::max(2u * header.m_NumEntries, 16u));
+		header.m_EntriesOffset = sizeof(PackArchiveHeader);
+		header.m_HashSlotsOffset = header.m_EntriesOffset + sizeof(PackArchiveEntry) * header.m_NumEntries;
+		header.m_PathsOffset = header.m_HashSlotsOffset + sizeof(u32) * header.m_NumHashSlots;
+
+		// Table of contents
+		//-----------------------------------------------------------------------------
+
+		Vector<PackArchiveEntry> entries(files.size());
+		Vector<u32>              slots(header.m_NumHashSlots, 0);
+		String                   paths;
+		u32 const                slotMask = header.m_NumHashSlots - 1;
+
+		for (u32 i = 0; i < files.size(); ++i) {
+			PackArchiveEntry& entry = entries[i];
+			entry.m_PathHash = HashPath(files[i]->m_Path.data(), files[i]->m_Path.size());
+			entry.m_PathOffset = static_cast<u32>(paths.size());
+			entry.m_PathLength = static_cast<u32>(files[i]->m_Path.size());
+			entry.m_SizeInBytes = files[i]->m_Data.size();
+			entry.m_UncompressedSizeInBytes = files[i]->m_UncompressedSizeInBytes;
+			entry.m_IsCompressed = files[i]->m_IsCompressed;
+			paths += files[i]->m_Path;
+
+			u32 slot = static_cast<u32>(entry.m_PathHash) & slotMask;
+			while (slots[slot] != 0) { slot = (slot + 1) & slotMask; }
+			slots[slot] = i + 1;
+		}
+
+		u64 dataOffset = AlignUp(header.m_PathsOffset + paths.size(), PackArchiveHeader::ENTRY_ALIGNMENT);
+		for (PackArchiveEntry& entry : entries) {
+			entry.m_DataOffset = dataOffset;
+			dataOffset = AlignUp(dataOffset + entry.m_SizeInBytes, PackArchiveHeader::ENTRY_ALIGNMENT);
+		}
+
+		// Write
+		//-----------------------------------------------------------------------------
+
+		std::ofstream ofs(archivePath, std::ios::binary);
+		if (!ofs.is_open()) {
+			printf("ERROR: Failed to write a pack archive [%s]\n", archivePath.c_str());
+			return false;
+		}
+
+		auto writePadding = [&ofs](u64 offset) {
+			static constexpr char s_Zeros[PackArchiveHeader::ENTRY_ALIGNMENT]{};
+			u64 const             paddingSize = AlignUp(offset, PackArchiveHeader::ENTRY_ALIGNMENT) - offset;
+			ofs.write(s_Zeros, static_cast<std::streamsize>(paddingSize));
+		};
+
+		ofs.write(reinterpret_cast<char const*>(&header), sizeof(PackArchiveHeader));
+		ofs.write(reinterpret_cast<char const*>(entries.data()), sizeof(PackArchiveEntry) * entries.size());
+		ofs.write(reinterpret_cast<char const*>(slots.data()), sizeof(u32) * slots.size());
+		ofs.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+		writePadding(header.m_PathsOffset + paths.size());
+
+		for (u32 i = 0; i < files.size(); ++i) {
+			ofs.write(reinterpret_cast<char const*>(files[i]->m_Data.data()),
+			          static_cast<std::streamsize>(files[i]->m_Data.size()));
+			writePadding(entries[i].m_DataOffset + entries[i].m_SizeInBytes);
+		}
+
+		return ofs.good();
+	}
+}
@@ -32,3 +32,31 @@ TEST(FileSystem, WriteRead_BinaryFile)
 
 	g_FileSystem.RemoveFile(filePath);
 }
+
+TEST(FileSystem, MapFile)
+{
+	Vector<u8> bin{ 4u,8u,15u,16u,23u,42u };
+	String filePath{ "FileSystem_TestMap.bin" };
+	g_FileSystem.WriteBinaryFile(filePath, bin.data(), bin.size());
+
+	{
+		MappedFile file = g_FileSystem.MapFile(filePath);
+		ASSERT_TRUE(file.IsValid());
+		EXPECT_EQ(file.GetSizeInBytes(), bin.size());
+		for (i32 i = 0; i < bin.size(); ++i) {
+			EXPECT_EQ(bin[i], file.GetData()[i]);
+		}
+
+		// Ownership of the mapping moves with the object
+		MappedFile movedFile = std::move(file);
+		EXPECT_FALSE(file.IsValid());
+		EXPECT_TRUE(movedFile.IsValid());
+		EXPECT_EQ(movedFile.GetData()[5], 42u);
+	}
+
+	// The file can be removed once it has been unmapped
+	EXPECT_TRUE(g_FileSystem.RemoveFile(filePath));
+
+	MappedFile missingFile = g_FileSystem.MapFile(filePath);
+	EXPECT_FALSE(missingFile.IsValid());
+}
@@ -0,0 +1,199 @@
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Containers/String.h"
+#include "CookieKat/Core/FileSystem/FileSystem.h"
+#include "CookieKat/Core/FileSystem/PackArchive.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace CKE;
+
+namespace {
+	Blob MakeCompressibleFile(u64 size) {
+		Blob file(size);
+		for (u64 i = 0; i < size; ++i) { file[i] = static_cast<u8>((i / 64) % 7); }
+		return file;
+	}
+
+	Blob MakeIncompressibleFile(u64 size) {
+		Blob file(size);
+		u32  state = 0x12345678;
+		for (u64 i = 0; i < size; ++i) {
+			state = state * 1664525u + 1013904223u;
+			file[i] = static_cast<u8>(state >> 24);
+		}
+		return file;
+	}
+
+	class PackArchiveTest : public testing::Test
+	{
+	protected:
+		void SetUp() override {
+			PackArchiveBuilder builder;
+			builder.AddFile("Textures/Compressible.tex", m_CompressibleFile, true);
+			builder.AddFile("Textures\\Incompressible.tex", m_IncompressibleFile, true);
+			builder.AddFile("Meshes/Stored.mesh", m_CompressibleFile, false);
+			ASSERT_TRUE(builder.WriteToFile(m_ArchivePath));
+		}
+
+		void TearDown() override {
+			g_FileSystem.UnmountAllArchives();
+			g_FileSystem.RemoveFile(m_ArchivePath);
+		}
+
+		template <typename T>
+		T ReadFromArchive(u64 offset) const {
+			Blob const archive = g_FileSystem.ReadBinaryFile(m_ArchivePath);
+			T          value{};
+			memcpy(&value, archive.data() + offset, sizeof(T));
+			return value;
+		}
+
+		// Rewrites a part of the archive file
+		template <typename T>
+		void PatchArchive(u64 offset, T const& value) {
+			Blob archive = g_FileSystem.ReadBinaryFile(m_ArchivePath);
+			memcpy(archive.data() + offset, &value, sizeof(T));
+			g_FileSystem.WriteBinaryFile(m_ArchivePath, archive.data(), archive.size());
+		}
+
+		Path m_ArchivePath = "PackArchive_Test.pak";
+		Blob m_CompressibleFile = MakeCompressibleFile(100'000);
+		Blob m_IncompressibleFile = MakeIncompressibleFile(10'000);
+	};
+}
+
+TEST_F(PackArchiveTest, FindEntry) {
+	PackArchive archive;
+	ASSERT_TRUE(archive.Open(m_ArchivePath));
+	EXPECT_EQ(archive.GetNumEntries(), 3);
+
+	PackArchiveEntry const* pCompressible = archive.FindEntry("Textures/Compressible.tex");
+	ASSERT_NE(pCompressible, nullptr);
+	EXPECT_TRUE(pCompressible->m_IsCompressed);
+	EXPECT_LT(pCompressible->m_SizeInBytes, m_CompressibleFile.size());
+	Blob file;
+	EXPECT_TRUE(archive.ReadEntry(*pCompressible, file));
+	EXPECT_EQ(file, m_CompressibleFile);
+
+	// Data that doesn't compress is stored as it is
+	PackArchiveEntry const* pIncompressible = archive.FindEntry("Textures\\Incompressible.tex");
+	ASSERT_NE(pIncompressible, nullptr);
+	EXPECT_FALSE(pIncompressible->m_IsCompressed);
+	EXPECT_TRUE(archive.ReadEntry(*pIncompressible, file));
+	EXPECT_EQ(file, m_IncompressibleFile);
+
+	EXPECT_EQ(archive.FindEntry("Textures/Missing.tex"), nullptr);
+	EXPECT_EQ(archive.FindEntry("Compressible.tex"), nullptr);
+}
+
+TEST_F(PackArchiveTest, EntriesAreAligned) {
+	PackArchive archive;
+	ASSERT_TRUE(archive.Open(m_ArchivePath));
+
+	for (char const* path : {"Textures/Compressible.tex", "Textures/Incompressible.tex", "Meshes/Stored.mesh"}) {
+		PackArchiveEntry const* pEntry = archive.FindEntry(path);
+		ASSERT_NE(pEntry, nullptr);
+		EXPECT_EQ(pEntry->m_DataOffset % PackArchiveHeader::ENTRY_ALIGNMENT, 0);
+	}
+}
+
+TEST_F(PackArchiveTest, MountArchive_ReadsFiles) {
+	ASSERT_TRUE(g_FileSystem.MountArchive(m_ArchivePath, "Data/"));
+
+	EXPECT_EQ(g_FileSystem.ReadBinaryFile("Data/Textures/Compressible.tex"), m_CompressibleFile);
+	EXPECT_EQ(g_FileSystem.ReadBinaryFile("Data\\Textures\\Incompressible.tex"), m_IncompressibleFile);
+
+	// Stored files are accessed in place
+	Span<u8 const> stored = g_FileSystem.GetArchivedFileData("Data/Meshes/Stored.mesh");
+	ASSERT_EQ(stored.size(), m_CompressibleFile.size());
+	EXPECT_TRUE(std::equal(stored.begin(), stored.end(), m_CompressibleFile.begin()));
+	EXPECT_TRUE(g_FileSystem.GetArchivedFileData("Data/Textures/Compressible.tex").empty());
+
+	MappedFile mapped = g_FileSystem.MapFile("Data/Meshes/Stored.mesh");
+	ASSERT_TRUE(mapped.IsValid());
+	EXPECT_EQ(mapped.GetData(), stored.data());
+
+	// Compressed files can be mapped too, they are decompressed
+	MappedFile decompressed = g_FileSystem.MapFile("Data/Textures/Compressible.tex");
+	ASSERT_TRUE(decompressed.IsValid());
+	ASSERT_EQ(decompressed.GetSizeInBytes(), m_CompressibleFile.size());
+	EXPECT_TRUE(std::equal(m_CompressibleFile.begin(), m_CompressibleFile.end(), decompressed.GetData()));
+}
+
+TEST_F(PackArchiveTest, MountArchive_FallsBackToDisk) {
+	ASSERT_TRUE(g_FileSystem.MountArchive(m_ArchivePath, "Data/"));
+	EXPECT_FALSE(g_FileSystem.MountArchive("PackArchive_Missing.pak", "Data/"));
+
+	Path filePath{"PackArchive_Loose.bin"};
+	Blob looseFile{1, 2, 3, 4};
+	g_FileSystem.WriteBinaryFile(filePath, looseFile.data(), looseFile.size());
+	EXPECT_EQ(g_FileSystem.ReadBinaryFile(filePath), looseFile);
+	g_FileSystem.RemoveFile(filePath);
+}
+
+TEST_F(PackArchiveTest, Open_FailsWithTablesOutsideTheFile) {
+	PackArchiveHeader const header = ReadFromArchive<PackArchiveHeader>(0);
+
+	auto expectOpenFails = [&](PackArchiveHeader const& corrupted) {
+		PatchArchive(0, corrupted);
+		PackArchive archive;
+		EXPECT_FALSE(archive.Open(m_ArchivePath));
+		PatchArchive(0, header);
+	};
+
+	PackArchiveHeader corrupted = header;
+	corrupted.m_NumEntries = 1'000'000;
+	expectOpenFails(corrupted);
+
+	corrupted = header;
+	corrupted.m_HashSlotsOffset = ~0ull - 8;
+	expectOpenFails(corrupted);
+
+	corrupted = header;
+	corrupted.m_PathsOffset = 1ull << 40;
+	expectOpenFails(corrupted);
+
+	// The slot count must be a power of two with room for every entry
+	corrupted = header;
+	corrupted.m_NumHashSlots = 0;
+	expectOpenFails(corrupted);
+	corrupted.m_NumHashSlots = 3;
+	expectOpenFails(corrupted);
+	corrupted.m_NumHashSlots = 2;
+	expectOpenFails(corrupted);
+
+	// Data of an entry past the end of the file
+	PackArchiveEntry entry = ReadFromArchive<PackArchiveEntry>(header.m_EntriesOffset);
+	entry.m_SizeInBytes = 1ull << 40;
+	PatchArchive(header.m_EntriesOffset, entry);
+
+	PackArchive archive;
+	EXPECT_FALSE(archive.Open(m_ArchivePath));
+}
+
+TEST_F(PackArchiveTest, ReadEntry_FailsWithCorruptedData) {
+	// The entries are sorted by path, the compressible file is the second one
+	PackArchiveHeader const header = ReadFromArchive<PackArchiveHeader>(0);
+	u64 const               entryOffset = header.m_EntriesOffset + sizeof(PackArchiveEntry);
+	PackArchiveEntry        entry = ReadFromArchive<PackArchiveEntry>(entryOffset);
+	ASSERT_TRUE(entry.m_IsCompressed);
+
+	// The compressed data doesn't fill the original size anymore
+	entry.m_UncompressedSizeInBytes += 1;
+	PatchArchive(entryOffset, entry);
+
+	PackArchive archive;
+	ASSERT_TRUE(archive.Open(m_ArchivePath));
+	PackArchiveEntry const* pEntry = archive.FindEntry("Textures/Compressible.tex");
+	ASSERT_NE(pEntry, nullptr);
+	Blob file{1, 2, 3};
+	EXPECT_FALSE(archive.ReadEntry(*pEntry, file));
+	EXPECT_TRUE(file.empty());
+	archive.Close();
+
+	ASSERT_TRUE(g_FileSystem.MountArchive(m_ArchivePath, "Data/"));
+	EXPECT_TRUE(g_FileSystem.ReadBinaryFile("Data/Textures/Compressible.tex").empty());
+	EXPECT_FALSE(g_FileSystem.MapFile("Data/Textures/Compressible.tex").IsValid());
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CookieKat/Core/Math/Math.h"
+
+#include <cfloat>
+
+namespace CKE {
+	// Axis aligned bounding box
+	// Default constructed boxes are empty, they contain nothing until a point is added
+	struct AABB
+	{
+		Vec3 m_Min{FLT_MAX};
+		Vec3 m_Max{-FLT_MAX};
+
+		AABB() = default;
+		AABB(Vec3 min, Vec3 max) : m_Min{min}, m_Max{max} {}
+
+		inline static AABB FromCenterExtents(Vec3 center, Vec3 extents);
+
+		inline bool IsEmpty() const;
+		inline Vec3 GetCenter() const { return (m_Min + m_Max) * 0.5f; }
+		inline Vec3 GetExtents() const { return (m_Max - m_Min) * 0.5f; }
+
+		// Grows the box to contain the point
+		inline void AddPoint(Vec3 point);
+
+		// Returns the box that contains this one after being transformed by the matrix
+		inline AABB Transform(Mat4 const& transform) const;
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Planes of a view frustum, the normals (xyz) point inside of it and w is the distance to the origin
+	struct Frustum
+	{
+		enum Plane : u32 { Left, Right, Bottom, Top, Near, Far, NumPlanes };
+
+		Vec4 m_Planes[NumPlanes];
+
+		// Extracts the planes of a projection * view matrix with a [0, 1] depth range
+		inline static Frustum FromViewProj(Mat4 const& viewProj);
+
+		// Returns false only if the box is completely outside of one of the planes, boxes
+		// close to the corners can pass the test even if they are not inside of the frustum
+		inline bool Intersects(Vec3 center, Vec3 extents) const;
+		inline bool Intersects(AABB const& box) const;
+	};
+}
+
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	inline AABB AABB::FromCenterExtents(Vec3 center, Vec3 extents) {
+		return AABB{center - extents, center + extents};
+	}
+
+	inline bool AABB::IsEmpty() const {
+		return m_Min.x > m_Max.x || m_Min.y > m_Max.y || m_Min.z > m_Max.z;
+	}
+
+	inline void AABB::AddPoint(Vec3 point) {
+		m_Min = glm::min(m_Min, point);
+		m_Max = glm::max(m_Max, point);
+	}
+
+	inline AABB AABB::Transform(Mat4 const& transform) const {
+		if (IsEmpty()) { return AABB{}; }
+
+		// The extents along each axis are the projection of the transformed box axes on it
+		Vec3 const center = Vec3{transform * Vec4{GetCenter(), 1.0f}};
+		Vec3 const extents = GetExtents();
+		Mat3 const absRotScale{glm::abs(Vec3{transform[0]}), glm::abs(Vec3{transform[1]}), glm::abs(Vec3{transform[2]})};
+		return FromCenterExtents(center, absRotScale * extents);
+	}
+
+	//-----------------------------------------------------------------------------
+
+	inline Frustum Frustum::FromViewProj(Mat4 const& viewProj) {
+		// Gribb-Hartmann, the matrix is column major so each row is gathered from the columns
+		Vec4 const row0{viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]};
+		Vec4 const row1{viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]};
+		Vec4 const row2{viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]};
+		Vec4 const row3{viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]};
+
+		Frustum frustum{};
+		frustum.m_Planes[Left] = row3 + row0;
+		frustum.m_Planes[Right] = row3 - row0;
+		frustum.m_Planes[Bottom] = row3 + row1;
+		frustum.m_Planes[Top] = row3 - row1;
+		frustum.m_Planes[Near] = row2;
+		frustum.m_Planes[Far] = row3 - row2;
+
+		// Normalized so the plane distances are in world units
+		for (Vec4& plane : frustum.m_Planes) {
+			plane /= glm::length(Vec3{plane});
+		}
+		return frustum;
+	}
+
+	inline bool Frustum::Intersects(Vec3 center, Vec3 extents) const {
+		for (Vec4 const& plane : m_Planes) {
+			Vec3 const normal{plane};
+			f32 const  distance = glm::dot(normal, center) + plane.w;
+			f32 const  radius = glm::dot(glm::abs(normal), extents);
+			if (distance + radius < 0.0f) { return false; }
+		}
+		return true;
+	}
+
+	inline bool Frustum::Intersects(AABB const& box) const {
+		return !box.IsEmpty() && Intersects(box.GetCenter(), box.GetExtents());
+	}
+}
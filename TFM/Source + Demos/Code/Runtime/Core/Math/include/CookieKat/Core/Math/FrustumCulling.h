@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CookieKat/Core/Math/Bounds.h"
+#include "CookieKat/Core/Containers/Containers.h"
+
+namespace CKE {
+	// Bounding boxes of a set of objects stored as a structure of arrays,
+	// so the culling can load the same component of several boxes at once
+	//
+	// Empty slots are stored with negative extents, which places them outside of every plane
+	struct BoundsStream
+	{
+		Vector<f32> m_CenterX;
+		Vector<f32> m_CenterY;
+		Vector<f32> m_CenterZ;
+		Vector<f32> m_ExtentsX;
+		Vector<f32> m_ExtentsY;
+		Vector<f32> m_ExtentsZ;
+
+		// The new slots are empty
+		void Resize(u32 numBounds);
+
+		void Set(u32 index, AABB const& box);
+		void SetEmpty(u32 index);
+
+		inline u32 GetSize() const { return static_cast<u32>(m_CenterX.size()); }
+	};
+
+	// Tests the bounds in the range [first, last) against the frustum with SSE/AVX
+	// The indices of the ones that intersect it are written to pOutVisible in increasing order,
+	// it must have room for (last - first) indices. Returns the number of visible bounds
+	//
+	// Disjoint ranges of the same stream can be culled from different threads
+	u32 CullBounds(Frustum const& frustum, BoundsStream const& bounds, u32 first, u32 last, u32* pOutVisible);
+}
@@ -0,0 +1,160 @@
+#include "FrustumCulling.h"
+
+#include "CookieKat/Core/Platform/Asserts.h"
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace CKE {
+	void BoundsStream::Resize(u32 numBounds) {
+		m_CenterX.resize(numBounds, 0.0f);
+		m_CenterY.resize(numBounds, 0.0f);
+		m_CenterZ.resize(numBounds, 0.0f);
+		m_ExtentsX.resize(numBounds, -FLT_MAX);
+		m_ExtentsY.resize(numBounds, -FLT_MAX);
+		m_ExtentsZ.resize(numBounds, -FLT_MAX);
+	}
+
+	void BoundsStream::Set(u32 index, AABB const& box) {
+		if (box.IsEmpty()) {
+			SetEmpty(index);
+			return;
+		}
+
+		Vec3 const center = box.GetCenter();
+		Vec3 const extents = box.GetExtents();
+		m_CenterX[index] = center.x;
+		m_CenterY[index] = center.y;
+		m_CenterZ[index] = center.z;
+		m_ExtentsX[index] = extents.x;
+		m_ExtentsY[index] = extents.y;
+		m_ExtentsZ[index] = extents.z;
+	}
+
+	void BoundsStream::SetEmpty(u32 index) {
+		m_CenterX[index] = 0.0f;
+		m_CenterY[index] = 0.0f;
+		m_CenterZ[index] = 0.0f;
+		m_ExtentsX[index] = -FLT_MAX;
+		m_ExtentsY[index] = -FLT_MAX;
+		m_ExtentsZ[index] = -FLT_MAX;
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	namespace {
+#if defined(__AVX__)
+		struct SimdOps
+		{
+			using Reg = __m256;
+			static constexpr u32 WIDTH = 8;
+
+			static Reg Load(f32 const* p) { return _mm256_loadu_ps(p); }
+			static Reg Set(f32 value) { return _mm256_set1_ps(value); }
+			static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+			static Reg Or(Reg a, Reg b) { return _mm256_or_ps(a, b); }
+			static Reg Zero() { return _mm256_setzero_ps(); }
+			static Reg LessThan(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static u32 MoveMask(Reg a) { return static_cast<u32>(_mm256_movemask_ps(a)); }
+		};
+#elif defined(__SSE2__) || defined(_M_X64)
+		struct SimdOps
+		{
+			using Reg = __m128;
+			static constexpr u32 WIDTH = 4;
+
+			static Reg Load(f32 const* p) { return _mm_loadu_ps(p); }
+			static Reg Set(f32 value) { return _mm_set1_ps(value); }
+			static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+			static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+			static Reg Or(Reg a, Reg b) { return _mm_or_ps(a, b); }
+			static Reg Zero() { return _mm_setzero_ps(); }
+			static Reg LessThan(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+			static u32 MoveMask(Reg a) { return static_cast<u32>(_mm_movemask_ps(a)); }
+		};
+#endif
+
+		// Scalar version of the test, used for the remainder of the range that doesn't fill a register
+		u32 CullBoundsScalar(Frustum const& frustum, BoundsStream const& bounds, u32 first, u32 last,
+		                     u32*           pOutVisible) {
+			u32 numVisible = 0;
+			for (u32 i = first; i < last; ++i) {
+				Vec3 const center{bounds.m_CenterX[i], bounds.m_CenterY[i], bounds.m_CenterZ[i]};
+				Vec3 const extents{bounds.m_ExtentsX[i], bounds.m_ExtentsY[i], bounds.m_ExtentsZ[i]};
+				if (frustum.Intersects(center, extents)) {
+					pOutVisible[numVisible++] = i;
+				}
+			}
+			return numVisible;
+		}
+
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+		// Tests WIDTH boxes against each plane at once, a box is culled if it is outside of any of them
+		u32 CullBoundsSimd(Frustum const& frustum, BoundsStream const& bounds, u32 first, u32 last,
+		                   u32*           pOutVisible) {
+			using Reg = SimdOps::Reg;
+
+			// Plane components and their absolute values, broadcast once for the whole range
+			Reg planeX[Frustum::NumPlanes], planeY[Frustum::NumPlanes], planeZ[Frustum::NumPlanes];
+			Reg planeW[Frustum::NumPlanes];
+			Reg absPlaneX[Frustum::NumPlanes], absPlaneY[Frustum::NumPlanes], absPlaneZ[Frustum::NumPlanes];
+			for (u32 p = 0; p < Frustum::NumPlanes; ++p) {
+				Vec4 const& plane = frustum.m_Planes[p];
+				planeX[p] = SimdOps::Set(plane.x);
+				planeY[p] = SimdOps::Set(plane.y);
+				planeZ[p] = SimdOps::Set(plane.z);
+				planeW[p] = SimdOps::Set(plane.w);
+				absPlaneX[p] = SimdOps::Set(glm::abs(plane.x));
+				absPlaneY[p] = SimdOps::Set(glm::abs(plane.y));
+				absPlaneZ[p] = SimdOps::Set(glm::abs(plane.z));
+			}
+
+			u32       numVisible = 0;
+			u32       i = first;
+			Reg const zero = SimdOps::Zero();
+			for (; i + SimdOps::WIDTH <= last; i += SimdOps::WIDTH) {
+				Reg const centerX = SimdOps::Load(&bounds.m_CenterX[i]);
+				Reg const centerY = SimdOps::Load(&bounds.m_CenterY[i]);
+				Reg const centerZ = SimdOps::Load(&bounds.m_CenterZ[i]);
+				Reg const extentsX = SimdOps::Load(&bounds.m_ExtentsX[i]);
+				Reg const extentsY = SimdOps::Load(&bounds.m_ExtentsY[i]);
+				Reg const extentsZ = SimdOps::Load(&bounds.m_ExtentsZ[i]);
+
+				Reg outside = zero;
+				for (u32 p = 0; p < Frustum::NumPlanes; ++p) {
+					Reg const distance = SimdOps::Add(
+						SimdOps::Add(SimdOps::Mul(planeX[p], centerX), SimdOps::Mul(planeY[p], centerY)),
+						SimdOps::Add(SimdOps::Mul(planeZ[p], centerZ), planeW[p]));
+					Reg const radius = SimdOps::Add(
+						SimdOps::Add(SimdOps::Mul(absPlaneX[p], extentsX), SimdOps::Mul(absPlaneY[p], extentsY)),
+						SimdOps::Mul(absPlaneZ[p], extentsZ));
+					outside = SimdOps::Or(outside, SimdOps::LessThan(SimdOps::Add(distance, radius), zero));
+				}
+
+				// Append the visible lanes in order without branching, culled lanes are overwritten
+				// by the next one. The writes never pass the lanes tested so far, so they stay in the output
+				u32 const visibleMask = ~SimdOps::MoveMask(outside);
+				for (u32 lane = 0; lane < SimdOps::WIDTH; ++lane) {
+					pOutVisible[numVisible] = i + lane;
+					numVisible += (visibleMask >> lane) & 1;
+				}
+			}
+
+			return numVisible + CullBoundsScalar(frustum, bounds, i, last, pOutVisible + numVisible);
+		}
+#endif
+	}
+
+	u32 CullBounds(Frustum const& frustum, BoundsStream const& bounds, u32 first, u32 last, u32* pOutVisible) {
+		CKE_ASSERT(first <= last && last <= bounds.GetSize());
+#if defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+		return CullBoundsSimd(frustum, bounds, first, last, pOutVisible);
+#else
+		return CullBoundsScalar(frustum, bounds, first, last, pOutVisible);
+#endif
+	}
+}
@@ -0,0 +1,126 @@
+#include "CookieKat/Core/Math/Bounds.h"
+#include "CookieKat/Core/Math/FrustumCulling.h"
+
+#include "CookieKat/Tests/Benchmark.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+using namespace CKE;
+using namespace CKE::Tests;
+
+namespace {
+	// Camera at the origin looking down -Z with a 90 degree fov
+	Frustum GetTestFrustum() {
+		Mat4 const view = glm::lookAt(Vec3{0.0f}, Vec3{0.0f, 0.0f, -1.0f}, Vec3{0.0f, 1.0f, 0.0f});
+		Mat4       proj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+		proj[1][1] *= -1; // Same flip as the rendering, it must not change the planes
+		return Frustum::FromViewProj(proj * view);
+	}
+
+	// Grid of boxes around the camera, some of them empty
+	BoundsStream GetTestBounds(u32 numBounds) {
+		BoundsStream bounds;
+		bounds.Resize(numBounds);
+		for (u32 i = 0; i < numBounds; ++i) {
+			if (i % 13 == 0) { continue; }
+
+			Vec3 const center{
+				static_cast<f32>(i % 40) * 5.0f - 100.0f,
+				static_cast<f32>(i / 40 % 40) * 5.0f - 100.0f,
+				static_cast<f32>(i / 1600) * 5.0f - 100.0f
+			};
+			bounds.Set(i, AABB::FromCenterExtents(center, Vec3{0.5f + static_cast<f32>(i % 3)}));
+		}
+		return bounds;
+	}
+}
+
+TEST(Bounds, AABB_Transform) {
+	AABB box{};
+	EXPECT_TRUE(box.IsEmpty());
+	box.AddPoint(Vec3{-1.0f, -2.0f, -3.0f});
+	box.AddPoint(Vec3{1.0f, 2.0f, 3.0f});
+	EXPECT_FALSE(box.IsEmpty());
+	EXPECT_EQ(box.GetCenter(), Vec3{0.0f});
+	EXPECT_EQ(box.GetExtents(), Vec3(1.0f, 2.0f, 3.0f));
+
+	// Rotated 90 degrees around Y, scaled and moved
+	Mat4 transform = glm::translate(Mat4{1.0f}, Vec3{10.0f, 0.0f, 0.0f});
+	transform = glm::rotate(transform, glm::radians(90.0f), Vec3{0.0f, 1.0f, 0.0f});
+	transform = glm::scale(transform, Vec3{2.0f});
+	AABB const transformed = box.Transform(transform);
+
+	Vec3 const center = transformed.GetCenter();
+	Vec3 const extents = transformed.GetExtents();
+	EXPECT_NEAR(center.x, 10.0f, 1e-4f);
+	EXPECT_NEAR(center.y, 0.0f, 1e-4f);
+	EXPECT_NEAR(center.z, 0.0f, 1e-4f);
+	EXPECT_NEAR(extents.x, 6.0f, 1e-4f);
+	EXPECT_NEAR(extents.y, 4.0f, 1e-4f);
+	EXPECT_NEAR(extents.z, 2.0f, 1e-4f);
+
+	EXPECT_TRUE(AABB{}.Transform(transform).IsEmpty());
+}
+
+TEST(Bounds, Frustum_Intersects) {
+	Frustum const frustum = GetTestFrustum();
+
+	EXPECT_TRUE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 0.0f, -10.0f}, Vec3{1.0f})));
+	EXPECT_TRUE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 9.0f, -10.0f}, Vec3{1.0f})));
+	EXPECT_TRUE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 0.0f, 0.5f}, Vec3{1.0f}))); // Crosses near
+
+	EXPECT_FALSE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 0.0f, 10.0f}, Vec3{1.0f})));   // Behind
+	EXPECT_FALSE(frustum.Intersects(AABB::FromCenterExtents(Vec3{-20.0f, 0.0f, -10.0f}, Vec3{1.0f}))); // Left
+	EXPECT_FALSE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 20.0f, -10.0f}, Vec3{1.0f})));  // Top
+	EXPECT_FALSE(frustum.Intersects(AABB::FromCenterExtents(Vec3{0.0f, 0.0f, -200.0f}, Vec3{1.0f})));  // Far
+	EXPECT_FALSE(frustum.Intersects(AABB{}));
+}
+
+TEST(Bounds, CullBounds_MatchesScalarTest) {
+	Frustum const      frustum = GetTestFrustum();
+	BoundsStream const bounds = GetTestBounds(5000);
+
+	// Ranges that don't start or end at a multiple of the register width
+	for (auto [first, last] : {std::pair<u32, u32>{0, 5000}, {3, 4001}, {17, 18}, {100, 100}}) {
+		Vector<u32> expected;
+		for (u32 i = first; i < last; ++i) {
+			Vec3 const center{bounds.m_CenterX[i], bounds.m_CenterY[i], bounds.m_CenterZ[i]};
+			Vec3 const extents{bounds.m_ExtentsX[i], bounds.m_ExtentsY[i], bounds.m_ExtentsZ[i]};
+			if (i % 13 != 0 && frustum.Intersects(AABB::FromCenterExtents(center, extents))) {
+				expected.push_back(i);
+			}
+		}
+
+		Vector<u32> visible(last - first);
+		u32 const   numVisible = CullBounds(frustum, bounds, first, last, visible.data());
+		visible.resize(numVisible);
+		EXPECT_EQ(visible, expected);
+	}
+}
+
+TEST(BoundsBenchmark, CullBounds_64K) {
+	constexpr u32 NUM_BOUNDS = 64000;
+
+	Frustum const      frustum = GetTestFrustum();
+	BoundsStream const bounds = GetTestBounds(NUM_BOUNDS);
+	Vector<u32>        visible(NUM_BOUNDS);
+
+	u32 numVisibleScalar = 0;
+	u64 scalarNs = MeasureNs([&]() {
+		for (u32 i = 0; i < NUM_BOUNDS; ++i) {
+			Vec3 const center{bounds.m_CenterX[i], bounds.m_CenterY[i], bounds.m_CenterZ[i]};
+			Vec3 const extents{bounds.m_ExtentsX[i], bounds.m_ExtentsY[i], bounds.m_ExtentsZ[i]};
+			if (frustum.Intersects(center, extents)) { visible[numVisibleScalar++] = i; }
+		}
+	});
+
+	u32 numVisible = 0;
+	u64 simdNs = MeasureNs([&]() {
+		numVisible = CullBounds(frustum, bounds, 0, NUM_BOUNDS, visible.data());
+	});
+	EXPECT_EQ(numVisible, numVisibleScalar);
+
+	PrintBenchmarkResult("Scalar frustum test", NUM_BOUNDS, scalarNs);
+	PrintBenchmarkResult("SIMD frustum test", NUM_BOUNDS, simdNs);
+}
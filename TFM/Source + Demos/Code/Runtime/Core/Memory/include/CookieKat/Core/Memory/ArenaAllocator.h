@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CookieKat/Core/Platform/PrimitiveTypes.h"
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Memory/LinearAllocator.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace CKE {
+	// Std-compatible allocator that takes its memory from a LinearAllocator, so containers can live in an arena
+	//
+	// Deallocating arena memory does nothing, it is released when the arena is reset.
+	// If the arena is full or there isn't one, it falls back to the heap so the container keeps working.
+	//
+	// Example:
+	//     LinearAllocator arena{pMemBlock, size};
+	//     ArenaVector<u32> values{ArenaStdAllocator<u32>{&arena}};
+	//     values.push_back(3);
+	template <typename T>
+	class ArenaStdAllocator
+	{
+	public:
+		using value_type = T;
+
+		// Containers moved or swapped keep their memory, which belongs to the arena they were created with
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		ArenaStdAllocator() = default;
+		explicit ArenaStdAllocator(LinearAllocator* pArena) : m_pArena{pArena} {}
+
+		template <typename U>
+		ArenaStdAllocator(ArenaStdAllocator<U> const& other) : m_pArena{other.GetArena()} {}
+
+		//-----------------------------------------------------------------------------
+
+		[[nodiscard]] T* allocate(usize count);
+		void             deallocate(T* pMemory, usize count);
+
+		inline LinearAllocator* GetArena() const { return m_pArena; }
+
+		template <typename U>
+		bool operator==(ArenaStdAllocator<U> const& other) const { return m_pArena == other.GetArena(); }
+
+	private:
+		LinearAllocator* m_pArena = nullptr;
+	};
+
+	template <typename T>
+	using ArenaVector = std::vector<T, ArenaStdAllocator<T>>;
+}
+
+// Template implementations
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	template <typename T>
+	T* ArenaStdAllocator<T>::allocate(usize count) {
+		if (m_pArena != nullptr) {
+			if (void* pMemory = m_pArena->TryAlloc(count * sizeof(T), alignof(T))) {
+				return static_cast<T*>(pMemory);
+			}
+		}
+		return static_cast<T*>(CKE::Alloc(count * sizeof(T), alignof(T)));
+	}
+
+	template <typename T>
+	void ArenaStdAllocator<T>::deallocate(T* pMemory, usize count) {
+		if (m_pArena != nullptr && m_pArena->Owns(pMemory)) { return; }
+		CKE::Free(pMemory);
+	}
+}
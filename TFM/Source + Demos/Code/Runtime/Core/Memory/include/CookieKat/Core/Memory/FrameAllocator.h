@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CookieKat/Core/Platform/PrimitiveTypes.h"
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/LinearAllocator.h"
+#include "CookieKat/Core/Memory/ArenaAllocator.h"
+
+#include <atomic>
+
+namespace CKE {
+	// Linear arenas for the temporary allocations of a frame, one per thread and buffered frame
+	//
+	// Each thread allocates from its own arena without any synchronization, and the arenas of
+	// a frame are reset when they are reused NumBufferedFrames later, so the memory allocated in a frame
+	// stays valid during the next NumBufferedFrames - 1 frames.
+	//
+	// Threads must be registered to get an arena, the TaskSystem registers the main thread and its workers.
+	class FrameAllocator
+	{
+	public:
+		static constexpr u32 MAX_BUFFERED_FRAMES = 3;
+		static constexpr u32 INVALID_THREAD_INDEX = 0xFFFFFFFF;
+
+		// Allocates the arenas of all the threads and frames
+		void Initialize(u32 numThreads, u64 arenaSizeInBytes, u32 numBufferedFrames = 2);
+		void Shutdown();
+
+		inline bool IsInitialized() const { return m_pMemoryBlock != nullptr; }
+
+		//-----------------------------------------------------------------------------
+
+		// Makes the calling thread use the arenas of the given thread index
+		static void RegisterThread(u32 threadIndex);
+		static void UnregisterThread();
+
+		// Returns the arena of the calling thread for the current frame,
+		// or nullptr if the thread isn't registered or the allocator isn't initialized
+		inline LinearAllocator* GetThreadArena();
+
+		//-----------------------------------------------------------------------------
+
+		// Advances to the next frame and resets the arenas it reuses
+		// No thread can be allocating from the arenas while this runs
+		void EndFrame();
+
+		inline u64 GetFrameIndex() const { return m_FrameIndex.load(std::memory_order_relaxed); }
+
+		// Returns the memory allocated by all the threads in the current frame
+		u64 GetFrameUsedSize() const;
+
+	private:
+		inline static thread_local u32 t_ThreadIndex = INVALID_THREAD_INDEX;
+
+		void*                   m_pMemoryBlock = nullptr;
+		Vector<LinearAllocator> m_Arenas;                 // numThreads arenas for each buffered frame
+		u32                     m_NumThreads = 0;
+		u32                     m_NumBufferedFrames = 0;
+		std::atomic<u64>        m_FrameIndex{0};
+	};
+
+	inline FrameAllocator g_FrameAllocator{};
+
+	//-----------------------------------------------------------------------------
+
+	// Std-compatible allocator that uses the frame arena of the thread that creates it
+	//
+	// Frame containers must only grow in the thread that created them and
+	// be released before their frame memory is reused
+	template <typename T>
+	class FrameStdAllocator : public ArenaStdAllocator<T>
+	{
+	public:
+		FrameStdAllocator() : ArenaStdAllocator<T>{g_FrameAllocator.GetThreadArena()} {}
+
+		template <typename U>
+		FrameStdAllocator(FrameStdAllocator<U> const& other) : ArenaStdAllocator<T>{other} {}
+
+		// Copies take their memory from the arena of the thread that makes the copy
+		FrameStdAllocator select_on_container_copy_construction() const { return FrameStdAllocator{}; }
+	};
+
+	// Vector for the temporaries of a frame, it uses no heap memory unless the frame arena is full
+	//
+	// Example:
+	//     FrameVector<EntityID> visibleEntities;
+	//     visibleEntities.reserve(numEntities);
+	template <typename T>
+	using FrameVector = std::vector<T, FrameStdAllocator<T>>;
+}
+
+// Inline implementations
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	LinearAllocator* FrameAllocator::GetThreadArena() {
+		if (t_ThreadIndex >= m_NumThreads) { return nullptr; }
+
+		u64 const frameSlot = GetFrameIndex() % m_NumBufferedFrames;
+		return &m_Arenas[frameSlot * m_NumThreads + t_ThreadIndex];
+	}
+}
@@ -13,26 +13,44 @@ namespace CKE {
 	//     void* pMemBlock = CKE::Alloc(pMemBlockSize);
 	//     LinearAllocator linearAlloc{pMemBlock, pMemBlockSize};
 	//     u32* a = linearAlloc.Alloc<u32>();     // Allocated 4 of 40 bytes
-	//     f64* a = linearAlloc.Alloc<f64>();     // Allocated 12 of 40 bytes
+	//     f64* a = linearAlloc.Alloc<f64>();     // Allocated 16 of 40 bytes (aligned to 8)
 	//     linearAlloc.FreeAll();                 // Reset entire buffer
 	class LinearAllocator
 	{
 	public:
+		// Offset of the allocator at a point in time, see FreeToMarker()
+		using Marker = u64;
+
 		LinearAllocator(void* pMemoryBlock, u64 sizeInBytes);
 
 		//-----------------------------------------------------------------------------
 
-		[[nodiscard]] inline void* Alloc(u64 sizeInBytes);
+		[[nodiscard]] inline void* Alloc(u64 sizeInBytes, u64 alignment = 1);
 
 		// Allocates a block of memory the size of T
 		// (Doesn't call any constructor)
 		template <typename T>
 		[[nodiscard]] inline T* Alloc();
 
+		// Same as Alloc, but returns nullptr instead of asserting if the block doesn't fit
+		[[nodiscard]] inline void* TryAlloc(u64 sizeInBytes, u64 alignment = 1);
+
 		//-----------------------------------------------------------------------------
 
 		void FreeAll();
 
+		// Returns the current offset, every block allocated after it can be freed at once with FreeToMarker()
+		inline Marker GetMarker() const { return m_OffsetInBytes; }
+		inline void   FreeToMarker(Marker marker);
+
+		//-----------------------------------------------------------------------------
+
+		inline u64 GetSize() const { return m_SizeInBytes; }
+		inline u64 GetUsedSize() const { return m_OffsetInBytes; }
+
+		// Returns true if the memory belongs to the block managed by the allocator
+		inline bool Owns(void const* pMemory) const;
+
 	private:
 		u8* m_pBuffer;       // Ptr to the memory block managed by the allocator
 		u64 m_SizeInBytes;   // Total size of the buffer
@@ -44,7 +62,7 @@ namespace CKE {
 namespace CKE {
 	template <typename T>
 	T* LinearAllocator::Alloc() {
-		return static_cast<T*>(Alloc(sizeof(T)));
+		return static_cast<T*>(Alloc(sizeof(T), alignof(T)));
 	}
 
 	inline LinearAllocator::LinearAllocator(void* pMemoryBlock, u64 sizeInBytes) {
@@ -53,14 +71,34 @@ namespace CKE {
 		m_OffsetInBytes = 0;
 	}
 
-	inline void* LinearAllocator::Alloc(u64 sizeInBytes) {
-		CKE_ASSERT(m_OffsetInBytes + sizeInBytes <= m_SizeInBytes);
-		void* pReturnMemory = m_pBuffer + m_OffsetInBytes;
-		m_OffsetInBytes += sizeInBytes;
+	inline void* LinearAllocator::Alloc(u64 sizeInBytes, u64 alignment) {
+		void* pReturnMemory = TryAlloc(sizeInBytes, alignment);
+		CKE_ASSERT(pReturnMemory != nullptr);
+		return pReturnMemory;
+	}
+
+	inline void* LinearAllocator::TryAlloc(u64 sizeInBytes, u64 alignment) {
+		// Align the address and not the offset, the memory block may not be aligned
+		uintptr_t const address = reinterpret_cast<uintptr_t>(m_pBuffer) + m_OffsetInBytes;
+		u64 const       padding = (alignment - address % alignment) % alignment;
+		if (m_OffsetInBytes + padding + sizeInBytes > m_SizeInBytes) { return nullptr; }
+
+		void* pReturnMemory = m_pBuffer + m_OffsetInBytes + padding;
+		m_OffsetInBytes += padding + sizeInBytes;
 		return pReturnMemory;
 	}
 
 	inline void LinearAllocator::FreeAll() {
 		m_OffsetInBytes = 0;
 	}
+
+	inline void LinearAllocator::FreeToMarker(Marker marker) {
+		CKE_ASSERT(marker <= m_OffsetInBytes);
+		m_OffsetInBytes = marker;
+	}
+
+	inline bool LinearAllocator::Owns(void const* pMemory) const {
+		u8 const* pBytes = static_cast<u8 const*>(pMemory);
+		return pBytes >= m_pBuffer && pBytes < m_pBuffer + m_SizeInBytes;
+	}
 }
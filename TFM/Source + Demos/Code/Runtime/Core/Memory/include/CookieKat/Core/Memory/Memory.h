@@ -29,6 +29,8 @@ Memory Managers
 	LinearAllocator
 	StackAllocator
 	PoolAllocator
+	AtomicPoolAllocator
+	FrameAllocator (Per-thread frame arenas)
 
 Debugging Toggles
 	[NO] Statistics Logging
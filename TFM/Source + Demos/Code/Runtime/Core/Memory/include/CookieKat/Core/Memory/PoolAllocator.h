@@ -4,17 +4,39 @@
 #include "CookieKat/Core/Platform/PrimitiveTypes.h"
 #include "CookieKat/Core/Containers/Containers.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+
 namespace CKE {
 	// Subdivides a memory block into fixed - size chunks and provides allocation and deallocation functionality.
+	//
+	// The free chunks form an intrusive linked list: each free chunk stores a pointer to the next one
+	// in its first bytes, so alloc and free are O(1) and the allocator doesn't use any other memory.
+	// Chunks must be able to hold a pointer and keep it aligned.
+	//
+	// Not thread safe, see AtomicPoolAllocator for chunks that are allocated and freed from several threads.
+	//
+	// Example:
+	//     void* pMemBlock = CKE::Alloc(sizeof(u64) * 4);
+	//     PoolAllocator pool{static_cast<char*>(pMemBlock), sizeof(u64), sizeof(u64) * 4};
+	//     u64* pA = pool.AllocChunk<u64>();
+	//     pool.FreeChunk(pA);
 	class PoolAllocator
 	{
 	public:
-		PoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes);
+		// Pattern written over the freed chunks when the debug checks are enabled
+		static constexpr u8 POISON_BYTE = 0xDD;
+
+		// With debugChecks the allocator poisons the freed chunks, asserts that a chunk
+		// isn't freed twice and that nothing wrote to a chunk after freeing it (O(n) frees, debugging only)
+		PoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes, bool debugChecks = false);
 
 		//-----------------------------------------------------------------------------
 
 		// Returns a pointer to an available block of memory.
-		[[nodiscard]] void* AllocChunk();
+		[[nodiscard]] inline void* AllocChunk();
 
 		// Templated version of AllocChunk that casts the returned pointer to the requested type.
 		template <typename T>
@@ -23,26 +45,119 @@ namespace CKE {
 		//-----------------------------------------------------------------------------
 
 		// Returns to the pool a previously requested chunk
-		void FreeChunk(void* pChunkPtr);
+		inline void FreeChunk(void* pChunkPtr);
+
+		// Returns all of the chunks to the pool, the chunks in use become invalid
+		void FreeAll();
+
+		//-----------------------------------------------------------------------------
+
+		inline u64 GetChunkSize() const { return m_ChunkSize; }
+		inline u64 GetNumChunks() const { return m_NumChunks; }
+		inline u64 GetNumFreeChunks() const { return m_NumFreeChunks; }
+
+		// Returns true if the pointer points to the start of a chunk of this pool
+		inline bool OwnsChunk(void const* pChunkPtr) const;
+
+	private:
+		struct FreeChunkNode
+		{
+			FreeChunkNode* m_pNext;
+		};
+
+		void DebugCheckFree(void* pChunkPtr) const;
+		void DebugCheckAlloc(void* pChunkPtr) const;
 
 	private:
-		// TODO: Replace the heavy Set block tracking implementation with a more compact & efficient one
-		char*    m_pBuffer;           // Ptr to the memory buffer managed by this allocator
-		u64      m_TotalSize;         // Total size of the memory buffer managed by the allocator
-		u64      m_BlockSize;         // Size of each block/chunk
-		Set<u64> m_BlockOffsetsFree;  // Array of the start offset of every available block
-		Set<u64> m_BlockOffsetsInUse; // Array of the start offset of every in-use block
+		char*          m_pBuffer;       // Ptr to the memory buffer managed by this allocator
+		u64            m_ChunkSize;     // Size of each block/chunk
+		u64            m_NumChunks;     // Number of chunks in the buffer
+		u64            m_NumFreeChunks; // Number of chunks in the free list
+		FreeChunkNode* m_pFreeList;     // First free chunk, nullptr when the pool is exhausted
+		bool           m_DebugChecks;
 	};
 
-	// TODO: Should we extract the templated functions to a derived class like this?
+	//-----------------------------------------------------------------------------
+
+	// Pool of chunks sized and aligned for T, that constructs and destroys the objects
+	//
+	// Example:
+	//     using Pool = TPoolAllocator<Particle>;
+	//     void* pMemBlock = CKE::Alloc(Pool::GetRequiredSize(100), alignof(Particle));
+	//     Pool pool{static_cast<char*>(pMemBlock), 100};
+	//     Particle* pParticle = pool.New(position, velocity);
+	//     pool.Delete(pParticle);
 	template <typename T>
 	class TPoolAllocator : public PoolAllocator
 	{
-		TPoolAllocator(char* pMemoryBlock, u32 maxElements) : PoolAllocator{pMemoryBlock, sizeof(T), maxElements * sizeof(T)} {}
+	public:
+		// Chunks are big enough to hold the free list link and keep T aligned
+		static constexpr u64 CHUNK_SIZE = (std::max(sizeof(T), sizeof(void*)) + alignof(T) - 1) / alignof(T) * alignof(T);
 
-		T* AllocChunk() {
-			return this->AllocChunk<T>();
-		}
+		// Size of the memory block needed to store maxElements objects
+		static constexpr u64 GetRequiredSize(u64 maxElements) { return maxElements * CHUNK_SIZE; }
+
+		TPoolAllocator(char* pMemoryBlock, u64 maxElements, bool debugChecks = false);
+
+		//-----------------------------------------------------------------------------
+
+		// Returns uninitialized memory for a T
+		[[nodiscard]] inline T* AllocChunk();
+
+		// Allocates a chunk and constructs a T in it
+		template <typename... ConstructorArgs>
+			requires std::is_constructible_v<T, ConstructorArgs...>
+		[[nodiscard]] T* New(ConstructorArgs&&... args);
+
+		// Calls the destructor of the object and returns its chunk to the pool
+		void Delete(T* pObject);
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Lock-free version of the PoolAllocator, chunks can be allocated and freed from any thread
+	//
+	// The head of the free list is a chunk index with a tag that changes on every update,
+	// so a thread that read a stale head can't complete its compare and swap (ABA problem).
+	// Each free chunk stores the index of the next one in its first 4 bytes.
+	class AtomicPoolAllocator
+	{
+	public:
+		AtomicPoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes);
+
+		//-----------------------------------------------------------------------------
+
+		// Returns a pointer to an available block of memory or nullptr if the pool is exhausted,
+		// another thread could free a chunk at any time so running out isn't an error here
+		[[nodiscard]] inline void* AllocChunk();
+
+		template <typename T>
+		[[nodiscard]] T* AllocChunk();
+
+		// Returns to the pool a chunk, it can be allocated in other thread
+		inline void FreeChunk(void* pChunkPtr);
+
+		//-----------------------------------------------------------------------------
+
+		inline u64 GetChunkSize() const { return m_ChunkSize; }
+		inline u64 GetNumChunks() const { return m_NumChunks; }
+
+		// Returns true if the pointer points to the start of a chunk of this pool
+		inline bool OwnsChunk(void const* pChunkPtr) const;
+
+	private:
+		static constexpr u32 INVALID_INDEX = 0xFFFFFFFF;
+
+		static constexpr u32 GetIndex(u64 head) { return static_cast<u32>(head); }
+		static constexpr u64 MakeHead(u64 prevHead, u32 index) { return ((prevHead >> 32) + 1) << 32 | index; }
+
+		inline std::atomic_ref<u32> GetNextIndex(u32 chunkIndex) const;
+
+	private:
+		char*            m_pBuffer;   // Ptr to the memory buffer managed by this allocator
+		u64              m_ChunkSize; // Size of each block/chunk
+		u64              m_NumChunks; // Number of chunks in the buffer
+		std::atomic<u64> m_Head;      // Tag (high 32 bits) and index of the first free chunk (low 32 bits)
 	};
 }
 
@@ -52,40 +167,170 @@ namespace CKE {
 namespace CKE {
 	template <typename T>
 	T* PoolAllocator::AllocChunk() {
-		CKE_ASSERT(sizeof(T) <= m_BlockSize);
+		CKE_ASSERT(sizeof(T) <= m_ChunkSize);
 		return static_cast<T*>(AllocChunk());
 	}
 
-	inline PoolAllocator::PoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes) {
+	inline PoolAllocator::PoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes, bool debugChecks) {
+		CKE_ASSERT(pMemoryBlock != nullptr);
+		CKE_ASSERT(chunkSizeInBytes >= sizeof(FreeChunkNode));
+		CKE_ASSERT(chunkSizeInBytes % alignof(FreeChunkNode) == 0);
+		CKE_ASSERT(reinterpret_cast<uintptr_t>(pMemoryBlock) % alignof(FreeChunkNode) == 0);
+		CKE_ASSERT(totalSizeInBytes % chunkSizeInBytes == 0);
+
 		m_pBuffer = pMemoryBlock;
-		m_TotalSize = totalSizeInBytes;
-		m_BlockSize = chunkSizeInBytes;
+		m_ChunkSize = chunkSizeInBytes;
+		m_NumChunks = totalSizeInBytes / chunkSizeInBytes;
+		m_DebugChecks = debugChecks;
 
-		CKE_ASSERT(totalSizeInBytes % chunkSizeInBytes == 0);
-		u64 const chunkCount = totalSizeInBytes / chunkSizeInBytes;
-		for (u64 i = 0; i < chunkCount; ++i) {
-			u64 blockOffset = i * chunkSizeInBytes;
-			m_BlockOffsetsFree.insert(blockOffset);
+		FreeAll();
+	}
+
+	inline void PoolAllocator::FreeAll() {
+		// Link the chunks in address order, so the first allocations are contiguous
+		m_pFreeList = nullptr;
+		for (u64 i = m_NumChunks; i > 0; --i) {
+			char* pChunk = m_pBuffer + (i - 1) * m_ChunkSize;
+			if (m_DebugChecks) { memset(pChunk, POISON_BYTE, m_ChunkSize); }
+
+			FreeChunkNode* pNode = new(pChunk) FreeChunkNode{m_pFreeList};
+			m_pFreeList = pNode;
 		}
+		m_NumFreeChunks = m_NumChunks;
 	}
 
 	inline void* PoolAllocator::AllocChunk() {
-		CKE_ASSERT(!m_BlockOffsetsFree.empty());
+		CKE_ASSERT(m_pFreeList != nullptr);
 
-		u64   blockOffset = *m_BlockOffsetsFree.begin();
-		char* pBlock = m_pBuffer + blockOffset;
+		FreeChunkNode* pChunk = m_pFreeList;
+		if (m_DebugChecks) { DebugCheckAlloc(pChunk); }
 
-		m_BlockOffsetsFree.erase(blockOffset);
-		m_BlockOffsetsInUse.insert(blockOffset);
-
-		return pBlock;
+		m_pFreeList = pChunk->m_pNext;
+		m_NumFreeChunks--;
+		return pChunk;
 	}
 
 	inline void PoolAllocator::FreeChunk(void* pChunkPtr) {
-		memset(pChunkPtr, 0, m_BlockSize);
+		CKE_ASSERT(OwnsChunk(pChunkPtr));
+		if (m_DebugChecks) {
+			DebugCheckFree(pChunkPtr);
+			memset(pChunkPtr, POISON_BYTE, m_ChunkSize);
+		}
+
+		m_pFreeList = new(pChunkPtr) FreeChunkNode{m_pFreeList};
+		m_NumFreeChunks++;
+	}
+
+	inline bool PoolAllocator::OwnsChunk(void const* pChunkPtr) const {
+		char const* pChunk = static_cast<char const*>(pChunkPtr);
+		if (pChunk < m_pBuffer || pChunk >= m_pBuffer + m_NumChunks * m_ChunkSize) { return false; }
+		return (pChunk - m_pBuffer) % m_ChunkSize == 0;
+	}
+
+	inline void PoolAllocator::DebugCheckFree(void* pChunkPtr) const {
+		// Walking the free list is slow, but it catches every double free
+		for (FreeChunkNode const* pNode = m_pFreeList; pNode != nullptr; pNode = pNode->m_pNext) {
+			CKE_ASSERT(pNode != pChunkPtr); // Chunk freed twice
+		}
+	}
+
+	inline void PoolAllocator::DebugCheckAlloc(void* pChunkPtr) const {
+		// Everything after the link must still be poisoned, otherwise the chunk was written after being freed
+		u8 const* pBytes = static_cast<u8 const*>(pChunkPtr);
+		for (u64 i = sizeof(FreeChunkNode); i < m_ChunkSize; ++i) {
+			CKE_ASSERT(pBytes[i] == POISON_BYTE); // Use after free
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+
+	template <typename T>
+	TPoolAllocator<T>::TPoolAllocator(char* pMemoryBlock, u64 maxElements, bool debugChecks)
+		: PoolAllocator{pMemoryBlock, CHUNK_SIZE, GetRequiredSize(maxElements), debugChecks} {
+		CKE_ASSERT(reinterpret_cast<uintptr_t>(pMemoryBlock) % alignof(T) == 0);
+	}
+
+	template <typename T>
+	T* TPoolAllocator<T>::AllocChunk() {
+		return PoolAllocator::AllocChunk<T>();
+	}
+
+	template <typename T>
+	template <typename... ConstructorArgs>
+		requires std::is_constructible_v<T, ConstructorArgs...>
+	T* TPoolAllocator<T>::New(ConstructorArgs&&... args) {
+		return new(AllocChunk()) T(std::forward<ConstructorArgs>(args)...);
+	}
+
+	template <typename T>
+	void TPoolAllocator<T>::Delete(T* pObject) {
+		CKE_ASSERT(pObject != nullptr);
+		pObject->~T();
+		FreeChunk(pObject);
+	}
+
+	//-----------------------------------------------------------------------------
+
+	template <typename T>
+	T* AtomicPoolAllocator::AllocChunk() {
+		CKE_ASSERT(sizeof(T) <= m_ChunkSize);
+		return static_cast<T*>(AllocChunk());
+	}
+
+	inline AtomicPoolAllocator::AtomicPoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes) {
+		CKE_ASSERT(pMemoryBlock != nullptr);
+		CKE_ASSERT(chunkSizeInBytes >= sizeof(u32));
+		CKE_ASSERT(chunkSizeInBytes % std::atomic_ref<u32>::required_alignment == 0);
+		CKE_ASSERT(reinterpret_cast<uintptr_t>(pMemoryBlock) % std::atomic_ref<u32>::required_alignment == 0);
+		CKE_ASSERT(totalSizeInBytes % chunkSizeInBytes == 0);
+
+		m_pBuffer = pMemoryBlock;
+		m_ChunkSize = chunkSizeInBytes;
+		m_NumChunks = totalSizeInBytes / chunkSizeInBytes;
+		CKE_ASSERT(m_NumChunks < INVALID_INDEX);
+
+		for (u64 i = 0; i < m_NumChunks; ++i) {
+			u32 const nextIndex = i + 1 < m_NumChunks ? static_cast<u32>(i + 1) : INVALID_INDEX;
+			GetNextIndex(static_cast<u32>(i)).store(nextIndex, std::memory_order_relaxed);
+		}
+		m_Head.store(m_NumChunks > 0 ? 0 : INVALID_INDEX, std::memory_order_release);
+	}
+
+	inline void* AtomicPoolAllocator::AllocChunk() {
+		u64 head = m_Head.load(std::memory_order_acquire);
+		while (true) {
+			u32 const index = GetIndex(head);
+			if (index == INVALID_INDEX) { return nullptr; }
+
+			// The chunk could have been allocated and overwritten by another thread since we read the head,
+			// in that case the tag changed and the exchange fails, so the garbage index is never used
+			u32 const nextIndex = GetNextIndex(index).load(std::memory_order_relaxed);
+			if (m_Head.compare_exchange_weak(head, MakeHead(head, nextIndex),
+			                                 std::memory_order_acquire, std::memory_order_acquire)) {
+				return m_pBuffer + index * m_ChunkSize;
+			}
+		}
+	}
+
+	inline void AtomicPoolAllocator::FreeChunk(void* pChunkPtr) {
+		CKE_ASSERT(OwnsChunk(pChunkPtr));
+		u32 const index = static_cast<u32>((static_cast<char*>(pChunkPtr) - m_pBuffer) / m_ChunkSize);
+
+		u64 head = m_Head.load(std::memory_order_relaxed);
+		do {
+			GetNextIndex(index).store(GetIndex(head), std::memory_order_relaxed);
+		}
+		while (!m_Head.compare_exchange_weak(head, MakeHead(head, index),
+		                                     std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	inline bool AtomicPoolAllocator::OwnsChunk(void const* pChunkPtr) const {
+		char const* pChunk = static_cast<char const*>(pChunkPtr);
+		if (pChunk < m_pBuffer || pChunk >= m_pBuffer + m_NumChunks * m_ChunkSize) { return false; }
+		return (pChunk - m_pBuffer) % m_ChunkSize == 0;
+	}
 
-		u64 blockOffset = static_cast<char*>(pChunkPtr) - m_pBuffer;
-		m_BlockOffsetsInUse.erase(blockOffset);
-		m_BlockOffsetsFree.insert(blockOffset);
+	inline std::atomic_ref<u32> AtomicPoolAllocator::GetNextIndex(u32 chunkIndex) const {
+		return std::atomic_ref<u32>{*reinterpret_cast<u32*>(m_pBuffer + chunkIndex * m_ChunkSize)};
 	}
 }
@@ -0,0 +1,32 @@
+#pragma once
+
+namespace CKE {
+	// Frees everything allocated from a Linear or Stack allocator during the lifetime of the scope
+	//
+	// Example:
+	//     {
+	//         ScratchScope scratch{&arena};
+	//         Vec3* pTemp = arena.Alloc<Vec3>();
+	//     } // pTemp is released here
+	template <typename Allocator>
+	class ScratchScope
+	{
+	public:
+		// A null allocator makes the scope do nothing
+		explicit ScratchScope(Allocator* pAllocator)
+			: m_pAllocator{pAllocator} {
+			if (m_pAllocator != nullptr) { m_Marker = m_pAllocator->GetMarker(); }
+		}
+
+		~ScratchScope() {
+			if (m_pAllocator != nullptr) { m_pAllocator->FreeToMarker(m_Marker); }
+		}
+
+		ScratchScope(ScratchScope const&) = delete;
+		ScratchScope& operator=(ScratchScope const&) = delete;
+
+	private:
+		Allocator*                 m_pAllocator;
+		typename Allocator::Marker m_Marker{};
+	};
+}
@@ -4,12 +4,25 @@
 #include "CookieKat/Core/Platform/PrimitiveTypes.h"
 #include "CookieKat/Core/Containers/Containers.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace CKE {
 	// Allocates memory linearly from a given buffer and
 	// allows releasing the last allocated block
+	//
+	// Each block is preceded by a small header with the state of the allocator before
+	// allocating it, so FreeLast() can unwind the blocks without any other memory.
 	class StackAllocator
 	{
 	public:
+		// State of the allocator at a point in time, see FreeToMarker()
+		struct Marker
+		{
+			u64 m_Top = 0;                  // Offset where the next block header would start
+			u64 m_LastBlockHeader = NO_BLOCK; // Offset of the header of the last allocated block
+		};
+
 		// Initialize the allocator with an existing memory block
 		// that it will manage and its size
 		StackAllocator(void* pMemoryBlock, u64 sizeInBytes);
@@ -17,7 +30,7 @@ namespace CKE {
 		//-----------------------------------------------------------------------------
 
 		// Allocates a memory block of the given size
-		void* Alloc(u64 sizeInBytes);
+		void* Alloc(u64 sizeInBytes, u64 alignment = alignof(u64));
 
 		// Allocates a memory block the size of T
 		template <typename T>
@@ -28,11 +41,21 @@ namespace CKE {
 		// Frees the last allocated memory block
 		void FreeLast();
 
+		// Frees every block allocated after the marker was taken
+		inline Marker GetMarker() const { return m_State; }
+		inline void   FreeToMarker(Marker marker);
+
+		inline u64 GetUsedSize() const { return m_State.m_Top; }
+
+	private:
+		static constexpr u64 NO_BLOCK = ~0ull;
+
+		using BlockHeader = Marker;
+
 	private:
-		// TODO: Replace Stack with a container that doesn't use the heap
-		u8*        m_pBuffer;           // Ptr to the memory block managed by the allocator
-		u64        m_SizeInBytes;       // Total size of the buffer
-		Stack<u64> m_AllocationOffsets; // Offset of the previously allocated blocks
+		u8*    m_pBuffer;     // Ptr to the memory block managed by the allocator
+		u64    m_SizeInBytes; // Total size of the buffer
+		Marker m_State;       // Current top and last allocated block
 	};
 }
 
@@ -42,24 +65,39 @@ namespace CKE {
 namespace CKE {
 	template <typename T>
 	T* StackAllocator::Alloc() {
-		return static_cast<T*>(Alloc(sizeof(T)));
+		return static_cast<T*>(Alloc(sizeof(T), std::max(alignof(T), alignof(BlockHeader))));
 	}
 
 	inline StackAllocator::StackAllocator(void* pMemoryBlock, u64 sizeInBytes) {
 		m_pBuffer = static_cast<u8*>(pMemoryBlock);
 		m_SizeInBytes = sizeInBytes;
-		m_AllocationOffsets.push(0);
+		m_State = Marker{};
 	}
 
-	inline void* StackAllocator::Alloc(u64 sizeInBytes) {
-		CKE_ASSERT(m_AllocationOffsets.top() + sizeInBytes <= m_SizeInBytes);
-		void*     pReturnMemory = m_pBuffer + m_AllocationOffsets.top();
-		u64 const newOffset = m_AllocationOffsets.top() + sizeInBytes;
-		m_AllocationOffsets.push(newOffset);
-		return pReturnMemory;
+	inline void* StackAllocator::Alloc(u64 sizeInBytes, u64 alignment) {
+		CKE_ASSERT(alignment >= alignof(BlockHeader) && alignment % alignof(BlockHeader) == 0);
+
+		// The header goes right before the aligned block
+		uintptr_t const headerAddress = reinterpret_cast<uintptr_t>(m_pBuffer) + m_State.m_Top;
+		uintptr_t const blockAddress = (headerAddress + sizeof(BlockHeader) + alignment - 1) / alignment * alignment;
+		u64 const       blockOffset = blockAddress - reinterpret_cast<uintptr_t>(m_pBuffer);
+		CKE_ASSERT(blockOffset + sizeInBytes <= m_SizeInBytes);
+
+		u64 const headerOffset = blockOffset - sizeof(BlockHeader);
+		memcpy(m_pBuffer + headerOffset, &m_State, sizeof(BlockHeader));
+
+		m_State.m_Top = blockOffset + sizeInBytes;
+		m_State.m_LastBlockHeader = headerOffset;
+		return m_pBuffer + blockOffset;
 	}
 
 	inline void StackAllocator::FreeLast() {
-		m_AllocationOffsets.pop();
+		CKE_ASSERT(m_State.m_LastBlockHeader != NO_BLOCK);
+		memcpy(&m_State, m_pBuffer + m_State.m_LastBlockHeader, sizeof(BlockHeader));
+	}
+
+	inline void StackAllocator::FreeToMarker(Marker marker) {
+		CKE_ASSERT(marker.m_Top <= m_State.m_Top);
+		m_State = marker;
 	}
 }
@@ -1,4 +1,7 @@
 #include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Memory/ArenaAllocator.h"
+#include "CookieKat/Core/Memory/FrameAllocator.h"
 #include "CookieKat/Core/Memory/LinearAllocator.h"
 #include "CookieKat/Core/Memory/PoolAllocator.h"
-#include "CookieKat/Core/Memory/StackAllocator.h"
+#include "CookieKat/Core/Memory/ScratchScope.h"
+#include "CookieKat/Core/Memory/StackAllocator.h"
\ No newline at end of file
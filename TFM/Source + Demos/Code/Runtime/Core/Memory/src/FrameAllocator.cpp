@@ -0,0 +1,77 @@
+#include "CookieKat/Core/Memory/FrameAllocator.h"
+
+#include "CookieKat/Core/Platform/Asserts.h"
+
+namespace CKE
+{
+	void FrameAllocator::Initialize(u32 numThreads, u64 arenaSizeInBytes, u32 numBufferedFrames)
+	{
+		CKE_ASSERT(!IsInitialized());
+		CKE_ASSERT(numThreads > 0);
+		CKE_ASSERT(numBufferedFrames > 0 && numBufferedFrames <= MAX_BUFFERED_FRAMES);
+
+		m_NumThreads = numThreads;
+		m_NumBufferedFrames = numBufferedFrames;
+		m_FrameIndex.store(0, std::memory_order_relaxed);
+
+		// A single block for all the arenas, each arena is aligned to a cache line
+		// so threads don't write to the same lines
+		constexpr u64 ARENA_ALIGNMENT = 64;
+		u64 const     alignedArenaSize = (arenaSizeInBytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+		u64 const     numArenas = static_cast<u64>(numThreads) * numBufferedFrames;
+		m_pMemoryBlock = CKE::Alloc(alignedArenaSize * numArenas, ARENA_ALIGNMENT);
+
+		m_Arenas.reserve(numArenas);
+		for (u64 i = 0; i < numArenas; ++i)
+		{
+			m_Arenas.emplace_back(static_cast<u8*>(m_pMemoryBlock) + i * alignedArenaSize, arenaSizeInBytes);
+		}
+	}
+
+	void FrameAllocator::Shutdown()
+	{
+		if (!IsInitialized()) { return; }
+
+		m_Arenas.clear();
+		CKE::Free(m_pMemoryBlock);
+		m_pMemoryBlock = nullptr;
+		m_NumThreads = 0;
+		m_NumBufferedFrames = 0;
+	}
+
+	void FrameAllocator::RegisterThread(u32 threadIndex)
+	{
+		t_ThreadIndex = threadIndex;
+	}
+
+	void FrameAllocator::UnregisterThread()
+	{
+		t_ThreadIndex = INVALID_THREAD_INDEX;
+	}
+
+	void FrameAllocator::EndFrame()
+	{
+		if (!IsInitialized()) { return; }
+
+		u64 const newFrameIndex = m_FrameIndex.load(std::memory_order_relaxed) + 1;
+		u64 const frameSlot = newFrameIndex % m_NumBufferedFrames;
+		for (u32 thread = 0; thread < m_NumThreads; ++thread)
+		{
+			m_Arenas[frameSlot * m_NumThreads + thread].FreeAll();
+		}
+		m_FrameIndex.store(newFrameIndex, std::memory_order_release);
+	}
+
+	u64 FrameAllocator::GetFrameUsedSize() const
+	{
+		if (!IsInitialized()) { return 0; }
+
+		u64 const frameSlot = GetFrameIndex() % m_NumBufferedFrames;
+		u64       usedSize = 0;
+		for (u32 thread = 0; thread < m_NumThreads; ++thread)
+		{
+			usedSize += m_Arenas[frameSlot * m_NumThreads + thread].GetUsedSize();
+		}
+		return usedSize;
+	}
+}
@@ -0,0 +1,102 @@
+#include "CookieKat/Core/Containers/Containers.h"
+
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Memory/PoolAllocator.h"
+
+#include "CookieKat/Tests/Benchmark.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace CKE;
+using namespace CKE::Tests;
+
+// Pool Allocator Benchmarks
+// They print their throughput and only check that the pools hand out every chunk
+//-----------------------------------------------------------------------------
+
+namespace
+{
+	// The previous pool implementation, which tracks the free and used chunks in two hash sets
+	class SetPoolAllocator
+	{
+	public:
+		SetPoolAllocator(char* pMemoryBlock, u64 chunkSizeInBytes, u64 totalSizeInBytes)
+			: m_pBuffer{ pMemoryBlock }, m_BlockSize{ chunkSizeInBytes }
+		{
+			for (u64 offset = 0; offset < totalSizeInBytes; offset += chunkSizeInBytes)
+			{
+				m_BlockOffsetsFree.insert(offset);
+			}
+		}
+
+		void* AllocChunk()
+		{
+			u64 blockOffset = *m_BlockOffsetsFree.begin();
+			m_BlockOffsetsFree.erase(blockOffset);
+			m_BlockOffsetsInUse.insert(blockOffset);
+			return m_pBuffer + blockOffset;
+		}
+
+		void FreeChunk(void* pChunkPtr)
+		{
+			memset(pChunkPtr, 0, m_BlockSize);
+			u64 blockOffset = static_cast<char*>(pChunkPtr) - m_pBuffer;
+			m_BlockOffsetsInUse.erase(blockOffset);
+			m_BlockOffsetsFree.insert(blockOffset);
+		}
+
+	private:
+		char*    m_pBuffer;
+		u64      m_BlockSize;
+		Set<u64> m_BlockOffsetsFree;
+		Set<u64> m_BlockOffsetsInUse;
+	};
+
+	constexpr u64 BENCH_CHUNK_SIZE = 64;
+	constexpr u64 BENCH_NUM_CHUNKS = 1'000'000;
+
+	// Allocates every chunk, frees them in a scattered order and allocates them again
+	template <typename Pool>
+	void RunPoolBenchmark(const char* benchName)
+	{
+		void* pMemoryBlock = CKE::Alloc(BENCH_CHUNK_SIZE * BENCH_NUM_CHUNKS);
+
+		Vector<void*> chunks(BENCH_NUM_CHUNKS);
+		u64           elapsedNs = 0;
+		{
+			Pool pool{ static_cast<char*>(pMemoryBlock), BENCH_CHUNK_SIZE, BENCH_CHUNK_SIZE * BENCH_NUM_CHUNKS };
+			elapsedNs = MeasureNs([&]()
+			{
+				for (u64 i = 0; i < BENCH_NUM_CHUNKS; ++i) { chunks[i] = pool.AllocChunk(); }
+				for (u64 i = 0; i < BENCH_NUM_CHUNKS; i += 2) { pool.FreeChunk(chunks[i]); }
+				for (u64 i = 1; i < BENCH_NUM_CHUNKS; i += 2) { pool.FreeChunk(chunks[i]); }
+				for (u64 i = 0; i < BENCH_NUM_CHUNKS; ++i) { chunks[i] = pool.AllocChunk(); }
+			});
+		}
+		PrintBenchmarkResult(benchName, BENCH_NUM_CHUNKS * 3, elapsedNs);
+
+		std::sort(chunks.begin(), chunks.end());
+		EXPECT_EQ(std::unique(chunks.begin(), chunks.end()), chunks.end());
+		EXPECT_EQ(chunks.front(), pMemoryBlock);
+
+		Free(pMemoryBlock);
+	}
+}
+
+TEST(PoolAllocatorBenchmark, SetPool_1M)
+{
+	RunPoolBenchmark<SetPoolAllocator>("Set pool alloc/free");
+}
+
+TEST(PoolAllocatorBenchmark, FreeListPool_1M)
+{
+	RunPoolBenchmark<PoolAllocator>("Free list pool alloc/free");
+}
+
+TEST(PoolAllocatorBenchmark, AtomicPool_1M)
+{
+	RunPoolBenchmark<AtomicPoolAllocator>("Atomic pool alloc/free");
+}
@@ -7,9 +7,14 @@
 #include "CookieKat/Core/Memory/LinearAllocator.h"
 #include "CookieKat/Core/Memory/StackAllocator.h"
 #include "CookieKat/Core/Memory/PoolAllocator.h"
+#include "CookieKat/Core/Memory/ArenaAllocator.h"
+#include "CookieKat/Core/Memory/FrameAllocator.h"
+#include "CookieKat/Core/Memory/ScratchScope.h"
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 using namespace CKE;
 
 
@@ -91,6 +96,176 @@ TEST(Core_Allocators, Linear_Allocator_OverflowThrows)
 	linearAllocator.FreeAll();
 }
 
+TEST(Core_Allocators, Linear_Allocator_AlignmentAndMarkers)
+{
+	constexpr u64 BLOCK_SIZE = 64;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE, 16);
+	LinearAllocator linearAllocator{ pMemoryBlock, BLOCK_SIZE };
+
+	u8*  pU8 = linearAllocator.Alloc<u8>();
+	f64* pF64 = linearAllocator.Alloc<f64>();
+	EXPECT_TRUE(CKE::IsAligned(pF64));
+	EXPECT_EQ(reinterpret_cast<u8*>(pF64) - pU8, 8);
+
+	LinearAllocator::Marker marker = linearAllocator.GetMarker();
+	void* pAligned = linearAllocator.Alloc(4, 16);
+	EXPECT_TRUE(CKE::IsAligned(pAligned, 16));
+	EXPECT_EQ(linearAllocator.TryAlloc(BLOCK_SIZE), nullptr);
+
+	// Memory allocated after the marker is reused
+	linearAllocator.FreeToMarker(marker);
+	EXPECT_EQ(linearAllocator.Alloc(4, 16), pAligned);
+
+	{
+		ScratchScope scratch{ &linearAllocator };
+		void* pScratch = linearAllocator.Alloc(32);
+		EXPECT_TRUE(linearAllocator.Owns(pScratch));
+	}
+	EXPECT_EQ(linearAllocator.GetUsedSize(), 20);
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Stack_Allocator_FreeLast)
+{
+	constexpr u64 BLOCK_SIZE = 256;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	StackAllocator stackAllocator{ pMemoryBlock, BLOCK_SIZE };
+
+	u32* pA = stackAllocator.Alloc<u32>();
+	u64  usedAfterA = stackAllocator.GetUsedSize();
+	u64* pB = stackAllocator.Alloc<u64>();
+	void* pC = stackAllocator.Alloc(24, 32);
+	*pA = 1;
+	*pB = 2;
+	memset(pC, 0xFF, 24);
+	EXPECT_TRUE(CKE::IsAligned(pB));
+	EXPECT_TRUE(CKE::IsAligned(pC, 32));
+
+	// The blocks are freed in reverse order and their memory is reused
+	stackAllocator.FreeLast();
+	EXPECT_EQ(stackAllocator.Alloc(24, 32), pC);
+	stackAllocator.FreeLast();
+	stackAllocator.FreeLast();
+	EXPECT_EQ(stackAllocator.GetUsedSize(), usedAfterA);
+	EXPECT_EQ(*pA, 1);
+	EXPECT_EQ(stackAllocator.Alloc<u64>(), pB);
+
+	// Markers free all the blocks at once, and FreeLast keeps working after them
+	StackAllocator::Marker marker = stackAllocator.GetMarker();
+	{
+		ScratchScope scratch{ &stackAllocator };
+		void* pD = stackAllocator.Alloc(64);
+		void* pE = stackAllocator.Alloc(64);
+	}
+	EXPECT_EQ(stackAllocator.GetUsedSize(), marker.m_Top);
+	stackAllocator.FreeLast();
+	stackAllocator.FreeLast();
+	EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+
+#ifdef CKE_BUILDSYSTEM_ASSERTS_ENABLE
+	EXPECT_DEATH({ stackAllocator.FreeLast(); }, "Assertion failed");
+	EXPECT_DEATH({ void* pBig = stackAllocator.Alloc(BLOCK_SIZE); }, "Assertion failed");
+#endif
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Arena_Vector)
+{
+	constexpr u64 BLOCK_SIZE = 1024;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	LinearAllocator arena{ pMemoryBlock, BLOCK_SIZE };
+
+	ArenaVector<u32> values{ ArenaStdAllocator<u32>{ &arena } };
+	values.reserve(16);
+	for (u32 i = 0; i < 16; ++i) { values.push_back(i); }
+	EXPECT_TRUE(arena.Owns(values.data()));
+	EXPECT_EQ(arena.GetUsedSize(), 16 * sizeof(u32));
+
+	// Too big for the arena, the vector moves to the heap
+	values.resize(BLOCK_SIZE);
+	EXPECT_FALSE(arena.Owns(values.data()));
+	EXPECT_EQ(values[15], 15);
+
+	// Without arena it's a regular heap vector
+	ArenaVector<u32> heapValues{};
+	heapValues.push_back(1);
+	EXPECT_EQ(heapValues.get_allocator().GetArena(), nullptr);
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Frame_Allocator)
+{
+	constexpr u32 NUM_THREADS = 2;
+	constexpr u64 ARENA_SIZE = 1024;
+
+	FrameAllocator frameAllocator{};
+
+	// Nothing to allocate from before initializing or registering the thread
+	EXPECT_EQ(frameAllocator.GetThreadArena(), nullptr);
+	frameAllocator.Initialize(NUM_THREADS, ARENA_SIZE, 2);
+	EXPECT_EQ(frameAllocator.GetThreadArena(), nullptr);
+
+	FrameAllocator::RegisterThread(0);
+	LinearAllocator* pFrame0Arena = frameAllocator.GetThreadArena();
+	ASSERT_NE(pFrame0Arena, nullptr);
+	void* pFrame0Memory = pFrame0Arena->Alloc(100);
+
+	// Each thread has its own arena
+	LinearAllocator* pOtherThreadArena = nullptr;
+	std::thread      otherThread{ [&]()
+	{
+		FrameAllocator::RegisterThread(1);
+		pOtherThreadArena = frameAllocator.GetThreadArena();
+		void* pMemory = pOtherThreadArena->Alloc(50);
+		FrameAllocator::UnregisterThread();
+	} };
+	otherThread.join();
+	EXPECT_NE(pOtherThreadArena, pFrame0Arena);
+	EXPECT_EQ(frameAllocator.GetFrameUsedSize(), 150);
+
+	// The memory of the previous frame is still valid in the next one
+	frameAllocator.EndFrame();
+	LinearAllocator* pFrame1Arena = frameAllocator.GetThreadArena();
+	EXPECT_NE(pFrame1Arena, pFrame0Arena);
+	EXPECT_EQ(pFrame0Arena->GetUsedSize(), 100);
+	EXPECT_EQ(frameAllocator.GetFrameUsedSize(), 0);
+
+	// And it is reset when the arena is reused
+	frameAllocator.EndFrame();
+	EXPECT_EQ(frameAllocator.GetThreadArena(), pFrame0Arena);
+	EXPECT_EQ(pFrame0Arena->GetUsedSize(), 0);
+	EXPECT_EQ(pFrame0Arena->Alloc(100), pFrame0Memory);
+
+	FrameAllocator::UnregisterThread();
+	frameAllocator.Shutdown();
+}
+
+TEST(Core_Allocators, Frame_Vector)
+{
+	g_FrameAllocator.Initialize(1, 4096);
+	FrameAllocator::RegisterThread(0);
+
+	FrameVector<u64> values;
+	for (u64 i = 0; i < 100; ++i) { values.push_back(i); }
+	LinearAllocator* pArena = g_FrameAllocator.GetThreadArena();
+	EXPECT_TRUE(pArena->Owns(values.data()));
+
+	// Copies made in threads without a frame arena use the heap
+	FrameVector<u64> copy;
+	std::thread      otherThread{ [&]() { copy = FrameVector<u64>{ values }; } };
+	otherThread.join();
+	EXPECT_FALSE(pArena->Owns(copy.data()));
+	EXPECT_EQ(copy, values);
+
+	copy = {};
+	values = {};
+	FrameAllocator::UnregisterThread();
+	g_FrameAllocator.Shutdown();
+}
+
 TEST(Core_Allocators, Pool_Allocator_Alloc)
 {
 	constexpr u64 BLOCK_SIZE = 32;
@@ -115,3 +290,208 @@ TEST(Core_Allocators, Pool_Allocator_Alloc)
 
 	Free(pMemoryBlock);
 }
+
+TEST(Core_Allocators, Pool_Allocator_ReusesFreedChunks)
+{
+	constexpr u64 CHUNK_SIZE = 16;
+	constexpr u64 BLOCK_SIZE = CHUNK_SIZE * 4;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	PoolAllocator poolAllocator{ static_cast<char*>(pMemoryBlock), CHUNK_SIZE, BLOCK_SIZE };
+	EXPECT_EQ(poolAllocator.GetNumChunks(), 4);
+
+	// Chunks are handed out in address order
+	void* pChunks[4];
+	for (u64 i = 0; i < 4; ++i)
+	{
+		pChunks[i] = poolAllocator.AllocChunk();
+		EXPECT_EQ(pChunks[i], static_cast<char*>(pMemoryBlock) + i * CHUNK_SIZE);
+		EXPECT_TRUE(poolAllocator.OwnsChunk(pChunks[i]));
+	}
+	EXPECT_EQ(poolAllocator.GetNumFreeChunks(), 0);
+	EXPECT_FALSE(poolAllocator.OwnsChunk(static_cast<char*>(pMemoryBlock) + 1));
+
+	// The last freed chunk is the next one to be allocated
+	poolAllocator.FreeChunk(pChunks[2]);
+	poolAllocator.FreeChunk(pChunks[0]);
+	EXPECT_EQ(poolAllocator.GetNumFreeChunks(), 2);
+	EXPECT_EQ(poolAllocator.AllocChunk(), pChunks[0]);
+	EXPECT_EQ(poolAllocator.AllocChunk(), pChunks[2]);
+
+	poolAllocator.FreeAll();
+	EXPECT_EQ(poolAllocator.GetNumFreeChunks(), 4);
+	EXPECT_EQ(poolAllocator.AllocChunk(), pChunks[0]);
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Pool_Allocator_ExhaustedAsserts)
+{
+	constexpr u64 BLOCK_SIZE = 8;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	PoolAllocator poolAllocator{ static_cast<char*>(pMemoryBlock), 8, BLOCK_SIZE };
+	void* pChunk = poolAllocator.AllocChunk();
+
+#ifdef CKE_BUILDSYSTEM_ASSERTS_ENABLE
+	EXPECT_DEATH({ void* pNoChunk = poolAllocator.AllocChunk(); }, "Assertion failed");
+#endif
+
+	poolAllocator.FreeChunk(pChunk);
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Pool_Allocator_DebugChecks)
+{
+	constexpr u64 CHUNK_SIZE = 32;
+	constexpr u64 BLOCK_SIZE = CHUNK_SIZE * 4;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	PoolAllocator poolAllocator{ static_cast<char*>(pMemoryBlock), CHUNK_SIZE, BLOCK_SIZE, true };
+
+	u8* pA = static_cast<u8*>(poolAllocator.AllocChunk());
+	u8* pB = static_cast<u8*>(poolAllocator.AllocChunk());
+	memset(pA, 1, CHUNK_SIZE);
+	poolAllocator.FreeChunk(pA);
+
+	// Freed chunks are poisoned after the free list link
+	for (u64 i = sizeof(void*); i < CHUNK_SIZE; ++i)
+	{
+		EXPECT_EQ(pA[i], PoolAllocator::POISON_BYTE);
+	}
+
+#ifdef CKE_BUILDSYSTEM_ASSERTS_ENABLE
+	EXPECT_DEATH({ poolAllocator.FreeChunk(pA); }, "Assertion failed");
+	EXPECT_DEATH({ poolAllocator.FreeChunk(pB + 1); }, "Assertion failed");
+
+	// Writing to a freed chunk is caught when it's allocated again
+	pA[CHUNK_SIZE - 1] = 0;
+	EXPECT_DEATH({ void* pChunk = poolAllocator.AllocChunk(); }, "Assertion failed");
+	pA[CHUNK_SIZE - 1] = PoolAllocator::POISON_BYTE;
+#endif
+
+	EXPECT_EQ(poolAllocator.AllocChunk(), pA);
+	poolAllocator.FreeChunk(pA);
+	poolAllocator.FreeChunk(pB);
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Typed_Pool_Allocator_New_Delete)
+{
+	// Smaller than the free list link, the chunks are padded to hold it
+	struct SmallElem
+	{
+		SmallElem(u16 value, i32* pDestroyedCount) : m_Value{ value }, m_pDestroyedCount{ pDestroyedCount } {}
+		~SmallElem() { (*m_pDestroyedCount)++; }
+
+		u16  m_Value;
+		i32* m_pDestroyedCount;
+	};
+
+	struct alignas(32) AlignedElem
+	{
+		f32 m_Values[3];
+	};
+
+	static_assert(TPoolAllocator<u8>::CHUNK_SIZE == sizeof(void*));
+	static_assert(TPoolAllocator<AlignedElem>::CHUNK_SIZE == 32);
+
+	using Pool = TPoolAllocator<SmallElem>;
+	constexpr u64 MAX_ELEMENTS = 3;
+	void* pMemoryBlock = CKE::Alloc(Pool::GetRequiredSize(MAX_ELEMENTS), alignof(SmallElem));
+	Pool  pool{ static_cast<char*>(pMemoryBlock), MAX_ELEMENTS };
+
+	i32        destroyedCount = 0;
+	SmallElem* pA = pool.New(static_cast<u16>(1), &destroyedCount);
+	SmallElem* pB = pool.New(static_cast<u16>(2), &destroyedCount);
+	SmallElem* pC = pool.New(static_cast<u16>(3), &destroyedCount);
+	EXPECT_EQ(pA->m_Value, 1);
+	EXPECT_EQ(pB->m_Value, 2);
+	EXPECT_EQ(pC->m_Value, 3);
+	EXPECT_TRUE(CKE::IsAligned(pB));
+	EXPECT_EQ(pool.GetNumFreeChunks(), 0);
+
+	pool.Delete(pB);
+	EXPECT_EQ(destroyedCount, 1);
+	EXPECT_EQ(pool.AllocChunk(), pB);
+
+	pool.FreeChunk(pB);
+	pool.Delete(pA);
+	pool.Delete(pC);
+	EXPECT_EQ(destroyedCount, 3);
+	EXPECT_EQ(pool.GetNumFreeChunks(), MAX_ELEMENTS);
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Atomic_Pool_Allocator_Alloc)
+{
+	constexpr u64 CHUNK_SIZE = 8;
+	constexpr u64 BLOCK_SIZE = CHUNK_SIZE * 2;
+	void* pMemoryBlock = CKE::Alloc(BLOCK_SIZE);
+	AtomicPoolAllocator poolAllocator{ static_cast<char*>(pMemoryBlock), CHUNK_SIZE, BLOCK_SIZE };
+
+	u64* pA = poolAllocator.AllocChunk<u64>();
+	u64* pB = poolAllocator.AllocChunk<u64>();
+	EXPECT_EQ(static_cast<void*>(pA), pMemoryBlock);
+	EXPECT_EQ(static_cast<void*>(pB), static_cast<char*>(pMemoryBlock) + CHUNK_SIZE);
+
+	// Exhaustion isn't an error in the atomic pool
+	EXPECT_EQ(poolAllocator.AllocChunk(), nullptr);
+
+	poolAllocator.FreeChunk(pA);
+	EXPECT_EQ(poolAllocator.AllocChunk(), pA);
+	poolAllocator.FreeChunk(pA);
+	poolAllocator.FreeChunk(pB);
+
+	Free(pMemoryBlock);
+}
+
+TEST(Core_Allocators, Atomic_Pool_Allocator_CrossThreadFrees)
+{
+	constexpr u64 NUM_THREADS = 4;
+	constexpr u64 NUM_CHUNKS = 64;
+	constexpr u64 ITERATIONS = 20'000;
+	void* pMemoryBlock = CKE::Alloc(NUM_CHUNKS * sizeof(u64));
+	AtomicPoolAllocator poolAllocator{ static_cast<char*>(pMemoryBlock), sizeof(u64), NUM_CHUNKS * sizeof(u64) };
+
+	// Each thread frees the chunks that the previous one allocated, and checks
+	// that nobody else wrote to the chunks it owns, which would mean that a chunk was handed out twice
+	Array<std::atomic<u64*>, NUM_THREADS> handoff{};
+	std::atomic<u64>                      errors{ 0 };
+
+	Vector<std::thread> threads;
+	for (u64 t = 0; t < NUM_THREADS; ++t)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for (u64 i = 0; i < ITERATIONS; ++i)
+			{
+				u64* pChunk = poolAllocator.AllocChunk<u64>();
+				if (pChunk == nullptr) { continue; }
+
+				u64 const value = t << 32 | i;
+				std::atomic_ref<u64>{ *pChunk }.store(value, std::memory_order_relaxed);
+				std::this_thread::yield();
+				if (std::atomic_ref<u64>{ *pChunk }.load(std::memory_order_relaxed) != value) { errors++; }
+
+				u64* pOtherChunk = handoff[(t + 1) % NUM_THREADS].exchange(nullptr);
+				if (pOtherChunk != nullptr) { poolAllocator.FreeChunk(pOtherChunk); }
+
+				u64* pPrevChunk = handoff[t].exchange(pChunk);
+				if (pPrevChunk != nullptr) { poolAllocator.FreeChunk(pPrevChunk); }
+			}
+		});
+	}
+	for (std::thread& thread : threads) { thread.join(); }
+
+	EXPECT_EQ(errors.load(), 0);
+
+	// Every chunk is back in the pool
+	for (std::atomic<u64*>& pChunk : handoff)
+	{
+		if (pChunk.load() != nullptr) { poolAllocator.FreeChunk(pChunk.load()); }
+	}
+	Vector<void*> chunks;
+	while (void* pChunk = poolAllocator.AllocChunk()) { chunks.push_back(pChunk); }
+	EXPECT_EQ(chunks.size(), NUM_CHUNKS);
+
+	Free(pMemoryBlock);
+}
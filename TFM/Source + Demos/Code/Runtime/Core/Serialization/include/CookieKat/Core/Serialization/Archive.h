@@ -19,6 +19,12 @@
 //-----------------------------------------------------------------------------
 
 namespace CKE {
+	template <typename T>
+	constexpr bool IsSpan = false;
+
+	template <typename T>
+	constexpr bool IsSpan<Span<T>> = true;
+
 	template <typename Serializer>
 	concept IsSerializer = std::is_base_of_v<CKE::IWriter, Serializer> || std::is_base_of_v<CKE::IReader, Serializer>;
 
@@ -55,12 +61,28 @@ namespace CKE {
 		template <typename T, typename K>
 		Archive& operator<<(Pair<T, K>& pair);
 
+		// Views of contiguous bulk serializable elements, written like a vector but padded so the
+		// elements are aligned in the archive
+		// When reading, the span points into the source data instead of copying it, so it is only valid
+		// while that data is alive. Spans of bytes have no padding, a Blob can be read as a view
+		template <typename T>
+		Archive& operator<<(Span<T const>& span);
+
 		//-----------------------------------------------------------------------------
 
 		// Forwards all of the "values" to the "<<" operator sequentially
 		template <typename... Values>
 		Archive& Serialize(Values&&... values);
 
+	protected:
+		// Types whose in memory representation is written as it is, containers of them are copied in bulk
+		// Types with a Serialize function are written member by member so their layout doesn't depend on padding
+		// Declared inside the archive because Serialize is usually private and only accessible to the archive
+		template <typename T>
+		static constexpr bool IsBulkSerializable = std::is_trivially_copyable_v<T> &&
+				!std::is_pointer_v<T> && !IsSpan<T> &&
+				!requires(T& value, Archive& archive) { value.Serialize(archive); };
+
 	protected:
 		Serializer m_Serializer;
 	};
@@ -72,6 +94,14 @@ namespace CKE {
 	{
 	public:
 		void WriteToFile(char const* path);
+
+		// Preallocates the buffer when the final size is roughly known
+		inline void Reserve(u64 sizeInBytes) { m_Serializer.Reserve(sizeInBytes); }
+
+		// Data written so far
+		inline Span<u8 const> GetData() const {
+			return Span<u8 const>{reinterpret_cast<u8 const*>(m_Serializer.GetData()), m_Serializer.GetSizeInBytes()};
+		}
 	};
 
 	class BinaryInputArchive : public Archive<BinaryReader>
@@ -80,7 +110,11 @@ namespace CKE {
 		~BinaryInputArchive();
 
 		void ReadFromFile(char const* path);
+
+		// Reads directly from the data without copying it, it must outlive the archive
+		// and any span that is read from it
 		void ReadFromBlob(Blob const& blob);
+		void ReadFromData(Span<u8 const> data);
 
 	private:
 		char* m_pData = nullptr;
@@ -114,7 +148,11 @@ namespace CKE {
 	template <typename T>
 	Archive<Serializer>& Archive<Serializer>::operator<<(T& value) {
 		// If T is not a primitive type, call the serialization function of T
-		if constexpr (IsNotSerializablePrimitive<T>) { value.Serialize(*this); }
+		if constexpr (IsNotSerializablePrimitive<T> && IsBulkSerializable<T>) {
+			if constexpr (std::is_base_of_v<IWriter, Serializer>) { m_Serializer.WriteBlob(&value, sizeof(T)); }
+			else { m_Serializer.ReadBlob(&value, sizeof(T)); }
+		}
+		else if constexpr (IsNotSerializablePrimitive<T>) { value.Serialize(*this); }
 		else if constexpr (std::is_enum_v<T>) {
 			if constexpr (std::is_base_of_v<IWriter, Serializer>) {
 				auto enumValue = static_cast<std::underlying_type_t<T>>(value);
@@ -149,7 +187,7 @@ namespace CKE {
 			vector.resize(numElements);
 		}
 
-		if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
+		if constexpr (IsBulkSerializable<T>) {
 			if constexpr (std::is_base_of_v<IWriter, Serializer>) {
 				m_Serializer.WriteBlob(vector.data(), numElements * sizeof(T));
 			}
@@ -176,8 +214,14 @@ namespace CKE {
 			if (numElements != Size) { CKE_UNREACHABLE_CODE(); } // Reading an array of different size
 		}
 
-		// Forward the rest of the elements to be written to/read from
-		for (u64 i = 0; i < Size; ++i) { *this << array[i]; }
+		if constexpr (IsBulkSerializable<T>) {
+			if constexpr (std::is_base_of_v<IWriter, Serializer>) { m_Serializer.WriteBlob(array.data(), Size * sizeof(T)); }
+			else { m_Serializer.ReadBlob(array.data(), Size * sizeof(T)); }
+		}
+		else {
+			// Forward the rest of the elements to be written to/read from
+			for (u64 i = 0; i < Size; ++i) { *this << array[i]; }
+		}
 
 		return *this;
 	}
@@ -236,6 +280,29 @@ namespace CKE {
 		return *this;
 	}
 
+	template <typename Serializer> requires IsSerializer<Serializer>
+	template <typename T>
+	Archive<Serializer>& Archive<Serializer>::operator<<(Span<T const>& span) {
+		static_assert(IsBulkSerializable<T>, "Only spans of trivially copyable types without a Serialize function can be serialized");
+
+		u64 numElements = 0;
+		if constexpr (std::is_base_of_v<IWriter, Serializer>) {
+			numElements = span.size();
+			m_Serializer.Write(numElements);
+			m_Serializer.WritePadding(alignof(T));
+			m_Serializer.WriteBlob(span.data(), numElements * sizeof(T));
+		}
+		else {
+			m_Serializer.Read(numElements);
+			m_Serializer.SkipPadding(alignof(T));
+			auto pElements = static_cast<T const*>(m_Serializer.ReadView(numElements * sizeof(T)));
+			CKE_ASSERT(reinterpret_cast<uintptr_t>(pElements) % alignof(T) == 0); // The source data is not aligned enough
+			span = Span<T const>{pElements, numElements};
+		}
+
+		return *this;
+	}
+
 	template <typename Serializer> requires IsSerializer<Serializer>
 	template <typename... Values>
 	Archive<Serializer>& Archive<Serializer>::Serialize(Values&&... values) {
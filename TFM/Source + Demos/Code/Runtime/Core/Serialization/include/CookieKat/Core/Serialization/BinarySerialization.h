@@ -5,6 +5,7 @@
 #include "CookieKat/Core/Platform/Asserts.h"
 #include "CookieKat/Core/FileSystem/FileSystem.h"
 
+#include <algorithm>
 #include <iostream>
 
 //-----------------------------------------------------------------------------
@@ -20,7 +21,13 @@ namespace CKE
 		inline char const* GetData() const { return m_pData.data(); }
 		inline u64         GetSizeInBytes() const { return m_SizeInBytes; }
 
-		inline Vector<char> const& GetDataVec() { return m_pData; }
+		inline Vector<char> const& GetDataVec() {
+			m_pData.resize(m_SizeInBytes);
+			return m_pData;
+		}
+
+		// Preallocates the buffer so writing up to sizeInBytes bytes doesn't reallocate it
+		void Reserve(u64 sizeInBytes);
 
 		void Write(i8 value) override;
 		void Write(i16 value) override;
@@ -37,14 +44,20 @@ namespace CKE
 
 		void Write(String const& value) override;
 
-		void WriteBlob(void* pData, u64 sizeInBytes);
+		void WriteBlob(void const* pData, u64 sizeInBytes);
+
+		// Writes zeros until the size is a multiple of the alignment
+		void WritePadding(u64 alignment);
 
 	private:
 		template <typename T>
 		inline void WritePrimitiveType(T& value);
 
+		// Makes room for sizeInBytes more bytes, the buffer grows geometrically
+		inline void EnsureCapacity(u64 sizeInBytes);
+
 	private:
-		Vector<char> m_pData;
+		Vector<char> m_pData; // Sized to the capacity of the buffer, only m_SizeInBytes are written
 		u64          m_SizeInBytes = 0;
 	};
 
@@ -74,6 +87,12 @@ namespace CKE
 
 		void ReadBlob(void* pData, u64 sizeInBytes);
 
+		// Returns a pointer to the next sizeInBytes bytes of the source data and skips them
+		void const* ReadView(u64 sizeInBytes);
+
+		// Skips the padding written by BinaryWriter::WritePadding
+		void SkipPadding(u64 alignment);
+
 	private:
 		template <typename T>
 		inline void ReadPrimitiveType(T& value);
@@ -94,15 +113,22 @@ namespace CKE
 	template <typename T>
 	void BinaryWriter::WritePrimitiveType(T& value)
 	{
-		m_pData.resize(m_pData.size() + sizeof(T));
+		EnsureCapacity(sizeof(T));
 		memcpy(m_pData.data() + m_SizeInBytes, &value, sizeof(T));
 		m_SizeInBytes += sizeof(T);
 	}
 
+	void BinaryWriter::EnsureCapacity(u64 sizeInBytes)
+	{
+		u64 const requiredSize = m_SizeInBytes + sizeInBytes;
+		if (requiredSize > m_pData.size()) { m_pData.resize(std::max(requiredSize, m_pData.size() * 2)); }
+	}
+
 	template <typename T>
 	void BinaryReader::ReadPrimitiveType(T& value)
 	{
 		CKE_ASSERT(m_pData != nullptr);
+		CKE_ASSERT(m_CurrByteOffset + sizeof(T) <= m_SizeInBytes);
 		memcpy(&value, m_pData + m_CurrByteOffset, sizeof(T));
 		m_CurrByteOffset += sizeof(T);
 	}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Serialization/Archive.h"
+
+namespace CKE {
+	// Builds a section ID from four characters, e.g. MakeSectionID("HEAD")
+	constexpr u32 MakeSectionID(char const (&name)[5]) {
+		return static_cast<u32>(name[0]) | static_cast<u32>(name[1]) << 8 |
+				static_cast<u32>(name[2]) << 16 | static_cast<u32>(name[3]) << 24;
+	}
+
+	// Layout of a sectioned archive:
+	//   SectionedArchiveHeader
+	//   SectionedArchiveSection[m_NumSections]   Table of contents
+	//   Data of each section                     Aligned to SECTION_ALIGNMENT
+	//
+	// Each section is a binary archive on its own, so it can be read or skipped without parsing the rest
+	struct SectionedArchiveHeader
+	{
+		static constexpr u32 MAGIC = 0x41534B43; // "CKSA"
+		static constexpr u32 FORMAT_VERSION = 1;
+
+		// Sections start aligned, so spans of aligned types can be read from them in place
+		static constexpr u64 SECTION_ALIGNMENT = 16;
+
+		u32 m_Magic = MAGIC;
+		u32 m_FormatVersion = FORMAT_VERSION;
+		u32 m_NumSections = 0;
+		u32 m_Padding = 0;
+	};
+
+	struct SectionedArchiveSection
+	{
+		u32 m_ID = 0;
+		u32 m_Version = 0;     // Version of the data of the section, set by the writer
+		u64 m_Offset = 0;      // From the start of the archive
+		u64 m_SizeInBytes = 0;
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Writes an archive made of independent sections
+	//
+	// Example:
+	//   BinaryOutputArchive header{};
+	//   header << resourceHeader;
+	//   SectionedArchiveWriter writer;
+	//   writer.AddSection(MakeSectionID("HEAD"), 1, header);
+	//   writer.WriteToFile("Wood.tex");
+	class SectionedArchiveWriter
+	{
+	public:
+		// Adds a section with a copy of the data, IDs must be unique within the archive
+		void AddSection(u32 sectionID, u32 version, Span<u8 const> data);
+		inline void AddSection(u32 sectionID, u32 version, BinaryOutputArchive const& archive);
+
+		// Returns the whole archive
+		Blob Build() const;
+
+		// Writes the archive, returns false if the file couldn't be written
+		bool WriteToFile(char const* path) const;
+
+	private:
+		struct Section
+		{
+			u32  m_ID;
+			u32  m_Version;
+			Blob m_Data;
+		};
+
+		Vector<Section> m_Sections;
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Reads the sections of an archive written by a SectionedArchiveWriter
+	// Nothing is copied, the data must outlive the reader and the archives that read from it
+	class SectionedArchiveReader
+	{
+	public:
+		// Returns false if the data isn't a sectioned archive or it was written with another format version
+		bool Open(Span<u8 const> data);
+
+		inline bool IsOpen() const { return m_pHeader != nullptr; }
+		inline u32  GetNumSections() const { return m_pHeader->m_NumSections; }
+
+		// Returns the section with the given ID or nullptr if the archive doesn't have it
+		SectionedArchiveSection const* FindSection(u32 sectionID) const;
+
+		Span<u8 const> GetSectionData(SectionedArchiveSection const& section) const;
+
+		// Starts reading a section with the archive
+		// Returns false if the section is missing or its data has a different version
+		bool ReadSection(u32 sectionID, u32 expectedVersion, BinaryInputArchive& archive) const;
+
+		// Returns true if the data starts like a sectioned archive, whatever its version
+		static bool IsSectionedArchive(Span<u8 const> data);
+
+	private:
+		Span<u8 const>                 m_Data;
+		SectionedArchiveHeader const*  m_pHeader = nullptr;
+		SectionedArchiveSection const* m_pSections = nullptr;
+	};
+}
+
+// Inline implementations
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	void SectionedArchiveWriter::AddSection(u32 sectionID, u32 version, BinaryOutputArchive const& archive) {
+		AddSection(sectionID, version, archive.GetData());
+	}
+}
@@ -41,6 +41,11 @@ namespace CKE
 
 	void BinaryInputArchive::ReadFromBlob(Blob const& blob)
 	{
-		m_Serializer.BeginReading(reinterpret_cast<char const*>(blob.data()), blob.size() * sizeof(char));
+		ReadFromData(blob);
+	}
+
+	void BinaryInputArchive::ReadFromData(Span<u8 const> data)
+	{
+		m_Serializer.BeginReading(reinterpret_cast<char const*>(data.data()), data.size());
 	}
 }
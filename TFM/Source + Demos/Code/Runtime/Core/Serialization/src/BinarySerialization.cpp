@@ -22,18 +22,31 @@ namespace CKE
 	{
 		u64 strSize = value.size();
 		Write(strSize);
-		m_pData.resize(m_pData.size() + strSize * sizeof(char));
-		memcpy(m_pData.data() + m_SizeInBytes, value.c_str(), strSize * sizeof(char));
-		m_SizeInBytes += strSize * sizeof(char);
+		WriteBlob(value.data(), strSize * sizeof(char));
 	}
 
-	void BinaryWriter::WriteBlob(void* pData, u64 sizeInBytes)
+	void BinaryWriter::WriteBlob(void const* pData, u64 sizeInBytes)
 	{
-		m_pData.resize(m_pData.size() + sizeInBytes);
+		if (sizeInBytes == 0) { return; }
+
+		EnsureCapacity(sizeInBytes);
 		memcpy(m_pData.data() + m_SizeInBytes, pData, sizeInBytes);
 		m_SizeInBytes += sizeInBytes;
 	}
 
+	void BinaryWriter::WritePadding(u64 alignment)
+	{
+		u64 const paddingSize = (alignment - m_SizeInBytes % alignment) % alignment;
+		EnsureCapacity(paddingSize);
+		memset(m_pData.data() + m_SizeInBytes, 0, paddingSize);
+		m_SizeInBytes += paddingSize;
+	}
+
+	void BinaryWriter::Reserve(u64 sizeInBytes)
+	{
+		if (sizeInBytes > m_pData.size()) { m_pData.resize(sizeInBytes); }
+	}
+
 	// Binary Reader
 	//-----------------------------------------------------------------------------
 
@@ -67,22 +80,32 @@ namespace CKE
 		u64 strSize = 0;
 		Read(strSize);
 
-		// Generate temp string buffer
-		char* tempBuffer = new char[strSize + 1];
-
-		memcpy(tempBuffer, m_pData + m_CurrByteOffset, strSize * sizeof(char));
+		// Copy the characters straight into the string
+		CKE_ASSERT(m_CurrByteOffset + strSize * sizeof(char) <= m_SizeInBytes);
+		value.assign(m_pData + m_CurrByteOffset, strSize);
 		m_CurrByteOffset += strSize * sizeof(char);
-
-		tempBuffer[strSize] = '\0';
-		value = tempBuffer;
-		delete[] tempBuffer;
 	}
 
 	void BinaryReader::ReadBlob(void* pData, u64 sizeInBytes)
+	{
+		if (sizeInBytes == 0) { return; }
+		memcpy(pData, ReadView(sizeInBytes), sizeInBytes);
+	}
+
+	void const* BinaryReader::ReadView(u64 sizeInBytes)
 	{
 		CKE_ASSERT(m_pData != nullptr);
+		CKE_ASSERT(m_CurrByteOffset + sizeInBytes <= m_SizeInBytes);
 
-		memcpy(pData, m_pData + m_CurrByteOffset, sizeInBytes);
+		void const* pView = m_pData + m_CurrByteOffset;
 		m_CurrByteOffset += sizeInBytes;
+		return pView;
+	}
+
+	void BinaryReader::SkipPadding(u64 alignment)
+	{
+		u64 const paddingSize = (alignment - m_CurrByteOffset % alignment) % alignment;
+		CKE_ASSERT(m_CurrByteOffset + paddingSize <= m_SizeInBytes);
+		m_CurrByteOffset += paddingSize;
 	}
 }
@@ -0,0 +1,141 @@
+#include "CookieKat/Core/Serialization/SectionedArchive.h"
+
+#include "CookieKat/Core/Platform/Asserts.h"
+
+#include <fstream>
+
+namespace CKE
+{
+	namespace
+	{
+		u64 AlignUp(u64 value, u64 alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+	}
+
+	// Sectioned Archive Writer
+	//-----------------------------------------------------------------------------
+
+	void SectionedArchiveWriter::AddSection(u32 sectionID, u32 version, Span<u8 const> data)
+	{
+		for (Section const& section : m_Sections)
+		{
+			CKE_ASSERT(section.m_ID != sectionID); // Section IDs must be unique
+		}
+		m_Sections.emplace_back(Section{sectionID, version, Blob(data.begin(), data.end())});
+	}
+
+	Blob SectionedArchiveWriter::Build() const
+	{
+		SectionedArchiveHeader header{};
+		header.m_NumSections = static_cast<u32>(m_Sections.size());
+
+		// Table of contents
+		Vector<SectionedArchiveSection> tableOfContents(m_Sections.size());
+		u64 offset = sizeof(SectionedArchiveHeader) + sizeof(SectionedArchiveSection) * m_Sections.size();
+		for (u64 i = 0; i < m_Sections.size(); ++i)
+		{
+			offset = AlignUp(offset, SectionedArchiveHeader::SECTION_ALIGNMENT);
+			tableOfContents[i].m_ID = m_Sections[i].m_ID;
+			tableOfContents[i].m_Version = m_Sections[i].m_Version;
+			tableOfContents[i].m_Offset = offset;
+			tableOfContents[i].m_SizeInBytes = m_Sections[i].m_Data.size();
+			offset += m_Sections[i].m_Data.size();
+		}
+
+		// The padding between the sections stays zeroed
+		Blob archive(offset, 0);
+		memcpy(archive.data(), &header, sizeof(SectionedArchiveHeader));
+		memcpy(archive.data() + sizeof(SectionedArchiveHeader), tableOfContents.data(),
+		       sizeof(SectionedArchiveSection) * tableOfContents.size());
+		for (u64 i = 0; i < m_Sections.size(); ++i)
+		{
+			if (m_Sections[i].m_Data.empty()) { continue; }
+			memcpy(archive.data() + tableOfContents[i].m_Offset, m_Sections[i].m_Data.data(), m_Sections[i].m_Data.size());
+		}
+		return archive;
+	}
+
+	bool SectionedArchiveWriter::WriteToFile(char const* path) const
+	{
+		Blob const    archive = Build();
+		std::ofstream ofs(path, std::ios::binary);
+		if (!ofs.is_open())
+		{
+			printf("ERROR: Failed to write a sectioned archive [%s]\n", path);
+			return false;
+		}
+
+		ofs.write(reinterpret_cast<char const*>(archive.data()), static_cast<std::streamsize>(archive.size()));
+		return ofs.good();
+	}
+
+	// Sectioned Archive Reader
+	//-----------------------------------------------------------------------------
+
+	bool SectionedArchiveReader::Open(Span<u8 const> data)
+	{
+		m_Data = {};
+		m_pHeader = nullptr;
+		m_pSections = nullptr;
+
+		if (!IsSectionedArchive(data)) { return false; }
+
+		auto pHeader = reinterpret_cast<SectionedArchiveHeader const*>(data.data());
+		if (pHeader->m_FormatVersion != SectionedArchiveHeader::FORMAT_VERSION) { return false; }
+
+		u64 const tableOfContentsEnd = sizeof(SectionedArchiveHeader) +
+				sizeof(SectionedArchiveSection) * static_cast<u64>(pHeader->m_NumSections);
+		if (tableOfContentsEnd > data.size()) { return false; }
+
+		auto pSections = reinterpret_cast<SectionedArchiveSection const*>(data.data() + sizeof(SectionedArchiveHeader));
+		for (u32 i = 0; i < pHeader->m_NumSections; ++i)
+		{
+			// Truncated archive
+			if (pSections[i].m_Offset > data.size() ||
+				pSections[i].m_SizeInBytes > data.size() - pSections[i].m_Offset) { return false; }
+		}
+
+		m_Data = data;
+		m_pHeader = pHeader;
+		m_pSections = pSections;
+		return true;
+	}
+
+	SectionedArchiveSection const* SectionedArchiveReader::FindSection(u32 sectionID) const
+	{
+		CKE_ASSERT(IsOpen());
+
+		// Archives have a handful of sections, a linear search is enough
+		for (u32 i = 0; i < m_pHeader->m_NumSections; ++i)
+		{
+			if (m_pSections[i].m_ID == sectionID) { return &m_pSections[i]; }
+		}
+		return nullptr;
+	}
+
+	Span<u8 const> SectionedArchiveReader::GetSectionData(SectionedArchiveSection const& section) const
+	{
+		CKE_ASSERT(IsOpen());
+		return m_Data.subspan(section.m_Offset, section.m_SizeInBytes);
+	}
+
+	bool SectionedArchiveReader::ReadSection(u32 sectionID, u32 expectedVersion, BinaryInputArchive& archive) const
+	{
+		SectionedArchiveSection const* pSection = FindSection(sectionID);
+		if (pSection == nullptr || pSection->m_Version != expectedVersion) { return false; }
+
+		archive.ReadFromData(GetSectionData(*pSection));
+		return true;
+	}
+
+	bool SectionedArchiveReader::IsSectionedArchive(Span<u8 const> data)
+	{
+		if (data.size() < sizeof(SectionedArchiveHeader)) { return false; }
+
+		u32 magic = 0;
+		memcpy(&magic, data.data(), sizeof(u32));
+		return magic == SectionedArchiveHeader::MAGIC;
+	}
+}
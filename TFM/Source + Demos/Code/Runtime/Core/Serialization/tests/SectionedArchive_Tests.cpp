@@ -0,0 +1,87 @@
+#include "CookieKat/Core/Serialization/SectionedArchive.h"
+#include "CookieKat/Core/Containers/Containers.h"
+
+#include <gtest/gtest.h>
+
+using namespace CKE;
+
+namespace {
+	constexpr u32 HEADER_SECTION = MakeSectionID("HEAD");
+	constexpr u32 DATA_SECTION = MakeSectionID("DATA");
+
+	Blob BuildArchive(String const& name, Vector<u32> const& values, u32 dataVersion = 1) {
+		BinaryOutputArchive header{};
+		String              headerName = name;
+		header << headerName;
+
+		BinaryOutputArchive data{};
+		Vector<u32>         dataValues = values;
+		data << dataValues;
+
+		SectionedArchiveWriter writer;
+		writer.AddSection(HEADER_SECTION, 1, header);
+		writer.AddSection(DATA_SECTION, dataVersion, data);
+		return writer.Build();
+	}
+}
+
+TEST(SectionedArchive, ReadSections) {
+	Blob archive = BuildArchive("Texture", {1, 2, 3});
+
+	SectionedArchiveReader reader;
+	ASSERT_TRUE(reader.Open(archive));
+	EXPECT_EQ(reader.GetNumSections(), 2);
+
+	// Sections can be read in any order
+	Vector<u32>        values;
+	BinaryInputArchive dataArchive{};
+	ASSERT_TRUE(reader.ReadSection(DATA_SECTION, 1, dataArchive));
+	dataArchive << values;
+	EXPECT_EQ(values, (Vector<u32>{1, 2, 3}));
+
+	String             name;
+	BinaryInputArchive headerArchive{};
+	ASSERT_TRUE(reader.ReadSection(HEADER_SECTION, 1, headerArchive));
+	headerArchive << name;
+	EXPECT_EQ(name, "Texture");
+
+	for (u32 sectionID : {HEADER_SECTION, DATA_SECTION}) {
+		SectionedArchiveSection const* pSection = reader.FindSection(sectionID);
+		ASSERT_NE(pSection, nullptr);
+		EXPECT_EQ(pSection->m_Offset % SectionedArchiveHeader::SECTION_ALIGNMENT, 0);
+	}
+}
+
+TEST(SectionedArchive, MissingSectionsAndVersions) {
+	Blob archive = BuildArchive("Mesh", {4, 5}, 2);
+
+	SectionedArchiveReader reader;
+	ASSERT_TRUE(reader.Open(archive));
+
+	BinaryInputArchive ar{};
+	EXPECT_EQ(reader.FindSection(MakeSectionID("NONE")), nullptr);
+	EXPECT_FALSE(reader.ReadSection(MakeSectionID("NONE"), 1, ar));
+
+	// Data written with an older version is detected instead of being misread
+	EXPECT_FALSE(reader.ReadSection(DATA_SECTION, 1, ar));
+	EXPECT_TRUE(reader.ReadSection(DATA_SECTION, 2, ar));
+}
+
+TEST(SectionedArchive, InvalidData) {
+	SectionedArchiveReader reader;
+
+	// Flat archives are not sectioned archives
+	BinaryOutputArchive flat{};
+	u64                 value = 42;
+	flat << value;
+	Blob flatData{flat.GetData().begin(), flat.GetData().end()};
+	EXPECT_FALSE(SectionedArchiveReader::IsSectionedArchive(flatData));
+	EXPECT_FALSE(reader.Open(flatData));
+
+	// Truncated archives are rejected
+	Blob archive = BuildArchive("Truncated", {1, 2, 3, 4, 5, 6, 7, 8});
+	EXPECT_TRUE(SectionedArchiveReader::IsSectionedArchive(archive));
+	archive.resize(archive.size() - 4);
+	EXPECT_FALSE(reader.Open(archive));
+	EXPECT_FALSE(reader.IsOpen());
+}
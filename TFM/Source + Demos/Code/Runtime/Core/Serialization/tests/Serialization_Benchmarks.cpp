@@ -0,0 +1,99 @@
+#include "CookieKat/Core/Serialization/Archive.h"
+#include "CookieKat/Core/Containers/Containers.h"
+
+#include "CookieKat/Tests/Benchmark.h"
+
+#include <gtest/gtest.h>
+
+using namespace CKE;
+using namespace CKE::Tests;
+
+// Benchmarks for reading and writing large arrays of vertices
+// They print their throughput to the console and only check that the results are coherent
+//-----------------------------------------------------------------------------
+
+namespace {
+	// Written as it is, vectors of it are copied in bulk
+	struct BenchVertex
+	{
+		f32 m_Position[3];
+		f32 m_Normal[3];
+		f32 m_UV[2];
+	};
+
+	// Same data, but written member by member
+	struct BenchSerializedVertex
+	{
+		CKE_SERIALIZE(m_Position, m_Normal, m_UV);
+
+		Array<f32, 3> m_Position;
+		Array<f32, 3> m_Normal;
+		Array<f32, 2> m_UV;
+	};
+
+	constexpr u64 NUM_VERTICES = 10'000'000;
+
+	template <typename Vertex>
+	Vector<Vertex> MakeVertices() {
+		Vector<Vertex> vertices(NUM_VERTICES);
+		for (u64 i = 0; i < NUM_VERTICES; ++i) {
+			f32 const f = static_cast<f32>(i);
+			vertices[i] = Vertex{{f, f, f}, {0.0f, 1.0f, 0.0f}, {f, -f}};
+		}
+		return vertices;
+	}
+
+	template <typename Vertex>
+	void RunRoundTripBenchmark(const char* writeBenchName, const char* readBenchName) {
+		Vector<Vertex> vertices = MakeVertices<Vertex>();
+		u64 const      sizeInBytes = vertices.size() * sizeof(Vertex);
+
+		BinaryOutputArchive writeArchive{};
+		u64 const           writeNs = MeasureNs([&]() { writeArchive << vertices; });
+		PrintThroughputResult(writeBenchName, sizeInBytes, writeNs);
+
+		Blob data{writeArchive.GetData().begin(), writeArchive.GetData().end()};
+
+		Vector<Vertex>     readVertices;
+		BinaryInputArchive readArchive{};
+		readArchive.ReadFromBlob(data);
+		u64 const readNs = MeasureNs([&]() { readArchive << readVertices; });
+		PrintThroughputResult(readBenchName, sizeInBytes, readNs);
+
+		ASSERT_EQ(readVertices.size(), vertices.size());
+		EXPECT_EQ(readVertices.back().m_Position[0], vertices.back().m_Position[0]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+TEST(SerializationBenchmark, MemberwiseVertices_10M) {
+	RunRoundTripBenchmark<BenchSerializedVertex>("Write memberwise vertices", "Read memberwise vertices");
+}
+
+TEST(SerializationBenchmark, BulkVertices_10M) {
+	RunRoundTripBenchmark<BenchVertex>("Write bulk vertices", "Read bulk vertices");
+}
+
+TEST(SerializationBenchmark, ViewVertices_10M) {
+	Vector<BenchVertex> vertices = MakeVertices<BenchVertex>();
+	u64 const           sizeInBytes = vertices.size() * sizeof(BenchVertex);
+
+	BinaryOutputArchive writeArchive{};
+	writeArchive.Reserve(sizeInBytes + 64);
+	Span<BenchVertex const> writeSpan{vertices};
+	u64 const               writeNs = MeasureNs([&]() { writeArchive << writeSpan; });
+	PrintThroughputResult("Write reserved vertices", sizeInBytes, writeNs);
+
+	Blob data{writeArchive.GetData().begin(), writeArchive.GetData().end()};
+
+	// Reading a view doesn't touch the vertices at all
+	Span<BenchVertex const> readSpan;
+	BinaryInputArchive      readArchive{};
+	readArchive.ReadFromBlob(data);
+	u64 const readNs = MeasureNs([&]() { readArchive << readSpan; });
+	PrintThroughputResult("Read vertices view", sizeInBytes, readNs);
+
+	ASSERT_EQ(readSpan.size(), vertices.size());
+	EXPECT_EQ(readSpan.back().m_Position[0], vertices.back().m_Position[0]);
+}
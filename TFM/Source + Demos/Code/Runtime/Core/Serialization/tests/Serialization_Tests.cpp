@@ -194,3 +194,117 @@ TEST(BinaryArchive, Enums) {
 	};
 	BinaryArchive_ReadWrite(enumClass, fileName);
 }
+
+// Bulk copies and views
+//-----------------------------------------------------------------------------
+
+namespace {
+	// Trivially copyable and without a Serialize function, it is written as it is
+	struct BulkVertex
+	{
+		f32 m_Position[3];
+		f32 m_UV[2];
+		u32 m_Color;
+
+		friend bool operator==(BulkVertex const& lhs, BulkVertex const& rhs) {
+			return memcmp(&lhs, &rhs, sizeof(BulkVertex)) == 0;
+		}
+	};
+
+	Vector<BulkVertex> MakeVertices(u64 numVertices) {
+		Vector<BulkVertex> vertices(numVertices);
+		for (u64 i = 0; i < numVertices; ++i) {
+			f32 const f = static_cast<f32>(i);
+			vertices[i] = BulkVertex{{f, f + 1.0f, f + 2.0f}, {f * 0.5f, f * 0.25f}, static_cast<u32>(i)};
+		}
+		return vertices;
+	}
+}
+
+TEST(BinaryArchive, BulkVector) {
+	const char*        fileName = "test_bulk_vector.hehe";
+	Vector<BulkVertex> writeVec = MakeVertices(1000);
+	BinaryArchive_ReadWrite(writeVec, fileName);
+
+	// Elements are copied as they are, without any per element overhead
+	BinaryOutputArchive writeArchive{};
+	writeArchive << writeVec;
+	EXPECT_EQ(writeArchive.GetData().size(), sizeof(u64) + sizeof(BulkVertex) * writeVec.size());
+}
+
+TEST(BinaryArchive, BulkArray) {
+	const char*            fileName = "test_bulk_array.hehe";
+	Array<EnumType, 3>   writeEnums{EnumType::ValueC, EnumType::ValueA, EnumType::ValueB};
+	Array<BulkVertex, 2>   writeVertices{BulkVertex{{1, 2, 3}, {4, 5}, 6}, BulkVertex{{7, 8, 9}, {10, 11}, 12}};
+	BinaryArchive_ReadWrite(writeEnums, fileName);
+	BinaryArchive_ReadWrite(writeVertices, fileName);
+}
+
+TEST(BinaryArchive, LongStrings) {
+	const char* fileName = "test_long_string.hehe";
+	String      writeStr(100'000, 'x');
+	writeStr[500] = '\0'; // Strings are not null terminated in the archive
+	BinaryArchive_ReadWrite(writeStr, fileName);
+}
+
+TEST(BinaryArchive, SpanView) {
+	Vector<BulkVertex> vertices = MakeVertices(100);
+	u8                 tag = 7;
+
+	BinaryOutputArchive writeArchive{};
+	writeArchive.Reserve(16);
+	Span<BulkVertex const> writeSpan{vertices};
+	writeArchive << tag << writeSpan;
+	Blob data{writeArchive.GetData().begin(), writeArchive.GetData().end()};
+
+	u8                     readTag = 0;
+	Span<BulkVertex const> readSpan;
+	BinaryInputArchive     readArchive{};
+	readArchive.ReadFromBlob(data);
+	readArchive << readTag << readSpan;
+
+	// The span points into the source data
+	EXPECT_EQ(readTag, tag);
+	ASSERT_EQ(readSpan.size(), vertices.size());
+	EXPECT_GE(reinterpret_cast<u8 const*>(readSpan.data()), data.data());
+	EXPECT_LT(reinterpret_cast<u8 const*>(readSpan.data()), data.data() + data.size());
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(readSpan.data()) % alignof(BulkVertex), 0);
+	EXPECT_TRUE(std::equal(readSpan.begin(), readSpan.end(), vertices.begin()));
+}
+
+TEST(BinaryArchive, SpanView_ReadsBlobs) {
+	// Blobs have the same layout as spans of bytes, so they can be read in place
+	Blob writeBlob{1, 2, 3, 4, 5};
+	u32  writeValue = 42;
+
+	BinaryOutputArchive writeArchive{};
+	writeArchive << writeBlob << writeValue;
+	Blob data{writeArchive.GetData().begin(), writeArchive.GetData().end()};
+
+	Span<u8 const>     readBlob;
+	u32                readValue = 0;
+	BinaryInputArchive readArchive{};
+	readArchive.ReadFromData(data);
+	readArchive << readBlob << readValue;
+
+	EXPECT_TRUE(std::equal(readBlob.begin(), readBlob.end(), writeBlob.begin(), writeBlob.end()));
+	EXPECT_EQ(readValue, writeValue);
+}
+
+TEST(BinaryArchive, SpanView_Array) {
+	// Each span of an array is read as a view, the spans themselves are never copied as bytes
+	Array<Blob, 2> writeBlobs{Blob{1, 2, 3}, Blob{4, 5}};
+
+	BinaryOutputArchive writeArchive{};
+	writeArchive << writeBlobs;
+	Blob data{writeArchive.GetData().begin(), writeArchive.GetData().end()};
+
+	Array<Span<u8 const>, 2> readBlobs;
+	BinaryInputArchive       readArchive{};
+	readArchive.ReadFromBlob(data);
+	readArchive << readBlobs;
+
+	for (u64 i = 0; i < writeBlobs.size(); ++i) {
+		EXPECT_TRUE(std::equal(readBlobs[i].begin(), readBlobs[i].end(), writeBlobs[i].begin(), writeBlobs[i].end()));
+	}
+}
@@ -13,6 +13,10 @@ namespace CKE {
 
 		m_ResourceSystem.Initialize(&m_TaskSystem);
 		m_SystemsRegistry.RegisterSystem(&m_ResourceSystem);
+
+		// Read the resources from the packed archive if there is one, otherwise they are read as loose files
+		Path const& dataPath = m_ResourceSystem.GetBasePath();
+		g_FileSystem.MountArchive(dataPath + "Data.pak", dataPath);
 	}
 
 	void Engine::InitializeEngine() {
@@ -61,19 +65,45 @@ namespace CKE {
 		// Tick Time
 		m_EngineTime.Update();
 
+		// Install the resources that finished loading in the background
+		m_ResourceSystem.Update();
+
+		// Render the world extracted in the previous frame while this one is simulated,
+		// what is on screen is always one frame behind the simulation
+		struct RenderFrameTaskSet : public ITaskSet
+		{
+			RenderingSystem* m_pRenderingSystem = nullptr;
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+				m_pRenderingSystem->RenderFrame();
+			}
+		};
+		RenderFrameTaskSet renderTask{};
+		renderTask.m_pRenderingSystem = &m_RenderingSystem;
+		m_TaskSystem.ScheduleTask(&renderTask);
+
 		// Update Entity World
 		m_EntitySystem.Update(updateCtx);
 
-		// Render Everything
-		m_RenderingSystem.RenderFrame();
+		// Snapshot the render data of this frame and wait for the previous one to finish rendering
+		m_RenderingSystem.ExtractRenderWorld();
+		m_TaskSystem.WaitForTask(&renderTask);
+		m_RenderingSystem.SwapRenderWorlds();
 
 		// Cleanup necessary input state
 		m_InputSystem.EndOfFrameUpdate();
+
+		// Release the temporary memory of an older frame
+		m_TaskSystem.EndFrame();
 	}
 
 	void Engine::Shutdown() {
 		m_EntitySystem.Shutdown();
+
+		// Finish the pending loads while the render device is still alive
+		m_ResourceSystem.Shutdown();
 		m_RenderingSystem.Shutdown();
+		g_FileSystem.UnmountAllArchives();
 
 		m_TaskSystem.Shutdown();
 	}
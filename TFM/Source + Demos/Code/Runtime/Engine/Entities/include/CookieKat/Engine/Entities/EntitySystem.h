@@ -5,6 +5,7 @@
 #include "CookieKat/Systems/EngineSystem/SystemsRegistry.h"
 #include "CookieKat/Systems/ECS/EntityDatabase.h"
 #include "CookieKat/Systems/ECS/ECSBaseSystem.h"
+#include "CookieKat/Systems/ECS/SystemScheduler.h"
 #include "CookieKat/Systems/TaskSystem/TaskSystem.h"
 
 #include "CookieKat/Core/Memory/Memory.h"
@@ -36,17 +37,21 @@ namespace CKE
 
 		//-----------------------------------------------------------------------------
 
+		// Adds a system at the end of the frame, systems that don't have conflicting
+		// component accesses with the previous ones can run in parallel with them
 		template <typename T>
 		void AddSystem()
 		{
 			T* pSys = CKE::New<T>();
 			m_Systems.emplace_back(pSys);
+			m_SystemScheduler.AddSystem(pSys);
 		}
 
 	private:
 		EntityDatabase m_EntityDatabase;
 
 		Vector<ECSBaseSystem*> m_Systems;
+		SystemScheduler        m_SystemScheduler;
 
 		TaskSystem* m_pTaskSystem = nullptr;
 		IWorldDefinition* m_pWorldDefinition = nullptr;
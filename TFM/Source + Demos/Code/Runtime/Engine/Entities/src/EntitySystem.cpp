@@ -38,12 +38,9 @@ namespace CKE
 			m_EntityDatabase.GetSingletonComponent<InputStateComponent>()->m_pInputContext = inputContext;
 		}
 
-		// Update all of the registered systems
+		// Update all of the registered systems, the ones that don't conflict run in parallel
 		SystemUpdateContext sysUpdateContext{ &m_EntityDatabase, m_pTaskSystem, context.GetEngineTime()->GetSecondsDeltaTime() };
-		for (auto& pSystem : m_Systems)
-		{
-			pSystem->Update(sysUpdateContext);
-		}
+		m_SystemScheduler.Update(sysUpdateContext);
 	}
 
 	void EntitySystem::Shutdown()
@@ -19,8 +19,13 @@ namespace CKE {
 		void Setup(FrameGraphSetupContext& setup) override;
 		void Execute(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd) override;
 
+		// The draws of the render queue are split in parts that resume the same rendering
+		u32  GetNumParts(u32 maxParts) override;
+		void ExecutePart(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd,
+		                 u32                  partIdx, u32             numParts) override;
+
 	private:
-		EntityDatabase*          m_pEntityDb = nullptr;
+		RenderQueue const*       m_pRenderQueue = nullptr;
 		ResourceSystem*          m_pResources = nullptr;
 		RenderingSettings const* m_pRenderingSettings = nullptr;
 
@@ -9,6 +9,7 @@
 
 namespace CKE {
 	struct RenderingSettings;
+	class RenderQueue;
 }
 
 namespace CKE {
@@ -16,15 +17,19 @@ namespace CKE {
 	{
 	public:
 		RenderPassInitCtx(RenderDevice*   pDevice, TextureSamplersCache* pSamplersCache, ResourceSystem* pResources,
-		                  EntityDatabase* pEntityDB, RenderingSettings*  pView, PipelineManager* pPipelineManager) :
+		                  EntityDatabase* pEntityDB, RenderingSettings*  pView, PipelineManager* pPipelineManager,
+		                  RenderQueue const* pRenderQueue) :
 			m_pDevice{pDevice}, m_pSamplerCache{pSamplersCache}, m_pResources{pResources}, m_pEntityDB{pEntityDB},
-			m_pView{pView}, m_pPipelineManager{pPipelineManager} {}
+			m_pView{pView}, m_pPipelineManager{pPipelineManager}, m_pRenderQueue{pRenderQueue} {}
 
 		RenderDevice*            GetDevice() const { return m_pDevice; }
 		TextureSamplersCache*    GetSamplerCache() const { return m_pSamplerCache; }
 		PipelineManager*         GetPipelineManager() const { return m_pPipelineManager; }
 		RenderingSettings const* GetRenderingSettings() const { return m_pView; }
 
+		// Draws of the objects visible from the camera in the current frame
+		RenderQueue const* GetRenderQueue() const { return m_pRenderQueue; }
+
 		ResourceSystem* GetResourceSystem() const { return m_pResources; }
 		EntityDatabase* GetEntityDatabase() const { return m_pEntityDB; }
 
@@ -36,5 +41,7 @@ namespace CKE {
 		TextureSamplersCache* m_pSamplerCache{nullptr};
 		PipelineManager*      m_pPipelineManager{nullptr};
 		RenderingSettings*    m_pView{nullptr};
+
+		RenderQueue const* m_pRenderQueue{nullptr};
 	};
 }
\ No newline at end of file
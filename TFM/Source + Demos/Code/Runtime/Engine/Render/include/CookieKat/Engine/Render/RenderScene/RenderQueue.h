@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Engine/Render/RenderScene/SceneCulling.h"
+
+#include <algorithm>
+
+namespace CKE {
+	// Sort key of a draw, draws of the same material and mesh end up next to each other
+	// and ordered by object index, so consecutive objects can be drawn as instances
+	//
+	// Layout: material slot (20 bits) | mesh slot (20 bits) | object index (24 bits)
+	struct DrawSortKey
+	{
+		static constexpr u32 OBJECT_BITS = 24;
+		static constexpr u32 MESH_BITS = 20;
+		static constexpr u32 MATERIAL_BITS = 20;
+
+		inline static u64 Make(u32 materialSlot, u32 meshSlot, u32 objectIdx);
+
+		inline static u32 GetObjectIdx(u64 key) { return static_cast<u32>(key & ((1ull << OBJECT_BITS) - 1)); }
+		// Material and mesh part of the key, equal for the draws that can be batched
+		inline static u64 GetBatch(u64 key) { return key >> OBJECT_BITS; }
+	};
+
+	// Instanced draw of a range of consecutive objects with the same mesh and material
+	// The object indices are passed as the instance index
+	struct DrawBatch
+	{
+		TResourceID<MeshResource>           m_MeshID;
+		TResourceID<RenderMaterialResource> m_MaterialID;
+		u32                                 m_FirstObject = 0;
+		u32                                 m_NumInstances = 0;
+	};
+
+	// Sorts the visible objects of a scene by material and mesh and merges them into instanced draws
+	class RenderQueue
+	{
+	public:
+		// Passes that draw the queue split the recording of the batches in parts once each part
+		// has at least this many batches, below it a single thread records them faster
+		static constexpr u32 MIN_BATCHES_PER_PART = 128;
+
+		// Must be called after the objects of the scene have been culled
+		void Build(SceneCulling const& scene);
+
+		inline Span<DrawBatch const> GetBatches() const { return m_Batches; }
+
+		// Number of parts, at most maxParts, the batches should be split into to be recorded in parallel
+		inline u32 GetNumParts(u32 maxParts) const;
+
+		// Batches of one of the parts, together the parts cover all of the batches in order
+		inline Span<DrawBatch const> GetBatches(u32 partIdx, u32 numParts) const;
+
+	private:
+		Vector<u64>       m_Keys{};
+		Vector<u64>       m_ScratchKeys{}; // Temporary storage of the sort
+		Vector<DrawBatch> m_Batches{};
+	};
+}
+
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	inline u64 DrawSortKey::Make(u32 materialSlot, u32 meshSlot, u32 objectIdx) {
+		CKE_ASSERT(materialSlot < (1u << MATERIAL_BITS) && meshSlot < (1u << MESH_BITS)
+			&& objectIdx < (1u << OBJECT_BITS));
+		return static_cast<u64>(materialSlot) << (MESH_BITS + OBJECT_BITS)
+				| static_cast<u64>(meshSlot) << OBJECT_BITS
+				| objectIdx;
+	}
+
+	inline u32 RenderQueue::GetNumParts(u32 maxParts) const {
+		u32 const numParts = static_cast<u32>(m_Batches.size() / MIN_BATCHES_PER_PART);
+		return std::clamp(numParts, 1u, std::max(maxParts, 1u));
+	}
+
+	inline Span<DrawBatch const> RenderQueue::GetBatches(u32 partIdx, u32 numParts) const {
+		CKE_ASSERT(partIdx < numParts);
+		u64 const first = m_Batches.size() * partIdx / numParts;
+		u64 const last = m_Batches.size() * (partIdx + 1) / numParts;
+		return Span<DrawBatch const>{m_Batches.data() + first, last - first};
+	}
+}
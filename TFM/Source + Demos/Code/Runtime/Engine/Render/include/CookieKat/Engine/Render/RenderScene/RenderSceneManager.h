@@ -3,9 +3,14 @@
 #include "CookieKat/Core/Containers/Containers.h"
 #include "CookieKat/Core/Math/Math.h"
 #include "CookieKat/Systems/RenderAPI/RenderHandle.h"
+#include "CookieKat/Systems/RenderAPI/RenderSettings.h"
+
+#include "CookieKat/Engine/Render/RenderScene/RenderWorld.h"
+#include "CookieKat/Engine/Render/RenderScene/SceneCulling.h"
 
 namespace CKE {
-	class EntityDatabase;
+	class ResourceSystem;
+	class TaskSystem;
 }
 
 namespace CKE {
@@ -77,7 +82,6 @@ namespace CKE {
 	{
 		ViewDataGPU           m_ViewData{};
 		Vector<ObjectDataGPU> m_ObjectData{};
-		LightsDataGPU         m_LightsData{};
 		EnvironmentGPU        m_EnviorementData{};
 	};
 
@@ -98,8 +102,16 @@ namespace CKE {
 		// Sets and uploads environment data to the GPU
 		void SetEnviorementData(EnvironmentGPU data);
 
-		// Copies all of the scene data from an entity world and sends it to the GPU
-		void CopySceneDataFromEntityWorld(RenderDevice* pDevice, EntityDatabase* pEntities);
+		// Copies the scene data from a snapshot of the entity world and sends it to the GPU
+		// The snapshot only has the objects that changed, so every snapshot of the world must be copied
+		void CopySceneDataFromRenderWorld(RenderDevice* pDevice, RenderWorld const& world, ResourceSystem* pResources);
+
+		// Tests the bounds of every object against the camera frustum in parallel and
+		// stores the objects that may be visible, must be called after the scene data is copied
+		void CullObjects(TaskSystem& taskSystem);
+
+		// Objects of the scene and the ones that passed the last culling
+		inline SceneCulling const& GetCulling() const { return m_Culling; }
 
 	public:
 		RenderDevice* m_pDevice = nullptr;
@@ -111,5 +123,26 @@ namespace CKE {
 		BufferHandle m_ObjectDataBuffer;
 		BufferHandle m_LightsBuffer;
 		BufferHandle m_EnviorementBuffer;
+
+	private:
+		// Range of objects modified in a frame, empty if m_First > m_Last
+		struct ObjectDataRange
+		{
+			u64 m_First = RenderSettings::MAX_OBJECTS;
+			u64 m_Last = 0;
+		};
+
+		// The object buffer has a copy per frame in flight and each copy is only updated once
+		// every MAX_FRAMES_IN_FLIGHT frames, so it needs the changes of all of those frames
+		Array<ObjectDataRange, RenderSettings::MAX_FRAMES_IN_FLIGHT> m_ObjectDataChanges{};
+		u32                                                          m_CurrentFrameChanges = 0;
+
+		// Culling
+		// The bounds are updated with the object data and emptied when the object is removed
+		//-----------------------------------------------------------------------------
+
+		SceneCulling  m_Culling{};
+		Map<u64, u32> m_MeshSlots{};     // Resource ID to ObjectDrawInfo::m_MeshSlot
+		Map<u64, u32> m_MaterialSlots{}; // Resource ID to ObjectDrawInfo::m_MaterialSlot
 	};
 }
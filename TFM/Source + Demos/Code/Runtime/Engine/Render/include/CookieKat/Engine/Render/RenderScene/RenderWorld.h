@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Systems/ECS/Query.h"
+
+#include "CookieKat/Engine/Entities/Components/CameraComponent.h"
+#include "CookieKat/Engine/Entities/Components/LocalToWorldComponent.h"
+#include "CookieKat/Engine/Entities/Components/MeshComponent.h"
+#include "CookieKat/Engine/Entities/Components/PointLightComponent.h"
+
+namespace CKE {
+	class EntityDatabase;
+}
+
+namespace CKE {
+	// Copy of the data of an entity world that is needed to render a frame
+	// The renderer only reads the copy, so the entity world can be simulated while it is rendered
+	struct RenderWorld
+	{
+		// Objects whose transform or mesh changed since the previous snapshot, same order in both vectors
+		Vector<LocalToWorldComponent> m_ChangedTransforms{};
+		Vector<MeshComponent>         m_ChangedMeshes{};
+		// Object indices of the meshes removed since the previous snapshot, by removing the
+		// component or deleting the entity. Applied before the changed objects
+		Vector<u64>                   m_RemovedObjects{};
+
+		Vector<PointLightComponent> m_PointLights{};
+
+		CameraComponent m_Camera{};
+		bool            m_HasCamera = false;
+
+		// Empties the world but keeps the memory of the vectors for the next snapshot
+		void Clear();
+	};
+
+	// Builds snapshots of an entity world, the components are copied a whole chunk column at a time
+	class RenderWorldExtractor
+	{
+	public:
+		// Overwrites the snapshot with the current state of the entity world
+		// Only the objects that changed since the previous extraction are copied, so every
+		// snapshot must be rendered and the entity world must always be the same one
+		void Extract(EntityDatabase& entities, RenderWorld& outWorld);
+
+	private:
+		Query<Read<LocalToWorldComponent>, Read<MeshComponent>,
+		      Changed<LocalToWorldComponent>, Changed<MeshComponent>> m_ChangedObjectsQuery{};
+	};
+}
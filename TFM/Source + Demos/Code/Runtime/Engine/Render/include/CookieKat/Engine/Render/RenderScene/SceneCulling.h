@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Math/Bounds.h"
+#include "CookieKat/Core/Math/FrustumCulling.h"
+#include "CookieKat/Systems/Resources/ResourceID.h"
+
+#include "CookieKat/Engine/Resources/Resources/MeshResource.h"
+#include "CookieKat/Engine/Resources/Resources/RenderMaterialResource.h"
+
+namespace CKE {
+	class TaskSystem;
+}
+
+namespace CKE {
+	// Resources used to draw an object, indexed like its object data
+	struct ObjectDrawInfo
+	{
+		TResourceID<MeshResource>           m_MeshID;
+		TResourceID<RenderMaterialResource> m_MaterialID;
+
+		// Small indices of the mesh and material in the scene, used to sort the draws
+		u32 m_MeshSlot = 0;
+		u32 m_MaterialSlot = 0;
+	};
+
+	// World bounds and draw info of the objects of a scene, indexed by object index (0 based)
+	// The slots of the object indices that aren't in use are empty and never visible
+	class SceneCulling
+	{
+	public:
+		// Number of objects tested by each partition of the culling task
+		static constexpr u32 CULLING_GROUP_SIZE = 1024;
+
+		void Initialize(u32 maxObjects);
+
+		void SetObject(u32 objectIdx, ObjectDrawInfo const& drawInfo, AABB const& worldBounds);
+		// Empties the slot of the object, removing an object that isn't in the scene does nothing
+		void RemoveObject(u32 objectIdx);
+
+		// Tests the bounds of every object against the frustum in parallel and stores the ones that may be visible
+		void Cull(TaskSystem& taskSystem, Frustum const& frustum);
+
+		// Object indices of the objects that passed the last culling, in increasing order
+		inline Span<u32 const> GetVisibleObjects() const { return {m_VisibleObjects.data(), m_NumVisibleObjects}; }
+		inline ObjectDrawInfo const& GetObjectDrawInfo(u32 objectIdx) const { return m_ObjectDrawInfos[objectIdx]; }
+		// Highest object index in use + 1, only the slots below it are culled
+		inline u32 GetNumObjectSlots() const { return m_NumObjectSlots; }
+
+	private:
+		Vector<ObjectDrawInfo> m_ObjectDrawInfos{};
+		BoundsStream           m_ObjectWorldBounds{};
+		Vector<bool>           m_SlotInUse{};
+		u32                    m_NumObjectSlots = 0;
+
+		// Each group writes its visible objects at its first slot, then they are compacted
+		Vector<u32> m_VisibleObjects{};
+		Vector<u32> m_NumVisiblePerGroup{};
+		u32         m_NumVisibleObjects = 0;
+	};
+}
@@ -8,6 +8,8 @@
 #include "CookieKat/Engine/Render/RTextureManager/RTextureManager.h"
 #include "CookieKat/Engine/Render/PipelineManager/PipelineManager.h"
 #include "CookieKat/Engine/Render/RenderScene/RenderSceneManager.h"
+#include "CookieKat/Engine/Render/RenderScene/RenderQueue.h"
+#include "CookieKat/Engine/Render/RenderScene/RenderWorld.h"
 #include "CookieKat/Systems/RenderUtils/TextureSamplersCache.h"
 #include "CookieKat/Systems/EngineSystem/IEngineSystem.h"
 
@@ -42,9 +44,20 @@ namespace CKE {
 		// NOTE: Must be called before Initialize()
 		void InitializeRenderTarget(void* pRT);
 		void Initialize(SystemsRegistry* pSystemsRegistry);
-		void RenderFrame();
 		void Shutdown();
 
+		// Frames are rendered from snapshots of the entity world, so the world can be updated
+		// while the previous frame is rendered. Each frame of the engine must call, in order:
+		// - RenderFrame() and ExtractRenderWorld(), they can run at the same time
+		// - SwapRenderWorlds() once both have finished
+
+		// Renders the last snapshot swapped in, does nothing until there is one
+		void RenderFrame();
+		// Copies the render data of the entity world into the snapshot that isn't being rendered
+		void ExtractRenderWorld();
+		// Makes the last extracted snapshot the one rendered by the next RenderFrame()
+		void SwapRenderWorlds();
+
 		void RecordRenderTargetResizeEvent(Int2 newSize);
 
 		inline RenderDevice& GetRenderDevice();
@@ -62,6 +75,12 @@ namespace CKE {
 		bool                 m_TriggerBackBufferResize = false;
 
 		RenderSceneManager m_RenderSceneManager{};
+		RenderQueue        m_RenderQueue{};
+
+		RenderWorldExtractor  m_RenderWorldExtractor{};
+		Array<RenderWorld, 2> m_RenderWorlds{};
+		u32                   m_ExtractedWorldIdx = 0;    // Snapshot written by ExtractRenderWorld()
+		bool                  m_HasRenderWorld = false; // True once a snapshot has been swapped in
 
 		DepthPrePass*    m_DepthPass{};
 		GBufferPass*     m_GBufferPass{};
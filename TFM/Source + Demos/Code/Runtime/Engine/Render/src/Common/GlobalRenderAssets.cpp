@@ -18,7 +18,7 @@ namespace CKE {
 		viewDesc.m_AspectMask = TextureAspectMask::Color;
 
 		TextureUploader uploader{};
-		uploader.Initialize(&m_Device, sizeof(u32));
+		uploader.Initialize(&m_Device);
 
 		u8 whiteCol[4] = {255, 255, 255, 255};
 		textureDesc.m_Format = TextureFormat::R8G8B8A8_SRGB;
@@ -42,8 +42,6 @@ namespace CKE {
 		viewDesc.m_Texture = m_NormalDefault;
 		m_NormalDefault_View = m_Device.CreateTextureView(viewDesc);
 
-		uploader.Shutdown();
-
 		ScreenQuad        screenQuad{};
 		BufferDesc screenQuadBufferDesc{};
 		screenQuadBufferDesc.m_Name = "ScreenQuad Buffer";
@@ -31,7 +31,7 @@ namespace CKE {
 		info.m_Handle = m_pDevice->CreateGraphicsPipeline(desc);
 		m_Cache.insert({idToAssign, info});
 
-		m_pResources->UnloadResource(resourceID);
+		// The pipeline keeps using the layout of the resource, so the resource stays referenced
 	}
 
 	PipelineHandle PipelineManager::GetPipeline(PipelineID id) {
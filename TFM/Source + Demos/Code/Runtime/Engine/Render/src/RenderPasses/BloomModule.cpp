@@ -216,7 +216,7 @@ namespace CKE {
 		};
 
 		m_Pipeline = pRenderSubSystems->GetDevice()->CreateGraphicsPipeline(desc);
-		pResources->UnloadResource(pipelineResourceID);
+		// The pipeline keeps using the layout of the resource, so the resource stays referenced
 	}
 
 	void BloomUpSamplePass::SetInputOutput(FGResourceID input, FGResourceID combineSrc,
@@ -315,7 +315,7 @@ namespace CKE {
 
 
 		m_Pipeline = pRenderSubSystems->GetDevice()->CreateGraphicsPipeline(desc);
-		pResources->UnloadResource(pipelineResourceID);
+		// The pipeline keeps using the layout of the resource, so the resource stays referenced
 	}
 
 	void BloomCombinePass::Setup(FrameGraphSetupContext& setup) {
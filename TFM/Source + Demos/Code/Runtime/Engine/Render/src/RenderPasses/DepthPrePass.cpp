@@ -1,7 +1,5 @@
 #include "CookieKat/Engine/Render/RenderPasses/DepthPrePass.h"
 
-#include "CookieKat/Engine/Entities/Components/LocalToWorldComponent.h"
-#include "CookieKat/Engine/Entities/Components/MeshComponent.h"
 #include "CookieKat/Engine/Render/RenderPasses/SharedIDs.h"
 #include "CookieKat/Engine/Render/RenderingSystem.h"
 
@@ -9,7 +7,7 @@
 
 namespace CKE {
 	void DepthPrePass::Initialize(RenderPassInitCtx* pInitCtx) {
-		m_pEntityDb = pInitCtx->GetEntityDatabase();
+		m_pRenderQueue = pInitCtx->GetRenderQueue();
 		m_pResources = pInitCtx->GetResourceSystem();
 		m_pRenderingSettings = pInitCtx->GetRenderingSettings();
 		m_Pipeline = pInitCtx->GetPipelineManager()->GetPipeline(PipelineIDS::DepthPrePass);
@@ -37,6 +35,15 @@ namespace CKE {
 	};
 
 	void DepthPrePass::Execute(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd) {
+		ExecutePart(ctx, cmdList, rd, 0, 1);
+	}
+
+	u32 DepthPrePass::GetNumParts(u32 maxParts) {
+		return m_pRenderQueue->GetNumParts(maxParts);
+	}
+
+	void DepthPrePass::ExecutePart(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd,
+	                               u32                  partIdx, u32             numParts) {
 		TextureViewHandle const depthStencil = ctx.GetTextureView(General::DepthStencil);
 		BufferHandle const      viewBuffer = ctx.GetBuffer(SceneGlobal::View);
 		BufferHandle const      objectBuffer = ctx.GetBuffer(SceneGlobal::ObjectData);
@@ -51,6 +58,8 @@ namespace CKE {
 				TextureLayout::DepthStencil_Attachment,
 				LoadOp::Clear, StoreOp::Store,
 			},
+			.m_Suspending = partIdx + 1 < numParts,
+			.m_Resuming = partIdx > 0,
 		});
 
 		cmdList.SetPipeline(m_Pipeline);
@@ -63,13 +72,19 @@ namespace CKE {
 		                                       .Build();
 		cmdList.BindDescriptor(m_Pipeline, descriptor);
 
-		// Record draw calls
-		for (auto& [l2w, mesh] : m_pEntityDb->GetMultiCompTupleIter<
-			     LocalToWorldComponent, MeshComponent>()) {
-			MeshResource const* m = m_pResources->GetResource<MeshResource>(mesh->m_MeshID);
-			cmdList.SetVertexBuffer(m->GetVertexBuffer());
-			cmdList.SetIndexBuffer(m->GetIndexBuffer(), 0);
-			cmdList.DrawIndexed(m->GetIndices().size(), mesh->m_ObjectIdx - 1);
+		// Record draw calls of the objects that passed the frustum culling
+		// The material is not used, only the mesh buffers are bound when they change
+		u64 lastMeshHandle = -1;
+		u32 numMeshIndices = 0;
+		for (DrawBatch const& batch : m_pRenderQueue->GetBatches(partIdx, numParts)) {
+			if (batch.m_MeshID.GetU64() != lastMeshHandle) {
+				MeshResource const* m = m_pResources->GetResource<MeshResource>(batch.m_MeshID);
+				cmdList.SetVertexBuffer(m->GetVertexBuffer());
+				cmdList.SetIndexBuffer(m->GetIndexBuffer(), 0);
+				numMeshIndices = m->GetNumIndices();
+				lastMeshHandle = batch.m_MeshID.GetU64();
+			}
+			cmdList.DrawIndexed(numMeshIndices, batch.m_NumInstances, 0, 0, batch.m_FirstObject);
 		}
 
 		cmdList.EndRendering();
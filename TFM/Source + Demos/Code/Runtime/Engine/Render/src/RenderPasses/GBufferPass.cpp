@@ -2,8 +2,6 @@
 #include "CookieKat/Engine/Render/RenderPasses/SharedIDs.h"
 #include "CookieKat/Engine/Render/RenderingSystem.h"
 
-#include "CookieKat/Engine/Entities/Components/LocalToWorldComponent.h"
-#include "CookieKat/Engine/Entities/Components/MeshComponent.h"
 #include "CookieKat/Engine/Resources/Resources/RenderMaterialResource.h"
 
 #include "Common/GlobalRenderAssets.h"
@@ -14,7 +12,7 @@ namespace CKE {
 	void GBufferPass::Initialize(RenderPassInitCtx* pCtx) {
 		m_pDevice = pCtx->GetDevice();
 		m_pSamplerCache = pCtx->GetSamplerCache();
-		m_pEntityDB = pCtx->GetEntityDatabase();
+		m_pRenderQueue = pCtx->GetRenderQueue();
 		m_pResources = pCtx->GetResourceSystem();
 		m_pRenderingSettings = pCtx->GetRenderingSettings();
 		m_Pipeline = pCtx->GetPipelineManager()->GetPipeline(PipelineIDS::GBufferPass);
@@ -63,6 +61,15 @@ namespace CKE {
 	}
 
 	void GBufferPass::Execute(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd) {
+		ExecutePart(ctx, cmdList, rd, 0, 1);
+	}
+
+	u32 GBufferPass::GetNumParts(u32 maxParts) {
+		return m_pRenderQueue->GetNumParts(maxParts);
+	}
+
+	void GBufferPass::ExecutePart(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd,
+	                              u32                  partIdx, u32             numParts) {
 		TextureViewHandle depthBufferTex = ctx.GetTextureView(GBuffer::DepthStencil);
 		TextureViewHandle albedoTex = ctx.GetTextureView(GBuffer::Albedo);
 		TextureViewHandle normalsTex = ctx.GetTextureView(GBuffer::Normals);
@@ -110,6 +117,8 @@ namespace CKE {
 				TextureLayout::DepthStencil_Attachment,
 				LoadOp::Load, StoreOp::Store,
 			},
+			.m_Suspending = partIdx + 1 < numParts,
+			.m_Resuming = partIdx > 0,
 		});
 
 		cmdList.SetPipeline(m_Pipeline);
@@ -130,40 +139,47 @@ namespace CKE {
 		// Record draw calls
 		//-----------------------------------------------------------------------------
 
+		// The visible objects are sorted by material and mesh, so the bindings only change between
+		// batches and the consecutive objects of a batch are drawn as instances
 		DescriptorSetBuilder b = rd.CreateDescriptorSetBuilder(m_Pipeline, 1);
 		u64                  lastMaterialHandle = -1;
-		for (auto& [l2w, mesh] : m_pEntityDB->GetMultiCompTupleIter<LocalToWorldComponent, MeshComponent>()) {
-			// Initially set default textures
-			TextureViewHandle albedo = GlobalRenderAssets::White1x1();
-			TextureViewHandle normal = GlobalRenderAssets::NormalDefault();
-			TextureViewHandle roughness = GlobalRenderAssets::White1x1();
-			TextureViewHandle metallic = GlobalRenderAssets::White1x1();
-
-			// Override default textures with material textures if any exist
-			if (mesh->m_MaterialID.IsNotNull()) {
-				auto const material = m_pResources->GetResource<RenderMaterialResource>(mesh->m_MaterialID);
-				if (material->GetAlbedoTexture().IsNotNull()) {
-					albedo = m_pResources->GetResource<RenderTextureResource>(material->GetAlbedoTexture())->GetTextureView();
-				}
-				if (material->GetNormalTexture().IsNotNull()) {
-					normal = m_pResources->GetResource<RenderTextureResource>(material->GetNormalTexture())->GetTextureView();
-				}
-				if (material->GetRoughnessTexture().IsNotNull()) {
-					roughness = m_pResources->GetResource<RenderTextureResource>(material->GetRoughnessTexture())->
-					                          GetTextureView();
-				}
-				if (material->GetMetalicTexture().IsNotNull()) {
-					metallic = m_pResources->GetResource<RenderTextureResource>(material->GetMetalicTexture())->
-					                         GetTextureView();
+		u64                  lastMeshHandle = -1;
+		u32                  numMeshIndices = 0;
+		for (DrawBatch const& batch : m_pRenderQueue->GetBatches(partIdx, numParts)) {
+			// Material Bindings
+			// Only resolved and bound if the material changed
+			if (batch.m_MaterialID.GetU64() != lastMaterialHandle) {
+				// Initially set default textures
+				TextureViewHandle albedo = GlobalRenderAssets::White1x1();
+				TextureViewHandle normal = GlobalRenderAssets::NormalDefault();
+				TextureViewHandle roughness = GlobalRenderAssets::White1x1();
+				TextureViewHandle metallic = GlobalRenderAssets::White1x1();
+
+				// Override default textures with material textures if any exist
+				if (batch.m_MaterialID.IsNotNull()) {
+					auto const material = m_pResources->GetResource<RenderMaterialResource>(batch.m_MaterialID);
+					if (material->GetAlbedoTexture().IsNotNull()) {
+						albedo = m_pResources->GetResource<RenderTextureResource>(material->GetAlbedoTexture())->
+						                       GetTextureView();
+					}
+					if (material->GetNormalTexture().IsNotNull()) {
+						normal = m_pResources->GetResource<RenderTextureResource>(material->GetNormalTexture())->
+						                       GetTextureView();
+					}
+					if (material->GetRoughnessTexture().IsNotNull()) {
+						roughness = m_pResources->GetResource<RenderTextureResource>(material->GetRoughnessTexture())->
+						                          GetTextureView();
+					}
+					if (material->GetMetalicTexture().IsNotNull()) {
+						metallic = m_pResources->GetResource<RenderTextureResource>(material->GetMetalicTexture())->
+						                         GetTextureView();
+					}
 				}
-			}
 
-			// Material Bindings
-			// Only bind if the material changed
-			if (mesh->m_MaterialID.GetU64() != lastMaterialHandle) {
 				SamplerDesc samplerDesc{};
 				samplerDesc.m_WrapU = TextureWrapMode::Repeat;
 				samplerDesc.m_WrapV = TextureWrapMode::Repeat;
+				samplerDesc.m_MaxLod = 1000.0f; // Material textures come with their whole mip chain
 				SamplerHandle       samplerHandle = m_pSamplerCache->CreateSampler(samplerDesc);
 				DescriptorSetHandle materialDescriptor =
 						b.BindTextureWithSampler(0, albedo, samplerHandle)
@@ -173,14 +189,20 @@ namespace CKE {
 						 .Build();
 
 				cmdList.BindDescriptor(m_Pipeline, materialDescriptor);
-				lastMaterialHandle = mesh->m_MaterialID.GetU64();
+				lastMaterialHandle = batch.m_MaterialID.GetU64();
 			}
 
 			// Mesh Buffers
-			MeshResource const* m = m_pResources->GetResource<MeshResource>(mesh->m_MeshID);
-			cmdList.SetVertexBuffer(m->GetVertexBuffer());
-			cmdList.SetIndexBuffer(m->GetIndexBuffer(), 0);
-			cmdList.DrawIndexed(m->GetIndices().size(), mesh->m_ObjectIdx - 1);
+			// Only bound if the mesh changed
+			if (batch.m_MeshID.GetU64() != lastMeshHandle) {
+				MeshResource const* m = m_pResources->GetResource<MeshResource>(batch.m_MeshID);
+				cmdList.SetVertexBuffer(m->GetVertexBuffer());
+				cmdList.SetIndexBuffer(m->GetIndexBuffer(), 0);
+				numMeshIndices = m->GetNumIndices();
+				lastMeshHandle = batch.m_MeshID.GetU64();
+			}
+
+			cmdList.DrawIndexed(numMeshIndices, batch.m_NumInstances, 0, 0, batch.m_FirstObject);
 		}
 
 		cmdList.EndRendering();
@@ -40,7 +40,7 @@ namespace CKE {
 		};
 
 		m_Pipeline = pCtx->GetDevice()->CreateGraphicsPipeline(pipelineDesc);
-		pResources->UnloadResource(pipelineResourceID);
+		// The pipeline keeps using the layout of the resource, so the resource stays referenced
 
 		// Generation of SSAO samples and Semi-sphere rotations
 		//-----------------------------------------------------------------------------
@@ -120,7 +120,7 @@ namespace CKE {
 
 		TextureViewHandle ssaoOutputTex = ctx.GetTextureView(SSAO_Raw);
 
-		rd.UploadBufferData_DEPR(sampling, &m_SamplingData, sizeof(SSAOSamplingDataGPU), 0);
+		rd.UploadBufferData(sampling, &m_SamplingData, sizeof(SSAOSamplingDataGPU), 0);
 
 		cmdList.BeginRendering(RenderingInfo{
 			.m_RenderArea = m_pRenderingSettings->m_RenderArea,
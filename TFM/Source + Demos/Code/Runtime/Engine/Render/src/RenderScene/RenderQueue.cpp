@@ -0,0 +1,39 @@
+#include "RenderScene/RenderQueue.h"
+
+#include "CookieKat/Core/Containers/RadixSort.h"
+#include "CookieKat/Core/Profilling/Profilling.h"
+
+namespace CKE {
+	void RenderQueue::Build(SceneCulling const& scene) {
+		CKE_PROFILE_EVENT();
+
+		Span<u32 const> visibleObjects = scene.GetVisibleObjects();
+		m_Keys.resize(visibleObjects.size());
+		m_ScratchKeys.resize(visibleObjects.size());
+		m_Batches.clear();
+
+		for (u64 i = 0; i < visibleObjects.size(); ++i) {
+			ObjectDrawInfo const& object = scene.GetObjectDrawInfo(visibleObjects[i]);
+			m_Keys[i] = DrawSortKey::Make(object.m_MaterialSlot, object.m_MeshSlot, visibleObjects[i]);
+		}
+
+		// The visible objects are already ordered by index and the sort is stable,
+		// so only the material and mesh bits need to be sorted
+		RadixSort(m_Keys, m_ScratchKeys, DrawSortKey::OBJECT_BITS);
+
+		u64 lastBatch = ~0ull;
+		for (u64 key : m_Keys) {
+			u32 const objectIdx = DrawSortKey::GetObjectIdx(key);
+			u64 const batch = DrawSortKey::GetBatch(key);
+
+			if (batch == lastBatch && m_Batches.back().m_FirstObject + m_Batches.back().m_NumInstances == objectIdx) {
+				m_Batches.back().m_NumInstances++;
+				continue;
+			}
+
+			ObjectDrawInfo const& object = scene.GetObjectDrawInfo(objectIdx);
+			m_Batches.push_back(DrawBatch{object.m_MeshID, object.m_MaterialID, objectIdx, 1});
+			lastBatch = batch;
+		}
+	}
+}
@@ -1,18 +1,19 @@
 #include "RenderScene/RenderSceneManager.h"
 
-#include "CookieKat/Systems/ECS/EntityDatabase.h"
+#include "CookieKat/Core/Profilling/Profilling.h"
+
 #include "CookieKat/Systems/RenderAPI/RenderDevice.h"
+#include "CookieKat/Systems/Resources/ResourceSystem.h"
 
-#include "CookieKat/Engine/Entities/Components/CameraComponent.h"
-#include "CookieKat/Engine/Entities/Components/LocalToWorldComponent.h"
-#include "CookieKat/Engine/Entities/Components/MeshComponent.h"
-#include "CookieKat/Engine/Entities/Components/PointLightComponent.h"
+#include <algorithm>
 
 namespace CKE {
 	void RenderSceneManager::InitializeGPUBuffers(RenderDevice* pDevice) {
 		m_pDevice = pDevice;
 		m_Scene.m_ObjectData.resize(RenderSettings::MAX_OBJECTS);
 
+		m_Culling.Initialize(RenderSettings::MAX_OBJECTS);
+
 		BufferDesc objectDataBufferDesc{};
 		objectDataBufferDesc.m_Name = "Object Data Buffer";
 		objectDataBufferDesc.m_Usage = BufferUsage::Storage | BufferUsage::TransferDst;
@@ -42,7 +43,7 @@ namespace CKE {
 		enviorementBufferDesc.m_Name = "Enviorement Buffer";
 		enviorementBufferDesc.m_Usage = BufferUsage::Uniform | BufferUsage::TransferDst;
 		enviorementBufferDesc.m_MemoryAccess = MemoryAccess::CPU_GPU;
-		enviorementBufferDesc.m_UpdateFrequency = UpdateFrequency::PerFrame;
+		enviorementBufferDesc.m_UpdateFrequency = UpdateFrequency::Static; // Only set when the environment changes
 		enviorementBufferDesc.m_SizeInBytes = sizeof(EnvironmentGPU);
 		m_EnviorementBuffer = m_pDevice->CreateBuffer(enviorementBufferDesc);
 	}
@@ -53,7 +54,7 @@ namespace CKE {
 		m_Scene.m_ViewData.m_ProjInv = glm::inverse(proj);
 		m_Scene.m_ViewData.m_ViewInv = glm::inverse(view);
 		m_Scene.m_ViewData.m_ViewProj = proj * view;
-		m_pDevice->UploadBufferData_DEPR(m_ViewBuffer, &m_Scene.m_ViewData, sizeof(ViewDataGPU), 0);
+		m_pDevice->UploadBufferData(m_ViewBuffer, &m_Scene.m_ViewData, sizeof(ViewDataGPU), 0);
 	}
 
 	void RenderSceneManager::SetRenderingViewSettings(RenderingSettings view) {
@@ -62,38 +63,87 @@ namespace CKE {
 
 	void RenderSceneManager::SetEnviorementData(EnvironmentGPU data) {
 		m_Scene.m_EnviorementData = data;
-		m_pDevice->UploadBufferData_DEPR(m_EnviorementBuffer, &m_Scene.m_EnviorementData,
-		                                 sizeof(EnvironmentGPU), 0);
+		m_pDevice->UploadBufferData(m_EnviorementBuffer, &m_Scene.m_EnviorementData, sizeof(EnvironmentGPU), 0);
 	}
 
-	void RenderSceneManager::CopySceneDataFromEntityWorld(RenderDevice*   pDevice,
-	                                                      EntityDatabase* pEntities) {
-		// Upload object data of all of the objects in the scene
+	void RenderSceneManager::CopySceneDataFromRenderWorld(RenderDevice*      pDevice,
+	                                                      RenderWorld const& world,
+	                                                      ResourceSystem*    pResources) {
+		CKE_PROFILE_EVENT();
+
+		// Upload object data of the objects that changed, most of the scene is usually static
 		//-----------------------------------------------------------------------------
 
-		int objCount = 0;
-		for (auto& [l2w, mesh] : pEntities->GetMultiCompTupleIter<
-			     LocalToWorldComponent, MeshComponent>()) {
+		m_CurrentFrameChanges = (m_CurrentFrameChanges + 1) % RenderSettings::MAX_FRAMES_IN_FLIGHT;
+		ObjectDataRange& frameChanges = m_ObjectDataChanges[m_CurrentFrameChanges];
+		frameChanges = ObjectDataRange{};
+
+		// Removals go first, the index of a removed object may be reused by an object of the same snapshot
+		// Their object data isn't uploaded, nothing reads it once the object can't be visible
+		for (u64 objectIdx : world.m_RemovedObjects) {
+			CKE_ASSERT(objectIdx > 0 && objectIdx < RenderSettings::MAX_OBJECTS);
+			m_Culling.RemoveObject(static_cast<u32>(objectIdx - 1));
+		}
+
+		// Objects usually come in runs with the same mesh and material, so their bounds
+		// and slots are only looked up when they change (the null material also has a slot)
+		ResourceID lastMeshID{~0ull};
+		ResourceID lastMaterialID{~0ull};
+		AABB       meshBounds{};
+		u32        meshSlot = 0;
+		u32        materialSlot = 0;
+
+		for (u64 i = 0; i < world.m_ChangedMeshes.size(); ++i) {
+			LocalToWorldComponent const& l2w = world.m_ChangedTransforms[i];
+			MeshComponent const&         mesh = world.m_ChangedMeshes[i];
+
 			ObjectDataGPU obj{};
-			obj.m_Local2World = l2w->m_LocalToWorld;
-			obj.m_NormalMat = glm::transpose(glm::inverse(l2w->m_LocalToWorld));
-			obj.m_AlbedoOverride = mesh->m_MaterialModifiers.m_Albedo;
-			obj.m_MetallicOverride = mesh->m_MaterialModifiers.m_MetalMask;
-			obj.m_RoughnessOverride = mesh->m_MaterialModifiers.m_Roughness;
-			obj.m_Reflectance = mesh->m_MaterialModifiers.m_Reflectance;
-			CKE_ASSERT(mesh->m_ObjectIdx - 1 >= 0 && mesh->m_ObjectIdx < RenderSettings::MAX_OBJECTS);
-			m_Scene.m_ObjectData[mesh->m_ObjectIdx - 1] = obj;
-			objCount++;
+			obj.m_Local2World = l2w.m_LocalToWorld;
+			obj.m_NormalMat = glm::transpose(glm::inverse(l2w.m_LocalToWorld));
+			obj.m_AlbedoOverride = mesh.m_MaterialModifiers.m_Albedo;
+			obj.m_MetallicOverride = mesh.m_MaterialModifiers.m_MetalMask;
+			obj.m_RoughnessOverride = mesh.m_MaterialModifiers.m_Roughness;
+			obj.m_Reflectance = mesh.m_MaterialModifiers.m_Reflectance;
+			CKE_ASSERT(mesh.m_ObjectIdx > 0 && mesh.m_ObjectIdx < RenderSettings::MAX_OBJECTS);
+
+			u64 objIdx = mesh.m_ObjectIdx - 1;
+			m_Scene.m_ObjectData[objIdx] = obj;
+			frameChanges.m_First = std::min(frameChanges.m_First, objIdx);
+			frameChanges.m_Last = std::max(frameChanges.m_Last, objIdx);
+
+			// Culling data
+			if (mesh.m_MeshID != lastMeshID) {
+				meshBounds = pResources->GetResource<MeshResource>(mesh.m_MeshID)->GetBounds();
+				meshSlot = m_MeshSlots.try_emplace(mesh.m_MeshID.GetU64(), static_cast<u32>(m_MeshSlots.size()))
+				                      .first->second;
+				lastMeshID = mesh.m_MeshID;
+			}
+			if (mesh.m_MaterialID != lastMaterialID) {
+				materialSlot = m_MaterialSlots.try_emplace(mesh.m_MaterialID.GetU64(),
+				                                           static_cast<u32>(m_MaterialSlots.size())).first->second;
+				lastMaterialID = mesh.m_MaterialID;
+			}
+			ObjectDrawInfo const drawInfo{mesh.m_MeshID, mesh.m_MaterialID, meshSlot, materialSlot};
+			m_Culling.SetObject(static_cast<u32>(objIdx), drawInfo, meshBounds.Transform(l2w.m_LocalToWorld));
+		}
+
+		ObjectDataRange uploadRange{};
+		for (ObjectDataRange const& changes : m_ObjectDataChanges) {
+			uploadRange.m_First = std::min(uploadRange.m_First, changes.m_First);
+			uploadRange.m_Last = std::max(uploadRange.m_Last, changes.m_Last);
+		}
+		if (uploadRange.m_First <= uploadRange.m_Last) {
+			pDevice->UploadBufferData(m_ObjectDataBuffer, &m_Scene.m_ObjectData[uploadRange.m_First],
+			                          (uploadRange.m_Last - uploadRange.m_First + 1) * sizeof(ObjectDataGPU),
+			                          uploadRange.m_First * sizeof(ObjectDataGPU));
 		}
-		pDevice->UploadBufferData_DEPR(m_ObjectDataBuffer, m_Scene.m_ObjectData.data(),
-		                               objCount * sizeof(ObjectDataGPU), 0);
 
 		// Init Main Camera
 		//-----------------------------------------------------------------------------
 
-		for (auto& [cam] : pEntities->GetMultiCompTupleIter<CameraComponent>()) {
-			Mat4 projFlipped = cam->m_Proj;
-			Mat4 view = cam->m_View;
+		if (world.m_HasCamera) {
+			Mat4 projFlipped = world.m_Camera.m_Proj;
+			Mat4 view = world.m_Camera.m_View;
 
 			projFlipped[1][1] *= -1;
 			m_Scene.m_ViewData.m_View = view;
@@ -102,24 +152,28 @@ namespace CKE {
 			m_Scene.m_ViewData.m_ViewInv = glm::inverse(view);
 			m_Scene.m_ViewData.m_ViewProj = projFlipped * view;
 
-			pDevice->UploadBufferData_DEPR(m_ViewBuffer, &m_Scene.m_ViewData, sizeof(ViewDataGPU), 0);
+			pDevice->UploadBufferData(m_ViewBuffer, &m_Scene.m_ViewData, sizeof(ViewDataGPU), 0);
 		}
 
-		// Collect and upload scene lights
+		// Collect scene lights
 		//-----------------------------------------------------------------------------
 
-		m_Scene.m_LightsData.m_Size.x = 0;
+		// Written straight to the copy of the buffer of this frame, the GPU isn't using it anymore
+		LightsDataGPU& lightsData = *static_cast<LightsDataGPU*>(pDevice->GetBufferMappedPtr(m_LightsBuffer));
+		lightsData.m_Size.x = 0;
 		int idx = 0;
-		for (auto pointLight : pEntities->GetSingleCompIter<PointLightComponent>()) {
-			m_Scene.m_LightsData.m_PointLights[idx].m_ViewSpacePosition = m_Scene.m_ViewData.m_View
+		for (PointLightComponent const& pointLight : world.m_PointLights) {
+			lightsData.m_PointLights[idx].m_ViewSpacePosition = m_Scene.m_ViewData.m_View
 					* Vec4(
-						pointLight->m_Position, 1.0f);
-			m_Scene.m_LightsData.m_PointLights[idx].m_Radiance = Vec4(pointLight->m_Radiance, 0.0f);
-			m_Scene.m_LightsData.m_Size.x++;
+						pointLight.m_Position, 1.0f);
+			lightsData.m_PointLights[idx].m_Radiance = Vec4(pointLight.m_Radiance, 0.0f);
+			lightsData.m_Size.x++;
 			idx++;
 		}
-		pDevice->UploadBufferData_DEPR(m_LightsBuffer, &m_Scene.m_LightsData,
-		                               sizeof(Vec4) + sizeof(PointLightGPU) * idx, 0);
+	}
+
+	void RenderSceneManager::CullObjects(TaskSystem& taskSystem) {
+		m_Culling.Cull(taskSystem, Frustum::FromViewProj(m_Scene.m_ViewData.m_ViewProj));
 	}
 
 	void RenderSceneManager::CleanupGPUBuffers(RenderDevice* pDevice) {
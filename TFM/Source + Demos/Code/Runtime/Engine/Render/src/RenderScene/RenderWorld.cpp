@@ -0,0 +1,53 @@
+#include "RenderScene/RenderWorld.h"
+
+#include "CookieKat/Core/Profilling/Profilling.h"
+#include "CookieKat/Systems/ECS/EntityDatabase.h"
+
+namespace CKE {
+	void RenderWorld::Clear() {
+		m_ChangedTransforms.clear();
+		m_ChangedMeshes.clear();
+		m_RemovedObjects.clear();
+		m_PointLights.clear();
+		m_HasCamera = false;
+	}
+
+	void RenderWorldExtractor::Extract(EntityDatabase& entities, RenderWorld& outWorld) {
+		CKE_PROFILE_EVENT();
+
+		if (!m_ChangedObjectsQuery.IsInitialized()) {
+			m_ChangedObjectsQuery.Initialize(entities);
+			entities.TrackRemovedComponents<MeshComponent>();
+		}
+
+		outWorld.Clear();
+
+		for (MeshComponent const& mesh : entities.GetRemovedComponents<MeshComponent>()) {
+			outWorld.m_RemovedObjects.push_back(mesh.m_ObjectIdx);
+		}
+		entities.ClearRemovedComponents<MeshComponent>();
+
+		using ObjectsChunk = QueryChunk<Read<LocalToWorldComponent>, Read<MeshComponent>,
+		                                Changed<LocalToWorldComponent>, Changed<MeshComponent>>;
+		m_ChangedObjectsQuery.ForEachChunk([&](ObjectsChunk const& chunk) {
+			Span<LocalToWorldComponent const> transforms = chunk.GetColumn<LocalToWorldComponent>();
+			Span<MeshComponent const>         meshes = chunk.GetColumn<MeshComponent>();
+			outWorld.m_ChangedTransforms.insert(outWorld.m_ChangedTransforms.end(), transforms.begin(), transforms.end());
+			outWorld.m_ChangedMeshes.insert(outWorld.m_ChangedMeshes.end(), meshes.begin(), meshes.end());
+		});
+
+		// Lights are uploaded every frame, so all of them are copied
+		entities.GetQuery<Read<PointLightComponent>>().ForEachChunk([&](auto const& chunk) {
+			Span<PointLightComponent const> lights = chunk.template GetColumn<PointLightComponent>();
+			outWorld.m_PointLights.insert(outWorld.m_PointLights.end(), lights.begin(), lights.end());
+		});
+
+		// The last camera of the world is the one used to render
+		entities.GetQuery<Read<CameraComponent>>().ForEachChunk([&](auto const& chunk) {
+			Span<CameraComponent const> cameras = chunk.template GetColumn<CameraComponent>();
+			if (cameras.empty()) { return; }
+			outWorld.m_Camera = cameras.back();
+			outWorld.m_HasCamera = true;
+		});
+	}
+}
@@ -0,0 +1,85 @@
+#include "RenderScene/SceneCulling.h"
+
+#include "CookieKat/Core/Profilling/Profilling.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace CKE {
+	void SceneCulling::Initialize(u32 maxObjects) {
+		m_ObjectDrawInfos.resize(maxObjects);
+		m_ObjectWorldBounds.Resize(maxObjects);
+		m_SlotInUse.resize(maxObjects, false);
+		m_VisibleObjects.resize(maxObjects);
+		m_NumVisiblePerGroup.resize((maxObjects + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE);
+	}
+
+	void SceneCulling::SetObject(u32 objectIdx, ObjectDrawInfo const& drawInfo, AABB const& worldBounds) {
+		CKE_ASSERT(objectIdx < m_SlotInUse.size());
+		m_ObjectDrawInfos[objectIdx] = drawInfo;
+		m_ObjectWorldBounds.Set(objectIdx, worldBounds);
+		m_SlotInUse[objectIdx] = true;
+		m_NumObjectSlots = std::max(m_NumObjectSlots, objectIdx + 1);
+	}
+
+	void SceneCulling::RemoveObject(u32 objectIdx) {
+		CKE_ASSERT(objectIdx < m_SlotInUse.size());
+		m_ObjectDrawInfos[objectIdx] = ObjectDrawInfo{};
+		m_ObjectWorldBounds.SetEmpty(objectIdx);
+		m_SlotInUse[objectIdx] = false;
+
+		// Trailing free slots don't need to be culled
+		while (m_NumObjectSlots > 0 && !m_SlotInUse[m_NumObjectSlots - 1]) {
+			m_NumObjectSlots--;
+		}
+	}
+
+	void SceneCulling::Cull(TaskSystem& taskSystem, Frustum const& frustum) {
+		CKE_PROFILE_EVENT();
+
+		// Each partition culls whole groups, so every group can write its visible objects
+		// to its own slots of the list without any synchronization
+		struct CullingTaskSet : public ITaskSet
+		{
+			Frustum             m_Frustum;
+			BoundsStream const* m_pBounds = nullptr;
+			u32                 m_NumObjects = 0;
+			u32*                m_pVisibleObjects = nullptr;
+			u32*                m_pNumVisiblePerGroup = nullptr;
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+				for (u32 group = range.start; group < range.end; ++group) {
+					u32 const first = group * CULLING_GROUP_SIZE;
+					u32 const last = std::min(first + CULLING_GROUP_SIZE, m_NumObjects);
+					m_pNumVisiblePerGroup[group] = CullBounds(m_Frustum, *m_pBounds, first, last,
+					                                          m_pVisibleObjects + first);
+				}
+			}
+		};
+
+		m_NumVisibleObjects = 0;
+		if (m_NumObjectSlots == 0) { return; }
+
+		u32 const      numGroups = (m_NumObjectSlots + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+		CullingTaskSet taskSet{};
+		taskSet.m_Frustum = frustum;
+		taskSet.m_pBounds = &m_ObjectWorldBounds;
+		taskSet.m_NumObjects = m_NumObjectSlots;
+		taskSet.m_pVisibleObjects = m_VisibleObjects.data();
+		taskSet.m_pNumVisiblePerGroup = m_NumVisiblePerGroup.data();
+		taskSet.m_SetSize = numGroups;
+		taskSet.m_MinRange = taskSystem.GetMinRangeForEvenSplit(numGroups);
+
+		taskSystem.ScheduleTask(&taskSet);
+		taskSystem.WaitForTask(&taskSet);
+
+		// Compact the groups, they only move towards the start of the list so a group never overwrites a later one
+		for (u32 group = 0; group < numGroups; ++group) {
+			u32 const numGroupVisible = m_NumVisiblePerGroup[group];
+			memmove(m_VisibleObjects.data() + m_NumVisibleObjects, m_VisibleObjects.data() + group * CULLING_GROUP_SIZE,
+			        numGroupVisible * sizeof(u32));
+			m_NumVisibleObjects += numGroupVisible;
+		}
+	}
+}
@@ -134,7 +134,7 @@ namespace CKE {
 
 		RenderPassInitCtx initCtx{
 			&m_Device, &m_SamplerCache, m_pResources, m_pEntitySystem->GetEntityDatabase(),
-			&m_RenderSceneManager.m_RenderingViewSettings, &m_PipelineManager
+			&m_RenderSceneManager.m_RenderingViewSettings, &m_PipelineManager, &m_RenderQueue
 		};
 		m_DepthPass = CKE::New<DepthPrePass>();
 		m_DepthPass->Initialize(&initCtx);
@@ -160,7 +160,7 @@ namespace CKE {
 		// Setup FrameGraph
 		//-----------------------------------------------------------------------------
 
-		m_FrameGraph.Initialize(&m_Device);
+		m_FrameGraph.Initialize(&m_Device, m_pTaskSystem);
 		m_FrameGraph.AddGraphicsPass(m_DepthPass);
 		m_FrameGraph.AddGraphicsPass(m_GBufferPass);
 		m_FrameGraph.AddGraphicsPass(m_SSAOPass);
@@ -196,15 +196,23 @@ namespace CKE {
 	void RenderingSystem::RenderFrame() {
 		CKE_PROFILE_EVENT();
 
+		if (!m_HasRenderWorld) { return; }
+		RenderWorld const& world = m_RenderWorlds[m_ExtractedWorldIdx ^ 1];
+
 		m_Device.AcquireNextBackBuffer();
 
 		// Update rendering buffers and config
-		m_RenderSceneManager.CopySceneDataFromEntityWorld(&m_Device, m_pEntitySystem->GetEntityDatabase());
+		m_RenderSceneManager.CopySceneDataFromRenderWorld(&m_Device, world, m_pResources);
+		m_RenderSceneManager.CullObjects(*m_pTaskSystem);
+		m_RenderQueue.Build(m_RenderSceneManager.GetCulling());
 		m_RenderSceneManager.SetRenderingViewSettings(RenderingSettings{
 			m_Device.GetBackBufferSize(),
 			ViewportData{Vec2{0.0f}, m_Device.GetBackBufferSize()}
 		});
 
+		// Copies of the data uploaded since the last frame go before the passes that read it
+		m_Device.SubmitUploads();
+
 		// Update BackBuffer texture reference and execute the FrameGraph
 		m_FrameGraph.UpdateImportedTexture(GetBackBufferImportedDesc(&m_Device));
 		m_FrameGraph.Execute(
@@ -222,6 +230,15 @@ namespace CKE {
 		}
 	}
 
+	void RenderingSystem::ExtractRenderWorld() {
+		m_RenderWorldExtractor.Extract(*m_pEntitySystem->GetEntityDatabase(), m_RenderWorlds[m_ExtractedWorldIdx]);
+	}
+
+	void RenderingSystem::SwapRenderWorlds() {
+		m_ExtractedWorldIdx ^= 1;
+		m_HasRenderWorld = true;
+	}
+
 	void RenderingSystem::Shutdown() {
 		m_Device.WaitForDevice();
 		m_FrameGraph.Shutdown();
@@ -0,0 +1,101 @@
+#include "CookieKat/Engine/Render/RenderScene/RenderQueue.h"
+#include "CookieKat/Engine/Render/RenderScene/RenderWorld.h"
+#include "CookieKat/Engine/Render/RenderScene/SceneCulling.h"
+#include "CookieKat/Systems/ECS/EntityDatabase.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <gtest/gtest.h>
+
+using namespace CKE;
+
+class RenderSceneTest : public testing::Test
+{
+protected:
+	void SetUp() override {
+		m_TaskSystem.Initialize();
+		m_EntityDB.Initialize(MAX_OBJECTS);
+		m_EntityDB.RegisterComponent<LocalToWorldComponent>();
+		m_EntityDB.RegisterComponent<MeshComponent>();
+		m_EntityDB.RegisterComponent<PointLightComponent>();
+		m_EntityDB.RegisterComponent<CameraComponent>();
+		m_Culling.Initialize(MAX_OBJECTS);
+	}
+
+	void TearDown() override {
+		m_EntityDB.Shutdown();
+		m_TaskSystem.Shutdown();
+	}
+
+	// Object in front of the camera, every object has a different material so each one is its own batch
+	EntityID CreateObject(u64 objectIdx) {
+		TResourceID<MeshResource>           meshID{1};
+		TResourceID<RenderMaterialResource> materialID{objectIdx};
+		Mat4 const l2w = glm::translate(Mat4{1.0f}, Vec3{static_cast<f32>(objectIdx), 0.0f, -10.0f});
+		return m_EntityDB.CreateEntityWith(LocalToWorldComponent{l2w}, MeshComponent{meshID, materialID, objectIdx});
+	}
+
+	// Extracts the world and updates the culling like RenderSceneManager does, with a unit box as the mesh bounds
+	// Returns the object indices (1 based) of the emitted draws
+	Vector<u64> RenderFrame() {
+		m_Extractor.Extract(m_EntityDB, m_World);
+
+		for (u64 objectIdx : m_World.m_RemovedObjects) {
+			m_Culling.RemoveObject(static_cast<u32>(objectIdx - 1));
+		}
+		for (u64 i = 0; i < m_World.m_ChangedMeshes.size(); ++i) {
+			MeshComponent const& mesh = m_World.m_ChangedMeshes[i];
+			u32 const            objectIdx = static_cast<u32>(mesh.m_ObjectIdx - 1);
+			AABB const           bounds = AABB::FromCenterExtents(Vec3{0.0f}, Vec3{0.5f});
+			m_Culling.SetObject(objectIdx, ObjectDrawInfo{mesh.m_MeshID, mesh.m_MaterialID, 0, objectIdx},
+			                    bounds.Transform(m_World.m_ChangedTransforms[i].m_LocalToWorld));
+		}
+
+		Mat4 const view = glm::lookAt(Vec3{0.0f}, Vec3{0.0f, 0.0f, -1.0f}, Vec3{0.0f, 1.0f, 0.0f});
+		Mat4 const proj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f);
+		m_Culling.Cull(m_TaskSystem, Frustum::FromViewProj(proj * view));
+		m_Queue.Build(m_Culling);
+
+		Vector<u64> drawn;
+		for (DrawBatch const& batch : m_Queue.GetBatches()) {
+			for (u32 i = 0; i < batch.m_NumInstances; ++i) {
+				drawn.push_back(batch.m_FirstObject + i + 1);
+			}
+		}
+		return drawn;
+	}
+
+	static constexpr u32 MAX_OBJECTS = 100;
+	TaskSystem           m_TaskSystem{};
+	EntityDatabase       m_EntityDB{};
+	RenderWorldExtractor m_Extractor{};
+	RenderWorld          m_World{};
+	SceneCulling         m_Culling{};
+	RenderQueue          m_Queue{};
+};
+
+TEST_F(RenderSceneTest, DeletedObjectsAreNotDrawn) {
+	EntityID e1 = CreateObject(1);
+	EntityID e2 = CreateObject(2);
+	EntityID e3 = CreateObject(3);
+	EXPECT_EQ(RenderFrame(), (Vector<u64>{1, 2, 3}));
+	EXPECT_EQ(m_Culling.GetNumObjectSlots(), 3);
+
+	m_EntityDB.DeleteEntity(e2);
+	EXPECT_EQ(RenderFrame(), (Vector<u64>{1, 3}));
+	EXPECT_EQ(m_Culling.GetNumObjectSlots(), 3);
+
+	// Removing the mesh removes the object too, the trailing free slots are not culled anymore
+	m_EntityDB.RemoveComponent<MeshComponent>(e3);
+	EXPECT_EQ(RenderFrame(), (Vector<u64>{1}));
+	EXPECT_EQ(m_Culling.GetNumObjectSlots(), 1);
+
+	// A new object can reuse the index of a removed one in the same frame
+	m_EntityDB.DeleteEntity(e1);
+	CreateObject(1);
+	EXPECT_EQ(RenderFrame(), (Vector<u64>{1}));
+	EXPECT_EQ(m_Culling.GetNumObjectSlots(), 1);
+
+	m_EntityDB.DeleteEntity(m_EntityDB.CreateEntity());
+	EXPECT_EQ(RenderFrame(), (Vector<u64>{1}));
+}
@@ -6,8 +6,12 @@ namespace CKE {
 	class MaterialLoader : public CompiledResourcesLoader
 	{
 	public:
+		static constexpr u32 DATA_VERSION = 1;
+
 		LoadResult LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const override;
+		u32        GetDataVersion() const override { return DATA_VERSION; }
 		LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) override;
+		LoadResult Unload(LoaderContext& ctx) const override;
 
 		Vector<ResourceTypeID> GetLoadableTypes() override { return{ ResourceTypeID("mat") }; }
 	};
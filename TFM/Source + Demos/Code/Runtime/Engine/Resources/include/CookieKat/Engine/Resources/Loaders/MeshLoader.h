@@ -11,10 +11,20 @@ namespace CKE
 	public:
 		void Initialize(RenderDevice* pRenderDevice);
 
+		// Imports a source mesh (.fbx, .obj) with Assimp
 		LoadResult Load(LoaderContext& ctx, Blob& binarySource) const override;
+
+		// Loads a compiled mesh (.mesh), the vertex and index streams are used from the mapped file as they are
+		LoadResult LoadMapped(LoaderContext& ctx, MappedFile file) const override;
+		bool       LoadsFromMappedFile(Path const& resourcePath) const override;
+
 		LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) override;
+		LoadResult Uninstall(LoaderContext& ctx) override;
+		LoadResult Unload(LoaderContext& ctx) const override;
 
-		Vector<ResourceTypeID> GetLoadableTypes() override { return{ ResourceTypeID("fbx"), ResourceTypeID("obj")}; }
+		Vector<ResourceTypeID> GetLoadableTypes() override {
+			return{ ResourceTypeID("mesh"), ResourceTypeID("fbx"), ResourceTypeID("obj")};
+		}
 
 	private:
 		RenderDevice* m_pDevice = nullptr;
@@ -9,11 +9,15 @@ namespace CKE {
 	class TextureLoader : public CompiledResourcesLoader
 	{
 	public:
+		static constexpr u32 DATA_VERSION = 1;
+
 		void Initialize(RenderDevice* pRenderDevice);
 
 		LoadResult LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const override;
+		u32        GetDataVersion() const override { return DATA_VERSION; }
 		LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) override;
 		LoadResult Uninstall(LoaderContext& ctx) override;
+		LoadResult Unload(LoaderContext& ctx) const override;
 
 		Vector<ResourceTypeID> GetLoadableTypes() override { return {ResourceTypeID("tex")}; }
 
@@ -24,11 +28,15 @@ namespace CKE {
 	class CubeMapLoader : public CompiledResourcesLoader
 	{
 	public:
+		static constexpr u32 DATA_VERSION = 1;
+
 		void Initialize(RenderDevice* pRenderDevice);
 
 		LoadResult LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const override;
+		u32        GetDataVersion() const override { return DATA_VERSION; }
 		LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) override;
 		LoadResult Uninstall(LoaderContext& ctx) override;
+		LoadResult Unload(LoaderContext& ctx) const override;
 
 		Vector<ResourceTypeID> GetLoadableTypes() override { return {ResourceTypeID("cubeMap")}; }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "CookieKat/Core/Math/Math.h"
+#include "CookieKat/Core/Math/Bounds.h"
 #include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/FileSystem/FileSystem.h"
 #include "CookieKat/Systems/Resources/IResource.h"
 #include "CookieKat/Systems/RenderAPI/RenderHandle.h"
 
@@ -38,6 +40,49 @@ namespace CKE {
 }
 
 namespace CKE {
+	// Range of the index buffer that belongs to one of the meshes of the source file
+	// The indices already point to the shared vertex buffer
+	struct SubMesh
+	{
+		u32 m_FirstIndex = 0;
+		u32 m_NumIndices = 0;
+	};
+
+	// Header of the compiled mesh files (.mesh)
+	//
+	// File layout:
+	//   MeshFileHeader | SubMesh[m_NumSubMeshes] | padding | vertices | padding | indices
+	//
+	// The vertex and index streams start at page aligned offsets, so once the file is mapped
+	// they can be handed to the buffer creation as they are without any parsing or copies
+	struct MeshFileHeader
+	{
+		static constexpr u32 MAGIC = 0x48534D43; // "CMSH"
+		static constexpr u32 VERSION = 2;
+		static constexpr u64 STREAM_ALIGNMENT = 4096;
+
+		u32 m_Magic = MAGIC;
+		u32 m_Version = VERSION;
+		u32 m_VertexStride = sizeof(Vertex_3P3N3T2Tc);
+		u32 m_IndexStride = sizeof(u32);
+		u32 m_NumVertices = 0;
+		u32 m_NumIndices = 0;
+		u32 m_NumSubMeshes = 0;
+		u32 m_Padding = 0;
+		u64 m_SubMeshesOffset = 0;
+		u64 m_VertexDataOffset = 0;
+		u64 m_IndexDataOffset = 0;
+		Vec3 m_BoundsMin{0.0f}; // Bounds of all the vertices in the mesh space
+		Vec3 m_BoundsMax{0.0f};
+
+		inline bool IsValid() const {
+			return m_Magic == MAGIC && m_Version == VERSION
+					&& m_VertexStride == sizeof(Vertex_3P3N3T2Tc) && m_IndexStride == sizeof(u32);
+		}
+	};
+
+	//-----------------------------------------------------------------------------
+
 	class MeshResource : public IResource
 	{
 		friend MeshLoader;
@@ -46,13 +91,29 @@ namespace CKE {
 		inline Vector<Vertex_3P3N3T2Tc> const& GetVertices() const { return m_Vertices; }
 		inline Vector<u32> const&              GetIndices() const { return m_Indices; }
 
+		inline u32                    GetNumVertices() const { return m_NumVertices; }
+		inline u32                    GetNumIndices() const { return m_NumIndices; }
+		inline Vector<SubMesh> const& GetSubMeshes() const { return m_SubMeshes; }
+
+		// Bounds of the vertices in the mesh space
+		inline AABB const& GetBounds() const { return m_Bounds; }
+
 		inline BufferHandle const& GetVertexBuffer() const { return m_VertexBufferHandle; }
 		inline BufferHandle const& GetIndexBuffer() const { return m_IndexBufferHandle; }
 
 	private:
 		// Triangle Mesh Data
+		// Only kept in memory for meshes imported from source files (.fbx, .obj), the data
+		// of compiled meshes is read from the mapped file and only lives in the GPU buffers
 		Vector<Vertex_3P3N3T2Tc> m_Vertices;
 		Vector<u32>              m_Indices;
+		u32                      m_NumVertices = 0;
+		u32                      m_NumIndices = 0;
+		Vector<SubMesh>          m_SubMeshes;
+		AABB                     m_Bounds;
+
+		// Compiled file, mapped from the load until the buffers have been created
+		MappedFile m_SourceFile;
 
 		// Render Resources
 		BufferHandle m_VertexBufferHandle;
@@ -33,7 +33,7 @@ namespace CKE {
 		TextureViewHandle    m_TextureView;
 		u32                  m_FaceWidth{};
 		u32                  m_FaceHeight{};
-		Array<Vector<u8>, 6> m_Faces{};
+		Array<Vector<u8>, 6> m_Faces{}; // RGBA8 pixels of each face, compressed in the compiled file
 	};
 }
 
@@ -52,6 +52,8 @@ namespace CKE {
 		inline TextureDesc const&       GetTextureDesc() const { return m_Desc; }
 
 	private:
+		// Pixels of all the mips packed one after the other, the compiled file stores
+		// them compressed and the loader replaces them with the decompressed data
 		Blob        m_Data{};
 		TextureDesc m_Desc{};
 
@@ -20,6 +20,15 @@ namespace CKE {
 		material->m_MetalicTexture = dependencies.GetInstallDependency<RenderTextureResource>(material->m_MetalicTexture.m_Value);
 		material->m_NormalTexture = dependencies.GetInstallDependency<RenderTextureResource>(material->m_NormalTexture.m_Value);
 
+		// The textures are accounted separately
+		ctx.SetMemoryUsage(sizeof(RenderMaterialResource), 0);
+
+		return LoadResult::Successful;
+	}
+
+	LoadResult MaterialLoader::Unload(LoaderContext& ctx) const {
+		auto material = ctx.GetResource<RenderMaterialResource>();
+		Delete(material);
 		return LoadResult::Successful;
 	}
 }
@@ -48,6 +48,7 @@ namespace CKE {
 				Vec2(texCoord.x, texCoord.y)
 			};
 			meshResource->m_Vertices.push_back(vert);
+			meshResource->m_Bounds.AddPoint(vert.m_Position);
 		}
 
 		u32 const numIndices = aiMesh->mNumFaces * 3;
@@ -59,6 +60,10 @@ namespace CKE {
 			}
 		}
 
+		meshResource->m_NumVertices = static_cast<u32>(meshResource->m_Vertices.size());
+		meshResource->m_NumIndices = static_cast<u32>(meshResource->m_Indices.size());
+		meshResource->m_SubMeshes.push_back(SubMesh{0, meshResource->m_NumIndices});
+
 		// Set texture dependencies
 		//-----------------------------------------------------------------------------
 
@@ -66,28 +71,109 @@ namespace CKE {
 		return LoadResult::Successful;
 	}
 
+	LoadResult MeshLoader::LoadMapped(LoaderContext& ctx, MappedFile file) const {
+		u64 const fileSize = file.GetSizeInBytes();
+		if (fileSize < sizeof(MeshFileHeader) ||
+			!reinterpret_cast<MeshFileHeader const*>(file.GetData())->IsValid()) {
+			printf("ERROR: [%s] is not a compiled mesh or was compiled with an older format\n",
+			       ctx.GetAssetPath().c_str());
+			return LoadResult::Failed;
+		}
+		MeshFileHeader const& header = *reinterpret_cast<MeshFileHeader const*>(file.GetData());
+
+		// A truncated file would be read out of bounds when creating the buffers
+		auto isInFile = [fileSize](u64 offset, u64 sizeInBytes) {
+			return offset <= fileSize && sizeInBytes <= fileSize - offset;
+		};
+		if (header.m_SubMeshesOffset % alignof(SubMesh) != 0 ||
+			!isInFile(header.m_SubMeshesOffset, header.m_NumSubMeshes * sizeof(SubMesh)) ||
+			!isInFile(header.m_VertexDataOffset, header.m_NumVertices * sizeof(Vertex_3P3N3T2Tc)) ||
+			!isInFile(header.m_IndexDataOffset, header.m_NumIndices * sizeof(u32))) {
+			printf("ERROR: The streams of [%s] are outside of the file\n", ctx.GetAssetPath().c_str());
+			return LoadResult::Failed;
+		}
+
+		SubMesh const* pSubMeshes = reinterpret_cast<SubMesh const*>(file.GetData() + header.m_SubMeshesOffset);
+		for (u32 i = 0; i < header.m_NumSubMeshes; ++i) {
+			SubMesh const& subMesh = pSubMeshes[i];
+			if (subMesh.m_FirstIndex > header.m_NumIndices ||
+				subMesh.m_NumIndices > header.m_NumIndices - subMesh.m_FirstIndex) {
+				printf("ERROR: The submeshes of [%s] are outside of the index stream\n", ctx.GetAssetPath().c_str());
+				return LoadResult::Failed;
+			}
+		}
+
+		auto meshResource = New<MeshResource>();
+		meshResource->m_NumVertices = header.m_NumVertices;
+		meshResource->m_NumIndices = header.m_NumIndices;
+		meshResource->m_SubMeshes.assign(pSubMeshes, pSubMeshes + header.m_NumSubMeshes);
+		meshResource->m_Bounds = AABB{header.m_BoundsMin, header.m_BoundsMax};
+
+		// The streams are read from the mapping when the buffers are created
+		meshResource->m_SourceFile = std::move(file);
+
+		ctx.SetResource(meshResource);
+		return LoadResult::Successful;
+	}
+
+	bool MeshLoader::LoadsFromMappedFile(Path const& resourcePath) const {
+		return resourcePath.ends_with(".mesh");
+	}
+
 	LoadResult MeshLoader::Install(LoaderContext& ctx, InstallDependencies& dependencies) {
 		auto meshResource = ctx.GetResource<MeshResource>();
 
+		// Compiled meshes upload the streams directly from the mapped file
+		void const* pVertexData = meshResource->m_Vertices.data();
+		void const* pIndexData = meshResource->m_Indices.data();
+		if (meshResource->m_SourceFile.IsValid()) {
+			MeshFileHeader const& header = *reinterpret_cast<MeshFileHeader const*>(meshResource->m_SourceFile.
+				GetData());
+			pVertexData = meshResource->m_SourceFile.GetData() + header.m_VertexDataOffset;
+			pIndexData = meshResource->m_SourceFile.GetData() + header.m_IndexDataOffset;
+		}
+
 		BufferDesc vertexBufferDesc;
 		vertexBufferDesc.m_Usage = BufferUsage::Vertex | BufferUsage::TransferDst;
 		vertexBufferDesc.m_MemoryAccess = MemoryAccess::GPU;
-		vertexBufferDesc.m_SizeInBytes = meshResource->m_Vertices.size() * sizeof(meshResource->
-			m_Vertices[0]);
-		vertexBufferDesc.m_StrideInBytes = sizeof(meshResource->m_Vertices[0]);
-		meshResource->m_VertexBufferHandle = m_pDevice->CreateBuffer_DEPR(vertexBufferDesc,
-			meshResource->m_Vertices.data(),
-			vertexBufferDesc.m_SizeInBytes);
+		vertexBufferDesc.m_SizeInBytes = meshResource->m_NumVertices * sizeof(Vertex_3P3N3T2Tc);
+		vertexBufferDesc.m_StrideInBytes = sizeof(Vertex_3P3N3T2Tc);
+		meshResource->m_VertexBufferHandle = m_pDevice->CreateBuffer(vertexBufferDesc);
+		m_pDevice->UploadBufferData(meshResource->m_VertexBufferHandle, pVertexData,
+		                            vertexBufferDesc.m_SizeInBytes, 0);
 
 		BufferDesc indexBufferDesc;
 		indexBufferDesc.m_Usage = BufferUsage::Index | BufferUsage::TransferDst;
 		indexBufferDesc.m_MemoryAccess = MemoryAccess::GPU;
-		indexBufferDesc.m_SizeInBytes = meshResource->m_Indices.size() * sizeof(u32);
+		indexBufferDesc.m_SizeInBytes = meshResource->m_NumIndices * sizeof(u32);
 		indexBufferDesc.m_StrideInBytes = sizeof(u32);
-		meshResource->m_IndexBufferHandle = m_pDevice->CreateBuffer_DEPR(indexBufferDesc,
-			meshResource->m_Indices.data(),
-			indexBufferDesc.m_SizeInBytes);
+		meshResource->m_IndexBufferHandle = m_pDevice->CreateBuffer(indexBufferDesc);
+		m_pDevice->UploadBufferData(meshResource->m_IndexBufferHandle, pIndexData,
+		                            indexBufferDesc.m_SizeInBytes, 0);
+
+		// The data is already in the upload buffer, it reaches the GPU buffers with the next frame
+		meshResource->m_SourceFile.Reset();
+
+		u64 const cpuSizeInBytes = sizeof(MeshResource) +
+				meshResource->m_Vertices.size() * sizeof(Vertex_3P3N3T2Tc) +
+				meshResource->m_Indices.size() * sizeof(u32) +
+				meshResource->m_SubMeshes.size() * sizeof(SubMesh);
+		u64 const gpuSizeInBytes = static_cast<u64>(vertexBufferDesc.m_SizeInBytes) + indexBufferDesc.m_SizeInBytes;
+		ctx.SetMemoryUsage(cpuSizeInBytes, gpuSizeInBytes);
+
+		return LoadResult::Successful;
+	}
 
+	LoadResult MeshLoader::Uninstall(LoaderContext& ctx) {
+		auto meshResource = ctx.GetResource<MeshResource>();
+		m_pDevice->DestroyBuffer(meshResource->m_VertexBufferHandle);
+		m_pDevice->DestroyBuffer(meshResource->m_IndexBufferHandle);
+		return LoadResult::Successful;
+	}
+
+	LoadResult MeshLoader::Unload(LoaderContext& ctx) const {
+		auto meshResource = ctx.GetResource<MeshResource>();
+		Delete(meshResource);
 		return LoadResult::Successful;
 	}
 }
@@ -28,6 +28,9 @@ namespace CKE {
 		pPipeline->m_PipelineLayoutDesc = layoutDesc;
 		pPipeline->m_VertexInputLayoutDesc = ShaderReflectionUtils::ReflectVertexInput(pPipeline->GetVertSource());
 
+		ctx.SetMemoryUsage(sizeof(PipelineResource) + pPipeline->m_VertShaderSource.size() +
+		                   pPipeline->m_FragShaderSource.size(), 0);
+
 		return LoadResult::Successful;
 	}
 
@@ -36,4 +39,10 @@ namespace CKE {
 		m_pRenderDevice->DestroyPipelineLayout(pPipeline->m_PipelineLayout);
 		return LoadResult::Successful;
 	}
+
+	LoadResult PipelineLoader::Unload(LoaderContext& ctx) const {
+		PipelineResource* pPipeline = ctx.GetResource<PipelineResource>();
+		Delete(pPipeline);
+		return LoadResult::Successful;
+	}
 }
@@ -1,10 +1,9 @@
 #include "Loaders/TextureLoader.h"
 
 #include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Compression/Compression.h"
 #include "CookieKat/Engine/Resources/Resources/RenderTextureResource.h"
 
-#include <lodepng.h>
-
 #include "CookieKat/Systems/RenderUtils/TextureUploader.h"
 
 namespace CKE {
@@ -14,7 +13,19 @@ namespace CKE {
 
 	LoadResult TextureLoader::LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const {
 		auto pTexture = New<RenderTextureResource>();
-		ar << *pTexture;
+
+		// Same layout as RenderTextureResource::Serialize, but the compressed mips are
+		// read in place from the file data instead of being copied first
+		Span<u8 const> compressedMipChain;
+		ar << compressedMipChain << pTexture->m_Desc;
+
+		// Decompress the mip chain here so the install only has to copy it to the GPU
+		TextureDesc const& desc = pTexture->m_Desc;
+		pTexture->m_Data.resize(TextureUploader::GetMipChainSizeInBytes(UInt2{desc.m_Size.x, desc.m_Size.y},
+		                                                                sizeof(u32), desc.m_MipLevels));
+		bool const decompressed = Compression::Decompress(compressedMipChain, pTexture->m_Data);
+		CKE_ASSERT(decompressed); // The texture data is corrupted or was compiled with an older format
+
 		ctx.SetResource(pTexture);
 		return  LoadResult::Successful;
 	}
@@ -22,10 +33,8 @@ namespace CKE {
 	LoadResult TextureLoader::Install(LoaderContext& ctx, InstallDependencies& dependencies) {
 		auto pTexture = ctx.GetResource<RenderTextureResource>();
 
-		// When we load the texture its data is loaded as a blob,
-		// we have to initializes the pointer to that blob in the texture desc
-
 		UInt3 texSize = pTexture->m_Desc.m_Size;
+		u32   numMips = pTexture->m_Desc.m_MipLevels;
 
 		// Allocate and create texture in GPU
 		TextureDesc texDesc{};
@@ -33,20 +42,19 @@ namespace CKE {
 		texDesc.m_AspectMask = TextureAspectMask::Color;
 		texDesc.m_TextureType = TextureType::Tex2D;
 		texDesc.m_Format = pTexture->m_Desc.m_Format;
+		texDesc.m_MipLevels = numMips;
 		TextureHandle texHandle = m_pRenderDevice->CreateTexture(texDesc);
 		pTexture->m_TextureHandle = texHandle;
 
-		// Uncompress Texture
-		Vector<u8> uncompressedTexture{};
-		uncompressedTexture.reserve(texSize.x * texSize.y);
-		lodepng::decode(uncompressedTexture, texSize.x, texSize.y, pTexture->m_Data);
-
-		// Upload it to GPU
+		// Upload it to GPU, the data was already decompressed when loading it
 		TextureUploader uploader{};
-		uploader.Initialize(m_pRenderDevice, uncompressedTexture.size());
-		uploader.UploadColorTexture2D(texHandle, uncompressedTexture.data(),
-		                              UInt2{texSize.x, texSize.y}, sizeof(u32));
-		uploader.Shutdown();
+		uploader.Initialize(m_pRenderDevice);
+		uploader.UploadTexture2DMips(texHandle, pTexture->m_Data.data(), UInt2{texSize.x, texSize.y},
+		                             sizeof(u32), numMips, TextureAspectMask::Color);
+
+		// The GPU has its own copy of the texture now
+		ctx.SetMemoryUsage(sizeof(RenderTextureResource), pTexture->m_Data.size());
+		pTexture->m_Data = Blob{};
 
 		// Create Texture View of the complete texture
 		TextureViewDesc viewDesc{};
@@ -54,6 +62,7 @@ namespace CKE {
 		viewDesc.m_Texture = texHandle;
 		viewDesc.m_Type = TextureViewType::Tex2D;
 		viewDesc.m_AspectMask = TextureAspectMask::Color;
+		viewDesc.m_MipLevelCount = numMips;
 		pTexture->m_TextureView = m_pRenderDevice->CreateTextureView(viewDesc);
 
 		return LoadResult::Successful;
@@ -65,6 +74,12 @@ namespace CKE {
 		m_pRenderDevice->DestroyTexture(pTex->m_TextureHandle);
 		return LoadResult::Successful;
 	}
+
+	LoadResult TextureLoader::Unload(LoaderContext& ctx) const {
+		RenderTextureResource* pTex = ctx.GetResource<RenderTextureResource>();
+		Delete(pTex);
+		return LoadResult::Successful;
+	}
 }
 
 namespace CKE {
@@ -74,8 +89,19 @@ namespace CKE {
 	}
 
 	LoadResult CubeMapLoader::LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const {
-		auto           pCubeMapAsset = CKE::New<RenderCubeMapResource>();
-		ar << *pCubeMapAsset;
+		auto pCubeMapAsset = CKE::New<RenderCubeMapResource>();
+
+		// Same layout as RenderCubeMapResource::Serialize, the compressed faces are read in place
+		Array<Span<u8 const>, 6> compressedFaces;
+		ar << pCubeMapAsset->m_FaceWidth << pCubeMapAsset->m_FaceHeight << compressedFaces;
+
+		u64 const faceSizeInBytes = static_cast<u64>(pCubeMapAsset->m_FaceWidth) * pCubeMapAsset->m_FaceHeight * 4;
+		for (u32 i = 0; i < 6; ++i) {
+			pCubeMapAsset->m_Faces[i].resize(faceSizeInBytes);
+			bool const decompressed = Compression::Decompress(compressedFaces[i], pCubeMapAsset->m_Faces[i]);
+			CKE_ASSERT(decompressed); // The cubemap data is corrupted or was compiled with an older format
+		}
+
 		ctx.SetResource(pCubeMapAsset);
 		return LoadResult::Successful;
 	}
@@ -83,17 +109,10 @@ namespace CKE {
 	LoadResult CubeMapLoader::Install(LoaderContext& ctx, InstallDependencies& dependencies) {
 		auto cubeMap = ctx.GetResource<RenderCubeMapResource>();
 
-		Array<Vector<u8>, 6> rawTex{};
-		void*                pCubeMapPtrs[6];
+		void* pCubeMapPtrs[6];
 		for (int i = 0; i < 6; ++i) {
-			rawTex[i].reserve(cubeMap->m_FaceWidth * cubeMap->m_FaceHeight);
-			lodepng::decode(rawTex[i],
-			                cubeMap->m_FaceWidth,
-			                cubeMap->m_FaceHeight,
-			                cubeMap->m_Faces[i]);
-			pCubeMapPtrs[i] = rawTex[i].data();
+			pCubeMapPtrs[i] = cubeMap->m_Faces[i].data();
 		}
-		cubeMap->m_Faces = rawTex;
 
 		TextureDesc textureDesc{};
 		textureDesc.m_Name = "CubeMap";
@@ -105,10 +124,9 @@ namespace CKE {
 		cubeMap->m_Texture = m_pRenderDevice->CreateTexture(textureDesc);
 
 		TextureUploader uploader{};
-		uploader.Initialize(m_pRenderDevice, cubeMap->m_FaceWidth * cubeMap->m_FaceHeight * 4 * 6);
+		uploader.Initialize(m_pRenderDevice);
 		uploader.UploadTextureCubeMap(cubeMap->m_Texture, pCubeMapPtrs,
 		                              UInt2{cubeMap->m_FaceWidth, cubeMap->m_FaceWidth});
-		uploader.Shutdown();
 
 		TextureViewDesc viewDesc{
 			cubeMap->m_Texture, TextureViewType::Cube,
@@ -117,6 +135,10 @@ namespace CKE {
 		};
 		cubeMap->m_TextureView = m_pRenderDevice->CreateTextureView(viewDesc);
 
+		// The faces are kept in memory for the SH computations
+		u64 const faceSizeInBytes = static_cast<u64>(cubeMap->m_FaceWidth) * cubeMap->m_FaceHeight * 4;
+		ctx.SetMemoryUsage(sizeof(RenderCubeMapResource) + faceSizeInBytes * 6, faceSizeInBytes * 6);
+
 		return LoadResult::Successful;
 	}
 
@@ -127,4 +149,10 @@ namespace CKE {
 
 		return LoadResult::Successful;
 	}
+
+	LoadResult CubeMapLoader::Unload(LoaderContext& ctx) const {
+		auto cubeMap = ctx.GetResource<RenderCubeMapResource>();
+		Delete(cubeMap);
+		return LoadResult::Successful;
+	}
 }
@@ -33,13 +33,17 @@ namespace CKE {
 	class CubeMoverSystem : public ECSBaseSystem
 	{
 	public:
+		inline void DeclareAccess(SystemAccessData& access) override {
+			access.Write<LocalToWorldComponent>().Write<VelocityComponent>();
+		}
+
 		inline void Update(SystemUpdateContext ctx) override {
 			CKE_PROFILE_EVENT();
 
 			TaskSystem* pTaskSys = ctx.GetTaskSystem();
 
 			CubeMoverJob cubeMoverJob;
-			cubeMoverJob.Setup(ctx.GetEntityDatabase(), ctx.GetDeltaTime());
+			cubeMoverJob.Setup(ctx.GetEntityDatabase(), pTaskSys, ctx.GetDeltaTime());
 
 			pTaskSys->ScheduleTask(&cubeMoverJob);
 			pTaskSys->WaitForTask(&cubeMoverJob);
@@ -16,6 +16,10 @@ namespace CKE {
 	public:
 		Vec2 m_Rotation;
 
+		inline void DeclareAccess(SystemAccessData& access) override {
+			access.Read<InputStateComponent>().Write<CameraComponent>();
+		}
+
 		inline void Update(SystemUpdateContext ctx) override {
 			CKE_PROFILE_EVENT();
 
@@ -19,6 +19,10 @@ namespace CKE {
 	class PendulumAnimationSystem : public ECSBaseSystem
 	{
 	public:
+		inline void DeclareAccess(SystemAccessData& access) override {
+			access.Write<LocalToWorldComponent>().Write<PendulumComponent>();
+		}
+
 		inline void Update(SystemUpdateContext ctx) override {
 			CKE_PROFILE_EVENT();
 
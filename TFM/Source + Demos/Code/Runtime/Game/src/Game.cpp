@@ -34,16 +34,18 @@ inline u64 GetNextMeshObjIdx() {
 }
 
 void Game::LoadWorldResources(ResourceSystem& res) {
-	s_CerberusMesh = res.LoadResource<MeshResource>("Models/Cerberus.fbx");
-	s_CerberusMat = res.LoadResource<RenderMaterialResource>("Materials/Cerberus.mat");
-	s_SphereMesh = res.LoadResource<MeshResource>("Models/Sphere.fbx");
-	s_CubeMesh = res.LoadResource<MeshResource>("Models/Cube.fbx");
-	s_IcosphereMesh = res.LoadResource<MeshResource>("Models/Icosphere.fbx");
-	s_PlatformMesh = res.LoadResource<MeshResource>("Models/Platform.fbx");
-	s_LampBaseMesh = res.LoadResource<MeshResource>("Models/Lamp_Base.fbx");
-	s_LampLightMesh = res.LoadResource<MeshResource>("Models/Lamp_Light.fbx");
-	s_GridMesh = res.LoadResource<MeshResource>("Models/Grid.fbx");
-	s_MonkeyMesh = res.LoadResource<MeshResource>("Models/Monkey.fbx");
+	// Request everything first so the resources load in parallel
+	s_CerberusMesh = res.LoadResourceAsync<MeshResource>("Models/Cerberus.fbx");
+	s_CerberusMat = res.LoadResourceAsync<RenderMaterialResource>("Materials/Cerberus.mat");
+	s_SphereMesh = res.LoadResourceAsync<MeshResource>("Models/Sphere.fbx");
+	s_CubeMesh = res.LoadResourceAsync<MeshResource>("Models/Cube.fbx");
+	s_IcosphereMesh = res.LoadResourceAsync<MeshResource>("Models/Icosphere.fbx");
+	s_PlatformMesh = res.LoadResourceAsync<MeshResource>("Models/Platform.fbx");
+	s_LampBaseMesh = res.LoadResourceAsync<MeshResource>("Models/Lamp_Base.fbx");
+	s_LampLightMesh = res.LoadResourceAsync<MeshResource>("Models/Lamp_Light.fbx");
+	s_GridMesh = res.LoadResourceAsync<MeshResource>("Models/Grid.fbx");
+	s_MonkeyMesh = res.LoadResourceAsync<MeshResource>("Models/Monkey.fbx");
+	res.WaitForAllResources();
 }
 
 void Game::PopulateWorld(EntityDatabase& db, EntitySystem* system) {
@@ -78,6 +80,15 @@ void Game::World_StressTest(CKE::EntityDatabase& db, CKE::EntitySystem* system)
 	constexpr int_least32_t   CUBE_SIZE = 30;
 	constexpr f32 CUBE_SEPARATION = 100.0f;
 
+	// All the cubes share the same archetype, so they are spawned with a single bulk creation
+	constexpr u64 NUM_CUBES = CUBE_SIZE * CUBE_SIZE * CUBE_SIZE;
+
+	Vector<LocalToWorldComponent> transforms;
+	Vector<MeshComponent>         meshes;
+	Vector<VelocityComponent>     velocities(NUM_CUBES, VelocityComponent{Vec3{0.0f, 0.0f, 0.0f}});
+	transforms.reserve(NUM_CUBES);
+	meshes.reserve(NUM_CUBES);
+
 	MeshComponent meshComp{};
 	meshComp.m_MeshID = s_CubeMesh;
 
@@ -95,19 +106,19 @@ void Game::World_StressTest(CKE::EntityDatabase& db, CKE::EntitySystem* system)
 					Random::F32(0.0f, 1.0f)
 				};
 				meshComp.m_ObjectIdx = GetNextMeshObjIdx();
+				meshes.push_back(meshComp);
 
-				EntityID e = db.CreateEntity();
 				Mat4 model = glm::translate(Mat4(1.0f),
 				                            Vec3(CUBE_SEPARATION * (-CUBE_SIZE / 2.0f + x),
 				                                 CUBE_SEPARATION * (-CUBE_SIZE / 2.0f + y),
 				                                 CUBE_SEPARATION * (-CUBE_SIZE / 2.0f + z)));
-				db.AddComponent<LocalToWorldComponent>(e, model);
-				db.AddComponent<MeshComponent>(e, meshComp);
-				db.AddComponent<VelocityComponent>(e, Vec3{0.0f, 0.0f, 0.0f});
+				transforms.push_back(LocalToWorldComponent{model});
 			}
 		}
 	}
 
+	db.CreateEntitiesWith(NUM_CUBES, transforms.data(), meshes.data(), velocities.data());
+
 	db.PrintAdminState();
 }
 
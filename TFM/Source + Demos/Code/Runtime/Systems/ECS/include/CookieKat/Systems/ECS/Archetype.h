@@ -3,11 +3,67 @@
 #include "CookieKat/Core/Containers/Containers.h"
 
 #include "IDs.h"
-#include "ComponentArray.h"
+#include "ChunkPool.h"
+
+#include <algorithm>
 
 namespace CKE {
+	// Copy of a single component column executed when an entity
+	// changes from one archetype to another
+	struct ArchetypeColumnMove
+	{
+		ArchetypeComponentColumn m_SrcColumn;   // Column in the source archetype
+		ArchetypeComponentColumn m_DstColumn;   // Column in the target archetype
+		u64                      m_SizeInBytes; // Size of the component data
+	};
+
+	// Location in the target archetype of a component added by a transition
+	struct ArchetypeAddedComponent
+	{
+		ComponentTypeID          m_ComponentID;
+		ArchetypeComponentColumn m_Column;      // INVALID_COMPONENT_COLUMN for Tags
+		u64                      m_SizeInBytes; // 0 for Tags
+	};
+
+	// Cached edge of the archetype graph
+	// Adding or removing a given set of components to an archetype always leads
+	// to the same target archetype, so we store the target together with the precomputed
+	// column remap table to avoid recalculating them on every structural change
+	struct ArchetypeTransition
+	{
+		Archetype*                      m_pTarget{nullptr};
+		Vector<ArchetypeColumnMove>     m_ColumnMoves{}; // Columns shared by both archetypes
+		Vector<ArchetypeAddedComponent> m_AddedComps{};  // Only used in add transitions
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Description of a component column of an archetype table
+	// The data of the column is split across all the chunks of the archetype
+	struct ArchetypeColumn
+	{
+		ComponentTypeID m_ComponentID;
+		u64             m_SizeInBytes;   // Size of each component
+		u64             m_OffsetInChunk; // Offset of the first element of the column inside each chunk
+	};
+
+	// Change versions of a component column inside a chunk, see EntityDatabase::GetChangeVersion()
+	// They are tracked per chunk instead of per row so iterating the unchanged data can be skipped
+	// without looking at it, at the cost of also reporting the unchanged rows of a changed chunk
+	struct ArchetypeColumnVersions
+	{
+		u64 m_ChangedVersion{0}; // Last time the column was written or the component added
+		u64 m_AddedVersion{0};   // Last time the component was added to an entity of the chunk
+	};
+
+	//-----------------------------------------------------------------------------
+
 	// Contains component data of all of the entities that have the exact
 	// component signature as the archetype, conceptually works as a 2D table
+	//
+	// The table is stored in fixed-size chunks, each chunk contains m_RowsPerChunk rows
+	// laid out as one array per column (Entity IDs first, then each component column).
+	// Chunks are requested from a pool when the table grows and returned when they become empty
 	class Archetype
 	{
 	public:
@@ -19,24 +75,78 @@ namespace CKE {
 
 		//-----------------------------------------------------------------------------
 
-		ArchetypeID                                m_ID{0};                 // Unique ID of the archetype
+		ArchetypeID                                    m_ID{0};                 // Unique ID of the archetype
 		Vector<ComponentTypeID>                        m_ComponentSet{};        // Unique set of component IDs used by the archetype
-		Vector<ComponentArray>                     m_ArchTable{};           // Table with the component data
-		u64                                        m_NumEntities{0};        // Number of entities in the component table
-		Vector<EntityID>                           m_RowIndexToEntity{};    // Given a row, returns the associated entity ID
+		Vector<ArchetypeColumn>                        m_ArchTable{};           // Columns of the table with component data
+		u64                                            m_NumEntities{0};        // Number of entities in the component table
+		Vector<u8*>                                    m_Chunks{};              // Memory of the table
+		u64                                            m_RowsPerChunk{0};       // Number of rows that fit in a chunk
 		Map<ComponentTypeID, ArchetypeComponentRecord> m_ArchetypeComponents{}; // Archetype Components of this archetype
 
+		Vector<ArchetypeColumnVersions> m_ColumnVersions{}; // Versions of each column, m_ArchTable.size() per chunk
+
+		ComponentSetID m_ComponentSetID{0}; // ID of the component set of the archetype
+		Vector<u64>    m_ComponentMask{};   // Bit N is set if the archetype contains the component with ID N
+
+		// Archetype graph edges, indexed by the component set ID of the target archetype
+		Map<ComponentSetID, ArchetypeTransition> m_AddEdges{};    // Transitions when adding components
+		Map<ComponentSetID, ArchetypeTransition> m_RemoveEdges{}; // Transitions when removing components
+
 	public:
+		// Adds a column for a component with data, must be called before adding any entity
+		void AddColumn(ComponentTypeID componentID, u64 sizeInBytes);
+
+		// Calculates the number of rows per chunk and the offset of each column inside the chunks
+		// Must be called after adding all of the columns
+		void CalculateChunkLayout();
+
 		// Add a new row to the archetype table
 		// Returns the index of the added row
-		u64 AddEntityRow(EntityID associatedEntity);
+		u64 AddEntityRow(EntityID associatedEntity, ChunkPool& chunkPool);
+
+		// Add a row to the archetype table for each one of the entities
+		// Returns the index of the first added row, the rest are contiguous to it
+		u64 AddEntityRows(Span<EntityID const> associatedEntities, ChunkPool& chunkPool);
 
 		// Removes the given row from the archetype table
 		// Returns the associated entity ID of the row that has been moved to fill the gap
-		EntityID RemoveEntityRow(u64 entityRow);
+		EntityID RemoveEntityRow(u64 entityRow, ChunkPool& chunkPool);
+
+		// Copies numRows contiguous elements from pSrcData into a column, starting at firstRow
+		void CopyToColumn(u64 componentColumn, u64 firstRow, u64 numRows, void const* pSrcData);
 
 		// Returns a ptr to the component data of the given position in the archetype table
 		inline void* GetComponentAt(u64 componentColumn, u64 entityRow);
+
+		// Returns the entity stored in a row of the table
+		inline EntityID GetEntityAt(u64 entityRow) const;
+
+		// Chunk access, rows inside a chunk are contiguous
+		inline u64             GetNumChunks() const { return m_Chunks.size(); }
+		inline u64             GetNumRowsInChunk(u64 chunkIndex) const;
+		inline void*           GetColumnInChunk(u64 componentColumn, u64 chunkIndex);
+		inline EntityID const* GetEntitiesInChunk(u64 chunkIndex) const;
+
+		// Change versions
+		inline ArchetypeColumnVersions&       GetColumnVersions(u64 componentColumn, u64 chunkIndex);
+		inline ArchetypeColumnVersions const& GetColumnVersions(u64 componentColumn, u64 chunkIndex) const;
+
+		// Marks the chunks that contain the rows as written at the given version
+		void MarkRowsChanged(u64 componentColumn, u64 firstRow, u64 numRows, u64 version);
+
+		// Marks the chunks that contain the rows as written and with the component added at the given version
+		void MarkRowsAdded(u64 componentColumn, u64 firstRow, u64 numRows, u64 version);
+
+		// Sets the bit of the component in the component mask
+		void AddComponentToMask(ComponentTypeID componentID);
+
+		// Checks if the component is part of the archetype component set, Tags included
+		inline bool HasComponent(ComponentTypeID componentID) const;
+
+		// Returns the table column of the component or INVALID_COMPONENT_COLUMN if
+		// the archetype doesn't have data for it
+		// Archetypes only have a handful of columns so a linear search is faster than a map lookup
+		inline ArchetypeComponentColumn GetComponentColumn(ComponentTypeID componentID) const;
 	};
 }
 
@@ -44,6 +154,54 @@ namespace CKE {
 
 namespace CKE {
 	void* Archetype::GetComponentAt(u64 componentColumn, u64 entityRow) {
-		return m_ArchTable[componentColumn].GetCompAtIndex(entityRow);
+		CKE_ASSERT(entityRow < m_NumEntities); // Trying to access a component that doesn't exist
+		ArchetypeColumn const& column = m_ArchTable[componentColumn];
+		u8*                    pChunk = m_Chunks[entityRow / m_RowsPerChunk];
+		return pChunk + column.m_OffsetInChunk + (entityRow % m_RowsPerChunk) * column.m_SizeInBytes;
+	}
+
+	EntityID Archetype::GetEntityAt(u64 entityRow) const {
+		CKE_ASSERT(entityRow < m_NumEntities);
+		u8 const* pChunk = m_Chunks[entityRow / m_RowsPerChunk];
+		return reinterpret_cast<EntityID const*>(pChunk)[entityRow % m_RowsPerChunk];
+	}
+
+	u64 Archetype::GetNumRowsInChunk(u64 chunkIndex) const {
+		CKE_ASSERT(chunkIndex < m_Chunks.size());
+		u64 firstRow = chunkIndex * m_RowsPerChunk;
+		return std::min(m_RowsPerChunk, m_NumEntities - firstRow);
+	}
+
+	void* Archetype::GetColumnInChunk(u64 componentColumn, u64 chunkIndex) {
+		CKE_ASSERT(chunkIndex < m_Chunks.size());
+		return m_Chunks[chunkIndex] + m_ArchTable[componentColumn].m_OffsetInChunk;
+	}
+
+	EntityID const* Archetype::GetEntitiesInChunk(u64 chunkIndex) const {
+		CKE_ASSERT(chunkIndex < m_Chunks.size());
+		return reinterpret_cast<EntityID const*>(m_Chunks[chunkIndex]);
+	}
+
+	ArchetypeColumnVersions& Archetype::GetColumnVersions(u64 componentColumn, u64 chunkIndex) {
+		CKE_ASSERT(chunkIndex < m_Chunks.size() && componentColumn < m_ArchTable.size());
+		return m_ColumnVersions[chunkIndex * m_ArchTable.size() + componentColumn];
+	}
+
+	ArchetypeColumnVersions const& Archetype::GetColumnVersions(u64 componentColumn, u64 chunkIndex) const {
+		CKE_ASSERT(chunkIndex < m_Chunks.size() && componentColumn < m_ArchTable.size());
+		return m_ColumnVersions[chunkIndex * m_ArchTable.size() + componentColumn];
+	}
+
+	bool Archetype::HasComponent(ComponentTypeID componentID) const {
+		u64 wordIndex = componentID / 64;
+		if (wordIndex >= m_ComponentMask.size()) { return false; }
+		return (m_ComponentMask[wordIndex] >> (componentID % 64)) & 1;
+	}
+
+	ArchetypeComponentColumn Archetype::GetComponentColumn(ComponentTypeID componentID) const {
+		for (ArchetypeComponentColumn column = 0; column < m_ArchTable.size(); ++column) {
+			if (m_ArchTable[column].m_ComponentID == componentID) { return column; }
+		}
+		return INVALID_COMPONENT_COLUMN;
 	}
 }
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Platform/Asserts.h"
+#include "CookieKat/Core/Containers/Containers.h"
+
+namespace CKE {
+	// Size of each one of the memory blocks used to store archetype tables
+	constexpr u64 ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+	constexpr u64 ARCHETYPE_CHUNK_ALIGNMENT = 64;
+
+	// Shared pool of fixed-size chunks used by all the archetypes of an entity database
+	// Chunks are allocated on demand and the ones returned by the archetypes are kept
+	// in a free list to be reused, so the memory used scales with the live entities
+	class ChunkPool
+	{
+	public:
+		ChunkPool() = default;
+		~ChunkPool();
+		ChunkPool(const ChunkPool& other) = delete;
+		ChunkPool(ChunkPool&& other) noexcept = default;
+		ChunkPool& operator=(const ChunkPool& other) = delete;
+		ChunkPool& operator=(ChunkPool&& other) noexcept;
+
+		//-----------------------------------------------------------------------------
+
+		// Returns an uninitialized chunk of ARCHETYPE_CHUNK_SIZE bytes
+		inline u8* AllocateChunk();
+
+		// Returns a chunk to the pool so it can be reused
+		inline void FreeChunk(u8* pChunk);
+
+		// Releases the memory of all the chunks that are not in use
+		void ReleaseFreeChunks();
+
+		// Statistics
+		//-----------------------------------------------------------------------------
+
+		inline u64 GetNumAllocatedChunks() const { return m_AllocatedChunks.size(); }
+		inline u64 GetNumChunksInUse() const { return m_AllocatedChunks.size() - m_FreeChunks.size(); }
+		inline u64 GetAllocatedSizeInBytes() const { return m_AllocatedChunks.size() * ARCHETYPE_CHUNK_SIZE; }
+
+	private:
+		void ReleaseAllChunks();
+
+	private:
+		Vector<u8*> m_FreeChunks;      // Chunks ready to be reused
+		Set<u8*>    m_AllocatedChunks; // All of the chunks owned by the pool
+	};
+}
+
+// Template implementation
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	inline ChunkPool::~ChunkPool() {
+		ReleaseAllChunks();
+	}
+
+	inline ChunkPool& ChunkPool::operator=(ChunkPool&& other) noexcept {
+		ReleaseAllChunks();
+		m_FreeChunks = std::move(other.m_FreeChunks);
+		m_AllocatedChunks = std::move(other.m_AllocatedChunks);
+		other.m_FreeChunks.clear();
+		other.m_AllocatedChunks.clear();
+		return *this;
+	}
+
+	u8* ChunkPool::AllocateChunk() {
+		if (!m_FreeChunks.empty()) {
+			u8* pChunk = m_FreeChunks.back();
+			m_FreeChunks.pop_back();
+			return pChunk;
+		}
+
+		u8* pChunk = static_cast<u8*>(CKE::Alloc(ARCHETYPE_CHUNK_SIZE, ARCHETYPE_CHUNK_ALIGNMENT));
+		m_AllocatedChunks.insert(pChunk);
+		return pChunk;
+	}
+
+	void ChunkPool::FreeChunk(u8* pChunk) {
+		CKE_ASSERT(m_AllocatedChunks.contains(pChunk)); // Chunk doesn't belong to this pool
+		m_FreeChunks.push_back(pChunk);
+	}
+
+	inline void ChunkPool::ReleaseFreeChunks() {
+		for (u8* pChunk : m_FreeChunks) {
+			m_AllocatedChunks.erase(pChunk);
+			CKE::Free(pChunk);
+		}
+		m_FreeChunks.clear();
+	}
+
+	inline void ChunkPool::ReleaseAllChunks() {
+		for (u8* pChunk : m_AllocatedChunks) {
+			CKE::Free(pChunk);
+		}
+		m_AllocatedChunks.clear();
+		m_FreeChunks.clear();
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/FrameAllocator.h"
 
 #include "IDs.h"
 #include "Archetype.h"
@@ -8,47 +9,11 @@
 
 //-----------------------------------------------------------------------------
 
-namespace CKE {
-	// TODO: Still in development
-	// Data structures for an advanced component querying method
-
-	enum class QueryOp
-	{
-		And,
-		Or,
-		Not,
-		Optional,
-	};
-
-	enum class QueryAccess
-	{
-		ReadWrite,
-		ReadOnly,
-		WriteOnly
-	};
-
-	struct QueryElement
-	{
-		ComponentTypeID m_ComponentID;
-		QueryAccess m_Access = QueryAccess::ReadWrite;
-		QueryOp     m_Op = QueryOp::And;
-	};
-
-	struct QueryInfo
-	{
-		Array<QueryElement, 16> m_QueryElements;
-		u32                     m_QueryElementsCount;
-	};
-}
-
-//-----------------------------------------------------------------------------
-
 namespace CKE {
 	// Forward Declarations
 
 	class EntityDatabase;
 	class Archetype;
-	class ComponentArray;
 
 	//-----------------------------------------------------------------------------
 
@@ -109,11 +74,10 @@ namespace CKE {
 		u64 m_NumEntitiesTotal = 0;     // Total number of entities to iterate in all archetypes
 		u64 m_NumEntitiesProcessed = 0; // Total number of entities already iterated
 
-		Vector<ArchetypeColumnPair> m_CompArchAccessData; // Data to access a component in a given archetype
+		FrameVector<ArchetypeColumnPair> m_CompArchAccessData; // Data to access a component in a given archetype
 
 		// Cached variables to avoid constant lookups
-		Archetype*      m_pCurrArch = nullptr;
-		ComponentArray* m_pCurrCompArray = nullptr;
+		Archetype* m_pCurrArch = nullptr;
 	};
 
 	//-----------------------------------------------------------------------------
@@ -130,7 +94,7 @@ namespace CKE {
 		inline T* GetComponent(u64 componentIndex);
 
 	private:
-		Vector<void*> m_Components;
+		FrameVector<void*> m_Components;
 	};
 
 	//-----------------------------------------------------------------------------
@@ -143,9 +107,9 @@ namespace CKE {
 		//-----------------------------------------------------------------------------
 
 		MultiComponentIter() = default;
-		MultiComponentIter(EntityDatabase* pEntityAdmin, Vector<ComponentTypeID>& componentID);
+		MultiComponentIter(EntityDatabase* pEntityAdmin, Span<ComponentTypeID const> componentID);
 
-		void Initialize(EntityDatabase* pEntityAdmin, Vector<ComponentTypeID>& componentID);
+		void Initialize(EntityDatabase* pEntityAdmin, Span<ComponentTypeID const> componentID);
 
 		// Utility Accessors
 		//-----------------------------------------------------------------------------
@@ -168,18 +132,18 @@ namespace CKE {
 		inline void BaseBeginIteratorSetup();
 
 	protected:
-		u64         m_CurrRowInArch = 0;
-		Vector<u64> m_CurrCompColumnsInArch;
+		u64              m_CurrRowInArch = 0;
+		FrameVector<u64> m_CurrCompColumnsInArch;
 
 		// Cached Variables to avoid constant lookups
-		Vector<ComponentArray*> m_pCurrCompArrays;
-		Archetype*              m_pCurrArch = nullptr;
+		Archetype* m_pCurrArch = nullptr;
 
 		u64 m_NumCompsInCurrArch = 0; // Total number of components in current archetype
 		u64 m_CurrArchIDIndex = 0;    // Current Archetype index in the matched arch IDS
 
-		Vector<ComponentTypeID> m_CompsToIterate;
-		Vector<ArchetypeID> m_MatchedArchIDs;
+		// Iterators are frame temporaries, their arrays live in the frame arena of the thread that creates them
+		FrameVector<ComponentTypeID> m_CompsToIterate;
+		FrameVector<ArchetypeID>     m_MatchedArchIDs;
 
 		Map<ComponentTypeID, Map<ArchetypeID, ArchetypeComponentColumn>>* m_pComponentToArchetypes = nullptr;
 		Map<ArchetypeID, Archetype*>*                                 m_IDToArchetype = nullptr;
@@ -212,7 +176,6 @@ namespace CKE {
 		for (ComponentTypeID const& compID : m_CompsToIterate) {
 			u64 compCol = m_pComponentToArchetypes->at(compID).at(newArchID);
 			m_CurrCompColumnsInArch.emplace_back(compCol);
-			m_pCurrCompArrays.emplace_back(&m_pCurrArch->m_ArchTable[compCol]);
 		}
 	}
 
@@ -277,7 +240,7 @@ namespace CKE {
 		auto& compTupleArr = m_OutCompTuple.m_Components;
 		compTupleArr.clear();
 		for (int i = 0; i < m_CompsToIterate.size(); ++i) {
-			compTupleArr.push_back(m_pCurrCompArrays[i]->GetCompAtIndex(m_CurrRowInArch));
+			compTupleArr.push_back(m_pCurrArch->GetComponentAt(m_CurrCompColumnsInArch[i], m_CurrRowInArch));
 		}
 		return &m_OutCompTuple;
 	}
@@ -298,7 +261,6 @@ namespace CKE {
 			m_pCurrArch = m_CompArchAccessData[0].m_pArch;
 			m_CurrCompColumn = componentColumn;
 			m_NumRowsInCurrArch = m_pCurrArch->m_NumEntities;
-			m_pCurrCompArray = &m_pCurrArch->m_ArchTable[componentColumn];
 		}
 	}
 
@@ -338,10 +300,8 @@ namespace CKE {
 			// Setup necesary data to iterate the next archetype
 			m_CurrCompColumn = m_CompArchAccessData[m_CurrArchAccessDataIndex].m_Column;
 
-			// Cache the archetype and component array ptr because
-			// these only change when changing archetypes
+			// Cache the archetype ptr because it only changes when changing archetypes
 			m_pCurrArch = m_CompArchAccessData[m_CurrArchAccessDataIndex].m_pArch;
-			m_pCurrCompArray = &m_pCurrArch->m_ArchTable[m_CurrCompColumn];
 
 			// Set new iter chunk total size
 			m_NumRowsInCurrArch = m_pCurrArch->m_NumEntities;
@@ -349,7 +309,7 @@ namespace CKE {
 	}
 
 	void* ComponentIter::operator*() {
-		return m_pCurrCompArray->GetCompAtIndex(m_CurrRowInArch);
+		return m_pCurrArch->GetComponentAt(m_CurrCompColumn, m_CurrRowInArch);
 	}
 
 	// Component tuple implementation
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Platform/Asserts.h"
+
 #include "IDs.h"
 
 namespace CKE {
@@ -31,6 +34,36 @@ namespace CKE {
 
 	//-----------------------------------------------------------------------------
 
+	// Components accessed by a system, used to decide which systems can run concurrently
+	//
+	// Example:
+	//   void DeclareAccess(SystemAccessData& access) override {
+	//     access.Read<VelocityComponent>().Write<LocalToWorldComponent>();
+	//   }
+	struct SystemAccessData
+	{
+		Vector<ComponentTypeID> m_ReadOnlyComps;
+		Vector<ComponentTypeID> m_ReadWriteComps;
+
+		// The system can't run concurrently with any other system, required to
+		// create/delete entities, add/remove components or manage singletons
+		bool m_IsExclusive = false;
+
+		template <typename T>
+		inline SystemAccessData& Read();
+		template <typename T>
+		inline SystemAccessData& Write();
+		inline SystemAccessData& Exclusive();
+
+		bool CanRead(ComponentTypeID componentID) const;
+		bool CanWrite(ComponentTypeID componentID) const;
+
+		// Checks if two systems with the given accesses can't run concurrently
+		bool ConflictsWith(SystemAccessData const& other) const;
+	};
+
+	//-----------------------------------------------------------------------------
+
 	// Interface for all ECS systems
 	class ECSBaseSystem
 	{
@@ -40,15 +73,84 @@ namespace CKE {
 		virtual void Initialize() { }
 		virtual void Update(SystemUpdateContext ctx) { }
 		virtual void Shutdown() { }
+
+		// Declares the components used by Update, it is called once all the components
+		// have been registered. Systems that don't declare their access run exclusively
+		virtual void DeclareAccess(SystemAccessData& access) { access.Exclusive(); }
 	};
+}
 
-	//-----------------------------------------------------------------------------
+// Access validation
+//-----------------------------------------------------------------------------
 
-	// TODO: In dev.
-	// Component access information
-	struct SystemAccessData
+#ifdef CKE_BUILDSYSTEM_ASSERTS_ENABLE
+#	define CKE_ECS_ACCESS_VALIDATION
+#endif
+
+namespace CKE {
+	// Tracks the access declaration of the system that is running on the current
+	// thread so the entity database can catch accesses that were not declared
+	// Nothing is checked outside of the systems (t_pCurrentAccess == nullptr)
+	//
+	// A thread that waits for a task can run any other task meanwhile, so the access is
+	// set by the body of each task and not by the code that schedules it. Task sets that
+	// are started by a system capture its access with GetCurrentAccess() and set it with
+	// a Scope in their ExecuteRange
+	class SystemAccessValidation
 	{
-		Vector<ComponentTypeID> m_ReadOnlyComps;
-		Vector<ComponentTypeID> m_ReadWriteComps;
+	public:
+		// Sets the access of the current thread during its lifetime
+		class Scope
+		{
+		public:
+			explicit Scope(SystemAccessData const* pAccess);
+			~Scope();
+
+		private:
+			SystemAccessData const* m_pPreviousAccess = nullptr;
+		};
+
+		static SystemAccessData const* GetCurrentAccess() { return t_pCurrentAccess; }
+
+		static void ValidateRead(ComponentTypeID componentID);
+		static void ValidateWrite(ComponentTypeID componentID);
+		static void ValidateStructuralChange();
+
+	private:
+		inline static thread_local SystemAccessData const* t_pCurrentAccess = nullptr;
 	};
 }
+
+#ifdef CKE_ECS_ACCESS_VALIDATION
+#	define CKE_ECS_VALIDATE_READ(componentID) CKE::SystemAccessValidation::ValidateRead(componentID)
+#	define CKE_ECS_VALIDATE_WRITE(componentID) CKE::SystemAccessValidation::ValidateWrite(componentID)
+#	define CKE_ECS_VALIDATE_STRUCTURAL_CHANGE() CKE::SystemAccessValidation::ValidateStructuralChange()
+#else
+// Unevaluated expressions, so they can still be used in fold expressions
+#	define CKE_ECS_VALIDATE_READ(componentID) ((void)sizeof(componentID))
+#	define CKE_ECS_VALIDATE_WRITE(componentID) ((void)sizeof(componentID))
+#	define CKE_ECS_VALIDATE_STRUCTURAL_CHANGE() ((void)0)
+#endif
+
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	template <typename T>
+	SystemAccessData& SystemAccessData::Read() {
+		CKE_ASSERT(ComponentStaticTypeID<T>::s_CompID != 0); // Component has not been registered
+		m_ReadOnlyComps.push_back(ComponentStaticTypeID<T>::s_CompID);
+		return *this;
+	}
+
+	template <typename T>
+	SystemAccessData& SystemAccessData::Write() {
+		CKE_ASSERT(ComponentStaticTypeID<T>::s_CompID != 0); // Component has not been registered
+		m_ReadWriteComps.push_back(ComponentStaticTypeID<T>::s_CompID);
+		return *this;
+	}
+
+	SystemAccessData& SystemAccessData::Exclusive() {
+		m_IsExclusive = true;
+		return *this;
+	}
+}
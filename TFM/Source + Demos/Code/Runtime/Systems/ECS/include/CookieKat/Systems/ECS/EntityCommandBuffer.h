@@ -0,0 +1,169 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Core/Platform/Asserts.h"
+
+#include "IDs.h"
+
+namespace CKE {
+	// Forward Declarations
+	class EntityDatabase;
+}
+
+namespace CKE {
+	enum class EntityCommandType : u8
+	{
+		CreateEntity,
+		DeleteEntity,
+		AddComponents,
+		RemoveComponents,
+	};
+
+	// Structural change recorded in a command buffer
+	struct EntityCommand
+	{
+		EntityCommandType m_Type;
+		EntityID          m_Entity;         // Invalid for CreateEntity
+		u32               m_FirstComponent; // Index of the first component of the command in the buffer
+		u32               m_NumComponents;
+	};
+
+	// Records structural changes (create/delete entities, add/remove components) so they can
+	// be executed later at a sync point, when no job is iterating the entity database
+	// Component data is copied into the buffer when the command is recorded
+	//
+	// A buffer must only be used by one thread at a time, use an EntityCommandBufferSet
+	// to record commands from parallel jobs
+	//
+	// Example:
+	//   EntityCommandBuffer cmds{&db};
+	//   db.GetQuery<Read<Health>>().ForEachChunk([&](auto const& chunk) {
+	//     ...
+	//     cmds.DeleteEntity(chunk.GetEntities()[i]);
+	//   });
+	//   cmds.Playback();
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer() = default;
+		explicit EntityCommandBuffer(EntityDatabase* pEntityDatabase);
+
+		void Initialize(EntityDatabase* pEntityDatabase);
+
+		// Commands
+		//-----------------------------------------------------------------------------
+
+		// Creates an entity with the given components and their initial data
+		void CreateEntity(Span<ComponentTypeID const> componentSet, Span<void* const> componentData);
+
+		template <typename... Ts>
+		void CreateEntityWith(Ts const&... components);
+
+		// Deletes an entity, the rest of its commands in the same playback are ignored
+		void DeleteEntity(EntityID entity);
+
+		// Adds components to an entity, if the entity already has one of them
+		// its data is replaced with the recorded one
+		void AddComponents(EntityID entity, Span<ComponentTypeID const> componentSet, Span<void* const> componentData);
+
+		template <typename T>
+		void AddComponent(EntityID entity, T const& component = T{});
+
+		// Removes components from an entity, components that the entity doesn't have are ignored
+		void RemoveComponents(EntityID entity, Span<ComponentTypeID const> componentSet);
+
+		template <typename T>
+		void RemoveComponent(EntityID entity);
+
+		//-----------------------------------------------------------------------------
+
+		// Executes all the recorded commands and clears the buffer
+		// Commands that target entities that are no longer alive are ignored
+		void Playback();
+
+		// Discards all the recorded commands
+		void Clear();
+
+		inline bool IsEmpty() const { return m_Commands.empty(); }
+		inline u64  GetNumCommands() const { return m_Commands.size(); }
+
+	private:
+		friend class EntityDatabase;
+
+		// Copies the components IDs and their data into the buffer
+		// Returns the index of the first component
+		u32 RecordComponents(Span<ComponentTypeID const> componentSet, Span<void* const> componentData);
+
+		inline void const* GetComponentData(u32 componentIndex) const {
+			return m_ComponentData.data() + m_ComponentDataOffsets[componentIndex];
+		}
+
+	private:
+		EntityDatabase*         m_pEntityDatabase = nullptr;
+		Vector<EntityCommand>   m_Commands;
+		Vector<ComponentTypeID> m_ComponentIDs;         // Components referenced by the commands
+		Vector<u64>             m_ComponentDataOffsets; // Offset in m_ComponentData of each component
+		Vector<u8>              m_ComponentData;        // Copy of the recorded component data
+	};
+
+	//-----------------------------------------------------------------------------
+
+	// Set of command buffers with one buffer per task system thread, so parallel jobs
+	// can record structural changes without any synchronization
+	//
+	// Example:
+	//   void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+	//     EntityCommandBuffer& cmds = m_pCommandBuffers->GetBuffer(threadNum);
+	//     ...
+	//   }
+	class EntityCommandBufferSet
+	{
+	public:
+		void Initialize(EntityDatabase* pEntityDatabase, u32 numThreads);
+
+		// Returns the buffer of the thread with the given index
+		inline EntityCommandBuffer& GetBuffer(u32 threadNum);
+
+		// Executes the commands of all the buffers together and clears them
+		void Playback();
+
+		// Discards the commands of all the buffers
+		void Clear();
+
+	private:
+		// Each buffer is allocated separately to avoid false sharing between the threads
+		Vector<UPtr<EntityCommandBuffer>> m_Buffers;
+		EntityDatabase*                   m_pEntityDatabase = nullptr;
+	};
+}
+
+// Template implementations
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	template <typename... Ts>
+	void EntityCommandBuffer::CreateEntityWith(Ts const&... components) {
+		Array<ComponentTypeID, sizeof...(Ts)> componentIDs{ComponentStaticTypeID<Ts>::s_CompID...};
+		Array<void*, sizeof...(Ts)>           componentData{const_cast<void*>(static_cast<void const*>(&components))...};
+		CreateEntity(componentIDs, componentData);
+	}
+
+	template <typename T>
+	void EntityCommandBuffer::AddComponent(EntityID entity, T const& component) {
+		ComponentTypeID componentID = ComponentStaticTypeID<T>::s_CompID;
+		void*           pData = const_cast<void*>(static_cast<void const*>(&component));
+		AddComponents(entity, Span<ComponentTypeID const>{&componentID, 1}, Span<void* const>{&pData, 1});
+	}
+
+	template <typename T>
+	void EntityCommandBuffer::RemoveComponent(EntityID entity) {
+		ComponentTypeID componentID = ComponentStaticTypeID<T>::s_CompID;
+		RemoveComponents(entity, Span<ComponentTypeID const>{&componentID, 1});
+	}
+
+	EntityCommandBuffer& EntityCommandBufferSet::GetBuffer(u32 threadNum) {
+		CKE_ASSERT(threadNum < m_Buffers.size());
+		return *m_Buffers[threadNum];
+	}
+}
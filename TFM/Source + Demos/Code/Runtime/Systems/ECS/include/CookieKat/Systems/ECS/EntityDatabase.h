@@ -6,9 +6,14 @@
 #include "ComponentIter.h"
 #include "TComponentIter.h"
 #include "Archetype.h"
+#include "Query.h"
+#include "ECSBaseSystem.h"
+#include "EntityCommandBuffer.h"
 
 #include <typeinfo>
 #include <functional>
+#include <atomic>
+#include <mutex>
 
 namespace CKE {
 	// Main ECS Database
@@ -38,6 +43,9 @@ namespace CKE {
 		// Registers a component with the given description
 		ComponentTypeID RegisterComponent(const char* name, u64 sizeInBytes);
 
+		// Returns the size of a registered component, 0 for Tags
+		u64 GetComponentSizeInBytes(ComponentTypeID componentID) const;
+
 		// Registers the component of type T with the database
 		template <typename T>
 		ComponentTypeID RegisterComponent();
@@ -70,7 +78,7 @@ namespace CKE {
 		//     Velocity* pVel = compTuple->GetComponent<Velocity>(1);
 		//     DoSomething(pPos, pVel);
 		//   }
-		MultiComponentIter GetMultiCompIter(ComponentSet componentID);
+		MultiComponentIter GetMultiCompIter(Span<ComponentTypeID const> componentID);
 
 		// Templated
 
@@ -118,6 +126,47 @@ namespace CKE {
 		template <typename pComp, typename... pComps>
 		void ForEach(std::function<void(pComp, pComps...)>&& callback);
 
+		// Queries (Fastest, the matching archetypes are cached)
+
+		// Returns a persistent query over the supplied terms
+		//
+		// Example:
+		//   auto query = db.GetQuery<Write<Position>, Read<Velocity>>();
+		//   query.ForEach([](Position& pos, Velocity const& vel) {
+		//     DoSomething(pos, vel);
+		//   });
+		template <typename... Terms>
+		Query<Terms...> GetQuery();
+
+		// Change Tracking
+		//-----------------------------------------------------------------------------
+
+		// Returns the current change version of the database
+		// Writes to component data mark their chunk with the current version and each query
+		// iteration advances it, this is what the Changed<T> and Added<T> query filters compare against
+		inline u64 GetChangeVersion() const {
+			return std::atomic_ref<u64>(m_ChangeVersion).load(std::memory_order_relaxed);
+		}
+
+		// Starts keeping a copy of every T component that leaves an entity, because it was removed
+		// or the entity was deleted. Queries can't see them anymore, so this is how the code that
+		// mirrors the components somewhere else (e.g. the render scene) finds out
+		//
+		// Asserts:
+		//   Component Type exists and has data
+		template <typename T>
+		void TrackRemovedComponents();
+
+		// Returns the T components removed since the last ClearRemovedComponents<T>(), in removal order
+		//
+		// Asserts:
+		//   Removals of T are tracked
+		template <typename T>
+		Span<T const> GetRemovedComponents() const;
+
+		template <typename T>
+		void ClearRemovedComponents();
+
 		// Entities
 		//-----------------------------------------------------------------------------
 
@@ -127,12 +176,70 @@ namespace CKE {
 		//   Didn't reach the max entity count limit
 		EntityID CreateEntity();
 
+		// Creates a new entity that is placed directly in the archetype of the component set.
+		// componentData[i] is used to initialize the component componentSet[i], it can be
+		// nullptr for components with size = 0 (Tags)
+		// A repeated component is added once with the data of its last occurrence
+		//
+		// Asserts:
+		//   Didn't reach the max entity count limit
+		//   Component Types exist
+		EntityID CreateEntity(Span<ComponentTypeID const> componentSet, Span<void* const> componentData);
+
+		// Creates a new entity with the supplied T components using a single archetype placement
+		//
+		// Example:
+		//   EntityID e = db.CreateEntityWith(Position{0, 1, 0}, Velocity{1, 0, 0});
+		template <typename... Ts>
+		EntityID CreateEntityWith(Ts... components);
+
+		// Creates count entities placed directly in the archetype of the component set.
+		// The rows of all of them are reserved at once and each component column is
+		// initialized with a single contiguous copy.
+		// componentData[i] must point to an array of count componentSet[i] components,
+		// it can be nullptr for components with size = 0 (Tags)
+		// Returns the created entities, entity i is initialized with the element i of the arrays
+		//
+		// Asserts:
+		//   Didn't reach the max entity count limit
+		//   Component Types exist
+		Vector<EntityID> CreateEntities(u64 count, Span<ComponentTypeID const> componentSet,
+		                                Span<void* const> componentData);
+
+		// Creates count entities with the T components, initialized from the supplied arrays
+		//
+		// Example:
+		//   Vector<Position> positions = ...; // One position per entity
+		//   Vector<Velocity> velocities = ...;
+		//   db.CreateEntitiesWith(positions.size(), positions.data(), velocities.data());
+		template <typename... Ts>
+		Vector<EntityID> CreateEntitiesWith(u64 count, Ts*... componentArrays);
+
 		// Deletes the given entity
 		//
 		// Asserts:
 		//   Entity exists
 		void DeleteEntity(EntityID entity);
 
+		// Deletes all of the given entities
+		//
+		// Asserts:
+		//   Entities exist and are not repeated
+		void DeleteEntities(Span<EntityID const> entities);
+
+		// Checks if the handle references an entity that is still alive
+		// Handles of deleted entities are never valid again, even if their slot is reused
+		bool IsEntityAlive(EntityID entity) const;
+
+		// Executes the commands recorded in the buffers as a single batch and clears them
+		// The commands of each entity are merged so it changes its archetype at most once,
+		// then entities are deleted, moved grouped by source and target archetype and
+		// created grouped by component set
+		// Commands that target entities that are no longer alive are ignored
+		//
+		// Must be called when no job is accessing the database
+		void ExecuteCommandBuffers(Span<EntityCommandBuffer* const> commandBuffers);
+
 		// Entity Components
 		//-----------------------------------------------------------------------------
 
@@ -166,9 +273,25 @@ namespace CKE {
 		//   Component Type exists
 		bool HasComponent(EntityID entity, ComponentTypeID componentID);
 
-		// TODO: Add multiple components in one call to reduce overhead in archetype changes
-		// void AddComponents(EntityID entity, Vector<ComponentID>, void** pComponentData);
-		// void RemoveComponents(EntityID entity, Vector<ComponentID>);
+		// Adds multiple components to an entity moving its data only once to the final archetype.
+		// componentData[i] is used to initialize the component componentSet[i], it can be
+		// nullptr for components with size = 0 (Tags)
+		// A repeated component is added once with the data of its last occurrence
+		//
+		// Asserts:
+		//	 Entity Exists
+		//   Component Types exist
+		//   Entity doesn't have any of the components
+		void AddComponents(EntityID entityID, Span<ComponentTypeID const> componentSet, Span<void* const> componentData);
+
+		// Removes multiple components from an entity moving its data only once to the final archetype
+		// A repeated component is removed once
+		//
+		// Asserts:
+		//	 Entity Exists
+		//   Component Types exist
+		//   Entity has all of the components
+		void RemoveComponents(EntityID entityID, Span<ComponentTypeID const> componentSet);
 
 		// Adds to an entity a T component, calling its default constructor
 		template <typename T>
@@ -190,6 +313,21 @@ namespace CKE {
 		template <typename T>
 		void RemoveComponent(EntityID entity);
 
+		// Adds to an entity all of the supplied T components with a single archetype change
+		//
+		// Example:
+		//   db.AddComponents(entity, Position{0, 1, 0}, Velocity{1, 0, 0});
+		template <typename... Ts>
+			requires (!std::is_convertible_v<Ts, Span<ComponentTypeID const>> && ...)
+		void AddComponents(EntityID entity, Ts... components);
+
+		// Removes all of the T components from an entity with a single archetype change
+		//
+		// Example:
+		//   db.RemoveComponents<Position, Velocity>(entity);
+		template <typename... Ts>
+		void RemoveComponents(EntityID entity);
+
 		// Returns a pointer to an entity's T component
 		// Its only a typed extension of GetComponent(...)
 		template <typename T>
@@ -264,39 +402,101 @@ namespace CKE {
 		// Auxiliary
 		//-----------------------------------------------------------------------------
 
-		ComponentSetID CalculateComponentSetID(Vector<ComponentTypeID> const& componentSet);
+		// The ID of a component set is order independent and can be updated incrementally,
+		// ID(Set + Comp) = ID(Set) ^ HashComponentID(Comp)
+		static ComponentSetID CalculateComponentSetID(Span<ComponentTypeID const> componentSet);
+		static inline u64     HashComponentID(ComponentTypeID componentID);
+
+		// Repeated components cancel out in the set ID, so they are removed before an edge is looked up
+		static bool                    HasRepeatedComponents(Span<ComponentTypeID const> componentSet);
+		static Vector<ComponentTypeID> RemoveRepeatedComponents(Span<ComponentTypeID const> componentSet);
 
 		// Returns the component column of component in a given archetype
 		ArchetypeComponentColumn GetComponentColumnInArchetype(ComponentTypeID component, ArchetypeID archetypeID) const;
 
-		void MoveComponentDataFromToArch(Archetype*       pOldArchetype, u64 oldArchetypeRow,
-		                                 Archetype*       pNewArchetype, u64 newArchetypeRow,
-		                                 ComponentTypeID& compID);
+		// Moves the entity data to the target archetype of the transition and updates
+		// its record and the record of the entity that fills its previous row
+		// Returns the row of the entity in the target archetype
+		u64 MoveEntityToArchetype(EntityID entityID, EntityRecord& record, ArchetypeTransition const& transition);
 
 		// Archetypes
 		//-----------------------------------------------------------------------------
 
 		// Create an archetype for the given component set
-		void CreateArchetype(Vector<ComponentTypeID> const& componentSet);
+		Archetype* CreateArchetype(Vector<ComponentTypeID> const& componentSet);
+
+		// Returns the archetype with the exact component set, creating it if necessary
+		Archetype* GetOrCreateArchetype(Vector<ComponentTypeID> const& componentSet);
+
+		// Returns the cached edge of adding/removing a set of components to/from an archetype
+		// The edge (and the target archetype) are created the first time they are requested
+		ArchetypeTransition const& GetAddTransition(Archetype* pArchetype, Span<ComponentTypeID const> componentSet);
+		ArchetypeTransition const& GetRemoveTransition(Archetype* pArchetype, Span<ComponentTypeID const> componentSet);
+
+		// Copies the data of the components added by a transition into numRows contiguous rows
+		// of the target archetype, starting at targetRow, and marks them as added
+		void CopyAddedComponentsData(ArchetypeTransition const& transition, u64 targetRow,
+		                                    Span<ComponentTypeID const> componentSet,
+		                                    Span<void* const> componentData, u64 numRows = 1);
+
+		// Copies the tracked components of a row that don't exist in the new archetype of the entity
+		// pNewArchetype is nullptr when the entity is deleted
+		void RecordRemovedComponents(Archetype* pArchetype, u64 row, Archetype const* pNewArchetype);
+
+		// Removes the entity from its archetype and from the active entity list,
+		// updating the records of the entities that fill the holes it leaves
+		// The slot of the entity is returned to the free list
+		void RemoveEntity(EntityID entity);
+
+		// Reserves a slot for a new entity, reusing a free one if possible, and adds it
+		// to the active entity list. The archetype data of the record is left to the caller
+		EntityID AllocateEntity();
+
+		// Returns the record of an alive entity
+		inline EntityRecord& GetEntityRecord(EntityID entity);
+
+		// Fills the column remap table of the transition between two archetypes
+		void BuildTransition(Archetype* pSrcArchetype, Archetype* pDstArchetype, ArchetypeTransition& transition) const;
 		// void DeleteArchetype(Vector<ComponentID> const& componentSet);
 		// bool ArchetypeExists(Vector<ComponentID> const& componentSet);
 
+		// Returns the cached state of the query, it is created and matched
+		// against all the existing archetypes the first time it is requested
+		// Can be called from systems running in parallel
+		QueryState* GetOrCreateQueryState(QueryInfo const& queryInfo);
+
+		// Returns the current change version and increments it, can be called from any thread
+		inline u64 AdvanceChangeVersion() {
+			return std::atomic_ref<u64>(m_ChangeVersion).fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Marks the component columns of every chunk that contains the component as changed
+		// Used by the legacy iterators, which don't know which chunks are going to be written
+		void MarkComponentChanged(ComponentTypeID componentID);
+
 	private:
 		friend class ComponentIter;
 		friend class MultiComponentIter;
+		friend struct QueryState;
 
 	private:
-		Vector<EntityID>        m_Entities;       // All the active entities in the world
-		Vector<ComponentTypeID> m_ComponentTypes; // All of the component types
-		Vector<Archetype>       m_Archetypes;     // All of the archetypes in use
+		Vector<EntityID>         m_Entities;       // All the active entities in the world
+		Vector<ComponentTypeID>  m_ComponentTypes; // All of the component types
+		Vector<UPtr<Archetype>>  m_Archetypes;     // All of the archetypes in use
+		ChunkPool                m_ChunkPool;      // Memory used by the archetype tables
+		Vector<UPtr<QueryState>> m_Queries;        // Cached archetype matches of all the queries
+
+		// Guards the list of queries, behind a pointer so the database can still be moved
+		UPtr<std::mutex> m_pQueriesMutex = std::make_unique<std::mutex>();
 
 		// Data Relationships
 		//-----------------------------------------------------------------------------
 
 		Map<ArchetypeID, Archetype*> m_IDToArchetype;
 
-		// Used to get the Archetype and the entity row
-		Map<EntityID, EntityRecord> m_EntityToRecord;
+		// Used to get the Archetype and the entity row, indexed by the entity index
+		Vector<EntityRecord> m_EntityRecords;
+		Vector<u32>          m_FreeEntityIndices; // Slots of deleted entities that can be reused
 
 		// Returns all the archetypes and columns that contain the component
 		Map<ComponentTypeID, Map<ArchetypeID, ArchetypeComponentColumn>> m_ComponentToArchetypes;
@@ -307,6 +507,11 @@ namespace CKE {
 
 		Map<ComponentTypeID, ComponentTypeData> m_ComponentTypeData; // RTTI for components
 
+		// Copies of the removed components of the types whose removals are tracked
+		Map<ComponentTypeID, Vector<u8>> m_RemovedComponents;
+
+		Archetype* m_pEmptyArchetype = nullptr; // Archetype of the entities without components
+
 		//-----------------------------------------------------------------------------
 
 		u64 m_MaxNumEntities = 0;
@@ -314,9 +519,12 @@ namespace CKE {
 		// ID Tracking
 		//-----------------------------------------------------------------------------
 
-		EntityID        m_NextEntityID{0};
 		ComponentTypeID m_LastComponentID = 0;
 		ArchetypeID     m_LastArchetypeID = 0;
+
+		// Current change version, 0 is used for never changed
+		// Accessed through std::atomic_ref so the database can still be moved
+		alignas(std::atomic_ref<u64>::required_alignment) mutable u64 m_ChangeVersion = 1;
 	};
 }
 
@@ -329,6 +537,8 @@ namespace CKE {
 		u64 m_NumEntities;
 		u64 m_NumComponentTypes;
 		u64 m_NumArchetypes;
+		u64 m_NumChunksInUse;     // Archetype table chunks that contain entities
+		u64 m_ChunkMemoryInBytes; // Memory allocated by the chunk pool
 	};
 
 	class EntityDatabaseDebugger
@@ -376,18 +586,51 @@ namespace CKE {
 		return compID;
 	}
 
+	template <typename T>
+	void EntityDatabase::TrackRemovedComponents() {
+		// The copies are stored back to back in a byte vector
+		static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+		static_assert(!std::is_empty_v<T>);
+		CKE_ASSERT(m_ComponentTypeData.contains(ComponentStaticTypeID<T>::s_CompID));
+		m_RemovedComponents.try_emplace(ComponentStaticTypeID<T>::s_CompID);
+	}
+
+	template <typename T>
+	Span<T const> EntityDatabase::GetRemovedComponents() const {
+		CKE_ASSERT(m_RemovedComponents.contains(ComponentStaticTypeID<T>::s_CompID));
+		Vector<u8> const& removed = m_RemovedComponents.at(ComponentStaticTypeID<T>::s_CompID);
+		return Span<T const>{reinterpret_cast<T const*>(removed.data()), removed.size() / sizeof(T)};
+	}
+
+	template <typename T>
+	void EntityDatabase::ClearRemovedComponents() {
+		CKE_ASSERT(m_RemovedComponents.contains(ComponentStaticTypeID<T>::s_CompID));
+		m_RemovedComponents.at(ComponentStaticTypeID<T>::s_CompID).clear();
+	}
+
 	template <typename T>
 	TComponentIterator<T> EntityDatabase::GetSingleCompIter() {
+		CKE_ECS_VALIDATE_WRITE(ComponentStaticTypeID<T>::s_CompID);
+		MarkComponentChanged(ComponentStaticTypeID<T>::s_CompID);
 		TComponentIterator<T> compIterator(this);
 		return compIterator;
 	}
 
 	template <typename T, typename... Other>
 	TMultiComponentIter<T, Other...> EntityDatabase::GetMultiCompTupleIter() {
+		CKE_ECS_VALIDATE_WRITE(ComponentStaticTypeID<T>::s_CompID);
+		(CKE_ECS_VALIDATE_WRITE(ComponentStaticTypeID<Other>::s_CompID), ...);
+		MarkComponentChanged(ComponentStaticTypeID<T>::s_CompID);
+		(MarkComponentChanged(ComponentStaticTypeID<Other>::s_CompID), ...);
 		TMultiComponentIter<T, Other...> iter(this);
 		return iter;
 	}
 
+	template <typename... Terms>
+	Query<Terms...> EntityDatabase::GetQuery() {
+		return Query<Terms...>{*this};
+	}
+
 	template <typename Func, typename... pComps>
 	void EntityDatabase::ForEach(Func&& callback) {
 		ForEach(std::function{std::forward<Func>(callback)});
@@ -401,20 +644,12 @@ namespace CKE {
 		}
 	}
 
-	template <size_t I, typename... Ts>
-	constexpr void PopulateVectorWithComponentIDs(Vector<ComponentTypeID>& vec) {
-		if constexpr (I == sizeof...(Ts)) { return; }
-		else {
-			vec.emplace_back(ComponentStaticTypeID<std::tuple_element_t<I, std::tuple<Ts...>>>::s_CompID);
-			PopulateVectorWithComponentIDs<I + 1, Ts...>(vec);
-		}
-	}
-
 	template <typename T, typename... Other>
 	MultiComponentIter EntityDatabase::GetMultiCompIter() {
-		Vector<ComponentTypeID> componentIDs;
-		PopulateVectorWithComponentIDs<0, T, Other...>(componentIDs);
-		return MultiComponentIter(this, componentIDs);
+		Array<ComponentTypeID, sizeof...(Other) + 1> const componentIDs{
+			ComponentStaticTypeID<T>::s_CompID, ComponentStaticTypeID<Other>::s_CompID...
+		};
+		return GetMultiCompIter(componentIDs);
 	}
 
 	template <typename T>
@@ -465,6 +700,48 @@ namespace CKE {
 		RemoveComponent(entity, ComponentStaticTypeID<T>::s_CompID);
 	}
 
+	template <typename... Ts>
+		requires (!std::is_convertible_v<Ts, Span<ComponentTypeID const>> && ...)
+	void EntityDatabase::AddComponents(EntityID entity, Ts... components) {
+		Array<ComponentTypeID, sizeof...(Ts)> componentIDs{ComponentStaticTypeID<Ts>::s_CompID...};
+		Array<void*, sizeof...(Ts)>           componentData{static_cast<void*>(&components)...};
+		AddComponents(entity, Span<ComponentTypeID const>{componentIDs}, Span<void* const>{componentData});
+	}
+
+	template <typename... Ts>
+	void EntityDatabase::RemoveComponents(EntityID entity) {
+		Array<ComponentTypeID, sizeof...(Ts)> componentIDs{ComponentStaticTypeID<Ts>::s_CompID...};
+		RemoveComponents(entity, Span<ComponentTypeID const>{componentIDs});
+	}
+
+	template <typename... Ts>
+	EntityID EntityDatabase::CreateEntityWith(Ts... components) {
+		Array<ComponentTypeID, sizeof...(Ts)> componentIDs{ComponentStaticTypeID<Ts>::s_CompID...};
+		Array<void*, sizeof...(Ts)>           componentData{static_cast<void*>(&components)...};
+		return CreateEntity(Span<ComponentTypeID const>{componentIDs}, Span<void* const>{componentData});
+	}
+
+	template <typename... Ts>
+	Vector<EntityID> EntityDatabase::CreateEntitiesWith(u64 count, Ts*... componentArrays) {
+		Array<ComponentTypeID, sizeof...(Ts)> componentIDs{ComponentStaticTypeID<Ts>::s_CompID...};
+		Array<void*, sizeof...(Ts)>           componentData{static_cast<void*>(componentArrays)...};
+		return CreateEntities(count, Span<ComponentTypeID const>{componentIDs}, Span<void* const>{componentData});
+	}
+
+	u64 EntityDatabase::HashComponentID(ComponentTypeID componentID) {
+		// SplitMix64 finalizer, spreads the sequential component IDs over the 64 bits
+		// so that the XOR of the hashes of a set is unlikely to collide
+		u64 x = componentID + 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	EntityRecord& EntityDatabase::GetEntityRecord(EntityID entity) {
+		CKE_ASSERT(IsEntityAlive(entity)); // Check that the entity exists and the handle is not stale
+		return m_EntityRecords[entity.GetIndex()];
+	}
+
 	template <typename T>
 	T* EntityDatabase::GetComponent(EntityID entity) {
 		return reinterpret_cast<T*>(GetComponent(entity, ComponentStaticTypeID<T>::s_CompID));
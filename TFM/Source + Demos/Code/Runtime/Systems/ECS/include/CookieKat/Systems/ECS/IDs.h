@@ -12,22 +12,30 @@ namespace CKE {
 	// Identifiers for many of the system structures
 	//-----------------------------------------------------------------------------
 
-	// Strongly type integer to represent an Entity ID
+	// Strongly typed handle to an entity
+	// The index identifies the slot of the entity in the database, slots are reused
+	// after an entity is deleted so the generation is used to detect stale handles
 	class EntityID
 	{
 	public:
-		explicit EntityID() : m_Value(0) {}              // Constructs an invalid entity ID
-		explicit EntityID(u32 value) : m_Value(value) {} // Constructs an entity ID with the given underlying value
+		explicit EntityID() : m_Index(0), m_Generation(0) {} // Constructs an invalid entity ID
+		explicit EntityID(u32 index, u32 generation) : m_Index(index), m_Generation(generation) {}
 
 		inline static EntityID Invalid() { return EntityID{}; } // Returns an invalid entity ID
-		inline bool            IsValid() const { return m_Value != 0; }
-		inline u32             GetValue() const { return m_Value; } // Returns the underlying value of the ID
-
-		inline bool operator==(const EntityID& other) const { return m_Value == other.m_Value; }
+		inline bool            IsValid() const { return m_Generation != 0; }
+		inline u32             GetIndex() const { return m_Index; }           // Returns the slot of the entity
+		inline u32             GetGeneration() const { return m_Generation; } // Returns the generation of the slot
+		// Returns the underlying value of the ID, index and generation packed together
+		inline u64 GetValue() const { return (static_cast<u64>(m_Generation) << 32) | m_Index; }
+
+		inline bool operator==(const EntityID& other) const {
+			return m_Index == other.m_Index && m_Generation == other.m_Generation;
+		}
 		inline bool operator!=(const EntityID& other) const { return !(*this == other); }
 
 	private:
-		u32 m_Value;
+		u32 m_Index;
+		u32 m_Generation; // 0 is never used by a valid entity
 	};
 
 	// TODO: Implement these IDs as strongly-typed
@@ -36,16 +44,21 @@ namespace CKE {
 	using ComponentSetID = u64;
 	using ArchetypeComponentColumn = u64;
 
+	// Column value used for components that don't have data in an archetype table (Tags)
+	constexpr ArchetypeComponentColumn INVALID_COMPONENT_COLUMN = static_cast<ArchetypeComponentColumn>(-1);
+
 	// Todo: Improve the interface for this structure
 	using ComponentSet = Vector<ComponentTypeID>;
 
 	//-----------------------------------------------------------------------------
 
-	// Explicit data assigned to an entity
+	// Explicit data assigned to an entity slot
 	struct EntityRecord
 	{
-		Archetype* m_pArchetype;         // Ptr to the archetype of the entity
+		Archetype* m_pArchetype;         // Ptr to the archetype of the entity, nullptr if the slot is free
 		u64        m_EntityArchetypeRow; // Index to the archetype table row where the entity components are located
+		u64        m_EntityIndex;        // Index of the entity in the list of active entities
+		u32        m_Generation;         // Current generation of the slot, incremented when the entity is deleted
 	};
 
 	// Type information of a component
@@ -7,21 +7,36 @@
 //-----------------------------------------------------------------------------
 
 namespace CKE {
+	// Task that executes JobType::ForEach(Component*, OtherComponents*...) over all the
+	// entities that contain the components. The matched archetype chunks are split between
+	// the partitions of the task set so each worker processes a disjoint slice of the entities
 	template <typename JobType, typename Component, typename... OtherComponents>
 	class ECSJob : public ITaskSet
 	{
 	public:
+		// Gathers the chunks to process, the job must be scheduled
+		// before the entities of the database are modified again
+		// The job runs with the access of the system that sets it up
 		void Setup(EntityDatabase* pAdmin, f32 dt);
+
+		// Same as Setup but the partitions are sized to the threads of the task system
+		void Setup(EntityDatabase* pAdmin, TaskSystem* pTaskSystem, f32 dt);
+
 		//void ForEach(Component* comp, OtherComponents*... other) {}
 
 	protected:
 		f32 m_Dt{};
 
 	private:
+		using JobQuery = Query<Write<Component>, Write<OtherComponents>...>;
+		using JobQueryChunk = QueryChunk<Write<Component>, Write<OtherComponents>...>;
+
 		void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override;
 
 	private:
-		EntityDatabase* m_pEntityDb = nullptr;
+		EntityDatabase*         m_pEntityDb = nullptr;
+		Vector<JobQueryChunk>   m_Chunks;
+		SystemAccessData const* m_pAccess = nullptr;
 	};
 }
 
@@ -32,15 +47,38 @@ namespace CKE {
 	void ECSJob<JobType, T, Other...>::Setup(EntityDatabase* pAdmin, f32 dt) {
 		m_pEntityDb = pAdmin;
 		m_Dt = dt;
+		m_pAccess = SystemAccessValidation::GetCurrentAccess();
+
+		m_Chunks.clear();
+		JobQuery query{*m_pEntityDb};
+		query.GatherChunks(m_Chunks);
+
+		// One partition per chunk, the scheduler groups them depending on its threads
+		m_SetSize = static_cast<u32>(m_Chunks.size());
+		m_MinRange = 1;
+	}
+
+	template <typename JobType, typename T, typename... Other>
+	void ECSJob<JobType, T, Other...>::Setup(EntityDatabase* pAdmin, TaskSystem* pTaskSystem, f32 dt) {
+		Setup(pAdmin, dt);
+		m_MinRange = pTaskSystem->GetMinRangeForEvenSplit(m_SetSize);
 	}
 
 	template <typename JobType, typename T, typename... Other>
 	void ECSJob<JobType, T, Other...>::ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) {
 		CKE_PROFILE_EVENT(typeid(JobType).name());
+		SystemAccessValidation::Scope accessScope{m_pAccess};
 
 		JobType* pJob = static_cast<JobType*>(this);
-		for (auto& compTuple : m_pEntityDb->GetMultiCompTupleIter<T, Other...>()) {
-			std::apply([pJob](auto&&... args) { pJob->ForEach(args...); }, compTuple);
+		for (u32 chunkIndex = range_.start; chunkIndex < range_.end; ++chunkIndex) {
+			JobQueryChunk const&                chunk = m_Chunks[chunkIndex];
+			std::tuple<Span<T>, Span<Other>...> columns{
+				chunk.template GetColumn<T>(), chunk.template GetColumn<Other>()...
+			};
+
+			for (u64 row = 0; row < chunk.GetNumRows(); ++row) {
+				std::apply([pJob, row](auto&... column) { pJob->ForEach(&column[row]...); }, columns);
+			}
 		}
 	}
 }
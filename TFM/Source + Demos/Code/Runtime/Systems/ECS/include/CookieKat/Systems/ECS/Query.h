@@ -0,0 +1,530 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/FrameAllocator.h"
+
+#include "CookieKat/Core/Profilling/Profilling.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
+
+#include "IDs.h"
+#include "Archetype.h"
+#include "ECSBaseSystem.h"
+
+#include <tuple>
+#include <utility>
+
+namespace CKE {
+	// Forward Declarations
+	class EntityDatabase;
+}
+
+// Query description
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	// Operation that a query element applies when matching archetypes
+	enum class QueryOp
+	{
+		And,      // The archetype must contain the component
+		Or,       // The archetype must contain at least one of the Or components of the query
+		Not,      // The archetype can't contain the component
+		Optional, // The component is accessed only if the archetype contains it
+	};
+
+	// How a query element accesses the component data
+	enum class QueryAccess
+	{
+		ReadWrite,
+		ReadOnly,
+		WriteOnly,
+		None, // The component is only used to filter archetypes
+	};
+
+	// Change filter of a query element, the chunks that don't pass any of the
+	// filters of the query are skipped
+	enum class QueryFilter
+	{
+		None,
+		Changed, // The component has been written since the previous iteration of the query
+		Added,   // The component has been added to an entity since the previous iteration of the query
+	};
+
+	struct QueryElement
+	{
+		ComponentTypeID m_ComponentID{0};
+		QueryAccess     m_Access = QueryAccess::ReadWrite;
+		QueryOp         m_Op = QueryOp::And;
+		QueryFilter     m_Filter = QueryFilter::None;
+
+		bool operator==(QueryElement const& other) const = default;
+	};
+
+	// Type-less description of a query
+	struct QueryInfo
+	{
+		static constexpr u32 MAX_ELEMENTS = 16;
+
+		Array<QueryElement, MAX_ELEMENTS> m_QueryElements{};
+		u32                               m_QueryElementsCount = 0;
+
+		// Appends an element to the query
+		//
+		// Asserts:
+		//   The query doesn't have more than MAX_ELEMENTS elements
+		void AddElement(ComponentTypeID componentID, QueryAccess access, QueryOp op,
+		                QueryFilter filter = QueryFilter::None);
+
+		// Returns true if any of the elements has a change filter
+		bool HasChangeFilters() const;
+
+		// Checks if the component set of the archetype satisfies the query
+		bool Matches(Archetype const& archetype) const;
+
+		bool operator==(QueryInfo const& other) const;
+	};
+
+	// Cached result of a query, it is owned by the entity database and it is updated
+	// every time an archetype is created so queries never search the archetypes again
+	struct QueryState
+	{
+		QueryInfo          m_Info{};
+		Vector<Archetype*> m_MatchedArchetypes{};
+		EntityDatabase*    m_pDatabase = nullptr;
+		bool               m_HasChangeFilters = false;
+
+		// Column of each query element in each matched archetype, stored as
+		// m_Info.m_QueryElementsCount consecutive columns per archetype.
+		// INVALID_COMPONENT_COLUMN if the element doesn't have data in the archetype
+		Vector<ArchetypeComponentColumn> m_MatchedColumns{};
+
+		// Adds the archetype to the matched list if it satisfies the query
+		void TryAddArchetype(Archetype* pArchetype);
+
+		// Returns the number of entities in all of the matched archetypes
+		u64 GetNumEntities() const;
+
+		// Checks if a chunk passes the change filters of the query, a chunk passes if any
+		// of the filtered columns has been changed (or added) after lastVersion
+		bool MatchesChangeFilters(u64 matchedArchetypeIndex, u64 chunkIndex, u64 lastVersion) const;
+
+		// Marks the columns that the query can write as changed in a chunk
+		void MarkWrittenColumns(u64 matchedArchetypeIndex, u64 chunkIndex, u64 version) const;
+
+		// Returns the version for the writes of a new iteration and advances the database version
+		u64 BeginIteration() const;
+
+		// Returns the state of the query in the database, creating it the first time
+		static QueryState* GetOrCreate(EntityDatabase& db, QueryInfo const& info);
+	};
+}
+
+// Query terms
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	// Entities must have a T component, accessed as T const&
+	template <typename T>
+	struct Read
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components don't have data, use With<T> instead");
+
+		using Component = T;
+		using ColumnType = T const;
+		static constexpr QueryOp     s_Op = QueryOp::And;
+		static constexpr QueryAccess s_Access = QueryAccess::ReadOnly;
+		static constexpr QueryFilter s_Filter = QueryFilter::None;
+
+		inline static std::tuple<T const&> GetArg(T const* pColumn, u64 row) { return {pColumn[row]}; }
+	};
+
+	// Entities must have a T component, accessed as T&
+	template <typename T>
+	struct Write
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components don't have data, use With<T> instead");
+
+		using Component = T;
+		using ColumnType = T;
+		static constexpr QueryOp     s_Op = QueryOp::And;
+		static constexpr QueryAccess s_Access = QueryAccess::ReadWrite;
+		static constexpr QueryFilter s_Filter = QueryFilter::None;
+
+		inline static std::tuple<T&> GetArg(T* pColumn, u64 row) { return {pColumn[row]}; }
+	};
+
+	// Entities must have a T component but its data is not accessed
+	template <typename T>
+	struct With
+	{
+		using Component = T;
+		using ColumnType = void;
+		static constexpr QueryOp     s_Op = QueryOp::And;
+		static constexpr QueryAccess s_Access = QueryAccess::None;
+		static constexpr QueryFilter s_Filter = QueryFilter::None;
+
+		inline static std::tuple<> GetArg(void*, u64) { return {}; }
+	};
+
+	// Entities can't have a T component
+	template <typename T>
+	struct Without
+	{
+		using Component = T;
+		using ColumnType = void;
+		static constexpr QueryOp     s_Op = QueryOp::Not;
+		static constexpr QueryAccess s_Access = QueryAccess::None;
+		static constexpr QueryFilter s_Filter = QueryFilter::None;
+
+		inline static std::tuple<> GetArg(void*, u64) { return {}; }
+	};
+
+	// Entities may have a T component, accessed as T* which is nullptr if they don't
+	// CKE::Optional is already used for std::optional, hence the With prefix
+	template <typename T>
+	struct WithOptional
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components don't have data, use With<T> instead");
+
+		using Component = T;
+		using ColumnType = T;
+		static constexpr QueryOp     s_Op = QueryOp::Optional;
+		static constexpr QueryAccess s_Access = QueryAccess::ReadWrite;
+		static constexpr QueryFilter s_Filter = QueryFilter::None;
+
+		inline static std::tuple<T*> GetArg(T* pColumn, u64 row) {
+			return {pColumn != nullptr ? pColumn + row : nullptr};
+		}
+	};
+
+	// Entities must have a T component and only the chunks in which T has been written since
+	// the previous iteration of the query are matched. The data is not accessed, combine it with
+	// Read<T>/Write<T> to access it. The writes done by the query itself are not reported to it
+	// Multiple Changed<T>/Added<T> terms match the chunks that pass any of them
+	//
+	// Writes are tracked per chunk: writing through a Write<T>/WithOptional<T> term, GetComponent<T>(),
+	// the legacy iterators or adding T marks the chunk, and so does moving an entity into the chunk
+	template <typename T>
+	struct Changed
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components don't have data to track changes");
+
+		using Component = T;
+		using ColumnType = void;
+		static constexpr QueryOp     s_Op = QueryOp::And;
+		static constexpr QueryAccess s_Access = QueryAccess::None;
+		static constexpr QueryFilter s_Filter = QueryFilter::Changed;
+
+		inline static std::tuple<> GetArg(void*, u64) { return {}; }
+	};
+
+	// Same as Changed<T> but only the chunks in which T has been added to an entity
+	// (including entity creation) since the previous iteration of the query are matched
+	template <typename T>
+	struct Added
+	{
+		static_assert(!std::is_empty_v<T>, "Tag components don't have data to track changes");
+
+		using Component = T;
+		using ColumnType = void;
+		static constexpr QueryOp     s_Op = QueryOp::And;
+		static constexpr QueryAccess s_Access = QueryAccess::None;
+		static constexpr QueryFilter s_Filter = QueryFilter::Added;
+
+		inline static std::tuple<> GetArg(void*, u64) { return {}; }
+	};
+}
+
+// Typed queries
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	// Contiguous slice of the entities matched by a query, all of them in the same archetype chunk
+	// Columns are exposed as spans so the loops over them can be vectorized
+	template <typename... Terms>
+	class QueryChunk
+	{
+	public:
+		// Returns the column of the T component, the span is empty for
+		// WithOptional<T> terms if the archetype doesn't contain T
+		//
+		// Example:
+		//   Span<Position const> positions = chunk.GetColumn<Position>(); // Read<Position>
+		//   Span<Velocity>       velocities = chunk.GetColumn<Velocity>(); // Write<Velocity>
+		template <typename T>
+		inline auto GetColumn() const;
+
+		// Returns the entities of the chunk, in the same order as the columns
+		inline Span<EntityID const> GetEntities() const { return {m_pEntities, m_NumRows}; }
+
+		inline u64 GetNumRows() const { return m_NumRows; }
+
+	private:
+		template <typename... Ts>
+		friend class Query;
+
+		Array<void*, sizeof...(Terms)> m_Columns{}; // Start of the data of each term, nullptr if it has none
+		EntityID const*                m_pEntities = nullptr;
+		u64                            m_NumRows = 0;
+	};
+
+	// Persistent query over the entities of a database, the list of matching archetypes
+	// is cached and updated when new archetypes are created
+	// Queries with Changed<T>/Added<T> terms remember the version of their last iteration,
+	// so they must be kept alive between iterations (e.g. as a member of a system)
+	//
+	// Example:
+	//   Query<Write<Position>, Read<Velocity>, Without<Frozen>> query{db};
+	//   query.ForEach([dt](Position& pos, Velocity const& vel) {
+	//     pos.m_Value += vel.m_Value * dt;
+	//   });
+	template <typename... Terms>
+	class Query
+	{
+		static_assert(sizeof...(Terms) > 0, "A query needs at least one term");
+		static_assert(sizeof...(Terms) <= QueryInfo::MAX_ELEMENTS, "Too many query terms");
+
+	public:
+		Query() = default;
+		explicit Query(EntityDatabase& db);
+
+		void Initialize(EntityDatabase& db);
+
+		// Executes the callback once per matched entity. It receives an argument for
+		// every Read<T> (T const&), Write<T> (T&) and WithOptional<T> (T*) term, in order
+		template <typename Func>
+		void ForEach(Func&& callback);
+
+		// Executes the callback once per chunk of matched entities with a QueryChunk<Terms...>&
+		template <typename Func>
+		void ForEachChunk(Func&& callback);
+
+		// Same as ForEach but the chunks are distributed between the workers of the task system
+		// Each chunk is processed by a single worker so the callback can write to the components
+		// of the entity it receives, any other shared state must be synchronized by the caller
+		// Returns after all of the entities have been processed
+		template <typename Func>
+		void ParallelForEach(TaskSystem& taskSystem, Func&& callback);
+
+		// Same as ForEachChunk but the chunks are distributed between the workers of the task system
+		template <typename Func>
+		void ParallelForEachChunk(TaskSystem& taskSystem, Func&& callback);
+
+		// Appends all of the chunks that currently match the query, they are valid
+		// until an entity is created, deleted or changes its archetype
+		// Counts as an iteration of the query for the change filters
+		void GatherChunks(Vector<QueryChunk<Terms...>>& chunks);
+
+		// Returns the number of entities that currently match the query
+		u64 GetNumEntities() const;
+
+		// Returns the number of archetypes that currently match the query
+		u64 GetNumMatchedArchetypes() const;
+
+		inline bool IsInitialized() const { return m_pState != nullptr; }
+
+		// Builds the type-less description of the query
+		static QueryInfo CreateQueryInfo();
+
+	private:
+		// Returns the chunk of a matched archetype
+		QueryChunk<Terms...> GetChunk(u64 matchedArchetypeIndex, u64 chunkIndex) const;
+
+		// Executes the callback with every chunk that passes the change filters,
+		// marking the columns written by the query as changed
+		template <typename Func>
+		void ForEachMatchedChunk(Func&& callback);
+
+		template <typename Func, size_t... I>
+		static void ForEachRowInChunk(Func& callback, QueryChunk<Terms...> const& chunk, std::index_sequence<I...>);
+
+	private:
+		QueryState* m_pState = nullptr;
+		u64         m_LastIterationVersion = 0; // Version of the writes of the last iteration
+	};
+}
+
+// Template implementations
+//-----------------------------------------------------------------------------
+
+namespace CKE {
+	namespace QueryUtils {
+		// Returns the index of the first term that references the T component,
+		// terms that access the data are preferred over filters
+		template <typename T, typename... Terms>
+		constexpr size_t FindTermIndex() {
+			constexpr bool matches[] = {std::is_same_v<typename Terms::Component, T>...};
+			constexpr bool hasData[] = {!std::is_void_v<typename Terms::ColumnType>...};
+			for (size_t i = 0; i < sizeof...(Terms); ++i) {
+				if (matches[i] && hasData[i]) { return i; }
+			}
+			for (size_t i = 0; i < sizeof...(Terms); ++i) {
+				if (matches[i]) { return i; }
+			}
+			return sizeof...(Terms);
+		}
+	}
+
+	template <typename... Terms>
+	template <typename T>
+	auto QueryChunk<Terms...>::GetColumn() const {
+		constexpr size_t termIndex = QueryUtils::FindTermIndex<T, Terms...>();
+		static_assert(termIndex < sizeof...(Terms), "The component is not part of the query");
+
+		using Term = std::tuple_element_t<termIndex, std::tuple<Terms...>>;
+		using ColumnType = typename Term::ColumnType;
+		static_assert(!std::is_void_v<ColumnType>, "The query term doesn't access the component data");
+
+		ColumnType* pColumn = static_cast<ColumnType*>(m_Columns[termIndex]);
+		return Span<ColumnType>{pColumn, pColumn != nullptr ? m_NumRows : 0};
+	}
+
+	template <typename... Terms>
+	Query<Terms...>::Query(EntityDatabase& db) {
+		Initialize(db);
+	}
+
+	template <typename... Terms>
+	void Query<Terms...>::Initialize(EntityDatabase& db) {
+		m_pState = QueryState::GetOrCreate(db, CreateQueryInfo());
+
+#ifdef CKE_ECS_ACCESS_VALIDATION
+		for (u32 i = 0; i < m_pState->m_Info.m_QueryElementsCount; ++i) {
+			QueryElement const& element = m_pState->m_Info.m_QueryElements[i];
+			if (element.m_Access == QueryAccess::ReadOnly) { CKE_ECS_VALIDATE_READ(element.m_ComponentID); }
+			else if (element.m_Access != QueryAccess::None) { CKE_ECS_VALIDATE_WRITE(element.m_ComponentID); }
+		}
+#endif
+	}
+
+	template <typename... Terms>
+	QueryInfo Query<Terms...>::CreateQueryInfo() {
+		QueryInfo info{};
+		(info.AddElement(ComponentStaticTypeID<typename Terms::Component>::s_CompID,
+		                 Terms::s_Access, Terms::s_Op, Terms::s_Filter), ...);
+		return info;
+	}
+
+	template <typename... Terms>
+	QueryChunk<Terms...> Query<Terms...>::GetChunk(u64 matchedArchetypeIndex, u64 chunkIndex) const {
+		constexpr u64                   numTerms = sizeof...(Terms);
+		Archetype*                      pArchetype = m_pState->m_MatchedArchetypes[matchedArchetypeIndex];
+		ArchetypeComponentColumn const* pColumns = &m_pState->m_MatchedColumns[matchedArchetypeIndex * numTerms];
+
+		QueryChunk<Terms...> chunk{};
+		chunk.m_NumRows = pArchetype->GetNumRowsInChunk(chunkIndex);
+		chunk.m_pEntities = pArchetype->GetEntitiesInChunk(chunkIndex);
+		for (u64 term = 0; term < numTerms; ++term) {
+			if (pColumns[term] != INVALID_COMPONENT_COLUMN) {
+				chunk.m_Columns[term] = pArchetype->GetColumnInChunk(pColumns[term], chunkIndex);
+			}
+		}
+		return chunk;
+	}
+
+	template <typename... Terms>
+	template <typename Func>
+	void Query<Terms...>::ForEachMatchedChunk(Func&& callback) {
+		CKE_ASSERT(m_pState != nullptr); // Query has not been initialized
+
+		u64 lastVersion = m_LastIterationVersion;
+		u64 version = m_pState->BeginIteration();
+		for (u64 archIndex = 0; archIndex < m_pState->m_MatchedArchetypes.size(); ++archIndex) {
+			Archetype* pArchetype = m_pState->m_MatchedArchetypes[archIndex];
+			for (u64 chunkIndex = 0; chunkIndex < pArchetype->GetNumChunks(); ++chunkIndex) {
+				if (!m_pState->MatchesChangeFilters(archIndex, chunkIndex, lastVersion)) { continue; }
+				m_pState->MarkWrittenColumns(archIndex, chunkIndex, version);
+				callback(GetChunk(archIndex, chunkIndex));
+			}
+		}
+		m_LastIterationVersion = version;
+	}
+
+	template <typename... Terms>
+	void Query<Terms...>::GatherChunks(Vector<QueryChunk<Terms...>>& chunks) {
+		ForEachMatchedChunk([&chunks](QueryChunk<Terms...> const& chunk) { chunks.push_back(chunk); });
+	}
+
+	template <typename... Terms>
+	template <typename Func>
+	void Query<Terms...>::ForEachChunk(Func&& callback) {
+		ForEachMatchedChunk(callback);
+	}
+
+	template <typename... Terms>
+	template <typename Func>
+	void Query<Terms...>::ParallelForEachChunk(TaskSystem& taskSystem, Func&& callback) {
+		CKE_PROFILE_EVENT();
+
+		// Each partition of the task set is a range of chunks, so the workers
+		// never share a chunk and don't need any synchronization between them
+		struct ChunkTaskSet : public ITaskSet
+		{
+			QueryChunk<Terms...> const* m_pChunks = nullptr;
+			Func*                       m_pCallback = nullptr;
+			SystemAccessData const*     m_pAccess = nullptr; // Access of the system that iterates the query
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+				SystemAccessValidation::Scope accessScope{m_pAccess};
+				for (u32 i = range.start; i < range.end; ++i) {
+					(*m_pCallback)(m_pChunks[i]);
+				}
+			}
+		};
+
+		FrameVector<QueryChunk<Terms...>> chunks;
+		ForEachMatchedChunk([&chunks](QueryChunk<Terms...> const& chunk) { chunks.push_back(chunk); });
+		if (chunks.empty()) { return; }
+
+		ChunkTaskSet taskSet{};
+		taskSet.m_pChunks = chunks.data();
+		taskSet.m_pCallback = &callback;
+		taskSet.m_pAccess = SystemAccessValidation::GetCurrentAccess();
+		taskSet.m_SetSize = static_cast<u32>(chunks.size());
+		taskSet.m_MinRange = taskSystem.GetMinRangeForEvenSplit(taskSet.m_SetSize);
+
+		taskSystem.ScheduleTask(&taskSet);
+		taskSystem.WaitForTask(&taskSet);
+	}
+
+	template <typename... Terms>
+	template <typename Func>
+	void Query<Terms...>::ParallelForEach(TaskSystem& taskSystem, Func&& callback) {
+		ParallelForEachChunk(taskSystem, [&callback](QueryChunk<Terms...> const& chunk) {
+			ForEachRowInChunk(callback, chunk, std::index_sequence_for<Terms...>{});
+		});
+	}
+
+	template <typename... Terms>
+	template <typename Func, size_t... I>
+	void Query<Terms...>::ForEachRowInChunk(Func& callback, QueryChunk<Terms...> const& chunk,
+	                                        std::index_sequence<I...>) {
+		// Typed column pointers are resolved once per chunk so the row loop only does pointer arithmetic
+		std::tuple<typename Terms::ColumnType*...> columns{
+			static_cast<typename Terms::ColumnType*>(chunk.m_Columns[I])...
+		};
+
+		for (u64 row = 0; row < chunk.m_NumRows; ++row) {
+			std::apply(callback, std::tuple_cat(Terms::GetArg(std::get<I>(columns), row)...));
+		}
+	}
+
+	template <typename... Terms>
+	template <typename Func>
+	void Query<Terms...>::ForEach(Func&& callback) {
+		ForEachChunk([&callback](QueryChunk<Terms...> const& chunk) {
+			ForEachRowInChunk(callback, chunk, std::index_sequence_for<Terms...>{});
+		});
+	}
+
+	template <typename... Terms>
+	u64 Query<Terms...>::GetNumEntities() const {
+		CKE_ASSERT(m_pState != nullptr); // Query has not been initialized
+		return m_pState->GetNumEntities();
+	}
+
+	template <typename... Terms>
+	u64 Query<Terms...>::GetNumMatchedArchetypes() const {
+		CKE_ASSERT(m_pState != nullptr); // Query has not been initialized
+		return m_pState->m_MatchedArchetypes.size();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
+
+#include "ECSBaseSystem.h"
+
+namespace CKE {
+	// Executes the ECS systems of a frame, running concurrently the ones
+	// whose declared component accesses don't conflict
+	//
+	// Systems keep the order in which they were added: if two systems conflict, the one
+	// added first runs first. The resulting dependency graph is grouped in stages,
+	// all of the systems in a stage run in parallel on the task system and each stage
+	// waits for the previous one
+	class SystemScheduler
+	{
+	public:
+		// Adds a system at the end of the frame, the scheduler doesn't own it
+		void AddSystem(ECSBaseSystem* pSystem);
+
+		// Builds the dependency graph from the access declarations of the systems
+		// It is done automatically on the first update after adding a system,
+		// all of the accessed components must be registered by then
+		void BuildSchedule();
+
+		// Executes all of the systems and returns once they have finished
+		void Update(SystemUpdateContext ctx);
+
+		// Schedule info
+		//-----------------------------------------------------------------------------
+
+		inline u64 GetNumSystems() const { return m_Systems.size(); }
+		inline u64 GetNumStages() const { return m_Stages.size(); }
+
+		// Returns the stage in which a system runs
+		u64 GetSystemStage(ECSBaseSystem* pSystem) const;
+
+		// Returns the systems that must finish before a system can start
+		Vector<ECSBaseSystem*> GetSystemDependencies(ECSBaseSystem* pSystem) const;
+
+	private:
+		struct SystemNode
+		{
+			ECSBaseSystem*   m_pSystem = nullptr;
+			SystemAccessData m_Access{};
+			Vector<u32>      m_Dependencies{}; // Index of the systems that must run before this one
+			u32              m_Stage = 0;
+		};
+
+		struct SystemTask : public ITaskSet
+		{
+			SystemNode const*    m_pNode = nullptr;
+			SystemUpdateContext* m_pContext = nullptr;
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override;
+		};
+
+		static void RunSystem(SystemNode const& node, SystemUpdateContext ctx);
+		u64         GetSystemIndex(ECSBaseSystem* pSystem) const;
+
+	private:
+		Vector<SystemNode>       m_Systems;
+		Vector<Vector<u32>>      m_Stages; // Index of the systems of each stage
+		Vector<UPtr<SystemTask>> m_Tasks;  // Enough tasks for the largest stage
+		bool                     m_IsScheduleDirty = true;
+	};
+}
@@ -18,8 +18,6 @@ namespace CKE {
 	private:
 		// Auxiliary
 		template <size_t I = 0, typename... Ts>
-		constexpr inline void PopulateVectorWithComponentIDs(Vector<ComponentTypeID>& vec);
-		template <size_t I = 0, typename... Ts>
 		constexpr inline void PopulateTupleWithComponents(std::tuple<Ts...>& tuple);
 
 	private:
@@ -46,32 +44,23 @@ namespace CKE {
 //-----------------------------------------------------------------------------
 
 namespace CKE {
-	template <typename Comp, typename... Other>
-	template <size_t I, typename... Ts>
-	constexpr void TMultiComponentIter<Comp, Other...>::PopulateVectorWithComponentIDs(Vector<ComponentTypeID>& vec) {
-		if constexpr (I == sizeof...(Ts)) { return; }
-		else {
-			vec.emplace_back(ComponentStaticTypeID<std::tuple_element_t<I, std::tuple<Ts...>>>::s_CompID);
-			PopulateVectorWithComponentIDs<I + 1, Ts...>(vec);
-		}
-	}
-
 	template <typename Comp, typename... Other>
 	template <size_t I, typename... Ts>
 	constexpr void TMultiComponentIter<Comp, Other...>::PopulateTupleWithComponents(std::tuple<Ts...>& tuple) {
 		if constexpr (I == sizeof...(Ts)) { return; }
 		else {
-			std::get<I>(tuple) = (std::tuple_element_t<I, std::tuple<Ts...>>)m_pCurrCompArrays.at(I)->
-					GetCompAtIndex(m_CurrRowInArch);
+			std::get<I>(tuple) = (std::tuple_element_t<I, std::tuple<Ts...>>)m_pCurrArch->
+					GetComponentAt(m_CurrCompColumnsInArch[I], m_CurrRowInArch);
 			PopulateTupleWithComponents<I + 1>(tuple);
 		}
 	}
 
 	template <typename Comp, typename... Other>
 	TMultiComponentIter<Comp, Other...>::TMultiComponentIter(EntityDatabase* pEntityAdmin) {
-		// Convert template tuple into a vector with the component IDs
-		Vector<ComponentTypeID> componentIDs;
-		PopulateVectorWithComponentIDs<0, Comp, Other...>(componentIDs);
+		// Convert template tuple into an array with the component IDs
+		Array<ComponentTypeID, sizeof...(Other) + 1> const componentIDs{
+			ComponentStaticTypeID<Comp>::s_CompID, ComponentStaticTypeID<Other>::s_CompID...
+		};
 		Initialize(pEntityAdmin, componentIDs);
 	}
 
@@ -1,33 +1,133 @@
 #include "Archetype.h"
 #include "CookieKat/Core/Platform/Asserts.h"
 
+#include <algorithm>
+
 namespace CKE {
-	EntityID Archetype::RemoveEntityRow(u64 entityRow) {
-		CKE_ASSERT(m_NumEntities > 0);
+	namespace {
+		// Alignment of the start of each column inside a chunk
+		constexpr u64 COLUMN_ALIGNMENT = 16;
+
+		inline u64 AlignColumnOffset(u64 offset) {
+			return (offset + COLUMN_ALIGNMENT - 1) & ~(COLUMN_ALIGNMENT - 1);
+		}
+	}
+
+	void Archetype::AddColumn(ComponentTypeID componentID, u64 sizeInBytes) {
+		CKE_ASSERT(m_NumEntities == 0 && m_Chunks.empty()); // The layout can't change once the table has data
+		m_ArchTable.push_back(ArchetypeColumn{componentID, sizeInBytes, 0});
+	}
+
+	void Archetype::CalculateChunkLayout() {
+		// Each row contains the entity ID and a component of each column,
+		// we also reserve the worst case padding needed to align every column
+		u64 rowSizeInBytes = sizeof(EntityID);
+		for (ArchetypeColumn const& column : m_ArchTable) { rowSizeInBytes += column.m_SizeInBytes; }
+		u64 maxPaddingInBytes = COLUMN_ALIGNMENT * (m_ArchTable.size() + 1);
 
-		EntityID movedEntityID = m_RowIndexToEntity[m_NumEntities - 1];
-		m_RowIndexToEntity[m_NumEntities - 1] = EntityID::Invalid();
-		m_RowIndexToEntity[entityRow] = movedEntityID;
+		CKE_ASSERT(ARCHETYPE_CHUNK_SIZE > maxPaddingInBytes + rowSizeInBytes); // Components don't fit in a chunk
+		m_RowsPerChunk = (ARCHETYPE_CHUNK_SIZE - maxPaddingInBytes) / rowSizeInBytes;
 
-		for (auto&& componentArray : m_ArchTable) {
-			componentArray.RemoveCompAt(entityRow);
+		// Entity IDs are located at the start of the chunk, followed by all the component columns
+		u64 offset = AlignColumnOffset(m_RowsPerChunk * sizeof(EntityID));
+		for (ArchetypeColumn& column : m_ArchTable) {
+			column.m_OffsetInChunk = offset;
+			offset = AlignColumnOffset(offset + m_RowsPerChunk * column.m_SizeInBytes);
 		}
+		CKE_ASSERT(offset <= ARCHETYPE_CHUNK_SIZE);
+	}
+
+	EntityID Archetype::RemoveEntityRow(u64 entityRow, ChunkPool& chunkPool) {
+		CKE_ASSERT(m_NumEntities > 0);
+		CKE_ASSERT(entityRow < m_NumEntities);
 
+		// Fill the hole with the last row of the table to keep it packed
+		u64      lastRow = m_NumEntities - 1;
+		EntityID movedEntityID = GetEntityAt(lastRow);
+		if (entityRow != lastRow) {
+			u8* pChunk = m_Chunks[entityRow / m_RowsPerChunk];
+			reinterpret_cast<EntityID*>(pChunk)[entityRow % m_RowsPerChunk] = movedEntityID;
+			for (u64 column = 0; column < m_ArchTable.size(); ++column) {
+				memcpy(GetComponentAt(column, entityRow), GetComponentAt(column, lastRow),
+				       m_ArchTable[column].m_SizeInBytes);
+			}
+		}
 		m_NumEntities--;
+
+		// Return the last chunk to the pool as soon as it becomes empty
+		if (m_NumEntities <= (m_Chunks.size() - 1) * m_RowsPerChunk) {
+			chunkPool.FreeChunk(m_Chunks.back());
+			m_Chunks.pop_back();
+			m_ColumnVersions.resize(m_Chunks.size() * m_ArchTable.size());
+		}
+
 		return movedEntityID;
 	}
 
-	u64 Archetype::AddEntityRow(EntityID associatedEntity) {
-		m_NumEntities++;
+	u64 Archetype::AddEntityRow(EntityID associatedEntity, ChunkPool& chunkPool) {
+		return AddEntityRows(Span<EntityID const>{&associatedEntity, 1}, chunkPool);
+	}
+
+	u64 Archetype::AddEntityRows(Span<EntityID const> associatedEntities, ChunkPool& chunkPool) {
+		CKE_ASSERT(m_RowsPerChunk > 0); // The chunk layout has not been calculated
+
+		// The new rows are always at the end of the table, this also works
+		// for archetypes without component columns (Empty or Tag only)
+		u64 firstRow = m_NumEntities;
+		m_NumEntities += associatedEntities.size();
+
+		// Request all the chunks needed for the new rows at once
+		while (m_Chunks.size() * m_RowsPerChunk < m_NumEntities) {
+			m_Chunks.push_back(chunkPool.AllocateChunk());
+		}
+		m_ColumnVersions.resize(m_Chunks.size() * m_ArchTable.size());
+
+		for (u64 i = 0; i < associatedEntities.size(); ++i) {
+			u64 row = firstRow + i;
+			u8* pChunk = m_Chunks[row / m_RowsPerChunk];
+			reinterpret_cast<EntityID*>(pChunk)[row % m_RowsPerChunk] = associatedEntities[i];
+		}
+
+		return firstRow;
+	}
+
+	void Archetype::CopyToColumn(u64 componentColumn, u64 firstRow, u64 numRows, void const* pSrcData) {
+		CKE_ASSERT(firstRow + numRows <= m_NumEntities);
+
+		// The rows are only contiguous inside each chunk, so we copy one chunk segment at a time
+		u64       sizeInBytes = m_ArchTable[componentColumn].m_SizeInBytes;
+		u8 const* pSrc = static_cast<u8 const*>(pSrcData);
+		u64       row = firstRow;
+		u64       endRow = firstRow + numRows;
+		while (row < endRow) {
+			u64 numRowsInChunk = std::min(m_RowsPerChunk - row % m_RowsPerChunk, endRow - row);
+			memcpy(GetComponentAt(componentColumn, row), pSrc, numRowsInChunk * sizeInBytes);
+			pSrc += numRowsInChunk * sizeInBytes;
+			row += numRowsInChunk;
+		}
+	}
+
+	void Archetype::MarkRowsChanged(u64 componentColumn, u64 firstRow, u64 numRows, u64 version) {
+		if (numRows == 0) { return; }
+		CKE_ASSERT(firstRow + numRows <= m_NumEntities);
+		for (u64 chunk = firstRow / m_RowsPerChunk; chunk <= (firstRow + numRows - 1) / m_RowsPerChunk; ++chunk) {
+			GetColumnVersions(componentColumn, chunk).m_ChangedVersion = version;
+		}
+	}
 
-		// Create a row in all of the component arrays
-		// for the entity data
-		u64 entityArchetypeRow = -1;
-		for (auto&& componentArray : m_ArchTable) {
-			entityArchetypeRow = componentArray.AppendComponentToEnd();
+	void Archetype::MarkRowsAdded(u64 componentColumn, u64 firstRow, u64 numRows, u64 version) {
+		if (numRows == 0) { return; }
+		CKE_ASSERT(firstRow + numRows <= m_NumEntities);
+		for (u64 chunk = firstRow / m_RowsPerChunk; chunk <= (firstRow + numRows - 1) / m_RowsPerChunk; ++chunk) {
+			ArchetypeColumnVersions& versions = GetColumnVersions(componentColumn, chunk);
+			versions.m_ChangedVersion = version;
+			versions.m_AddedVersion = version;
 		}
-		m_RowIndexToEntity[entityArchetypeRow] = associatedEntity;
+	}
 
-		return entityArchetypeRow;
+	void Archetype::AddComponentToMask(ComponentTypeID componentID) {
+		u64 wordIndex = componentID / 64;
+		if (wordIndex >= m_ComponentMask.size()) { m_ComponentMask.resize(wordIndex + 1, 0); }
+		m_ComponentMask[wordIndex] |= 1ull << (componentID % 64);
 	}
 }
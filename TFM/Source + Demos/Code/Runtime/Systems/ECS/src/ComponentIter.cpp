@@ -30,14 +30,14 @@ namespace CKE {
 		}
 	}
 
-	MultiComponentIter::MultiComponentIter(EntityDatabase* pEntityAdmin, ComponentSet& componentID) {
+	MultiComponentIter::MultiComponentIter(EntityDatabase* pEntityAdmin, Span<ComponentTypeID const> componentID) {
 		Initialize(pEntityAdmin, componentID);
 	}
 
-	void MultiComponentIter::Initialize(EntityDatabase* pEntityAdmin, Vector<ComponentTypeID>& componentID) {
+	void MultiComponentIter::Initialize(EntityDatabase* pEntityAdmin, Span<ComponentTypeID const> componentID) {
 		m_IDToArchetype = &pEntityAdmin->m_IDToArchetype;
 		m_pComponentToArchetypes = &pEntityAdmin->m_ComponentToArchetypes;
-		m_CompsToIterate = componentID;
+		m_CompsToIterate.assign(componentID.begin(), componentID.end());
 
 		// We have a vector where we will store the matched
 		// archetypes that contain the given components
@@ -0,0 +1,66 @@
+#include "ECSBaseSystem.h"
+
+#include <algorithm>
+
+namespace CKE {
+	namespace {
+		inline bool ContainsComponent(Vector<ComponentTypeID> const& components, ComponentTypeID componentID) {
+			return std::find(components.begin(), components.end(), componentID) != components.end();
+		}
+
+		inline bool ContainsAnyComponent(Vector<ComponentTypeID> const& components,
+		                                 Vector<ComponentTypeID> const& other) {
+			for (ComponentTypeID componentID : other) {
+				if (ContainsComponent(components, componentID)) { return true; }
+			}
+			return false;
+		}
+	}
+
+	bool SystemAccessData::CanRead(ComponentTypeID componentID) const {
+		return m_IsExclusive
+				|| ContainsComponent(m_ReadOnlyComps, componentID)
+				|| ContainsComponent(m_ReadWriteComps, componentID);
+	}
+
+	bool SystemAccessData::CanWrite(ComponentTypeID componentID) const {
+		return m_IsExclusive || ContainsComponent(m_ReadWriteComps, componentID);
+	}
+
+	bool SystemAccessData::ConflictsWith(SystemAccessData const& other) const {
+		if (m_IsExclusive || other.m_IsExclusive) { return true; }
+
+		// Any number of systems can read a component at the same time,
+		// but a write conflicts with every other access
+		return ContainsAnyComponent(m_ReadWriteComps, other.m_ReadWriteComps)
+				|| ContainsAnyComponent(m_ReadWriteComps, other.m_ReadOnlyComps)
+				|| ContainsAnyComponent(m_ReadOnlyComps, other.m_ReadWriteComps);
+	}
+
+	//-----------------------------------------------------------------------------
+
+	SystemAccessValidation::Scope::Scope(SystemAccessData const* pAccess) {
+		// Workers can run other systems while they wait for a task, so the previous access is restored
+		m_pPreviousAccess = t_pCurrentAccess;
+		t_pCurrentAccess = pAccess;
+	}
+
+	SystemAccessValidation::Scope::~Scope() {
+		t_pCurrentAccess = m_pPreviousAccess;
+	}
+
+	void SystemAccessValidation::ValidateRead(ComponentTypeID componentID) {
+		if (t_pCurrentAccess == nullptr) { return; }
+		CKE_ASSERT(t_pCurrentAccess->CanRead(componentID)); // The system didn't declare a read of the component
+	}
+
+	void SystemAccessValidation::ValidateWrite(ComponentTypeID componentID) {
+		if (t_pCurrentAccess == nullptr) { return; }
+		CKE_ASSERT(t_pCurrentAccess->CanWrite(componentID)); // The system didn't declare a write to the component
+	}
+
+	void SystemAccessValidation::ValidateStructuralChange() {
+		if (t_pCurrentAccess == nullptr) { return; }
+		CKE_ASSERT(t_pCurrentAccess->m_IsExclusive); // Structural changes require exclusive access
+	}
+}
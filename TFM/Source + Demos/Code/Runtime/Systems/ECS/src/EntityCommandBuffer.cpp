@@ -0,0 +1,121 @@
+#include "EntityCommandBuffer.h"
+
+#include "EntityDatabase.h"
+
+#include <algorithm>
+
+namespace CKE {
+	EntityCommandBuffer::EntityCommandBuffer(EntityDatabase* pEntityDatabase) {
+		Initialize(pEntityDatabase);
+	}
+
+	void EntityCommandBuffer::Initialize(EntityDatabase* pEntityDatabase) {
+		CKE_ASSERT(pEntityDatabase != nullptr);
+		m_pEntityDatabase = pEntityDatabase;
+	}
+
+	void EntityCommandBuffer::CreateEntity(Span<ComponentTypeID const> componentSet, Span<void* const> componentData) {
+		u32 firstComponent = RecordComponents(componentSet, componentData);
+
+		// Creations with the same component set are batched together during playback,
+		// sorting the components here makes all of them store the components in the same order
+		auto componentsBegin = m_ComponentIDs.begin() + firstComponent;
+		auto offsetsBegin = m_ComponentDataOffsets.begin() + firstComponent;
+		for (u64 i = 1; i < componentSet.size(); ++i) {
+			for (u64 j = i; j > 0 && componentsBegin[j] < componentsBegin[j - 1]; --j) {
+				std::swap(componentsBegin[j], componentsBegin[j - 1]);
+				std::swap(offsetsBegin[j], offsetsBegin[j - 1]);
+			}
+		}
+
+		m_Commands.push_back(EntityCommand{
+			EntityCommandType::CreateEntity, EntityID::Invalid(), firstComponent, static_cast<u32>(componentSet.size())
+		});
+	}
+
+	void EntityCommandBuffer::DeleteEntity(EntityID entity) {
+		CKE_ASSERT(entity.IsValid());
+		m_Commands.push_back(EntityCommand{EntityCommandType::DeleteEntity, entity, 0, 0});
+	}
+
+	void EntityCommandBuffer::AddComponents(EntityID          entity, Span<ComponentTypeID const> componentSet,
+	                                        Span<void* const> componentData) {
+		CKE_ASSERT(entity.IsValid());
+		u32 firstComponent = RecordComponents(componentSet, componentData);
+		m_Commands.push_back(EntityCommand{
+			EntityCommandType::AddComponents, entity, firstComponent, static_cast<u32>(componentSet.size())
+		});
+	}
+
+	void EntityCommandBuffer::RemoveComponents(EntityID entity, Span<ComponentTypeID const> componentSet) {
+		CKE_ASSERT(entity.IsValid());
+		u32 firstComponent = static_cast<u32>(m_ComponentIDs.size());
+		for (ComponentTypeID componentID : componentSet) {
+			m_ComponentIDs.push_back(componentID);
+			m_ComponentDataOffsets.push_back(m_ComponentData.size());
+		}
+		m_Commands.push_back(EntityCommand{
+			EntityCommandType::RemoveComponents, entity, firstComponent, static_cast<u32>(componentSet.size())
+		});
+	}
+
+	u32 EntityCommandBuffer::RecordComponents(Span<ComponentTypeID const> componentSet,
+	                                          Span<void* const>           componentData) {
+		CKE_ASSERT(m_pEntityDatabase != nullptr); // Command buffer has not been initialized
+		CKE_ASSERT(componentSet.size() == componentData.size());
+
+		u32 firstComponent = static_cast<u32>(m_ComponentIDs.size());
+		for (u64 i = 0; i < componentSet.size(); ++i) {
+			u64 sizeInBytes = m_pEntityDatabase->GetComponentSizeInBytes(componentSet[i]);
+			u64 offset = m_ComponentData.size();
+			m_ComponentIDs.push_back(componentSet[i]);
+			m_ComponentDataOffsets.push_back(offset);
+			if (sizeInBytes > 0) {
+				CKE_ASSERT(componentData[i] != nullptr); // Check that we have passed actual data to copy
+				m_ComponentData.resize(offset + sizeInBytes);
+				memcpy(m_ComponentData.data() + offset, componentData[i], sizeInBytes);
+			}
+		}
+		return firstComponent;
+	}
+
+	void EntityCommandBuffer::Playback() {
+		CKE_ASSERT(m_pEntityDatabase != nullptr); // Command buffer has not been initialized
+		EntityCommandBuffer* pThis = this;
+		m_pEntityDatabase->ExecuteCommandBuffers(Span<EntityCommandBuffer* const>{&pThis, 1});
+	}
+
+	void EntityCommandBuffer::Clear() {
+		m_Commands.clear();
+		m_ComponentIDs.clear();
+		m_ComponentDataOffsets.clear();
+		m_ComponentData.clear();
+	}
+
+	//-----------------------------------------------------------------------------
+
+	void EntityCommandBufferSet::Initialize(EntityDatabase* pEntityDatabase, u32 numThreads) {
+		CKE_ASSERT(numThreads > 0);
+		m_pEntityDatabase = pEntityDatabase;
+		m_Buffers.clear();
+		for (u32 i = 0; i < numThreads; ++i) {
+			m_Buffers.emplace_back(std::make_unique<EntityCommandBuffer>(pEntityDatabase));
+		}
+	}
+
+	void EntityCommandBufferSet::Playback() {
+		CKE_ASSERT(m_pEntityDatabase != nullptr); // Command buffer set has not been initialized
+
+		Vector<EntityCommandBuffer*> buffers;
+		for (UPtr<EntityCommandBuffer>& pBuffer : m_Buffers) {
+			if (!pBuffer->IsEmpty()) { buffers.push_back(pBuffer.get()); }
+		}
+		m_pEntityDatabase->ExecuteCommandBuffers(buffers);
+	}
+
+	void EntityCommandBufferSet::Clear() {
+		for (UPtr<EntityCommandBuffer>& pBuffer : m_Buffers) {
+			pBuffer->Clear();
+		}
+	}
+}
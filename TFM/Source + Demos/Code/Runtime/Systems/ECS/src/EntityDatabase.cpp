@@ -11,8 +11,10 @@ namespace CKE {
 	void EntityDatabase::Initialize(u64 maxEntities) {
 		m_MaxNumEntities = maxEntities;
 		m_Entities.reserve(m_MaxNumEntities);
-		m_Archetypes.reserve(100'000);
 		m_ComponentTypes.reserve(25'000);
+
+		// Archetype for entities with 0 components, all new entities start here
+		m_pEmptyArchetype = CreateArchetype(Vector<ComponentTypeID>{});
 	}
 
 	void EntityDatabase::Shutdown() { }
@@ -24,13 +26,16 @@ namespace CKE {
 		return m_LastComponentID;
 	}
 
-	ComponentSetID EntityDatabase::CalculateComponentSetID(Vector<ComponentTypeID> const& componentSet) {
-		Vector<ComponentTypeID> compVec = componentSet;
-		std::sort(compVec.begin(), compVec.end());
+	u64 EntityDatabase::GetComponentSizeInBytes(ComponentTypeID componentID) const {
+		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
+		return m_ComponentTypeData.at(componentID).m_SizeInBytes;
+	}
 
+	ComponentSetID EntityDatabase::CalculateComponentSetID(Span<ComponentTypeID const> componentSet) {
+		// XOR is commutative so we don't need to sort the set
 		ComponentSetID id = 254633;
-		for (int i = 0; i < compVec.size(); ++i) {
-			id ^= std::hash<ComponentSetID>()(compVec[i]) << i;
+		for (ComponentTypeID compID : componentSet) {
+			id ^= HashComponentID(compID);
 		}
 		return id;
 	}
@@ -43,7 +48,7 @@ namespace CKE {
 		return m_ComponentToArchetypes.at(component).at(archetypeID);
 	}
 
-	void EntityDatabase::CreateArchetype(Vector<ComponentTypeID> const& componentSet) {
+	Archetype* EntityDatabase::CreateArchetype(Vector<ComponentTypeID> const& componentSet) {
 		// Generate a new archetype ID
 		m_LastArchetypeID++;
 
@@ -51,12 +56,12 @@ namespace CKE {
 		ComponentSetID componentSetID = CalculateComponentSetID(componentSet);
 
 		// Create the archetype and initialize some basic data
-		Archetype& archetype = m_Archetypes.emplace_back(Archetype{});
+		// Archetypes are allocated individually so their address doesn't change when more are created
+		Archetype& archetype = *m_Archetypes.emplace_back(std::make_unique<Archetype>());
 		archetype.m_ComponentSet = componentSet;
+		archetype.m_ComponentSetID = componentSetID;
 		archetype.m_ID = m_LastArchetypeID;
 		archetype.m_NumEntities = 0;
-		archetype.m_RowIndexToEntity.resize(m_MaxNumEntities);
-		std::fill(archetype.m_RowIndexToEntity.begin(), archetype.m_RowIndexToEntity.end(), EntityID::Invalid());
 
 		// Set data relationships
 		m_ComponentSetToArchetype.insert({componentSetID, &archetype});
@@ -66,11 +71,12 @@ namespace CKE {
 		int componentColumn = 0;
 		for (ComponentTypeID componentID : componentSet) {
 			CKE_ASSERT(m_ComponentTypeData.contains(componentID));
+			archetype.AddComponentToMask(componentID);
 			u64 compSizeInBytes = m_ComponentTypeData.at(componentID).m_SizeInBytes;
 			if (compSizeInBytes == 0) { continue; } // If a component has size 0 don't create an array for it
 
-			// Create component array
-			archetype.m_ArchTable.push_back(ComponentArray{componentID, m_MaxNumEntities, compSizeInBytes});
+			// Create component column
+			archetype.AddColumn(componentID, compSizeInBytes);
 
 			// If we find the component doesn't have a relationship
 			// with any archetype then we create it
@@ -85,92 +91,217 @@ namespace CKE {
 
 			componentColumn++;
 		}
+
+		// Memory for the table is only requested from the chunk pool when entities are added
+		archetype.CalculateChunkLayout();
+
+		// Existing queries are updated here, so they never have to search for new archetypes
+		std::lock_guard lock{*m_pQueriesMutex};
+		for (UPtr<QueryState>& pQuery : m_Queries) {
+			pQuery->TryAddArchetype(&archetype);
+		}
+
+		return &archetype;
 	}
 
-	bool EntityDatabase::HasComponent(EntityID entity, ComponentTypeID componentID) {
-		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
-		CKE_ASSERT(m_EntityToRecord.contains(entity));         // Check that the entity exists;
+	bool EntityDatabase::HasRepeatedComponents(Span<ComponentTypeID const> componentSet) {
+		for (u64 i = 0; i < componentSet.size(); ++i) {
+			for (u64 j = i + 1; j < componentSet.size(); ++j) {
+				if (componentSet[i] == componentSet[j]) { return true; }
+			}
+		}
+		return false;
+	}
 
-		ArchetypeID entityArchID = m_EntityToRecord[entity].m_pArchetype->m_ID;
-		auto&&      compArchetypes = m_ComponentToArchetypes[componentID];
-		return compArchetypes.contains(entityArchID);
+	Vector<ComponentTypeID> EntityDatabase::RemoveRepeatedComponents(Span<ComponentTypeID const> componentSet) {
+		Vector<ComponentTypeID> uniqueSet;
+		for (ComponentTypeID compID : componentSet) {
+			if (std::find(uniqueSet.begin(), uniqueSet.end(), compID) == uniqueSet.end()) {
+				uniqueSet.push_back(compID);
+			}
+		}
+		return uniqueSet;
 	}
 
-	void EntityDatabase::AddSingletonComponent(ComponentTypeID componentID, void* pComponentData) {
-		CKE_ASSERT(!m_IDToSingletonComponents.contains(componentID));
-		CKE_ASSERT(pComponentData != nullptr);
+	QueryState* EntityDatabase::GetOrCreateQueryState(QueryInfo const& queryInfo) {
+		// Systems that don't conflict can build their queries at the same time
+		std::lock_guard lock{*m_pQueriesMutex};
+		for (UPtr<QueryState>& pQuery : m_Queries) {
+			if (pQuery->m_Info == queryInfo) { return pQuery.get(); }
+		}
 
-		SingletonComponentRecord record{};
-		record.m_SizeInBytes = m_ComponentTypeData.at(componentID).m_SizeInBytes;
-		record.m_pComponentData = CKE::Alloc(m_ComponentTypeData.at(componentID).m_SizeInBytes);
-		memcpy(record.m_pComponentData, pComponentData, sizeof(SingletonComponentRecord));
-		m_IDToSingletonComponents.insert({componentID, record});
+		QueryState& query = *m_Queries.emplace_back(std::make_unique<QueryState>());
+		query.m_Info = queryInfo;
+		query.m_pDatabase = this;
+		query.m_HasChangeFilters = queryInfo.HasChangeFilters();
+		for (UPtr<Archetype>& pArchetype : m_Archetypes) {
+			query.TryAddArchetype(pArchetype.get());
+		}
+		return &query;
 	}
 
-	void EntityDatabase::RemoveSingletonComponent(ComponentTypeID componentID) {
-		CKE_ASSERT(m_IDToSingletonComponents.contains(componentID));
-		m_IDToSingletonComponents.erase(componentID);
+	Archetype* EntityDatabase::GetOrCreateArchetype(Vector<ComponentTypeID> const& componentSet) {
+		ComponentSetID componentSetID = CalculateComponentSetID(componentSet);
+		auto           archIt = m_ComponentSetToArchetype.find(componentSetID);
+		if (archIt != m_ComponentSetToArchetype.end()) { return archIt->second; }
+		return CreateArchetype(componentSet);
 	}
 
-	void* EntityDatabase::GetSingletonComponent(ComponentTypeID componentID) {
-		CKE_ASSERT(m_IDToSingletonComponents.contains(componentID));
-		return m_IDToSingletonComponents.at(componentID).m_pComponentData;
+	ArchetypeTransition const& EntityDatabase::GetAddTransition(Archetype*                  pArchetype,
+	                                                            Span<ComponentTypeID const> componentSet) {
+		// {C, D, D} has the same set ID as {C}, so it must follow the edge of {C, D} instead
+		if (componentSet.size() > 1 && HasRepeatedComponents(componentSet)) [[unlikely]] {
+			return GetAddTransition(pArchetype, RemoveRepeatedComponents(componentSet));
+		}
+
+		// Edges are indexed by the set ID of the target archetype, which can be calculated
+		// incrementally from the current archetype without sorting or allocating
+		ComponentSetID targetSetID = pArchetype->m_ComponentSetID;
+		for (ComponentTypeID compID : componentSet) { targetSetID ^= HashComponentID(compID); }
+
+		auto edgeIt = pArchetype->m_AddEdges.find(targetSetID);
+		if (edgeIt != pArchetype->m_AddEdges.end()) [[likely]] {
+			CKE_ASSERT(edgeIt->second.m_AddedComps.size() == componentSet.size());
+			return edgeIt->second;
+		}
+
+		// First time we follow this edge, find the target archetype and cache the transition
+		Vector<ComponentTypeID> newComponentSet = pArchetype->m_ComponentSet;
+		for (ComponentTypeID compID : componentSet) {
+			CKE_ASSERT(m_ComponentTypeData.contains(compID)); // Check that the component has been registered
+			CKE_ASSERT(std::find(newComponentSet.begin(), newComponentSet.end(), compID) ==
+				newComponentSet.end()); // Entity already has the component
+			newComponentSet.push_back(compID);
+		}
+		Archetype* pNewArchetype = GetOrCreateArchetype(newComponentSet);
+		CKE_ASSERT(pNewArchetype->m_ComponentSetID == targetSetID);
+
+		ArchetypeTransition& transition = pArchetype->m_AddEdges[targetSetID];
+		BuildTransition(pArchetype, pNewArchetype, transition);
+		for (ComponentTypeID compID : componentSet) {
+			ArchetypeAddedComponent addedComp{compID, INVALID_COMPONENT_COLUMN, 0};
+			addedComp.m_SizeInBytes = m_ComponentTypeData.at(compID).m_SizeInBytes;
+			if (addedComp.m_SizeInBytes > 0) {
+				addedComp.m_Column = GetComponentColumnInArchetype(compID, pNewArchetype->m_ID);
+			}
+			transition.m_AddedComps.push_back(addedComp);
+		}
+
+		// The inverse edge is always known at this point, so we cache it too
+		if (!pNewArchetype->m_RemoveEdges.contains(pArchetype->m_ComponentSetID)) {
+			BuildTransition(pNewArchetype, pArchetype, pNewArchetype->m_RemoveEdges[pArchetype->m_ComponentSetID]);
+		}
+
+		return transition;
 	}
 
-	void* EntityDatabase::GetComponent(EntityID entity, ComponentTypeID componentID) {
-		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
-		CKE_ASSERT(m_EntityToRecord.contains(entity));         // Check that the entity exists;
+	ArchetypeTransition const& EntityDatabase::GetRemoveTransition(Archetype*                  pArchetype,
+	                                                               Span<ComponentTypeID const> componentSet) {
+		if (componentSet.size() > 1 && HasRepeatedComponents(componentSet)) [[unlikely]] {
+			return GetRemoveTransition(pArchetype, RemoveRepeatedComponents(componentSet));
+		}
 
-		auto&      entityRecord = m_EntityToRecord[entity];
-		Archetype* pArchetype = entityRecord.m_pArchetype;
-		u64        row = entityRecord.m_EntityArchetypeRow;
+		ComponentSetID targetSetID = pArchetype->m_ComponentSetID;
+		for (ComponentTypeID compID : componentSet) { targetSetID ^= HashComponentID(compID); }
 
-		if (HasComponent(entity, componentID)) {
-			u64             compColumnInArchTable = GetComponentColumnInArchetype(componentID, pArchetype->m_ID);
-			ComponentArray* componentArray = &pArchetype->m_ArchTable.at(compColumnInArchTable);
-			u8*             pComponentData = componentArray->GetCompAtIndex(row);
-			return pComponentData;
+		auto edgeIt = pArchetype->m_RemoveEdges.find(targetSetID);
+		if (edgeIt != pArchetype->m_RemoveEdges.end()) [[likely]] {
+			CKE_ASSERT(pArchetype->m_ComponentSet.size() - edgeIt->second.m_pTarget->m_ComponentSet.size()
+				== componentSet.size());
+			return edgeIt->second;
 		}
-		CKE_UNREACHABLE_CODE();
-		return nullptr;
+
+		// First time we follow this edge, find the target archetype and cache the transition
+		Vector<ComponentTypeID> newComponentSet = pArchetype->m_ComponentSet;
+		for (ComponentTypeID compID : componentSet) {
+			CKE_ASSERT(m_ComponentTypeData.contains(compID)); // Check that the component has been registered
+			auto compIt = std::find(newComponentSet.begin(), newComponentSet.end(), compID);
+			CKE_ASSERT(compIt != newComponentSet.end()); // Entity doesn't have the component
+			*compIt = newComponentSet.back();
+			newComponentSet.pop_back();
+		}
+		Archetype* pNewArchetype = GetOrCreateArchetype(newComponentSet);
+		CKE_ASSERT(pNewArchetype->m_ComponentSetID == targetSetID);
+
+		ArchetypeTransition& transition = pArchetype->m_RemoveEdges[targetSetID];
+		BuildTransition(pArchetype, pNewArchetype, transition);
+
+		return transition;
 	}
 
-	void EntityDatabase::AddComponent(EntityID entityID, ComponentTypeID componentID, void* pComponentData) {
-		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
-		CKE_ASSERT(m_EntityToRecord.contains(entityID));       // Check that the entity exists
+	void EntityDatabase::BuildTransition(Archetype*           pSrcArchetype, Archetype* pDstArchetype,
+	                                     ArchetypeTransition& transition) const {
+		transition.m_pTarget = pDstArchetype;
+		transition.m_ColumnMoves.clear();
+
+		// Only the components that are present in both archetypes and have data need to be copied
+		for (ComponentTypeID compID : pSrcArchetype->m_ComponentSet) {
+			u64 compSizeInBytes = m_ComponentTypeData.at(compID).m_SizeInBytes;
+			if (compSizeInBytes == 0) { continue; }
+
+			auto const& archToCompCol = m_ComponentToArchetypes.at(compID);
+			auto        dstColumnIt = archToCompCol.find(pDstArchetype->m_ID);
+			if (dstColumnIt == archToCompCol.end()) { continue; }
+
+			ArchetypeColumnMove move{};
+			move.m_SrcColumn = archToCompCol.at(pSrcArchetype->m_ID);
+			move.m_DstColumn = dstColumnIt->second;
+			move.m_SizeInBytes = compSizeInBytes;
+			transition.m_ColumnMoves.push_back(move);
+		}
+	}
 
-		// Cache data from soon to be old entity archetype
-		EntityRecord& record = m_EntityToRecord[entityID];
-		Archetype*    pOldArchetype = record.m_pArchetype;
-		u64           oldArchetypeRow = record.m_EntityArchetypeRow;
+	void EntityDatabase::CopyAddedComponentsData(ArchetypeTransition const&  transition, u64 targetRow,
+	                                             Span<ComponentTypeID const> componentSet,
+	                                             Span<void* const>           componentData, u64 numRows) {
+		CKE_ASSERT(componentSet.size() == componentData.size());
+		CKE_ASSERT(componentSet.size() >= transition.m_AddedComps.size());
+
+		// The added components are stored in the same order they were supplied when the edge was created,
+		// but the same edge can be used with any permutation of the set
+		// Repeated components are copied in order, so the data of the last one is kept
+		for (u64 i = 0; i < componentSet.size(); ++i) {
+			ArchetypeAddedComponent const* pAddedComp =
+					i < transition.m_AddedComps.size() ? &transition.m_AddedComps[i] : nullptr;
+			if (pAddedComp == nullptr || pAddedComp->m_ComponentID != componentSet[i]) {
+				auto addedIt = std::find_if(transition.m_AddedComps.begin(), transition.m_AddedComps.end(),
+				                            [&](ArchetypeAddedComponent const& added) {
+					                            return added.m_ComponentID == componentSet[i];
+				                            });
+				CKE_ASSERT(addedIt != transition.m_AddedComps.end());
+				pAddedComp = &*addedIt;
+			}
 
-		// Define new Entity Component Set and calculate its ID
-		Vector<ComponentTypeID> newComponentSet = pOldArchetype->m_ComponentSet;
-		newComponentSet.push_back(componentID);
-		ComponentSetID newComponentSetID = CalculateComponentSetID(newComponentSet);
+			// Only copy if size is bigger than 0, if its 0 it means its just a tag component
+			// The rows are contiguous inside each chunk so there is a single copy per chunk
+			if (pAddedComp->m_SizeInBytes > 0) {
+				CKE_ASSERT(componentData[i] != nullptr); // Check that we have passed actual data to copy
+				transition.m_pTarget->CopyToColumn(pAddedComp->m_Column, targetRow, numRows, componentData[i]);
+				transition.m_pTarget->MarkRowsAdded(pAddedComp->m_Column, targetRow, numRows, GetChangeVersion());
+			}
+		}
+	}
 
-		// Find or create the new archetype for the component set
-		if (!m_ComponentSetToArchetype.contains(newComponentSetID)) { CreateArchetype(newComponentSet); }
-		Archetype* pNewArchetype = m_ComponentSetToArchetype.at(newComponentSetID);
+	u64 EntityDatabase::MoveEntityToArchetype(EntityID                   entityID, EntityRecord& record,
+	                                          ArchetypeTransition const& transition) {
+		Archetype* pOldArchetype = record.m_pArchetype;
+		u64        oldArchetypeRow = record.m_EntityArchetypeRow;
+		Archetype* pNewArchetype = transition.m_pTarget;
 
 		// Create a new row in the new archetype
-		u64 newArchetypeRow = pNewArchetype->AddEntityRow(entityID);
+		u64 newArchetypeRow = pNewArchetype->AddEntityRow(entityID, m_ChunkPool);
 
-		// Copy old component data into new archetype
+		// Copy the shared component data into the new archetype
 		// At this point there is a row for the entity in both archetypes
-		for (ComponentTypeID& compID : pOldArchetype->m_ComponentSet) {
-			MoveComponentDataFromToArch(pOldArchetype, oldArchetypeRow, pNewArchetype, newArchetypeRow, compID);
+		for (ArchetypeColumnMove const& move : transition.m_ColumnMoves) {
+			memcpy(pNewArchetype->GetComponentAt(move.m_DstColumn, newArchetypeRow),
+			       pOldArchetype->GetComponentAt(move.m_SrcColumn, oldArchetypeRow),
+			       move.m_SizeInBytes);
 		}
 
-		// Copy newly added component data into new archetype
-		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Component not registered
-		// Only copy if size is bigger than 0, if its 0 it means its just a tag component
-		u64 compSizeInBytes = m_ComponentTypeData.at(componentID).m_SizeInBytes;
-		if (compSizeInBytes > 0) {
-			CKE_ASSERT(pComponentData != nullptr); // Check that we have passed actual data to copy
-			u64 newCompColumn = GetComponentColumnInArchetype(componentID, pNewArchetype->m_ID);
-			u8* pComp = static_cast<u8*>(pNewArchetype->GetComponentAt(newCompColumn, newArchetypeRow));
-			memcpy(pComp, pComponentData, compSizeInBytes);
+		// The entity is new to the chunk, so queries that didn't match its previous archetype see it as changed
+		for (u64 column = 0; column < pNewArchetype->m_ArchTable.size(); ++column) {
+			pNewArchetype->MarkRowsChanged(column, newArchetypeRow, 1, GetChangeVersion());
 		}
 
 		// Update Record to point to new archetype
@@ -178,29 +309,82 @@ namespace CKE {
 		record.m_pArchetype = pNewArchetype;
 
 		// Remove entity it from the previous archetype
-		EntityID movedEntityID = pOldArchetype->RemoveEntityRow(oldArchetypeRow);
+		if (!m_RemovedComponents.empty()) { RecordRemovedComponents(pOldArchetype, oldArchetypeRow, pNewArchetype); }
+		EntityID movedEntityID = pOldArchetype->RemoveEntityRow(oldArchetypeRow, m_ChunkPool);
 		// When we remove a row from an archetype, we need to fill the hole left in that position so we move
 		// the last element of the array to the removed row.
 		// We have to find the entity that points to that moved row and update it.
 		if (entityID != movedEntityID) {
-			m_EntityToRecord[movedEntityID].m_EntityArchetypeRow = oldArchetypeRow;
+			m_EntityRecords[movedEntityID.GetIndex()].m_EntityArchetypeRow = oldArchetypeRow;
+		}
+
+		return newArchetypeRow;
+	}
+
+	bool EntityDatabase::HasComponent(EntityID entity, ComponentTypeID componentID) {
+		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
+		return GetEntityRecord(entity).m_pArchetype->HasComponent(componentID);
+	}
+
+	void EntityDatabase::AddSingletonComponent(ComponentTypeID componentID, void* pComponentData) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+		CKE_ASSERT(!m_IDToSingletonComponents.contains(componentID));
+		CKE_ASSERT(pComponentData != nullptr);
+
+		SingletonComponentRecord record{};
+		record.m_SizeInBytes = m_ComponentTypeData.at(componentID).m_SizeInBytes;
+		record.m_pComponentData = CKE::Alloc(m_ComponentTypeData.at(componentID).m_SizeInBytes);
+		memcpy(record.m_pComponentData, pComponentData, sizeof(SingletonComponentRecord));
+		m_IDToSingletonComponents.insert({componentID, record});
+	}
+
+	void EntityDatabase::RemoveSingletonComponent(ComponentTypeID componentID) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+		CKE_ASSERT(m_IDToSingletonComponents.contains(componentID));
+		m_IDToSingletonComponents.erase(componentID);
+	}
+
+	void* EntityDatabase::GetSingletonComponent(ComponentTypeID componentID) {
+		CKE_ECS_VALIDATE_READ(componentID);
+		CKE_ASSERT(m_IDToSingletonComponents.contains(componentID));
+		return m_IDToSingletonComponents.at(componentID).m_pComponentData;
+	}
+
+	void* EntityDatabase::GetComponent(EntityID entity, ComponentTypeID componentID) {
+		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
+		CKE_ECS_VALIDATE_READ(componentID);
+
+		EntityRecord& entityRecord = GetEntityRecord(entity);
+		Archetype*    pArchetype = entityRecord.m_pArchetype;
+
+		ArchetypeComponentColumn compColumn = pArchetype->GetComponentColumn(componentID);
+		if (compColumn != INVALID_COMPONENT_COLUMN) {
+			// The returned data can be modified, so it is considered a write
+			pArchetype->MarkRowsChanged(compColumn, entityRecord.m_EntityArchetypeRow, 1, GetChangeVersion());
+			return pArchetype->GetComponentAt(compColumn, entityRecord.m_EntityArchetypeRow);
 		}
+		CKE_UNREACHABLE_CODE(); // Entity doesn't have the component or it is a Tag
+		return nullptr;
+	}
+
+	void EntityDatabase::AddComponent(EntityID entityID, ComponentTypeID componentID, void* pComponentData) {
+		AddComponents(entityID, Span<ComponentTypeID const>{&componentID, 1}, Span<void* const>{&pComponentData, 1});
 	}
 
-	void EntityDatabase::MoveComponentDataFromToArch(Archetype*   pOldArchetype, u64 oldArchetypeRow,
-	                                                 Archetype*   pNewArchetype, u64 newArchetypeRow,
-	                                                 ComponentTypeID& compID) {
-		// Get the column of the current component in each archetype
-		u64 oldCompColumnInOldArchetype = GetComponentColumnInArchetype(compID, pOldArchetype->m_ID);
-		u64 oldCompColumnInNewArchetype = GetComponentColumnInArchetype(compID, pNewArchetype->m_ID);
+	void EntityDatabase::AddComponents(EntityID          entityID, Span<ComponentTypeID const> componentSet,
+	                                   Span<void* const> componentData) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
 
-		// Get the size of the component in bytes
-		u64 compSizeInBytes = m_ComponentTypeData[compID].m_SizeInBytes;
+		// The transition of an empty set goes back to the same archetype, there is nothing to move
+		if (componentSet.empty()) { return; }
 
-		// Get the pointers of the component locations and copy the data
-		u8* pOldComp = (u8*)pOldArchetype->GetComponentAt(oldCompColumnInOldArchetype, oldArchetypeRow);
-		u8* pNewComp = (u8*)pNewArchetype->GetComponentAt(oldCompColumnInNewArchetype, newArchetypeRow);
-		memcpy(pNewComp, pOldComp, compSizeInBytes);
+		// Follow the archetype graph edge and move the entity data once
+		EntityRecord&              record = GetEntityRecord(entityID);
+		ArchetypeTransition const& transition = GetAddTransition(record.m_pArchetype, componentSet);
+		u64                        newArchetypeRow = MoveEntityToArchetype(entityID, record, transition);
+
+		// Copy newly added component data into new archetype
+		CopyAddedComponentsData(transition, newArchetypeRow, componentSet, componentData);
 	}
 
 	EntityDatabaseDebugger EntityDatabase::GetDebugger() {
@@ -209,7 +393,7 @@ namespace CKE {
 
 	void EntityDatabase::PrintAdminState() {
 		u32 numArchetypesInUse = 0;
-		for (Archetype& arch : m_Archetypes) { if (arch.m_NumEntities != 0) { numArchetypesInUse++; } }
+		for (auto& pArch : m_Archetypes) { if (pArch->m_NumEntities != 0) { numArchetypesInUse++; } }
 
 		std::cout << "-------------------------------------------------------------------" << std::endl;
 		std::cout << "	Entity Admin State" << std::endl;
@@ -227,7 +411,8 @@ namespace CKE {
 
 		std::cout << "-------------------------------------------------------------------" << std::endl;
 
-		for (Archetype& arch : m_Archetypes) {
+		for (auto& pArchetype : m_Archetypes) {
+			Archetype& arch = *pArchetype;
 			if (arch.m_NumEntities == 0) { continue; }
 
 			std::cout << "Archetype " << arch.m_ID << " - " << arch.m_NumEntities << " Entities" << std::endl;
@@ -241,10 +426,10 @@ namespace CKE {
 	}
 
 	void EntityDatabase::PrintEntityState(EntityID entityID) {
-		EntityRecord& record = m_EntityToRecord[entityID];
+		EntityRecord& record = GetEntityRecord(entityID);
 		Archetype*    pArch = record.m_pArchetype;
 
-		std::cout << "Entity " << entityID.GetValue() << std::endl;
+		std::cout << "Entity " << entityID.GetIndex() << " (Generation " << entityID.GetGeneration() << ")" << std::endl;
 
 		std::ios_base::fmtflags f(std::cout.flags());
 
@@ -252,7 +437,7 @@ namespace CKE {
 			ArchetypeComponentColumn compCol = m_ComponentToArchetypes.at(archCompID).at(record.m_pArchetype->m_ID);
 			String&                  compName = m_ComponentTypeData[archCompID].m_Name;
 			u64                      compSize = m_ComponentTypeData[archCompID].m_SizeInBytes;
-			u8*                      compData = pArch->m_ArchTable[compCol].GetCompAtIndex(record.m_EntityArchetypeRow);
+			u8*                      compData = static_cast<u8*>(pArch->GetComponentAt(compCol, record.m_EntityArchetypeRow));
 
 			std::cout << "    " << compName << " " << compSize << " Bytes - ";
 			for (int i = 0; i < compSize; ++i) {
@@ -269,12 +454,14 @@ namespace CKE {
 		s.m_NumEntities = m_Db->m_Entities.size();
 		s.m_NumComponentTypes = m_Db->m_ComponentTypes.size();
 		s.m_NumArchetypes = m_Db->m_Archetypes.size();
+		s.m_NumChunksInUse = m_Db->m_ChunkPool.GetNumChunksInUse();
+		s.m_ChunkMemoryInBytes = m_Db->m_ChunkPool.GetAllocatedSizeInBytes();
 		return s;
 	}
 
 	void EntityDatabaseDebugger::PrintGeneralState() const {
 		u32 numArchetypesInUse = 0;
-		for (Archetype& arch : m_Db->m_Archetypes) { if (arch.m_NumEntities != 0) { numArchetypesInUse++; } }
+		for (auto& pArch : m_Db->m_Archetypes) { if (pArch->m_NumEntities != 0) { numArchetypesInUse++; } }
 
 		std::cout << "-------------------------------------------------------------------" << std::endl;
 		std::cout << "	Entity Admin State" << std::endl;
@@ -292,7 +479,8 @@ namespace CKE {
 
 		std::cout << "-------------------------------------------------------------------" << std::endl;
 
-		for (Archetype& arch : m_Db->m_Archetypes) {
+		for (auto& pArchetype : m_Db->m_Archetypes) {
+			Archetype& arch = *pArchetype;
 			if (arch.m_NumEntities == 0) { continue; }
 
 			std::cout << "Archetype " << arch.m_ID << " - " << arch.m_NumEntities << " Entities" << std::endl;
@@ -306,106 +494,422 @@ namespace CKE {
 	}
 
 	void EntityDatabase::RemoveComponent(EntityID entityID, ComponentTypeID componentID) {
-		CKE_ASSERT(m_ComponentTypeData.contains(componentID)); // Check that the component has been registered
-		CKE_ASSERT(m_EntityToRecord.contains(entityID));       // Check that the entity exists;
-
-		// Cache data from soon to be old entity archetype
-		EntityRecord& entityRecord = m_EntityToRecord[entityID];
-		Archetype*    pOldArchetype = entityRecord.m_pArchetype;
-		u64           oldArchetypeRow = entityRecord.m_EntityArchetypeRow;
-
-		// Define new Entity Component Set and calculate its ID
-		Vector<ComponentTypeID> newComponentSet = pOldArchetype->m_ComponentSet;
-		for (int i = 0; i < newComponentSet.size(); ++i) {
-			if (newComponentSet[i] == componentID) {
-				newComponentSet[i] = newComponentSet[newComponentSet.size() - 1];
-				newComponentSet.pop_back();
-			}
-		}
-		ComponentSetID newComponentSetID = CalculateComponentSetID(newComponentSet);
-
-		// Find or create the new archetype for the component set
-		// (High chances of not creating a new archetype)
-		if (!m_ComponentSetToArchetype.contains(newComponentSetID)) { CreateArchetype(newComponentSet); }
-		Archetype* pNewArchetype = m_ComponentSetToArchetype.at(newComponentSetID);
-
-		// Create a new row in the new archetype
-		u64 newArchetypeRow = pNewArchetype->AddEntityRow(entityID);
+		RemoveComponents(entityID, Span<ComponentTypeID const>{&componentID, 1});
+	}
 
-		// Copy old component data into new archetype
-		// At this point there is a row for the entity in both archetypes
-		// Only copy the components present in the new archetype
-		for (ComponentTypeID& compID : pNewArchetype->m_ComponentSet) {
-			MoveComponentDataFromToArch(pOldArchetype, oldArchetypeRow, pNewArchetype, newArchetypeRow, compID);
-		}
+	void EntityDatabase::RemoveComponents(EntityID entityID, Span<ComponentTypeID const> componentSet) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+		if (componentSet.empty()) { return; }
 
-		// Update Record to point to new archetype
-		entityRecord.m_EntityArchetypeRow = newArchetypeRow;
-		entityRecord.m_pArchetype = pNewArchetype;
-
-		// Remove entity it from the previous archetype
-		EntityID movedEntityID = pOldArchetype->RemoveEntityRow(oldArchetypeRow);
-		m_EntityToRecord[movedEntityID].m_EntityArchetypeRow = oldArchetypeRow;
+		// Follow the archetype graph edge and move the entity data,
+		// only the components present in the new archetype are copied
+		EntityRecord&              record = GetEntityRecord(entityID);
+		ArchetypeTransition const& transition = GetRemoveTransition(record.m_pArchetype, componentSet);
+		MoveEntityToArchetype(entityID, record, transition);
 	}
 
 	ComponentIter EntityDatabase::GetSingleCompIter(ComponentTypeID componentID) {
+		CKE_ECS_VALIDATE_WRITE(componentID);
+		MarkComponentChanged(componentID);
 		ComponentIter compIterator(this, componentID);
 		return compIterator;
 	}
 
-	MultiComponentIter EntityDatabase::GetMultiCompIter(ComponentSet componentID) {
+	MultiComponentIter EntityDatabase::GetMultiCompIter(Span<ComponentTypeID const> componentID) {
+		for (ComponentTypeID id : componentID) {
+			CKE_ECS_VALIDATE_WRITE(id);
+			MarkComponentChanged(id);
+		}
 		MultiComponentIter compIter(this, componentID);
 		return compIter;
 	}
 
+	void EntityDatabase::MarkComponentChanged(ComponentTypeID componentID) {
+		auto archetypesIt = m_ComponentToArchetypes.find(componentID);
+		if (archetypesIt == m_ComponentToArchetypes.end()) { return; }
+
+		u64 version = GetChangeVersion();
+		for (auto const& [archetypeID, column] : archetypesIt->second) {
+			Archetype* pArchetype = m_IDToArchetype.at(archetypeID);
+			for (u64 chunk = 0; chunk < pArchetype->GetNumChunks(); ++chunk) {
+				pArchetype->GetColumnVersions(column, chunk).m_ChangedVersion = version;
+			}
+		}
+	}
+
+	bool EntityDatabase::IsEntityAlive(EntityID entity) const {
+		if (entity.GetIndex() >= m_EntityRecords.size()) { return false; }
+		EntityRecord const& record = m_EntityRecords[entity.GetIndex()];
+		return record.m_Generation == entity.GetGeneration() && record.m_pArchetype != nullptr;
+	}
+
+	EntityID EntityDatabase::AllocateEntity() {
+		CKE_ASSERT(m_Entities.size() < m_MaxNumEntities); // Check that we didn't run out of space
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+
+		// Reuse the slot of a deleted entity if possible, its generation
+		// was already advanced when it was deleted
+		u32 entityIndex;
+		if (!m_FreeEntityIndices.empty()) {
+			entityIndex = m_FreeEntityIndices.back();
+			m_FreeEntityIndices.pop_back();
+		}
+		else {
+			entityIndex = static_cast<u32>(m_EntityRecords.size());
+			m_EntityRecords.push_back(EntityRecord{nullptr, 0, 0, 1});
+		}
+
+		EntityRecord& record = m_EntityRecords[entityIndex];
+		EntityID      entity{entityIndex, record.m_Generation};
+		record.m_EntityIndex = m_Entities.size();
+		m_Entities.push_back(entity); // Add entity to global entity list for tracking
+
+		return entity;
+	}
+
 	EntityID EntityDatabase::CreateEntity() {
-		CKE_ASSERT(m_Entities.size() < m_MaxNumEntities);         // Check that we didn't run out of space
-		m_NextEntityID = EntityID{m_NextEntityID.GetValue() + 1}; // Advance unique entity ID counter
-		m_Entities.push_back(m_NextEntityID);                     // Add entity to global entity list for tracking
+		EntityID entity = AllocateEntity();
+
+		// New entities don't have components so they are placed in the empty archetype
+		// The row doesn't contain data, but it keeps the row to entity relationship valid
+		EntityRecord& entityRecord = m_EntityRecords[entity.GetIndex()];
+		entityRecord.m_pArchetype = m_pEmptyArchetype;
+		entityRecord.m_EntityArchetypeRow = m_pEmptyArchetype->AddEntityRow(entity, m_ChunkPool);
+
+		return entity;
+	}
 
-		// Note: Having to create an empty component set and an empty archetype
-		// here is a bit weird, maybe we could just generate this special archetype
-		// at startup and give it a special identifier, although its not really a big deal
+	EntityID EntityDatabase::CreateEntity(Span<ComponentTypeID const> componentSet, Span<void* const> componentData) {
+		EntityID entity = AllocateEntity();
 
-		// Generate empty component set
-		Vector<ComponentTypeID> componentSet{};
-		ComponentSetID      componentSetID = CalculateComponentSetID(componentSet);
+		// Use the edge from the empty archetype to find the final archetype,
+		// but place the entity directly there instead of moving it
+		ArchetypeTransition const& transition = GetAddTransition(m_pEmptyArchetype, componentSet);
 
-		// Generate archetype for entities with 0 components if necessary
-		// We don't create a row in this empty archetype because it doesn't make sense
-		if (!m_ComponentSetToArchetype.contains(componentSetID)) { CreateArchetype(componentSet); }
-		Archetype* arch = m_ComponentSetToArchetype.at(componentSetID);
-		arch->m_NumEntities++;
+		EntityRecord& entityRecord = m_EntityRecords[entity.GetIndex()];
+		entityRecord.m_pArchetype = transition.m_pTarget;
+		entityRecord.m_EntityArchetypeRow = transition.m_pTarget->AddEntityRow(entity, m_ChunkPool);
 
-		// Generate the relationship between entity and archetype
-		EntityRecord entityRecord{};
-		entityRecord.m_EntityArchetypeRow = arch->m_NumEntities - 1;
-		entityRecord.m_pArchetype = arch;
-		m_EntityToRecord.insert({m_NextEntityID, entityRecord});
+		CopyAddedComponentsData(transition, entityRecord.m_EntityArchetypeRow, componentSet, componentData);
 
-		return m_NextEntityID;
+		return entity;
 	}
 
-	void EntityDatabase::DeleteEntity(EntityID entity) {
-		CKE_ASSERT(m_EntityToRecord.contains(entity));
-
-		// Remove entity from entities array
-		// TODO: This is insanely slow
-		for (u64 i = 0; i < m_Entities.size(); ++i) {
-			if (m_Entities[i] == entity) {
-				m_Entities[i] = m_Entities[m_Entities.size() - 1];
-				m_Entities.pop_back();
-				break;
-			}
+	Vector<EntityID> EntityDatabase::CreateEntities(u64 count, Span<ComponentTypeID const> componentSet,
+	                                                Span<void* const> componentData) {
+		CKE_ASSERT(m_Entities.size() + count <= m_MaxNumEntities); // Check that we didn't run out of space
+
+		Vector<EntityID> newEntities(count);
+		for (u64 i = 0; i < count; ++i) {
+			newEntities[i] = AllocateEntity();
+		}
+
+		// Reserve all the rows in the final archetype at once and fill each
+		// component column with a single copy
+		ArchetypeTransition const& transition = GetAddTransition(m_pEmptyArchetype, componentSet);
+		Archetype*                 pArchetype = transition.m_pTarget;
+		u64                        firstRow = pArchetype->AddEntityRows(newEntities, m_ChunkPool);
+		if (count > 0) {
+			CopyAddedComponentsData(transition, firstRow, componentSet, componentData, count);
+		}
+
+		for (u64 i = 0; i < count; ++i) {
+			EntityRecord& entityRecord = m_EntityRecords[newEntities[i].GetIndex()];
+			entityRecord.m_pArchetype = pArchetype;
+			entityRecord.m_EntityArchetypeRow = firstRow + i;
+		}
+
+		return newEntities;
+	}
+
+	void EntityDatabase::RecordRemovedComponents(Archetype* pArchetype, u64 row, Archetype const* pNewArchetype) {
+		for (auto& [componentID, removed] : m_RemovedComponents) {
+			ArchetypeComponentColumn const column = pArchetype->GetComponentColumn(componentID);
+			if (column == INVALID_COMPONENT_COLUMN) { continue; }
+			if (pNewArchetype != nullptr && pNewArchetype->HasComponent(componentID)) { continue; }
+
+			u8 const* pComponent = static_cast<u8 const*>(pArchetype->GetComponentAt(column, row));
+			removed.insert(removed.end(), pComponent, pComponent + pArchetype->m_ArchTable[column].m_SizeInBytes);
+		}
+	}
+
+	void EntityDatabase::RemoveEntity(EntityID entity) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+		EntityRecord& record = GetEntityRecord(entity);
+
+		// Remove entity from entities array, filling the hole with the last entity
+		EntityID lastEntity = m_Entities.back();
+		m_Entities[record.m_EntityIndex] = lastEntity;
+		m_Entities.pop_back();
+		if (lastEntity != entity) {
+			m_EntityRecords[lastEntity.GetIndex()].m_EntityIndex = record.m_EntityIndex;
 		}
 
 		// Start removing entity component row from its archetype table
-		EntityRecord& record = m_EntityToRecord[entity];
-		EntityID      movedEntityID = record.m_pArchetype->RemoveEntityRow(record.m_EntityArchetypeRow);
+		if (!m_RemovedComponents.empty()) {
+			RecordRemovedComponents(record.m_pArchetype, record.m_EntityArchetypeRow, nullptr);
+		}
+		EntityID movedEntityID = record.m_pArchetype->RemoveEntityRow(record.m_EntityArchetypeRow, m_ChunkPool);
 		// Update the record of the moved entity
-		m_EntityToRecord[movedEntityID].m_EntityArchetypeRow = record.m_EntityArchetypeRow;
+		if (movedEntityID != entity) {
+			m_EntityRecords[movedEntityID.GetIndex()].m_EntityArchetypeRow = record.m_EntityArchetypeRow;
+		}
 
-		// Erase entity to record relationship
-		m_EntityToRecord.erase(entity);
+		// Invalidate all the handles to the entity and return its slot to the free list
+		// Generation 0 is reserved for invalid IDs so it is skipped when wrapping around
+		record.m_pArchetype = nullptr;
+		record.m_Generation++;
+		if (record.m_Generation == 0) { record.m_Generation = 1; }
+		m_FreeEntityIndices.push_back(entity.GetIndex());
+	}
+
+	void EntityDatabase::DeleteEntity(EntityID entity) {
+		RemoveEntity(entity);
+	}
+
+	void EntityDatabase::DeleteEntities(Span<EntityID const> entities) {
+		// Every removal is O(1), the record of each entity is looked up right before removing it
+		// because deleting the previous entities may have moved its row.
+		// Repeated entities are detected because their handle is already stale
+		for (EntityID entity : entities) {
+			RemoveEntity(entity);
+		}
+	}
+
+	void EntityDatabase::ExecuteCommandBuffers(Span<EntityCommandBuffer* const> commandBuffers) {
+		CKE_ECS_VALIDATE_STRUCTURAL_CHANGE();
+
+		struct CommandRef
+		{
+			EntityCommandBuffer const* m_pBuffer;
+			EntityCommand const*       m_pCommand;
+			ComponentSetID             m_ComponentSetID; // Only used by creations
+			u64                        m_Order;          // Position of the command in the recorded sequence
+		};
+
+		// Component data to write into an entity after moving it
+		struct PendingComponent
+		{
+			ComponentTypeID m_ComponentID;
+			void const*     m_pData;
+		};
+
+		struct PendingMove
+		{
+			EntityID   m_Entity;
+			Archetype* m_pSrcArchetype;
+			Archetype* m_pDstArchetype;
+			u64        m_FirstComponent; // Index in pendingComponents
+			u64        m_NumComponents;
+		};
+
+		Vector<CommandRef> createCommands;
+		Vector<CommandRef> entityCommands;
+		for (EntityCommandBuffer const* pBuffer : commandBuffers) {
+			for (EntityCommand const& command : pBuffer->m_Commands) {
+				if (command.m_Type == EntityCommandType::CreateEntity) {
+					Span<ComponentTypeID const> componentSet{
+						&pBuffer->m_ComponentIDs[command.m_FirstComponent], command.m_NumComponents
+					};
+					createCommands.push_back(CommandRef{
+						pBuffer, &command, CalculateComponentSetID(componentSet), createCommands.size()
+					});
+				}
+				else {
+					entityCommands.push_back(CommandRef{pBuffer, &command, 0, entityCommands.size()});
+				}
+			}
+		}
+
+		// Merge the commands of each entity in order, so it is moved at most once
+		//-----------------------------------------------------------------------------
+
+		std::sort(entityCommands.begin(), entityCommands.end(), [](CommandRef const& a, CommandRef const& b) {
+			u64 entityA = a.m_pCommand->m_Entity.GetValue();
+			u64 entityB = b.m_pCommand->m_Entity.GetValue();
+			return entityA != entityB ? entityA < entityB : a.m_Order < b.m_Order;
+		});
+
+		Vector<EntityID>         deletedEntities;
+		Vector<PendingMove>      pendingMoves;
+		Vector<PendingComponent> pendingComponents;
+
+		// Components added to/removed from the archetype of the current entity
+		Vector<ComponentTypeID> addedComponents;
+		Vector<ComponentTypeID> removedComponents;
+
+		// Most of the entities that change in the same way share the source and target archetypes
+		Archetype*     pLastSrcArchetype = nullptr;
+		Archetype*     pLastDstArchetype = nullptr;
+		ComponentSetID lastTargetSetID = 0;
+
+		for (u64 begin = 0, end = 0; begin < entityCommands.size(); begin = end) {
+			EntityID entity = entityCommands[begin].m_pCommand->m_Entity;
+			end = begin + 1;
+			while (end < entityCommands.size() && entityCommands[end].m_pCommand->m_Entity == entity) { end++; }
+			if (!IsEntityAlive(entity)) { continue; }
+
+			Archetype*     pSrcArchetype = GetEntityRecord(entity).m_pArchetype;
+			ComponentSetID targetSetID = pSrcArchetype->m_ComponentSetID;
+			u64            firstComponent = pendingComponents.size();
+			bool           isDeleted = false;
+			addedComponents.clear();
+			removedComponents.clear();
+			for (u64 i = begin; i < end && !isDeleted; ++i) {
+				EntityCommandBuffer const* pBuffer = entityCommands[i].m_pBuffer;
+				EntityCommand const&       command = *entityCommands[i].m_pCommand;
+				for (u32 c = command.m_FirstComponent; c < command.m_FirstComponent + command.m_NumComponents; ++c) {
+					ComponentTypeID compID = pBuffer->m_ComponentIDs[c];
+					auto            addedIt = std::find(addedComponents.begin(), addedComponents.end(), compID);
+					auto            removedIt = std::find(removedComponents.begin(), removedComponents.end(), compID);
+					bool            hasComponent = addedIt != addedComponents.end() ||
+							(removedIt == removedComponents.end() && pSrcArchetype->HasComponent(compID));
+					auto pendingIt = std::find_if(pendingComponents.begin() + firstComponent, pendingComponents.end(),
+					                              [compID](PendingComponent const& pending) {
+						                              return pending.m_ComponentID == compID;
+					                              });
+
+					if (command.m_Type == EntityCommandType::AddComponents) {
+						if (!hasComponent) {
+							targetSetID ^= HashComponentID(compID);
+							if (removedIt != removedComponents.end()) { removedComponents.erase(removedIt); }
+							else { addedComponents.push_back(compID); }
+						}
+						if (pendingIt != pendingComponents.end()) { pendingIt->m_pData = pBuffer->GetComponentData(c); }
+						else { pendingComponents.push_back(PendingComponent{compID, pBuffer->GetComponentData(c)}); }
+					}
+					else if (command.m_Type == EntityCommandType::RemoveComponents) {
+						if (hasComponent) {
+							targetSetID ^= HashComponentID(compID);
+							if (addedIt != addedComponents.end()) { addedComponents.erase(addedIt); }
+							else { removedComponents.push_back(compID); }
+						}
+						if (pendingIt != pendingComponents.end()) { pendingComponents.erase(pendingIt); }
+					}
+				}
+				isDeleted = command.m_Type == EntityCommandType::DeleteEntity;
+			}
+
+			if (isDeleted) {
+				pendingComponents.resize(firstComponent);
+				deletedEntities.push_back(entity);
+				continue;
+			}
+
+			Archetype* pDstArchetype = pSrcArchetype;
+			if (targetSetID != pSrcArchetype->m_ComponentSetID) {
+				if (pSrcArchetype != pLastSrcArchetype || targetSetID != lastTargetSetID) {
+					auto archIt = m_ComponentSetToArchetype.find(targetSetID);
+					if (archIt != m_ComponentSetToArchetype.end()) { pLastDstArchetype = archIt->second; }
+					else {
+						Vector<ComponentTypeID> componentSet;
+						for (ComponentTypeID compID : pSrcArchetype->m_ComponentSet) {
+							if (std::find(removedComponents.begin(), removedComponents.end(), compID) ==
+								removedComponents.end()) { componentSet.push_back(compID); }
+						}
+						componentSet.insert(componentSet.end(), addedComponents.begin(), addedComponents.end());
+						pLastDstArchetype = CreateArchetype(componentSet);
+					}
+					pLastSrcArchetype = pSrcArchetype;
+					lastTargetSetID = targetSetID;
+				}
+				pDstArchetype = pLastDstArchetype;
+			}
+
+			u64 numComponents = pendingComponents.size() - firstComponent;
+			if (pDstArchetype != pSrcArchetype || numComponents > 0) {
+				pendingMoves.push_back(PendingMove{entity, pSrcArchetype, pDstArchetype, firstComponent, numComponents});
+			}
+		}
+
+		// Deletions
+		//-----------------------------------------------------------------------------
+
+		DeleteEntities(deletedEntities);
+
+		// Moves, grouped by source and target archetype so each transition is built once
+		// and the rows of the same tables are accessed together
+		//-----------------------------------------------------------------------------
+
+		std::sort(pendingMoves.begin(), pendingMoves.end(), [](PendingMove const& a, PendingMove const& b) {
+			if (a.m_pSrcArchetype->m_ID != b.m_pSrcArchetype->m_ID) {
+				return a.m_pSrcArchetype->m_ID < b.m_pSrcArchetype->m_ID;
+			}
+			return a.m_pDstArchetype->m_ID < b.m_pDstArchetype->m_ID;
+		});
+
+		ArchetypeTransition transition{};
+		Archetype*          pTransitionSrc = nullptr;
+		for (PendingMove const& move : pendingMoves) {
+			EntityRecord& record = GetEntityRecord(move.m_Entity);
+			u64           row = record.m_EntityArchetypeRow;
+			if (move.m_pDstArchetype != move.m_pSrcArchetype) {
+				if (pTransitionSrc != move.m_pSrcArchetype || transition.m_pTarget != move.m_pDstArchetype) {
+					BuildTransition(move.m_pSrcArchetype, move.m_pDstArchetype, transition);
+					pTransitionSrc = move.m_pSrcArchetype;
+				}
+				row = MoveEntityToArchetype(move.m_Entity, record, transition);
+			}
+
+			for (u64 i = move.m_FirstComponent; i < move.m_FirstComponent + move.m_NumComponents; ++i) {
+				PendingComponent const&  pending = pendingComponents[i];
+				ArchetypeComponentColumn column = move.m_pDstArchetype->GetComponentColumn(pending.m_ComponentID);
+				if (column == INVALID_COMPONENT_COLUMN) { continue; } // Tags don't have data
+
+				memcpy(move.m_pDstArchetype->GetComponentAt(column, row), pending.m_pData,
+				       move.m_pDstArchetype->m_ArchTable[column].m_SizeInBytes);
+				if (move.m_pSrcArchetype->HasComponent(pending.m_ComponentID)) {
+					move.m_pDstArchetype->MarkRowsChanged(column, row, 1, GetChangeVersion());
+				}
+				else { move.m_pDstArchetype->MarkRowsAdded(column, row, 1, GetChangeVersion()); }
+			}
+		}
+
+		// Creations, grouped by component set so each group is created with a single CreateEntities
+		//-----------------------------------------------------------------------------
+
+		std::sort(createCommands.begin(), createCommands.end(), [](CommandRef const& a, CommandRef const& b) {
+			return a.m_ComponentSetID != b.m_ComponentSetID ? a.m_ComponentSetID < b.m_ComponentSetID : a.m_Order < b.m_Order;
+		});
+
+		// The components of a creation are sorted when recorded, so all the commands
+		// of a group have them in the same order
+		Vector<Vector<u8>> stagingColumns;
+		Vector<void*>      stagingData;
+		for (u64 begin = 0, end = 0; begin < createCommands.size(); begin = end) {
+			end = begin + 1;
+			while (end < createCommands.size() &&
+				createCommands[end].m_ComponentSetID == createCommands[begin].m_ComponentSetID) { end++; }
+
+			EntityCommandBuffer const*  pFirstBuffer = createCommands[begin].m_pBuffer;
+			EntityCommand const&        firstCommand = *createCommands[begin].m_pCommand;
+			Span<ComponentTypeID const> groupSet{
+				&pFirstBuffer->m_ComponentIDs[firstCommand.m_FirstComponent], firstCommand.m_NumComponents
+			};
+
+			// Gather the data of each component in a contiguous array
+			u64 count = end - begin;
+			stagingColumns.resize(std::max(stagingColumns.size(), groupSet.size()));
+			stagingData.assign(groupSet.size(), nullptr);
+			for (u64 c = 0; c < groupSet.size(); ++c) {
+				u64 sizeInBytes = m_ComponentTypeData.at(groupSet[c]).m_SizeInBytes;
+				if (sizeInBytes == 0) { continue; }
+
+				stagingColumns[c].resize(count * sizeInBytes);
+				for (u64 i = 0; i < count; ++i) {
+					CommandRef const& ref = createCommands[begin + i];
+					memcpy(stagingColumns[c].data() + i * sizeInBytes,
+					       ref.m_pBuffer->GetComponentData(ref.m_pCommand->m_FirstComponent + static_cast<u32>(c)),
+					       sizeInBytes);
+				}
+				stagingData[c] = stagingColumns[c].data();
+			}
+
+			CreateEntities(count, groupSet, stagingData);
+		}
+
+		for (EntityCommandBuffer* pBuffer : commandBuffers) {
+			pBuffer->Clear();
+		}
 	}
 }
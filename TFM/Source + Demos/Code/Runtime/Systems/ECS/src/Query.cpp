@@ -0,0 +1,114 @@
+#include "Query.h"
+
+#include "CookieKat/Core/Platform/Asserts.h"
+#include "EntityDatabase.h"
+
+namespace CKE {
+	void QueryInfo::AddElement(ComponentTypeID componentID, QueryAccess access, QueryOp op, QueryFilter filter) {
+		CKE_ASSERT(m_QueryElementsCount < MAX_ELEMENTS);
+		CKE_ASSERT(componentID != 0); // Component has not been registered
+		m_QueryElements[m_QueryElementsCount] = QueryElement{componentID, access, op, filter};
+		m_QueryElementsCount++;
+	}
+
+	bool QueryInfo::HasChangeFilters() const {
+		for (u32 i = 0; i < m_QueryElementsCount; ++i) {
+			if (m_QueryElements[i].m_Filter != QueryFilter::None) { return true; }
+		}
+		return false;
+	}
+
+	bool QueryInfo::Matches(Archetype const& archetype) const {
+		bool hasOrElements = false;
+		bool matchesAnyOr = false;
+		for (u32 i = 0; i < m_QueryElementsCount; ++i) {
+			QueryElement const& element = m_QueryElements[i];
+			bool                hasComponent = archetype.HasComponent(element.m_ComponentID);
+			switch (element.m_Op) {
+			case QueryOp::And:
+				if (!hasComponent) { return false; }
+				break;
+			case QueryOp::Not:
+				if (hasComponent) { return false; }
+				break;
+			case QueryOp::Or:
+				hasOrElements = true;
+				matchesAnyOr |= hasComponent;
+				break;
+			case QueryOp::Optional:
+				break;
+			}
+		}
+		return !hasOrElements || matchesAnyOr;
+	}
+
+	bool QueryInfo::operator==(QueryInfo const& other) const {
+		if (m_QueryElementsCount != other.m_QueryElementsCount) { return false; }
+		for (u32 i = 0; i < m_QueryElementsCount; ++i) {
+			if (m_QueryElements[i] != other.m_QueryElements[i]) { return false; }
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------
+
+	void QueryState::TryAddArchetype(Archetype* pArchetype) {
+		if (!m_Info.Matches(*pArchetype)) { return; }
+
+		m_MatchedArchetypes.push_back(pArchetype);
+		for (u32 i = 0; i < m_Info.m_QueryElementsCount; ++i) {
+			QueryElement const& element = m_Info.m_QueryElements[i];
+			// Filtered elements need the column to check its versions
+			if (element.m_Access == QueryAccess::None && element.m_Filter == QueryFilter::None) {
+				m_MatchedColumns.push_back(INVALID_COMPONENT_COLUMN);
+			}
+			else {
+				m_MatchedColumns.push_back(pArchetype->GetComponentColumn(element.m_ComponentID));
+			}
+		}
+	}
+
+	u64 QueryState::GetNumEntities() const {
+		u64 numEntities = 0;
+		for (Archetype const* pArchetype : m_MatchedArchetypes) {
+			numEntities += pArchetype->m_NumEntities;
+		}
+		return numEntities;
+	}
+
+	bool QueryState::MatchesChangeFilters(u64 matchedArchetypeIndex, u64 chunkIndex, u64 lastVersion) const {
+		if (!m_HasChangeFilters) { return true; }
+
+		Archetype const*                pArchetype = m_MatchedArchetypes[matchedArchetypeIndex];
+		ArchetypeComponentColumn const* pColumns = &m_MatchedColumns[matchedArchetypeIndex * m_Info.m_QueryElementsCount];
+		for (u32 i = 0; i < m_Info.m_QueryElementsCount; ++i) {
+			QueryFilter filter = m_Info.m_QueryElements[i].m_Filter;
+			if (filter == QueryFilter::None) { continue; }
+
+			ArchetypeColumnVersions const& versions = pArchetype->GetColumnVersions(pColumns[i], chunkIndex);
+			u64 columnVersion = filter == QueryFilter::Changed ? versions.m_ChangedVersion : versions.m_AddedVersion;
+			if (columnVersion > lastVersion) { return true; }
+		}
+		return false;
+	}
+
+	void QueryState::MarkWrittenColumns(u64 matchedArchetypeIndex, u64 chunkIndex, u64 version) const {
+		Archetype*                      pArchetype = m_MatchedArchetypes[matchedArchetypeIndex];
+		ArchetypeComponentColumn const* pColumns = &m_MatchedColumns[matchedArchetypeIndex * m_Info.m_QueryElementsCount];
+		for (u32 i = 0; i < m_Info.m_QueryElementsCount; ++i) {
+			QueryAccess access = m_Info.m_QueryElements[i].m_Access;
+			bool        canWrite = access == QueryAccess::ReadWrite || access == QueryAccess::WriteOnly;
+			if (canWrite && pColumns[i] != INVALID_COMPONENT_COLUMN) {
+				pArchetype->GetColumnVersions(pColumns[i], chunkIndex).m_ChangedVersion = version;
+			}
+		}
+	}
+
+	u64 QueryState::BeginIteration() const {
+		return m_pDatabase->AdvanceChangeVersion();
+	}
+
+	QueryState* QueryState::GetOrCreate(EntityDatabase& db, QueryInfo const& info) {
+		return db.GetOrCreateQueryState(info);
+	}
+}
@@ -0,0 +1,112 @@
+#include "SystemScheduler.h"
+
+#include "CookieKat/Core/Profilling/Profilling.h"
+#include "CookieKat/Core/Platform/Asserts.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
+
+#include <algorithm>
+
+namespace CKE {
+	void SystemScheduler::AddSystem(ECSBaseSystem* pSystem) {
+		CKE_ASSERT(pSystem != nullptr);
+		m_Systems.push_back(SystemNode{pSystem});
+		m_IsScheduleDirty = true;
+	}
+
+	void SystemScheduler::BuildSchedule() {
+		m_Stages.clear();
+
+		for (u32 i = 0; i < m_Systems.size(); ++i) {
+			SystemNode& node = m_Systems[i];
+			node.m_Access = SystemAccessData{};
+			node.m_pSystem->DeclareAccess(node.m_Access);
+
+			// A system depends on all the previous systems it conflicts with, the graph
+			// edges always go forward so the registration order is a valid topological order
+			node.m_Dependencies.clear();
+			node.m_Stage = 0;
+			for (u32 prev = 0; prev < i; ++prev) {
+				if (m_Systems[prev].m_Access.ConflictsWith(node.m_Access)) {
+					node.m_Dependencies.push_back(prev);
+					node.m_Stage = std::max(node.m_Stage, m_Systems[prev].m_Stage + 1);
+				}
+			}
+
+			if (node.m_Stage >= m_Stages.size()) { m_Stages.resize(node.m_Stage + 1); }
+			m_Stages[node.m_Stage].push_back(i);
+		}
+
+		// The calling thread runs the first system of each stage
+		m_Tasks.clear();
+		for (Vector<u32> const& stage : m_Stages) {
+			while (m_Tasks.size() < stage.size() - 1) {
+				m_Tasks.emplace_back(std::make_unique<SystemTask>());
+			}
+		}
+
+		m_IsScheduleDirty = false;
+	}
+
+	void SystemScheduler::Update(SystemUpdateContext ctx) {
+		CKE_PROFILE_EVENT();
+
+		if (m_IsScheduleDirty) { BuildSchedule(); }
+
+		// Each system runs in its own task, the calling thread runs the first one of the stage
+		TaskSystem* pTaskSystem = ctx.GetTaskSystem();
+		for (Vector<u32> const& stage : m_Stages) {
+			if (stage.size() == 1 || pTaskSystem == nullptr) {
+				for (u32 systemIndex : stage) { RunSystem(m_Systems[systemIndex], ctx); }
+				continue;
+			}
+
+			for (u64 i = 1; i < stage.size(); ++i) {
+				SystemTask& task = *m_Tasks[i - 1];
+				task.m_pNode = &m_Systems[stage[i]];
+				task.m_pContext = &ctx;
+				pTaskSystem->ScheduleTask(&task);
+			}
+
+			RunSystem(m_Systems[stage[0]], ctx);
+
+			for (u64 i = 1; i < stage.size(); ++i) {
+				pTaskSystem->WaitForTask(m_Tasks[i - 1].get());
+			}
+		}
+	}
+
+	void SystemScheduler::SystemTask::ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) {
+		// Set here and not when scheduling, the thread can be waiting inside another system
+		SystemAccessValidation::Scope accessScope{&m_pNode->m_Access};
+		m_pNode->m_pSystem->Update(*m_pContext);
+	}
+
+	void SystemScheduler::RunSystem(SystemNode const& node, SystemUpdateContext ctx) {
+		SystemAccessValidation::Scope accessScope{&node.m_Access};
+		node.m_pSystem->Update(ctx);
+	}
+
+	//-----------------------------------------------------------------------------
+
+	u64 SystemScheduler::GetSystemIndex(ECSBaseSystem* pSystem) const {
+		for (u64 i = 0; i < m_Systems.size(); ++i) {
+			if (m_Systems[i].m_pSystem == pSystem) { return i; }
+		}
+		CKE_UNREACHABLE_CODE(); // System has not been added to the scheduler
+		return 0;
+	}
+
+	u64 SystemScheduler::GetSystemStage(ECSBaseSystem* pSystem) const {
+		CKE_ASSERT(!m_IsScheduleDirty);
+		return m_Systems[GetSystemIndex(pSystem)].m_Stage;
+	}
+
+	Vector<ECSBaseSystem*> SystemScheduler::GetSystemDependencies(ECSBaseSystem* pSystem) const {
+		CKE_ASSERT(!m_IsScheduleDirty);
+		Vector<ECSBaseSystem*> dependencies;
+		for (u32 dependency : m_Systems[GetSystemIndex(pSystem)].m_Dependencies) {
+			dependencies.push_back(m_Systems[dependency].m_pSystem);
+		}
+		return dependencies;
+	}
+}
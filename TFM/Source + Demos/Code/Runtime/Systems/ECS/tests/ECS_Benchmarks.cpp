@@ -0,0 +1,453 @@
+#include "CookieKat/Systems/ECS/EntityDatabase.h"
+#include "CookieKat/Tests/Benchmark.h"
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+
+using namespace CKE;
+using namespace CKE::Tests;
+
+// Benchmarks for the hot paths of the entity database
+// They print their timings to the console and only check that the results are coherent
+//-----------------------------------------------------------------------------
+
+namespace {
+	struct BenchPosition
+	{
+		f32 x = 0.0f, y = 0.0f, z = 0.0f;
+	};
+
+	struct BenchRotation
+	{
+		f32 x = 0.0f, y = 0.0f, z = 0.0f, w = 1.0f;
+	};
+
+	struct BenchVelocity
+	{
+		f32 x = 1.0f, y = 1.0f, z = 1.0f;
+	};
+}
+
+//-----------------------------------------------------------------------------
+
+// 10K entities with {Pos, Rot}, each operation adds or removes Vel.
+// Every move after the first one per archetype pair follows a cached transition
+TEST(EntityDatabaseBenchmark, AddRemoveComponent_1M) {
+	constexpr u64 NUM_ENTITIES = 10'000;
+	constexpr u64 NUM_OPERATIONS = 1'000'000;
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	Vector<EntityID> entities;
+	entities.reserve(NUM_ENTITIES);
+	for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+		EntityID e = db.CreateEntity();
+		db.AddComponent<BenchPosition>(e, BenchPosition{static_cast<f32>(i), 0.0f, 0.0f});
+		db.AddComponent<BenchRotation>(e);
+		entities.push_back(e);
+	}
+
+	// Every iteration moves an entity to the {Pos, Rot, Vel} archetype and back
+	u64 elapsedNs = MeasureNs([&]() {
+		for (u64 op = 0; op < NUM_OPERATIONS / 2; ++op) {
+			EntityID e = entities[op % NUM_ENTITIES];
+			db.AddComponent<BenchVelocity>(e);
+			db.RemoveComponent<BenchVelocity>(e);
+		}
+	});
+	PrintBenchmarkResult("AddRemoveComponent", NUM_OPERATIONS, elapsedNs);
+
+	for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+		EXPECT_EQ(db.GetComponent<BenchPosition>(entities[i])->x, static_cast<f32>(i));
+		EXPECT_FALSE(db.HasComponent<BenchVelocity>(entities[i]));
+	}
+}
+
+TEST(EntityDatabaseBenchmark, SpawnWithComponents_100K) {
+	constexpr u64 NUM_ENTITIES = 100'000;
+
+	EntityDatabase db{NUM_ENTITIES * 2};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	// One archetype change per component
+	u64 elapsedSingleNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+			EntityID e = db.CreateEntity();
+			db.AddComponent<BenchPosition>(e, BenchPosition{static_cast<f32>(i), 0.0f, 0.0f});
+			db.AddComponent<BenchRotation>(e);
+			db.AddComponent<BenchVelocity>(e);
+		}
+	});
+	PrintBenchmarkResult("CreateEntity + AddComponent x3", NUM_ENTITIES, elapsedSingleNs);
+
+	// Entities are placed directly in their final archetype
+	u64 elapsedBatchedNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+			db.CreateEntityWith(BenchPosition{static_cast<f32>(i), 0.0f, 0.0f}, BenchRotation{}, BenchVelocity{});
+		}
+	});
+	PrintBenchmarkResult("CreateEntityWith<Pos, Rot, Vel>", NUM_ENTITIES, elapsedBatchedNs);
+
+	u64 numEntities = 0;
+	for (auto [pos, rot, vel] : db.GetMultiCompTupleIter<BenchPosition, BenchRotation, BenchVelocity>()) {
+		numEntities++;
+	}
+	EXPECT_EQ(numEntities, NUM_ENTITIES * 2);
+}
+
+TEST(EntityDatabaseBenchmark, SpawnDespawnBulk_100K) {
+	constexpr u64 NUM_ENTITIES = 100'000;
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	Vector<BenchPosition> positions(NUM_ENTITIES);
+	Vector<BenchRotation> rotations(NUM_ENTITIES);
+	Vector<BenchVelocity> velocities(NUM_ENTITIES);
+	for (u64 i = 0; i < NUM_ENTITIES; ++i) { positions[i].x = static_cast<f32>(i); }
+
+	// One entity at a time
+	Vector<EntityID> entities;
+	entities.reserve(NUM_ENTITIES);
+	u64 elapsedSingleNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+			entities.push_back(db.CreateEntityWith(positions[i], rotations[i], velocities[i]));
+		}
+	});
+	PrintBenchmarkResult("CreateEntityWith<Pos, Rot, Vel>", NUM_ENTITIES, elapsedSingleNs);
+
+	elapsedSingleNs = MeasureNs([&]() {
+		for (EntityID e : entities) { db.DeleteEntity(e); }
+	});
+	PrintBenchmarkResult("DeleteEntity", NUM_ENTITIES, elapsedSingleNs);
+	EXPECT_EQ(db.GetDebugger().GetStateSnapshot().m_NumEntities, 0);
+
+	// All the entities at once
+	u64 elapsedBulkNs = MeasureNs([&]() {
+		entities = db.CreateEntitiesWith(NUM_ENTITIES, positions.data(), rotations.data(), velocities.data());
+	});
+	PrintBenchmarkResult("CreateEntitiesWith<Pos, Rot, Vel>", NUM_ENTITIES, elapsedBulkNs);
+
+	for (u64 i = 0; i < NUM_ENTITIES; i += 1'000) {
+		EXPECT_EQ(db.GetComponent<BenchPosition>(entities[i])->x, static_cast<f32>(i));
+	}
+
+	elapsedBulkNs = MeasureNs([&]() {
+		db.DeleteEntities(entities);
+	});
+	PrintBenchmarkResult("DeleteEntities", NUM_ENTITIES, elapsedBulkNs);
+	EXPECT_EQ(db.GetDebugger().GetStateSnapshot().m_NumEntities, 0);
+}
+
+TEST(EntityDatabaseBenchmark, RandomAccessGetComponent_1M) {
+	constexpr u64 NUM_ENTITIES = 100'000;
+	constexpr u64 NUM_OPERATIONS = 1'000'000;
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	Vector<BenchPosition> positions(NUM_ENTITIES);
+	Vector<BenchVelocity> velocities(NUM_ENTITIES);
+	for (u64 i = 0; i < NUM_ENTITIES; ++i) { positions[i].x = static_cast<f32>(i); }
+	Vector<EntityID> entities = db.CreateEntitiesWith(NUM_ENTITIES, positions.data(), velocities.data());
+
+	// Access pattern of gameplay code following references between entities
+	Vector<EntityID> accessOrder(NUM_OPERATIONS);
+	u64              seed = 12345;
+	for (u64 i = 0; i < NUM_OPERATIONS; ++i) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		accessOrder[i] = entities[(seed >> 33) % NUM_ENTITIES];
+	}
+
+	f32 sum = 0.0f;
+	u64 elapsedNs = MeasureNs([&]() {
+		for (EntityID e : accessOrder) {
+			if (db.HasComponent<BenchVelocity>(e)) {
+				sum += db.GetComponent<BenchPosition>(e)->x;
+			}
+		}
+	});
+	PrintBenchmarkResult("HasComponent + GetComponent", NUM_OPERATIONS, elapsedNs);
+	EXPECT_GT(sum, 0.0f);
+}
+
+TEST(EntityDatabaseBenchmark, IterateQueryVsTupleIter_1M) {
+	constexpr u64 NUM_ENTITIES = 1'000'000;
+	constexpr u64 NUM_ARCHETYPES = 8;
+
+	struct BenchTag0 { };
+	struct BenchTag1 { };
+	struct BenchTag2 { };
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchVelocity>();
+	db.RegisterComponent<BenchTag0>();
+	db.RegisterComponent<BenchTag1>();
+	db.RegisterComponent<BenchTag2>();
+
+	// Spread the entities in several archetypes with the same data columns
+	Vector<BenchPosition> positions(NUM_ENTITIES / NUM_ARCHETYPES);
+	Vector<BenchVelocity> velocities(NUM_ENTITIES / NUM_ARCHETYPES);
+	for (u64 arch = 0; arch < NUM_ARCHETYPES; ++arch) {
+		Vector<EntityID> entities = db.CreateEntitiesWith(positions.size(), positions.data(), velocities.data());
+		for (EntityID e : entities) {
+			if (arch & 1) { db.AddComponent<BenchTag0>(e); }
+			if (arch & 2) { db.AddComponent<BenchTag1>(e); }
+			if (arch & 4) { db.AddComponent<BenchTag2>(e); }
+		}
+	}
+
+	u64 elapsedIterNs = MeasureNs([&]() {
+		for (auto [pPos, pVel] : db.GetMultiCompTupleIter<BenchPosition, BenchVelocity>()) {
+			pPos->x += pVel->x;
+			pPos->y += pVel->y;
+			pPos->z += pVel->z;
+		}
+	});
+	PrintBenchmarkResult("GetMultiCompTupleIter<Pos, Vel>", NUM_ENTITIES, elapsedIterNs);
+
+	Query<Write<BenchPosition>, Read<BenchVelocity>> query{db};
+	u64 elapsedQueryNs = MeasureNs([&]() {
+		query.ForEach([](BenchPosition& pos, BenchVelocity const& vel) {
+			pos.x += vel.x;
+			pos.y += vel.y;
+			pos.z += vel.z;
+		});
+	});
+	PrintBenchmarkResult("Query<Write<Pos>, Read<Vel>>::ForEach", NUM_ENTITIES, elapsedQueryNs);
+
+	u64 elapsedChunkNs = MeasureNs([&]() {
+		query.ForEachChunk([](QueryChunk<Write<BenchPosition>, Read<BenchVelocity>> const& chunk) {
+			Span<BenchPosition>       pos = chunk.GetColumn<BenchPosition>();
+			Span<BenchVelocity const> vel = chunk.GetColumn<BenchVelocity>();
+			for (u64 i = 0; i < chunk.GetNumRows(); ++i) {
+				pos[i].x += vel[i].x;
+				pos[i].y += vel[i].y;
+				pos[i].z += vel[i].z;
+			}
+		});
+	});
+	PrintBenchmarkResult("Query<Write<Pos>, Read<Vel>>::ForEachChunk", NUM_ENTITIES, elapsedChunkNs);
+
+	EXPECT_EQ(query.GetNumMatchedArchetypes(), NUM_ARCHETYPES);
+	query.ForEach([](BenchPosition const& pos, BenchVelocity const&) { EXPECT_EQ(pos.x, 3.0f); });
+}
+
+TEST(EntityDatabaseBenchmark, ParallelForEach_1M) {
+	constexpr u64 NUM_ENTITIES = 1'000'000;
+	constexpr u64 NUM_ITERATIONS = 10;
+
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchVelocity>();
+
+	Vector<BenchPosition> positions(NUM_ENTITIES);
+	Vector<BenchVelocity> velocities(NUM_ENTITIES);
+	db.CreateEntitiesWith(NUM_ENTITIES, positions.data(), velocities.data());
+
+	// Heavier per-entity work so the cost of scheduling the tasks is not dominant
+	auto integrate = [](BenchPosition& pos, BenchVelocity const& vel) {
+		for (u32 step = 0; step < 8; ++step) {
+			pos.x += vel.x * 0.125f;
+			pos.y += std::sqrt(pos.x * pos.x + vel.y);
+			pos.z += pos.y * 0.5f - vel.z;
+		}
+	};
+
+	Query<Write<BenchPosition>, Read<BenchVelocity>> query{db};
+	u64 elapsedSerialNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ITERATIONS; ++i) { query.ForEach(integrate); }
+	});
+	PrintBenchmarkResult("Query::ForEach", NUM_ENTITIES * NUM_ITERATIONS, elapsedSerialNs);
+
+	u64 elapsedParallelNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ITERATIONS; ++i) { query.ParallelForEach(taskSystem, integrate); }
+	});
+	PrintBenchmarkResult("Query::ParallelForEach", NUM_ENTITIES * NUM_ITERATIONS, elapsedParallelNs);
+	std::cout << "[ BENCH    ] Threads: " << taskSystem.GetNumThreads() << " / Speedup: "
+			<< static_cast<f64>(elapsedSerialNs) / elapsedParallelNs << "x" << std::endl;
+
+	taskSystem.Shutdown();
+}
+
+TEST(EntityDatabaseBenchmark, CommandBufferPlayback_100K) {
+	constexpr u64 NUM_ENTITIES = 100'000;
+
+	EntityDatabase db{NUM_ENTITIES * 3};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	Vector<BenchPosition> positions(NUM_ENTITIES);
+	Vector<EntityID>      entities = db.CreateEntitiesWith(NUM_ENTITIES, positions.data());
+
+	// Each frame spawns entities and adds a component to the existing ones, in the order
+	// a gameplay job would produce them. The spawned entities are deleted at the end of the
+	// frame so all the runs reuse the same memory
+	EntityCommandBuffer cmds{&db};
+	auto                resetFrame = [&]() {
+		Vector<EntityID> spawned;
+		db.GetQuery<Read<BenchVelocity>>().ForEachChunk([&](auto const& chunk) {
+			spawned.insert(spawned.end(), chunk.GetEntities().begin(), chunk.GetEntities().end());
+		});
+		db.DeleteEntities(spawned);
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) { db.RemoveComponent<BenchRotation>(entities[i]); }
+	};
+	auto recordFrame = [&]() {
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+			cmds.CreateEntityWith(BenchPosition{}, BenchVelocity{});
+			cmds.AddComponent<BenchRotation>(entities[i]);
+		}
+	};
+
+	// Warm up
+	recordFrame();
+	cmds.Playback();
+	resetFrame();
+
+	u64 elapsedDirectNs = MeasureNs([&]() {
+		for (u64 i = 0; i < NUM_ENTITIES; ++i) {
+			db.CreateEntityWith(BenchPosition{}, BenchVelocity{});
+			db.AddComponent<BenchRotation>(entities[i]);
+		}
+	});
+	PrintBenchmarkResult("CreateEntityWith + AddComponent", NUM_ENTITIES * 2, elapsedDirectNs);
+	resetFrame();
+
+	u64 elapsedRecordNs = MeasureNs(recordFrame);
+	PrintBenchmarkResult("EntityCommandBuffer record", NUM_ENTITIES * 2, elapsedRecordNs);
+
+	u64 elapsedPlaybackNs = MeasureNs([&]() { cmds.Playback(); });
+	PrintBenchmarkResult("EntityCommandBuffer playback", NUM_ENTITIES * 2, elapsedPlaybackNs);
+
+	u64 numMoving = db.GetQuery<Read<BenchPosition>, Read<BenchVelocity>>().GetNumEntities();
+	u64 numRotated = db.GetQuery<Read<BenchPosition>, Read<BenchRotation>>().GetNumEntities();
+	EXPECT_EQ(numMoving, NUM_ENTITIES);
+	EXPECT_EQ(numRotated, NUM_ENTITIES);
+}
+
+TEST(EntityDatabaseBenchmark, ExtractChangedVsAll_100K) {
+	constexpr u64 NUM_STATIC = 99'000;
+	constexpr u64 NUM_DYNAMIC = 1'000;
+	constexpr u64 NUM_FRAMES = 100;
+
+	EntityDatabase db{NUM_STATIC + NUM_DYNAMIC};
+	db.RegisterComponent<BenchPosition>();
+	db.RegisterComponent<BenchRotation>();
+	db.RegisterComponent<BenchVelocity>();
+
+	// Mostly static scene, only the entities with a velocity move
+	Vector<BenchPosition> positions(NUM_STATIC + NUM_DYNAMIC);
+	Vector<BenchRotation> rotations(NUM_STATIC + NUM_DYNAMIC);
+	Vector<BenchVelocity> velocities(NUM_DYNAMIC);
+	db.CreateEntitiesWith(NUM_STATIC, positions.data(), rotations.data());
+	db.CreateEntitiesWith(NUM_DYNAMIC, positions.data(), rotations.data(), velocities.data());
+
+	auto moveQuery = db.GetQuery<Write<BenchPosition>, Read<BenchVelocity>>();
+	auto allQuery = db.GetQuery<Read<BenchPosition>, Read<BenchRotation>>();
+	auto changedQuery = db.GetQuery<Read<BenchPosition>, Read<BenchRotation>, Changed<BenchPosition>>();
+
+	// Render-side extraction, copies the transforms of the entities to a buffer
+	Vector<BenchPosition> extracted(NUM_STATIC + NUM_DYNAMIC);
+	u64                   numExtracted = 0;
+	auto                  extract = [&](BenchPosition const& pos, BenchRotation const& rot) {
+		extracted[numExtracted++ % extracted.size()] = BenchPosition{pos.x + rot.x, pos.y + rot.y, pos.z + rot.z};
+	};
+	auto move = [](BenchPosition& pos, BenchVelocity const& vel) { pos.x += vel.x; };
+
+	changedQuery.ForEach(extract); // The first extraction copies everything
+	numExtracted = 0;
+
+	u64 elapsedAllNs = MeasureNs([&]() {
+		for (u64 frame = 0; frame < NUM_FRAMES; ++frame) {
+			moveQuery.ForEach(move);
+			allQuery.ForEach(extract);
+		}
+	});
+	PrintBenchmarkResult("Extract all", NUM_FRAMES, elapsedAllNs);
+	EXPECT_EQ(numExtracted, (NUM_STATIC + NUM_DYNAMIC) * NUM_FRAMES);
+
+	numExtracted = 0;
+	u64 elapsedChangedNs = MeasureNs([&]() {
+		for (u64 frame = 0; frame < NUM_FRAMES; ++frame) {
+			moveQuery.ForEach(move);
+			changedQuery.ForEach(extract);
+		}
+	});
+	PrintBenchmarkResult("Extract Changed<T>", NUM_FRAMES, elapsedChangedNs);
+	std::cout << "[ BENCH    ] Extracted per frame: " << numExtracted / NUM_FRAMES << " / Speedup: "
+			<< static_cast<f64>(elapsedAllNs) / elapsedChangedNs << "x" << std::endl;
+
+	// Only the chunks of the dynamic entities pass the filter
+	EXPECT_EQ(numExtracted, NUM_DYNAMIC * NUM_FRAMES);
+}
+
+TEST(EntityDatabaseBenchmark, MemoryFootprint_64Archetypes) {
+	constexpr u64 MAX_ENTITIES = 1'000'000;
+	constexpr u64 NUM_COMPONENTS = 6;
+	constexpr u64 NUM_ARCHETYPES = 1 << NUM_COMPONENTS;
+	constexpr u64 ENTITIES_PER_ARCHETYPE = 1'000;
+	constexpr u64 MAX_COMPONENT_SIZE = 64;
+
+	EntityDatabase db{MAX_ENTITIES};
+	Array<ComponentTypeID, NUM_COMPONENTS> componentIDs{};
+	Array<u64, NUM_COMPONENTS>             componentSizes{12, 16, 12, 4, 64, 8};
+	for (u64 i = 0; i < NUM_COMPONENTS; ++i) {
+		componentIDs[i] = db.RegisterComponent("BenchComponent", componentSizes[i]);
+	}
+
+	// Every subset of the components is a different archetype
+	Vector<u8>       zeroedData(ENTITIES_PER_ARCHETYPE * MAX_COMPONENT_SIZE, 0);
+	Vector<EntityID> allEntities;
+	u64              fullCapacityLayoutBytes = 0;
+	u64              liveDataBytes = 0;
+	u64              elapsedNs = MeasureNs([&]() {
+		for (u64 mask = 1; mask < NUM_ARCHETYPES; ++mask) {
+			Vector<ComponentTypeID> componentSet;
+			Vector<void*>           componentData;
+			u64                     rowSizeInBytes = sizeof(EntityID);
+			for (u64 i = 0; i < NUM_COMPONENTS; ++i) {
+				if ((mask >> i) & 1) {
+					componentSet.push_back(componentIDs[i]);
+					componentData.push_back(zeroedData.data());
+					rowSizeInBytes += componentSizes[i];
+				}
+			}
+			Vector<EntityID> entities = db.CreateEntities(ENTITIES_PER_ARCHETYPE, componentSet, componentData);
+			allEntities.insert(allEntities.end(), entities.begin(), entities.end());
+
+			// Previous layout: one array of MAX_ENTITIES elements per column of each archetype
+			fullCapacityLayoutBytes += MAX_ENTITIES * rowSizeInBytes;
+			liveDataBytes += ENTITIES_PER_ARCHETYPE * rowSizeInBytes;
+		}
+	});
+	PrintBenchmarkResult("CreateEntities in 63 archetypes", (NUM_ARCHETYPES - 1) * ENTITIES_PER_ARCHETYPE, elapsedNs);
+
+	EntityDatabaseStateSnapshot snapshot = db.GetDebugger().GetStateSnapshot();
+	constexpr f64               MiB = 1024.0 * 1024.0;
+	std::cout << "[ BENCH    ] Archetype tables - Full capacity layout: " << fullCapacityLayoutBytes / MiB
+			<< "MiB / Chunked layout: " << snapshot.m_ChunkMemoryInBytes / MiB
+			<< "MiB (" << snapshot.m_NumChunksInUse << " chunks) / Live data: " << liveDataBytes / MiB << "MiB"
+			<< std::endl;
+
+	EXPECT_GE(snapshot.m_ChunkMemoryInBytes, liveDataBytes);
+	EXPECT_LT(snapshot.m_ChunkMemoryInBytes, fullCapacityLayoutBytes / 100);
+
+	// Chunks are returned to the pool when the archetypes become empty
+	db.DeleteEntities(allEntities);
+	EXPECT_EQ(db.GetDebugger().GetStateSnapshot().m_NumChunksInUse, 0);
+}
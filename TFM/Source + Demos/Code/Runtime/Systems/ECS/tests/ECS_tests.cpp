@@ -1,6 +1,10 @@
 #include "CookieKat/Systems/ECS/EntityDatabase.h"
+#include "CookieKat/Systems/ECS/Jobs/ECSJob.h"
+#include "CookieKat/Systems/ECS/SystemScheduler.h"
 #include <gtest/gtest.h>
 
+#include <atomic>
+
 using namespace CKE;
 
 struct DataComp1
@@ -126,6 +130,39 @@ TEST_F(EntityDatabaseTest, AddUnregisteredComponentFails) {
 	EXPECT_DEATH(m_EntityDB.AddComponent<UnregisteredComp1>(e, UnregisteredComp1{0}), "Assertion failed");
 }
 
+TEST_F(EntityDatabaseTest, DeletedEntityHandlesAreStale) {
+	EntityID e1 = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues());
+	EXPECT_TRUE(m_EntityDB.IsEntityAlive(e1));
+
+	m_EntityDB.DeleteEntity(e1);
+	EXPECT_FALSE(m_EntityDB.IsEntityAlive(e1));
+
+	// The slot is reused by the next entity, but the old handle stays invalid
+	EntityID e2 = m_EntityDB.CreateEntityWith(DataComp1{4, 5, 6, 7});
+	EXPECT_EQ(e1.GetIndex(), e2.GetIndex());
+	EXPECT_NE(e1, e2);
+	EXPECT_FALSE(m_EntityDB.IsEntityAlive(e1));
+	EXPECT_TRUE(m_EntityDB.IsEntityAlive(e2));
+	EXPECT_FALSE(m_EntityDB.IsEntityAlive(EntityID::Invalid()));
+
+	EXPECT_TRUE((*m_EntityDB.GetComponent<DataComp1>(e2) == DataComp1{4, 5, 6, 7}));
+	EXPECT_DEATH(m_EntityDB.GetComponent<DataComp1>(e1), "Assertion failed");
+}
+
+TEST_F(EntityDatabaseTest, HasComponentWorksWithTags) {
+	struct TagComp { };
+	m_EntityDB.RegisterComponent<TagComp>();
+
+	EntityID e = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues(), TagComp{});
+	EXPECT_TRUE(m_EntityDB.HasComponent<TagComp>(e));
+	EXPECT_TRUE(m_EntityDB.HasComponent<DataComp1>(e));
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp2>(e));
+
+	m_EntityDB.RemoveComponent<TagComp>(e);
+	EXPECT_FALSE(m_EntityDB.HasComponent<TagComp>(e));
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e) == DataComp1::DefaultValues());
+}
+
 TEST_F(EntityDatabaseTest, General) {
 	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 0);
 
@@ -215,6 +252,206 @@ TEST_F(EntityDatabaseTest, AddInterleavedEntities) {
 	EXPECT_TRUE(*comp2 == c2);
 }
 
+TEST_F(EntityDatabaseTest, AddRemoveComponentKeepsData) {
+	EntityID  e1 = m_EntityDB.CreateEntity();
+	EntityID  e2 = m_EntityDB.CreateEntity();
+	DataComp1 c1 = DataComp1{4, 5, 6, 7};
+	DataComp1 c2 = DataComp1{0, 1, 2, 3};
+	m_EntityDB.AddComponent<DataComp1>(e1, c1);
+	m_EntityDB.AddComponent<DataComp1>(e2, c2);
+
+	// Round trip through the {DataComp1, DataComp2} archetype multiple times
+	// so the cached archetype transitions get used
+	for (int i = 0; i < 3; ++i) {
+		m_EntityDB.AddComponent<DataComp2>(e2, DataComp2::DefaultValues());
+		EXPECT_TRUE(m_EntityDB.HasComponent<DataComp2>(e2));
+		EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp2>(e2) == DataComp2::DefaultValues());
+
+		m_EntityDB.RemoveComponent<DataComp2>(e2);
+		EXPECT_FALSE(m_EntityDB.HasComponent<DataComp2>(e2));
+		EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e1) == c1);
+		EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e2) == c2);
+	}
+}
+
+TEST_F(EntityDatabaseTest, AddRemoveMultipleComponents) {
+	EntityID e1 = m_EntityDB.CreateEntity();
+	EntityID e2 = m_EntityDB.CreateEntity();
+	m_EntityDB.AddComponent<Comp4>(e1);
+	m_EntityDB.AddComponent<Comp4>(e2);
+
+	m_EntityDB.AddComponents(e1, DataComp1::DefaultValues(), Comp2{}, DataComp2::DefaultValues());
+	// Same set in a different order must end in the same archetype
+	m_EntityDB.AddComponents(e2, DataComp2::DefaultValues(), DataComp1::DefaultValues(), Comp2{});
+
+	for (EntityID e : {e1, e2}) {
+		EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e) == DataComp1::DefaultValues());
+		EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp2>(e) == DataComp2::DefaultValues());
+		EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(e)->a, -53);
+		EXPECT_EQ(m_EntityDB.GetComponent<Comp4>(e)->a, 255);
+	}
+
+	// {Comp4}, {Comp4, DataComp1, Comp2, DataComp2} and the empty archetype
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumArchetypes, 3);
+
+	m_EntityDB.RemoveComponents<DataComp1, DataComp2>(e1);
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp1>(e1));
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp2>(e1));
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(e1)->a, -53);
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp4>(e1)->a, 255);
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e2) == DataComp1::DefaultValues());
+}
+
+TEST_F(EntityDatabaseTest, RepeatedComponentsDontFollowCachedTransitions) {
+	EntityID e1 = m_EntityDB.CreateEntity();
+	EntityID e2 = m_EntityDB.CreateEntity();
+
+	// {DataComp1, DataComp2, DataComp2} has the same set ID as the {DataComp1} edge cached here
+	m_EntityDB.AddComponents(e1, DataComp1::DefaultValues());
+	Array<ComponentTypeID, 3> repeatedSet{
+		ComponentStaticTypeID<DataComp1>::s_CompID,
+		ComponentStaticTypeID<DataComp2>::s_CompID,
+		ComponentStaticTypeID<DataComp2>::s_CompID
+	};
+	DataComp1       c1{4, 5, 6, 7};
+	DataComp2       c2First = DataComp2::DefaultValues();
+	DataComp2       c2Last{9, 8, 7, 6};
+	Array<void*, 3> repeatedData{&c1, &c2First, &c2Last};
+	m_EntityDB.AddComponents(e2, repeatedSet, repeatedData);
+
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e2) == c1);
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp2>(e2) == c2Last);
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e1) == DataComp1::DefaultValues());
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp2>(e1));
+
+	// Same for the {DataComp1} remove edge, cached by removing DataComp1 from e1
+	m_EntityDB.AddComponents(e1, DataComp2::DefaultValues());
+	m_EntityDB.RemoveComponents<DataComp1>(e1);
+	m_EntityDB.RemoveComponents(e2, repeatedSet);
+
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp1>(e2));
+	EXPECT_FALSE(m_EntityDB.HasComponent<DataComp2>(e2));
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp2>(e1) == DataComp2::DefaultValues());
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 2);
+}
+
+TEST_F(EntityDatabaseTest, EmptyComponentSetsDontMoveTheEntity) {
+	EntityID e1 = m_EntityDB.CreateEntityWith(DataComp1{4, 5, 6, 7});
+	EntityID e2 = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues());
+
+	m_EntityDB.AddComponents(e1, Span<ComponentTypeID const>{}, Span<void* const>{});
+	m_EntityDB.RemoveComponents(e1, Span<ComponentTypeID const>{});
+
+	EXPECT_TRUE(m_EntityDB.IsEntityAlive(e1));
+	EXPECT_TRUE((*m_EntityDB.GetComponent<DataComp1>(e1) == DataComp1{4, 5, 6, 7}));
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e2) == DataComp1::DefaultValues());
+
+	u64 numIterated = 0;
+	for (auto [d1] : m_EntityDB.GetMultiCompTupleIter<DataComp1>()) { numIterated++; }
+	EXPECT_EQ(numIterated, 2);
+}
+
+TEST_F(EntityDatabaseTest, CreateEntityWithComponents) {
+	EntityID e1 = m_EntityDB.CreateEntityWith(DataComp1{4, 5, 6, 7}, Comp3{});
+	EntityID e2 = m_EntityDB.CreateEntity();
+	m_EntityDB.AddComponent<Comp3>(e2);
+	m_EntityDB.AddComponent<DataComp1>(e2, DataComp1::DefaultValues());
+
+	EXPECT_TRUE((*m_EntityDB.GetComponent<DataComp1>(e1) == DataComp1{4, 5, 6, 7}));
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp3>(e1)->a, 3.141516);
+	EXPECT_TRUE(*m_EntityDB.GetComponent<DataComp1>(e2) == DataComp1::DefaultValues());
+
+	u64 numIterated = 0;
+	for (auto [d1, c3] : m_EntityDB.GetMultiCompTupleIter<DataComp1, Comp3>()) {
+		numIterated++;
+	}
+	EXPECT_EQ(numIterated, 2);
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 2);
+}
+
+TEST_F(EntityDatabaseTest, CreateDeleteEntitiesInBulk) {
+	EntityID single = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues(), Comp3{});
+
+	Vector<DataComp1> data1(90);
+	Vector<Comp3>     data3(90);
+	for (u32 i = 0; i < 90; ++i) { data1[i] = DataComp1{i, 1, 2, 3}; }
+	Vector<EntityID> entities = m_EntityDB.CreateEntitiesWith(90, data1.data(), data3.data());
+
+	EXPECT_EQ(entities.size(), 90);
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 91);
+	for (u32 i = 0; i < 90; ++i) {
+		EXPECT_TRUE((*m_EntityDB.GetComponent<DataComp1>(entities[i]) == DataComp1{i, 1, 2, 3}));
+		EXPECT_TRUE(m_EntityDB.HasComponent<Comp3>(entities[i]));
+	}
+
+	// Delete every other entity together with the single one
+	Vector<EntityID> toDelete{single};
+	for (u32 i = 0; i < 90; i += 2) { toDelete.push_back(entities[i]); }
+	m_EntityDB.DeleteEntities(toDelete);
+
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 45);
+	for (u32 i = 1; i < 90; i += 2) {
+		EXPECT_TRUE((*m_EntityDB.GetComponent<DataComp1>(entities[i]) == DataComp1{i, 1, 2, 3}));
+	}
+
+	u64 numIterated = 0;
+	for (auto [d1, c3] : m_EntityDB.GetMultiCompTupleIter<DataComp1, Comp3>()) {
+		EXPECT_EQ(d1->a % 2, 1);
+		numIterated++;
+	}
+	EXPECT_EQ(numIterated, 45);
+
+	// The remaining entities are still valid after removing them one by one
+	for (u32 i = 1; i < 90; i += 2) { m_EntityDB.DeleteEntity(entities[i]); }
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 0);
+}
+
+TEST_F(EntityDatabaseTest, IteratorsUseTheFrameArena) {
+	m_EntityDB.CreateEntityWith(DataComp1::DefaultValues(), Comp3{});
+
+	g_FrameAllocator.Initialize(1, 64 * 1024);
+	FrameAllocator::RegisterThread(0);
+
+	u64 numIterated = 0;
+	for (auto [d1, c3] : m_EntityDB.GetMultiCompTupleIter<DataComp1, Comp3>()) {
+		numIterated++;
+	}
+	EXPECT_EQ(numIterated, 1);
+	EXPECT_GT(g_FrameAllocator.GetFrameUsedSize(), 0);
+
+	FrameAllocator::UnregisterThread();
+	g_FrameAllocator.Shutdown();
+}
+
+TEST(EntityDatabaseChunksTest, ComponentDataSpansMultipleChunks) {
+	constexpr u32 NUM_ENTITIES = 5'000;
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<DataComp1>();
+	db.RegisterComponent<Comp3>();
+
+	Vector<DataComp1> data1(NUM_ENTITIES);
+	for (u32 i = 0; i < NUM_ENTITIES; ++i) { data1[i] = DataComp1{i, 1, 2, 3}; }
+	Vector<EntityID> entities = db.CreateEntitiesWith(NUM_ENTITIES, data1.data());
+	EXPECT_GT(db.GetDebugger().GetStateSnapshot().m_NumChunksInUse, 1);
+
+	// Moving the entities between archetypes keeps their data
+	for (u32 i = 0; i < NUM_ENTITIES; i += 3) { db.AddComponent<Comp3>(entities[i]); }
+	for (u32 i = 0; i < NUM_ENTITIES; i += 2) { db.DeleteEntity(entities[i]); }
+
+	u64 numIterated = 0;
+	for (DataComp1* pComp : db.GetSingleCompIter<DataComp1>()) {
+		EXPECT_EQ(pComp->a % 2, 1);
+		numIterated++;
+	}
+	EXPECT_EQ(numIterated, NUM_ENTITIES / 2);
+
+	for (u32 i = 1; i < NUM_ENTITIES; i += 2) {
+		EXPECT_TRUE((*db.GetComponent<DataComp1>(entities[i]) == DataComp1{i, 1, 2, 3}));
+		EXPECT_EQ(db.HasComponent<Comp3>(entities[i]), i % 3 == 0);
+	}
+}
+
 TEST_F(EntityDatabaseTest, IterateOneComponent) {
 	EntityID  e1 = m_EntityDB.CreateEntity();
 	EntityID  e2 = m_EntityDB.CreateEntity();
@@ -255,4 +492,527 @@ TEST_F(EntityDatabaseTest, IterateOneComponentT) {
 	//	d1->c = i * 3;
 	//	d1->d = i * 4;
 	//}
-}
\ No newline at end of file
+}
+TEST_F(EntityDatabaseTest, QueryReadWriteComponents) {
+	for (u32 i = 0; i < 10; ++i) {
+		m_EntityDB.CreateEntityWith(DataComp1{i, 0, 0, 0}, Comp2{static_cast<i32>(i)});
+	}
+	for (u32 i = 0; i < 10; ++i) {
+		m_EntityDB.CreateEntityWith(DataComp1{i, 0, 0, 0}, Comp2{static_cast<i32>(i)}, Comp3{});
+	}
+	m_EntityDB.CreateEntityWith(DataComp1{100, 0, 0, 0});
+
+	Query<Write<DataComp1>, Read<Comp2>> query{m_EntityDB};
+	EXPECT_EQ(query.GetNumMatchedArchetypes(), 2);
+	EXPECT_EQ(query.GetNumEntities(), 20);
+
+	query.ForEach([](DataComp1& data, Comp2 const& comp2) {
+		data.d = data.a + comp2.a;
+	});
+
+	u64 numIterated = 0;
+	query.ForEachChunk([&](QueryChunk<Write<DataComp1>, Read<Comp2>> const& chunk) {
+		Span<DataComp1>   data = chunk.GetColumn<DataComp1>();
+		Span<Comp2 const> comps2 = chunk.GetColumn<Comp2>();
+		EXPECT_EQ(data.size(), chunk.GetNumRows());
+		EXPECT_EQ(chunk.GetEntities().size(), chunk.GetNumRows());
+		for (u64 i = 0; i < chunk.GetNumRows(); ++i) {
+			EXPECT_EQ(data[i].d, data[i].a * 2);
+			EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(chunk.GetEntities()[i])->a, comps2[i].a);
+			numIterated++;
+		}
+	});
+	EXPECT_EQ(numIterated, 20);
+}
+
+TEST_F(EntityDatabaseTest, QueryFilters) {
+	struct TagComp { };
+	m_EntityDB.RegisterComponent<TagComp>();
+
+	m_EntityDB.CreateEntityWith(Comp2{1});
+	m_EntityDB.CreateEntityWith(Comp2{2}, Comp3{});
+	m_EntityDB.CreateEntityWith(Comp2{4}, TagComp{});
+	m_EntityDB.CreateEntityWith(Comp2{8}, Comp3{}, TagComp{});
+
+	i32 sum = 0;
+	m_EntityDB.GetQuery<Read<Comp2>, Without<Comp3>>().ForEach([&](Comp2 const& comp) { sum += comp.a; });
+	EXPECT_EQ(sum, 1 + 4);
+
+	sum = 0;
+	m_EntityDB.GetQuery<Read<Comp2>, With<TagComp>>().ForEach([&](Comp2 const& comp) { sum += comp.a; });
+	EXPECT_EQ(sum, 4 + 8);
+
+	sum = 0;
+	u32 numWithComp3 = 0;
+	m_EntityDB.GetQuery<Read<Comp2>, WithOptional<Comp3>>().ForEach([&](Comp2 const& comp, Comp3* pComp3) {
+		sum += comp.a;
+		if (pComp3 != nullptr) {
+			EXPECT_EQ(pComp3->a, Comp3{}.a);
+			numWithComp3++;
+		}
+	});
+	EXPECT_EQ(sum, 1 + 2 + 4 + 8);
+	EXPECT_EQ(numWithComp3, 2);
+}
+
+TEST_F(EntityDatabaseTest, QueryMatchesArchetypesCreatedLater) {
+	Query<Read<Comp2>> query = m_EntityDB.GetQuery<Read<Comp2>>();
+	EXPECT_EQ(query.GetNumEntities(), 0);
+
+	EntityID e = m_EntityDB.CreateEntityWith(Comp2{});
+	EXPECT_EQ(query.GetNumMatchedArchetypes(), 1);
+	EXPECT_EQ(query.GetNumEntities(), 1);
+
+	m_EntityDB.AddComponent<Comp4>(e);
+	m_EntityDB.CreateEntityWith(Comp3{});
+	EXPECT_EQ(query.GetNumMatchedArchetypes(), 2);
+	EXPECT_EQ(query.GetNumEntities(), 1);
+
+	// Queries with the same terms share their state
+	EXPECT_EQ(m_EntityDB.GetQuery<Read<Comp2>>().GetNumMatchedArchetypes(), 2);
+}
+
+TEST_F(EntityDatabaseTest, QueryChangedFilterSkipsUnchangedChunks) {
+	EntityID e1 = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues());
+	EntityID e2 = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues(), Comp2{});
+
+	Query<Read<DataComp1>, Changed<DataComp1>> changedQuery{m_EntityDB};
+	auto                                        countChanged = [&]() {
+		u64 count = 0;
+		changedQuery.ForEach([&count](DataComp1 const&) { count++; });
+		return count;
+	};
+
+	// New entities are changed, then nothing changes until something writes to them
+	EXPECT_EQ(countChanged(), 2);
+	EXPECT_EQ(countChanged(), 0);
+
+	m_EntityDB.GetComponent<DataComp1>(e2)->a = 5;
+	EXPECT_EQ(countChanged(), 1);
+
+	// Writing other components doesn't affect the filter
+	m_EntityDB.GetQuery<Write<Comp2>>().ForEach([](Comp2& comp) { comp.a = 3; });
+	EXPECT_EQ(countChanged(), 0);
+
+	m_EntityDB.GetQuery<Write<DataComp1>>().ForEach([](DataComp1& comp) { comp.b = 7; });
+	EXPECT_EQ(countChanged(), 2);
+
+	// Entities moved to another archetype are seen as changed
+	m_EntityDB.AddComponent<Comp3>(e1);
+	EXPECT_EQ(countChanged(), 1);
+
+	// The writes of a query are not reported to itself
+	Query<Write<DataComp1>, Changed<DataComp1>> selfQuery{m_EntityDB};
+	u64                                          numWritten = 0;
+	selfQuery.ForEach([&numWritten](DataComp1& comp) { comp.c = 9; numWritten++; });
+	EXPECT_EQ(numWritten, 2);
+	selfQuery.ForEach([&numWritten](DataComp1& comp) { numWritten++; });
+	EXPECT_EQ(numWritten, 2);
+	EXPECT_EQ(countChanged(), 2);
+}
+
+TEST_F(EntityDatabaseTest, QueryAddedFilter) {
+	Query<Read<Comp2>, Added<Comp2>> addedQuery{m_EntityDB};
+	auto                              countAdded = [&]() {
+		u64 count = 0;
+		addedQuery.ForEach([&count](Comp2 const&) { count++; });
+		return count;
+	};
+
+	EntityID e1 = m_EntityDB.CreateEntityWith(Comp2{});
+	EntityID e2 = m_EntityDB.CreateEntityWith(DataComp1::DefaultValues());
+	EXPECT_EQ(countAdded(), 1);
+	EXPECT_EQ(countAdded(), 0);
+
+	// Writes and moves are not additions
+	m_EntityDB.GetComponent<Comp2>(e1)->a = 1;
+	m_EntityDB.AddComponent<Comp3>(e1);
+	EXPECT_EQ(countAdded(), 0);
+
+	m_EntityDB.AddComponent<Comp2>(e2);
+	EXPECT_EQ(countAdded(), 1);
+
+	// Additions from command buffers are tracked too
+	EntityID            e3 = m_EntityDB.CreateEntityWith(Comp4{});
+	EntityCommandBuffer cmds{&m_EntityDB};
+	cmds.AddComponent<Comp2>(e3);
+	cmds.Playback();
+	EXPECT_EQ(countAdded(), 1);
+}
+
+TEST(EntityDatabaseParallelTest, ParallelForEachProcessesEveryEntityOnce) {
+	constexpr u32 NUM_ENTITIES = 20'000;
+
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<DataComp1>();
+	db.RegisterComponent<Comp2>();
+	db.RegisterComponent<Comp3>();
+
+	Vector<DataComp1> data1(NUM_ENTITIES / 2);
+	Vector<Comp2>     comps2(NUM_ENTITIES / 2);
+	Vector<Comp3>     comps3(NUM_ENTITIES / 2);
+	db.CreateEntitiesWith(NUM_ENTITIES / 2, data1.data(), comps2.data());
+	db.CreateEntitiesWith(NUM_ENTITIES / 2, data1.data(), comps2.data(), comps3.data());
+
+	std::atomic<u64> numProcessed = 0;
+	db.GetQuery<Write<DataComp1>, Read<Comp2>>().ParallelForEach(taskSystem, [&](DataComp1& data, Comp2 const&) {
+		data.a++;
+		numProcessed++;
+	});
+	EXPECT_EQ(numProcessed, NUM_ENTITIES);
+
+	db.GetQuery<Read<DataComp1>>().ForEach([](DataComp1 const& data) { EXPECT_EQ(data.a, 1); });
+	taskSystem.Shutdown();
+}
+
+namespace {
+	class IncrementJob : public ECSJob<IncrementJob, DataComp1, Comp2>
+	{
+	public:
+		inline void ForEach(DataComp1* pData, Comp2* pComp2) {
+			pData->a++;
+			pComp2->a++;
+		}
+	};
+}
+
+TEST(EntityDatabaseParallelTest, ECSJobPartitionsAreDisjoint) {
+	constexpr u32 NUM_ENTITIES = 20'000;
+
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	EntityDatabase db{NUM_ENTITIES};
+	db.RegisterComponent<DataComp1>();
+	db.RegisterComponent<Comp2>();
+
+	Vector<DataComp1> data1(NUM_ENTITIES);
+	Vector<Comp2>     comps2(NUM_ENTITIES, Comp2{0});
+	db.CreateEntitiesWith(NUM_ENTITIES, data1.data(), comps2.data());
+
+	IncrementJob job{};
+	job.Setup(&db, &taskSystem, 0.0f);
+	taskSystem.ScheduleTask(&job);
+	taskSystem.WaitForTask(&job);
+
+	db.GetQuery<Read<DataComp1>, Read<Comp2>>().ForEach([](DataComp1 const& data, Comp2 const& comp2) {
+		EXPECT_EQ(data.a, 1);
+		EXPECT_EQ(comp2.a, 1);
+	});
+	taskSystem.Shutdown();
+}
+
+namespace {
+	// System that executes a callback with the component access it is constructed with
+	class TestSystem : public ECSBaseSystem
+	{
+	public:
+		TestSystem(SystemAccessData access, std::function<void(SystemUpdateContext&)> update) :
+			m_Access(std::move(access)), m_Update(std::move(update)) { }
+
+		void DeclareAccess(SystemAccessData& access) override { access = m_Access; }
+		void Update(SystemUpdateContext ctx) override { m_Update(ctx); }
+
+	private:
+		SystemAccessData                          m_Access;
+		std::function<void(SystemUpdateContext&)> m_Update;
+	};
+}
+
+TEST_F(EntityDatabaseTest, SystemSchedulerGroupsNonConflictingSystems) {
+	auto       noop = [](SystemUpdateContext&) {};
+	TestSystem writeComp2{SystemAccessData{}.Write<Comp2>(), noop};
+	TestSystem readComp2{SystemAccessData{}.Read<Comp2>(), noop};
+	TestSystem readComp2Again{SystemAccessData{}.Read<Comp2>().Read<Comp3>(), noop};
+	TestSystem writeComp3{SystemAccessData{}.Write<Comp3>(), noop};
+	TestSystem writeComp4{SystemAccessData{}.Write<Comp4>(), noop};
+	TestSystem exclusive{SystemAccessData{}.Exclusive(), noop};
+
+	SystemScheduler scheduler{};
+	scheduler.AddSystem(&writeComp2);
+	scheduler.AddSystem(&readComp2);
+	scheduler.AddSystem(&readComp2Again);
+	scheduler.AddSystem(&writeComp3);
+	scheduler.AddSystem(&writeComp4);
+	scheduler.AddSystem(&exclusive);
+	scheduler.BuildSchedule();
+
+	EXPECT_EQ(scheduler.GetSystemStage(&writeComp2), 0);
+	EXPECT_EQ(scheduler.GetSystemStage(&writeComp4), 0);
+	EXPECT_EQ(scheduler.GetSystemStage(&readComp2), 1);
+	EXPECT_EQ(scheduler.GetSystemStage(&readComp2Again), 1);
+	EXPECT_EQ(scheduler.GetSystemStage(&writeComp3), 2);
+	EXPECT_EQ(scheduler.GetSystemStage(&exclusive), 3);
+	EXPECT_EQ(scheduler.GetNumStages(), 4);
+
+	Vector<ECSBaseSystem*> dependencies = scheduler.GetSystemDependencies(&writeComp3);
+	ASSERT_EQ(dependencies.size(), 1);
+	EXPECT_EQ(dependencies[0], &readComp2Again);
+}
+
+TEST_F(EntityDatabaseTest, SystemSchedulerRunsSystemsInDependencyOrder) {
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	EntityID e = m_EntityDB.CreateEntityWith(Comp2{0}, Comp3{});
+
+	// Each writer needs the value written by the previous one, the readers run between them
+	std::atomic<u32> numReads = 0;
+	auto             reader = [&](SystemUpdateContext& ctx) {
+		EXPECT_EQ(ctx.GetEntityDatabase()->GetComponent<Comp2>(e)->a, 1);
+		numReads++;
+	};
+	TestSystem first{SystemAccessData{}.Write<Comp2>(), [&](SystemUpdateContext& ctx) {
+		ctx.GetEntityDatabase()->GetQuery<Write<Comp2>>().ForEach([](Comp2& comp) { comp.a = 1; });
+	}};
+	TestSystem reader1{SystemAccessData{}.Read<Comp2>(), reader};
+	TestSystem reader2{SystemAccessData{}.Read<Comp2>().Write<Comp3>(), reader};
+	TestSystem last{SystemAccessData{}.Write<Comp2>(), [&](SystemUpdateContext& ctx) {
+		EXPECT_EQ(numReads, 2);
+		ctx.GetEntityDatabase()->GetComponent<Comp2>(e)->a = 2;
+	}};
+
+	SystemScheduler scheduler{};
+	scheduler.AddSystem(&first);
+	scheduler.AddSystem(&reader1);
+	scheduler.AddSystem(&reader2);
+	scheduler.AddSystem(&last);
+	scheduler.Update(SystemUpdateContext{&m_EntityDB, &taskSystem, 0.0f});
+
+	EXPECT_EQ(scheduler.GetNumStages(), 3);
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(e)->a, 2);
+	taskSystem.Shutdown();
+}
+
+TEST_F(EntityDatabaseTest, ParallelSystemsCanBuildNewQueries) {
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	// A new database each time, so the queries are always created inside the systems
+	for (u32 iteration = 0; iteration < 50; ++iteration) {
+		EntityDatabase db{MAX_ENTITIES};
+		db.RegisterComponent<DataComp1>();
+		db.RegisterComponent<Comp2>();
+		db.RegisterComponent<Comp3>();
+		db.RegisterComponent<Comp4>();
+		db.CreateEntityWith(Comp2{}, Comp3{});
+		db.CreateEntityWith(Comp2{}, Comp4{});
+		db.CreateEntityWith(DataComp1::DefaultValues(), Comp3{});
+
+		std::atomic<u32> numMatches = 0;
+		TestSystem       readComp2{SystemAccessData{}.Read<Comp2>(), [&](SystemUpdateContext& ctx) {
+			EntityDatabase& entities = *ctx.GetEntityDatabase();
+			numMatches += static_cast<u32>(entities.GetQuery<Read<Comp2>>().GetNumEntities());
+			numMatches += static_cast<u32>(entities.GetQuery<Read<Comp2>, With<Comp3>>().GetNumEntities());
+			numMatches += static_cast<u32>(entities.GetQuery<Read<Comp2>, Without<Comp3>>().GetNumEntities());
+		}};
+		TestSystem readDataComp1{SystemAccessData{}.Read<DataComp1>(), [&](SystemUpdateContext& ctx) {
+			EntityDatabase& entities = *ctx.GetEntityDatabase();
+			numMatches += static_cast<u32>(entities.GetQuery<Read<DataComp1>>().GetNumEntities());
+			numMatches += static_cast<u32>(entities.GetQuery<Read<DataComp1>, With<Comp3>>().GetNumEntities());
+			numMatches += static_cast<u32>(entities.GetQuery<Read<DataComp1>, Without<Comp4>>().GetNumEntities());
+		}};
+
+		SystemScheduler scheduler{};
+		scheduler.AddSystem(&readComp2);
+		scheduler.AddSystem(&readDataComp1);
+		scheduler.Update(SystemUpdateContext{&db, &taskSystem, 0.0f});
+
+		EXPECT_EQ(scheduler.GetNumStages(), 1);
+		EXPECT_EQ(numMatches, 2 + 1 + 1 + 1 + 1 + 1);
+	}
+	taskSystem.Shutdown();
+}
+
+#ifdef CKE_ECS_ACCESS_VALIDATION
+TEST_F(EntityDatabaseTest, UndeclaredSystemAccessIsDetected) {
+	m_EntityDB.CreateEntityWith(Comp2{}, Comp3{});
+
+	TestSystem readOnly{SystemAccessData{}.Read<Comp2>(), [](SystemUpdateContext& ctx) {
+		ctx.GetEntityDatabase()->GetQuery<Write<Comp2>>();
+	}};
+	TestSystem structural{SystemAccessData{}.Write<Comp2>(), [](SystemUpdateContext& ctx) {
+		ctx.GetEntityDatabase()->CreateEntity();
+	}};
+
+	SystemScheduler readOnlyScheduler{};
+	readOnlyScheduler.AddSystem(&readOnly);
+	EXPECT_DEATH(readOnlyScheduler.Update(SystemUpdateContext{&m_EntityDB, nullptr, 0.0f}), "");
+
+	SystemScheduler structuralScheduler{};
+	structuralScheduler.AddSystem(&structural);
+	EXPECT_DEATH(structuralScheduler.Update(SystemUpdateContext{&m_EntityDB, nullptr, 0.0f}), "");
+}
+
+TEST_F(EntityDatabaseTest, ParallelIterationRunsWithTheAccessOfItsSystem) {
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+	EntityID e = m_EntityDB.CreateEntityWith(Comp2{}, Comp3{});
+
+	// The chunks are processed by the workers, they are checked against the access of the system
+	auto readComp3InChunks = [e](SystemUpdateContext& ctx) {
+		EntityDatabase& entities = *ctx.GetEntityDatabase();
+		entities.GetQuery<Read<Comp2>>().ParallelForEachChunk(*ctx.GetTaskSystem(), [&](auto const&) {
+			entities.GetComponent<Comp3>(e);
+		});
+	};
+	TestSystem declared{SystemAccessData{}.Read<Comp2>().Read<Comp3>(), readComp3InChunks};
+	TestSystem undeclared{SystemAccessData{}.Read<Comp2>(), readComp3InChunks};
+
+	SystemScheduler declaredScheduler{};
+	declaredScheduler.AddSystem(&declared);
+	declaredScheduler.Update(SystemUpdateContext{&m_EntityDB, &taskSystem, 0.0f});
+
+	SystemScheduler undeclaredScheduler{};
+	undeclaredScheduler.AddSystem(&undeclared);
+	EXPECT_DEATH(undeclaredScheduler.Update(SystemUpdateContext{&m_EntityDB, &taskSystem, 0.0f}), "");
+	taskSystem.Shutdown();
+}
+#endif
+
+TEST_F(EntityDatabaseTest, CommandBufferCreatesAndDeletesEntities) {
+	EntityID toDelete = m_EntityDB.CreateEntityWith(Comp2{5});
+	EntityID toKeep = m_EntityDB.CreateEntityWith(Comp2{6});
+
+	EntityCommandBuffer cmds{&m_EntityDB};
+	for (i32 i = 0; i < 10; ++i) {
+		cmds.CreateEntityWith(Comp2{i}, DataComp1{static_cast<u32>(i), 1, 2, 3});
+		cmds.CreateEntityWith(DataComp1{static_cast<u32>(i), 1, 2, 3}, Comp2{i}, Comp3{});
+	}
+	cmds.DeleteEntity(toDelete);
+	cmds.AddComponent<Comp3>(toDelete); // Ignored, the entity is deleted first
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 2);
+
+	cmds.Playback();
+	EXPECT_TRUE(cmds.IsEmpty());
+	EXPECT_FALSE(m_EntityDB.IsEntityAlive(toDelete));
+	EXPECT_TRUE(m_EntityDB.IsEntityAlive(toKeep));
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 21);
+
+	Query<Read<Comp2>, Read<DataComp1>> query{m_EntityDB};
+	EXPECT_EQ(query.GetNumMatchedArchetypes(), 2);
+	EXPECT_EQ(query.GetNumEntities(), 20);
+	query.ForEach([](Comp2 const& comp2, DataComp1 const& data) {
+		EXPECT_EQ(static_cast<u32>(comp2.a), data.a);
+		EXPECT_EQ(data.d, 3);
+	});
+}
+
+TEST_F(EntityDatabaseTest, CommandBufferMergesComponentChanges) {
+	EntityID e1 = m_EntityDB.CreateEntityWith(Comp2{1});
+	EntityID e2 = m_EntityDB.CreateEntityWith(Comp2{2}, Comp3{});
+	EntityID stale = m_EntityDB.CreateEntityWith(Comp2{3});
+	m_EntityDB.DeleteEntity(stale);
+
+	EntityCommandBuffer cmds{&m_EntityDB};
+	cmds.AddComponent<Comp3>(e1, Comp3{1.0});
+	cmds.AddComponent<Comp4>(e1, Comp4{7});
+	cmds.RemoveComponent<Comp3>(e1);
+	cmds.AddComponent<Comp2>(e1, Comp2{10}); // Already present, replaces the data
+	cmds.RemoveComponent<Comp3>(e2);
+	cmds.RemoveComponent<Comp4>(e2); // Not present, ignored
+	cmds.AddComponent<Comp3>(stale);
+	cmds.Playback();
+
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(e1)->a, 10);
+	EXPECT_FALSE(m_EntityDB.HasComponent<Comp3>(e1));
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp4>(e1)->a, 7);
+	EXPECT_EQ(m_EntityDB.GetComponent<Comp2>(e2)->a, 2);
+	EXPECT_FALSE(m_EntityDB.HasComponent<Comp3>(e2));
+	EXPECT_EQ(m_Debugger.GetStateSnapshot().m_NumEntities, 2);
+}
+
+TEST_F(EntityDatabaseTest, RemovedComponentsAreTracked) {
+	m_EntityDB.TrackRemovedComponents<Comp2>();
+	EntityID e1 = m_EntityDB.CreateEntityWith(Comp2{1}, Comp3{});
+	EntityID e2 = m_EntityDB.CreateEntityWith(Comp2{2});
+	EntityID e3 = m_EntityDB.CreateEntityWith(Comp2{3});
+	EntityID e4 = m_EntityDB.CreateEntityWith(Comp2{4});
+
+	// Moves that keep the component are not removals
+	m_EntityDB.AddComponent<Comp4>(e1);
+	m_EntityDB.RemoveComponent<Comp3>(e1);
+	m_EntityDB.DeleteEntity(m_EntityDB.CreateEntityWith(Comp3{}));
+	EXPECT_TRUE(m_EntityDB.GetRemovedComponents<Comp2>().empty());
+
+	m_EntityDB.RemoveComponent<Comp2>(e1);
+	m_EntityDB.DeleteEntity(e2);
+	EntityCommandBuffer cmds{&m_EntityDB};
+	cmds.RemoveComponent<Comp2>(e3);
+	cmds.DeleteEntity(e4);
+	cmds.Playback();
+
+	Span<Comp2 const> removed = m_EntityDB.GetRemovedComponents<Comp2>();
+	ASSERT_EQ(removed.size(), 4);
+	EXPECT_EQ(removed[0].a, 1);
+	EXPECT_EQ(removed[1].a, 2);
+	// Playback applies the deletions before the component changes
+	EXPECT_EQ(removed[2].a, 4);
+	EXPECT_EQ(removed[3].a, 3);
+
+	m_EntityDB.ClearRemovedComponents<Comp2>();
+	EXPECT_TRUE(m_EntityDB.GetRemovedComponents<Comp2>().empty());
+}
+
+TEST(EntityDatabaseParallelTest, CommandBufferSetRecordsFromParallelJobs) {
+	constexpr u32 NUM_ENTITIES = 10'000;
+
+	TaskSystem taskSystem{};
+	taskSystem.Initialize();
+
+	EntityDatabase db{NUM_ENTITIES * 2};
+	db.RegisterComponent<DataComp1>();
+	db.RegisterComponent<Comp2>();
+	db.RegisterComponent<Comp3>();
+
+	Vector<DataComp1> data1(NUM_ENTITIES);
+	for (u32 i = 0; i < NUM_ENTITIES; ++i) { data1[i].a = i; }
+	db.CreateEntitiesWith(NUM_ENTITIES, data1.data());
+
+	EntityCommandBufferSet commandBuffers{};
+	commandBuffers.Initialize(&db, taskSystem.GetNumThreads());
+
+	// Odd entities are deleted, even ones get a new component and spawn a new entity
+	struct SpawnJob : public ITaskSet
+	{
+		Vector<QueryChunk<Read<DataComp1>>> m_Chunks;
+		EntityCommandBufferSet*             m_pCommandBuffers = nullptr;
+
+		void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+			EntityCommandBuffer& cmds = m_pCommandBuffers->GetBuffer(threadNum);
+			for (u32 c = range.start; c < range.end; ++c) {
+				Span<DataComp1 const> data = m_Chunks[c].GetColumn<DataComp1>();
+				Span<EntityID const>  entities = m_Chunks[c].GetEntities();
+				for (u64 i = 0; i < data.size(); ++i) {
+					if (data[i].a % 2 == 1) { cmds.DeleteEntity(entities[i]); }
+					else {
+						cmds.AddComponent<Comp3>(entities[i]);
+						cmds.CreateEntityWith(Comp2{static_cast<i32>(data[i].a)});
+					}
+				}
+			}
+		}
+	};
+
+	SpawnJob job{};
+	db.GetQuery<Read<DataComp1>>().GatherChunks(job.m_Chunks);
+	job.m_pCommandBuffers = &commandBuffers;
+	job.m_SetSize = static_cast<u32>(job.m_Chunks.size());
+	taskSystem.ScheduleTask(&job);
+	taskSystem.WaitForTask(&job);
+	commandBuffers.Playback();
+
+	EXPECT_EQ(db.GetDebugger().GetStateSnapshot().m_NumEntities, NUM_ENTITIES);
+	u64 numWithComp3 = db.GetQuery<Read<DataComp1>, With<Comp3>>().GetNumEntities();
+	u64 numWithoutComp3 = db.GetQuery<Read<DataComp1>, Without<Comp3>>().GetNumEntities();
+	EXPECT_EQ(numWithComp3, NUM_ENTITIES / 2);
+	EXPECT_EQ(numWithoutComp3, 0);
+
+	i64 sum = 0;
+	db.GetQuery<Read<Comp2>>().ForEach([&](Comp2 const& comp) { sum += comp.a; });
+	EXPECT_EQ(sum, static_cast<i64>(NUM_ENTITIES / 2 - 1) * (NUM_ENTITIES / 2));
+	taskSystem.Shutdown();
+}
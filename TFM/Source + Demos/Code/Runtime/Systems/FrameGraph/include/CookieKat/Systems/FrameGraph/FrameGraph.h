@@ -13,6 +13,7 @@
 namespace CKE {
 	// Forward Declarations
 	class RenderDevice;
+	class TaskSystem;
 }
 
 namespace CKE {
@@ -23,7 +24,9 @@ namespace CKE {
 	public:
 		//-----------------------------------------------------------------------------
 
-		void Initialize(RenderDevice* pDevice);
+		// The passes are recorded in parallel in the threads of the task system if one is given,
+		// otherwise they are recorded in the calling thread
+		void Initialize(RenderDevice* pDevice, TaskSystem* pTaskSystem = nullptr);
 		void Shutdown();
 
 		//-----------------------------------------------------------------------------
@@ -104,6 +107,10 @@ namespace CKE {
 			FenceHandle m_SignalFences; // Fence to signal on pass finish
 			bool m_SubmitAfterExecuting = false; // Should this be the end of a command buffer and trigger a submit
 
+			// Data defined when executing the graph
+			u32  m_NumParts = 1; // Command lists the recording of the pass is split into
+			Vec3 m_DebugColor{}; // Color of the debug label of the pass
+
 			// Clears the references to resources when compiling the pass
 			// IT DOESN'T RELEASE THE ACTUAL GPU RESOURCES
 			inline void ClearCompilation(RenderDevice* pDevice) {
@@ -123,6 +130,16 @@ namespace CKE {
 			}
 		};
 
+		// Recording of a part of a pass into its own command list, it can run in any thread
+		struct RecordingJob
+		{
+			u32                 m_PassIdx = 0;
+			u32                 m_PartIdx = 0;
+			GraphicsCommandList m_GraphicsCmdList{}; // Only the list of the type of the pass is used
+			TransferCommandList m_TransferCmdList{};
+			ComputeCommandList  m_ComputeCmdList{};
+		};
+
 		// Tracks the deferred destruction of Semaphores that are still in use
 		struct DeletionEntry
 		{
@@ -136,6 +153,8 @@ namespace CKE {
 
 		void ClearCurrentCompilation();
 
+		void Execute_RecordJob(RecordingJob& job, u32 threadIdx);
+
 		void AddPass(FGRenderPassID id, FGRenderPass* pPass, RenderPassType type);
 
 		void Compile_TransientTexUsageFlags();
@@ -144,6 +163,7 @@ namespace CKE {
 
 	private:
 		RenderDevice* m_pDevice = nullptr;
+		TaskSystem*   m_pTaskSystem = nullptr;
 
 		// Returns the index in the passes vector
 		Map<FGRenderPassID, u64> m_RenderPassIDToIndex;
@@ -151,6 +171,12 @@ namespace CKE {
 		FrameGraphDB             m_DB{};                    // Graph resources
 		UInt2                    m_RenderTargetSize{0, 0};  // Current backbuffer size used to calculate relative texture sizes
 		Vector<DeletionEntry>    m_SemaphoreDeletionList{}; // Info to deffer the destruction of in-use data
+
+		// Execution state, kept between frames to reuse the memory
+		Vector<RecordingJob>        m_RecordingJobs{};        // Parts of all of the passes in submission order
+		Vector<GraphicsCommandList> m_PendingGraphicsLists{}; // Recorded lists waiting for the submit of their batch
+		Vector<TransferCommandList> m_PendingTransferLists{};
+		Vector<ComputeCommandList>  m_PendingComputeLists{};
 	};
 }
 
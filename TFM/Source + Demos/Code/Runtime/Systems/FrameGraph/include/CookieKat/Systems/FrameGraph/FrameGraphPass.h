@@ -38,6 +38,17 @@ namespace CKE {
 		FGGraphicsRenderPass(FGRenderPassID id) : FGRenderPass(id) { }
 
 		virtual void Execute(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd) = 0;
+
+		// Passes with a lot of draws can split their recording in parts, each part is recorded into its
+		// own command list, possibly at the same time as the other parts, and the lists are submitted in order.
+		// Called every frame before recording the pass, with the number of threads that can record it
+		virtual u32 GetNumParts(u32 maxParts) { return 1; }
+
+		// Records one of the parts of the pass, by default the whole pass is a single part
+		virtual void ExecutePart(ExecuteResourcesCtx& ctx, GraphicsCommandList& cmdList, RenderDevice& rd,
+		                         u32                  partIdx, u32             numParts) {
+			Execute(ctx, cmdList, rd);
+		}
 	};
 
 	class FGTransferRenderPass : public FGRenderPass
@@ -1,6 +1,8 @@
 #include "CookieKat/Systems/FrameGraph/FrameGraph.h"
 #include "CookieKat/Systems/RenderAPI/RenderDevice.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
 
+#include "CookieKat/Core/Profilling/Profilling.h"
 #include "CookieKat/Core/Random/Random.h"
 #include <CookieKat/Core/Logging/LoggingSystem.h>
 
@@ -193,9 +195,11 @@ namespace CKE {
 }
 
 namespace CKE {
-	void FrameGraph::Initialize(RenderDevice* pDevice) {
+	void FrameGraph::Initialize(RenderDevice* pDevice, TaskSystem* pTaskSystem) {
 		CKE_ASSERT(pDevice != nullptr);
+		CKE_ASSERT(pTaskSystem == nullptr || pTaskSystem->GetNumThreads() <= RenderSettings::MAX_RECORDING_THREADS);
 		m_pDevice = pDevice;
+		m_pTaskSystem = pTaskSystem;
 	}
 
 	void FrameGraph::Shutdown() {
@@ -596,131 +600,174 @@ namespace CKE {
 		m_pDevice->SubmitGraphicsCommandList(revertLayoutsCmdList, revertLayoutsSubmInfo);
 
 		// Update the deletion of leftover semaphores from previous compilations
-		Vector<DeletionEntry> temp{};
-		for (DeletionEntry& entry : m_SemaphoreDeletionList) {
+		// Done in place, so there isn't a copy of the list every frame
+		std::erase_if(m_SemaphoreDeletionList, [this](DeletionEntry& entry) {
 			if (entry.m_FramesTillDeletion <= 0) {
 				m_pDevice->DestroySemaphore(entry.m_Handle);
+				return true;
 			}
-			else {
-				entry.m_FramesTillDeletion--;
-				temp.emplace_back(entry);
-			}
-		}
-		m_SemaphoreDeletionList = temp;
+			entry.m_FramesTillDeletion--;
+			return false;
+		});
 	}
 
-	template <typename T>
-	struct QueueRecordingState
-	{
-		bool m_IsFirstPassOverall = true;
-		bool m_CurrentlyRecording = false;
-		T    m_CmdList;
-	};
-
 	Vec3 RandomColor() {
 		return Vec3{Random::F32(0, 1), Random::F32(0, 1), Random::F32(0, 1)};
 	}
 
+	void FrameGraph::Execute_RecordJob(RecordingJob& job, u32 threadIdx) {
+		RenderPassData& passData = m_Passes[job.m_PassIdx];
+
+		if (passData.m_Type == RenderPassType::Graphics) {
+			auto                 pPass = (FGGraphicsRenderPass*)passData.m_pPass;
+			GraphicsCommandList& cmdList = job.m_GraphicsCmdList;
+			cmdList = m_pDevice->GetGraphicsCmdList(threadIdx);
+			cmdList.Begin();
+			cmdList.BeginDebugLabel(pPass->m_ID.c_str(), passData.m_DebugColor);
+
+			// The rest of the parts may resume the rendering of the previous one, nothing can be recorded
+			// between them, so the transitions of the pass are only done before the first one
+			if (job.m_PartIdx == 0) {
+				RecordResouceTransitions(cmdList, passData);
+			}
+			pPass->ExecutePart(passData.m_ExecuteContext, cmdList, *m_pDevice, job.m_PartIdx, passData.m_NumParts);
+
+			cmdList.EndDebugLabel();
+			cmdList.End();
+		}
+		else if (passData.m_Type == RenderPassType::Transfer) {
+			auto                 pPass = (FGTransferRenderPass*)passData.m_pPass;
+			TransferCommandList& cmdList = job.m_TransferCmdList;
+			cmdList = m_pDevice->GetTransferCmdList(threadIdx);
+			cmdList.Begin();
+			cmdList.BeginDebugLabel(pPass->m_ID.c_str(), passData.m_DebugColor);
+			pPass->Execute(passData.m_ExecuteContext, cmdList, *m_pDevice);
+			cmdList.EndDebugLabel();
+			cmdList.End();
+		}
+		else if (passData.m_Type == RenderPassType::Compute) {
+			auto                pPass = (FGComputeRenderPass*)passData.m_pPass;
+			ComputeCommandList& cmdList = job.m_ComputeCmdList;
+			cmdList = m_pDevice->GetComputeCmdList(threadIdx);
+			cmdList.Begin();
+			cmdList.BeginDebugLabel(pPass->m_ID.c_str(), passData.m_DebugColor);
+			pPass->Execute(passData.m_ExecuteContext, cmdList, *m_pDevice);
+			cmdList.EndDebugLabel();
+			cmdList.End();
+		}
+	}
+
 	void FrameGraph::Execute(CmdListWaitSemaphoreInfo waitInfoAtStart,
 	                         SemaphoreHandle          signalSemaphoreOnFinish,
 	                         FenceHandle              signalFenceOnFinish) {
+		CKE_PROFILE_EVENT();
+
 		// The last pass must always be submitted and sync
 		RenderPassData& finalRenderPassData = m_Passes[m_Passes.size() - 1];
 		finalRenderPassData.m_SignalSemaphores.clear(); // TODO: Not great to just clear all
 		finalRenderPassData.m_SignalSemaphores.push_back(i_PassExecutionFinishedSemaphore);
 		finalRenderPassData.m_SubmitAfterExecuting = true;
 
+		// Recording
 		//-----------------------------------------------------------------------------
 
-		QueueRecordingState<GraphicsCommandList> gfxState{};
-		QueueRecordingState<TransferCommandList> transfState{};
-		QueueRecordingState<ComputeCommandList>  compState{};
-
-		bool isFirstPassOverall = true;
-
-		for (RenderPassData& passData : m_Passes) {
+		// Every pass, or every part of the passes that are split, is recorded into its own command list
+		// The lists of a submission batch are executed one after the other by the queue, so recording
+		// them separately and in any order gives the same result as recording the whole batch in one list
+		u32 const maxParts = m_pTaskSystem != nullptr ? m_pTaskSystem->GetNumThreads() : 1;
+		m_RecordingJobs.clear();
+		for (u32 passIdx = 0; passIdx < m_Passes.size(); ++passIdx) {
+			RenderPassData& passData = m_Passes[passIdx];
 			passData.m_ExecuteContext.RefreshContext(&m_DB);
+			passData.m_DebugColor = RandomColor();
 
+			passData.m_NumParts = 1;
 			if (passData.m_Type == RenderPassType::Graphics) {
 				auto pPass = (FGGraphicsRenderPass*)passData.m_pPass;
+				passData.m_NumParts = std::max(1u, pPass->GetNumParts(maxParts));
+			}
 
-				if (!gfxState.m_CurrentlyRecording) {
-					gfxState.m_CurrentlyRecording = true;
-					gfxState.m_CmdList = m_pDevice->GetGraphicsCmdList();
-					gfxState.m_CmdList.Begin();
-				}
-
-				gfxState.m_CmdList.BeginDebugLabel(pPass->m_ID.c_str(), RandomColor());
-				RecordResouceTransitions(gfxState.m_CmdList, passData);
-				pPass->Execute(passData.m_ExecuteContext, gfxState.m_CmdList, *m_pDevice);
-				gfxState.m_CmdList.EndDebugLabel();
+			for (u32 partIdx = 0; partIdx < passData.m_NumParts; ++partIdx) {
+				m_RecordingJobs.push_back(RecordingJob{.m_PassIdx = passIdx, .m_PartIdx = partIdx});
+			}
+		}
 
-				if (passData.m_SubmitAfterExecuting) {
-					gfxState.m_CmdList.End();
-					CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
+		if (m_pTaskSystem != nullptr) {
+			// The thread index selects the command pool, so each pool is only used by one thread
+			struct RecordingTaskSet : public ITaskSet
+			{
+				FrameGraph* m_pGraph = nullptr;
 
-					if (isFirstPassOverall) {
-						submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
-						isFirstPassOverall = false;
+				void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+					for (u32 i = range.start; i < range.end; ++i) {
+						m_pGraph->Execute_RecordJob(m_pGraph->m_RecordingJobs[i], threadNum);
 					}
-
-					m_pDevice->SubmitGraphicsCommandList(gfxState.m_CmdList, submitInfo);
-					gfxState.m_CurrentlyRecording = false;
 				}
+			};
+
+			RecordingTaskSet taskSet{};
+			taskSet.m_pGraph = this;
+			taskSet.m_SetSize = static_cast<u32>(m_RecordingJobs.size());
+			taskSet.m_MinRange = 1; // There are few jobs and their cost is very uneven
+
+			m_pTaskSystem->ScheduleTask(&taskSet);
+			m_pTaskSystem->WaitForTask(&taskSet);
+		}
+		else {
+			for (RecordingJob& job : m_RecordingJobs) {
+				Execute_RecordJob(job, 0);
 			}
-			else if (passData.m_Type == RenderPassType::Transfer) {
-				auto pPass = (FGTransferRenderPass*)passData.m_pPass;
+		}
 
-				if (!transfState.m_CurrentlyRecording) {
-					transfState.m_CurrentlyRecording = true;
-					transfState.m_CmdList = m_pDevice->GetTransferCmdList();
-					transfState.m_CmdList.Begin();
-				}
+		// Submission
+		//-----------------------------------------------------------------------------
 
-				transfState.m_CmdList.BeginDebugLabel(pPass->m_ID.c_str(), RandomColor());
-				pPass->Execute(passData.m_ExecuteContext, transfState.m_CmdList, *m_pDevice);
-				transfState.m_CmdList.EndDebugLabel();
+		bool isFirstPassOverall = true;
 
-				if (passData.m_SubmitAfterExecuting) {
-					transfState.m_CmdList.End();
-					CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
+		for (RecordingJob& job : m_RecordingJobs) {
+			RenderPassData& passData = m_Passes[job.m_PassIdx];
+			bool const      submit = passData.m_SubmitAfterExecuting && job.m_PartIdx == passData.m_NumParts - 1;
 
-					if (isFirstPassOverall) {
-						waitInfoAtStart.m_Stage = PipelineStage::Transfer;
-						submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
-						isFirstPassOverall = false;
-					}
+			if (passData.m_Type == RenderPassType::Graphics) {
+				m_PendingGraphicsLists.push_back(job.m_GraphicsCmdList);
+				if (!submit) { continue; }
 
-					m_pDevice->SubmitTransferCommandList(transfState.m_CmdList, submitInfo);
-					transfState.m_CurrentlyRecording = false;
+				CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
+				if (isFirstPassOverall) {
+					submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
+					isFirstPassOverall = false;
 				}
-			}
-			else if (passData.m_Type == RenderPassType::Compute) {
-				auto pPass = (FGComputeRenderPass*)passData.m_pPass;
 
-				if (!compState.m_CurrentlyRecording) {
-					compState.m_CurrentlyRecording = true;
-					compState.m_CmdList = m_pDevice->GetComputeCmdList();
-					compState.m_CmdList.Begin();
+				m_pDevice->SubmitGraphicsCommandLists(m_PendingGraphicsLists, submitInfo);
+				m_PendingGraphicsLists.clear();
+			}
+			else if (passData.m_Type == RenderPassType::Transfer) {
+				m_PendingTransferLists.push_back(job.m_TransferCmdList);
+				if (!submit) { continue; }
+
+				CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
+				if (isFirstPassOverall) {
+					waitInfoAtStart.m_Stage = PipelineStage::Transfer;
+					submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
+					isFirstPassOverall = false;
 				}
 
-				compState.m_CmdList.BeginDebugLabel(pPass->m_ID.c_str(), RandomColor());
-				pPass->Execute(passData.m_ExecuteContext, compState.m_CmdList, *m_pDevice);
-				compState.m_CmdList.EndDebugLabel();
-
-				if (passData.m_SubmitAfterExecuting) {
-					compState.m_CmdList.End();
-					CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
-
-					if (isFirstPassOverall) {
-						waitInfoAtStart.m_Stage = PipelineStage::ComputeShader;
-						submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
-						isFirstPassOverall = false;
-					}
-
-					m_pDevice->SubmitComputeCommandList(compState.m_CmdList, submitInfo);
-					compState.m_CurrentlyRecording = false;
+				m_pDevice->SubmitTransferCommandLists(m_PendingTransferLists, submitInfo);
+				m_PendingTransferLists.clear();
+			}
+			else if (passData.m_Type == RenderPassType::Compute) {
+				m_PendingComputeLists.push_back(job.m_ComputeCmdList);
+				if (!submit) { continue; }
+
+				CmdListSubmitInfo submitInfo = passData.GetSubmitInfo();
+				if (isFirstPassOverall) {
+					waitInfoAtStart.m_Stage = PipelineStage::ComputeShader;
+					submitInfo.m_WaitSemaphores.push_back(waitInfoAtStart);
+					isFirstPassOverall = false;
 				}
+
+				m_pDevice->SubmitComputeCommandLists(m_PendingComputeLists, submitInfo);
+				m_PendingComputeLists.clear();
 			}
 		}
 
@@ -9,6 +9,8 @@ namespace CKE {
 		static constexpr i32  GRAPHICS_CMDLIST_COUNT_PERFRAME = 100;
 		static constexpr i32  TRANSFER_CMDLIST_COUNT_PERFRAME = 100;
 		static constexpr i32  COMPUTE_CMDLIST_COUNT_PERFRAME = 50;
+		static constexpr u32  MAX_RECORDING_THREADS = 64; // Threads that can record command lists at the same time
+		static constexpr u64  UPLOAD_REGION_SIZE = 64ull * 1024 * 1024; // Upload memory of a frame, bigger uploads are staged on their own
 		static constexpr bool ENABLE_DEBUG = false;
 	};
 }
\ No newline at end of file
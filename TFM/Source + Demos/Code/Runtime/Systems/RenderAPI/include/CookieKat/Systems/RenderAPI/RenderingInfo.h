@@ -36,5 +36,11 @@ namespace CKE {
 		RenderingAttachment         m_DepthAttachment;
 		bool                        m_UseStencilAttachment = false;
 		RenderingAttachment         m_StencilAttachment;
+
+		// A rendering can be split across command lists submitted one after the other in the same batch,
+		// every part except the last one suspends it and every part except the first one resumes it.
+		// The attachments are only loaded by the first part and stored by the last one
+		bool m_Suspending = false;
+		bool m_Resuming = false;
 	};
 }
@@ -148,7 +148,7 @@ namespace CKE {
 		template <typename Serializer>
 			requires IsSerializer<Serializer>
 		void Serialize(CKE::Archive<Serializer>& archive) {
-			archive.Serialize(m_Size.x, m_Size.y, m_Size.z, m_Format);
+			archive.Serialize(m_Size.x, m_Size.y, m_Size.z, m_Format, m_MipLevels);
 		}
 
 		TextureFormat     m_Format = TextureFormat::R8G8B8A8_SRGB;
@@ -4,6 +4,7 @@
 #include "CookieKat/Core/Platform/PrimitiveTypes.h"
 #include "CommandList.h"
 #include "RenderHandle.h"
+#include "CookieKat/Systems/RenderAPI/RenderSettings.h"
 
 #include <vulkan/vulkan_core.h>
 
@@ -22,6 +23,34 @@ namespace CKE {
 		Vector<DescriptorSetHandle> m_DescriptorSets{};
 	};
 
+	// Command pool owned by a single recording thread, Vulkan pools can't be used from several threads
+	// The pool and its command buffers are created the first time the thread needs them
+	struct ThreadCommandPool_Vk
+	{
+		VkCommandPool           m_CommandPool{};
+		Vector<VkCommandBuffer> m_CommandBuffers{};
+		u64                     m_LastCmdIdx = 0;
+	};
+
+	// Part of the upload buffer and the command buffers that copy its data to the destination resources
+	// Regions are used one after the other, a region is in flight from the submit of its copies until the
+	// in-flight fence of the frame submitted after them is signaled
+	struct UploadRegion_Vk
+	{
+		u64 m_Begin = 0; // Range of the region in the upload buffer
+		u64 m_End = 0;
+		u64 m_Head = 0; // Start of the free memory of the region
+
+		VkCommandPool           m_CommandPool{};
+		Vector<VkCommandBuffer> m_CommandBuffers{};
+		u64                     m_NextCmdIdx = 0;
+		bool                    m_IsRecording = false; // The last command buffer has copies that haven't been submitted
+
+		bool        m_IsInFlight = false;
+		u64         m_GuardFrame = 0; // Number of the frame whose in-flight fence guards the copies
+		FenceHandle m_GuardFence{};
+	};
+
 	// Per-frame data managed by the render device
 	class FrameData_Vk
 	{
@@ -60,6 +89,9 @@ namespace CKE {
 		VkCommandPool m_TransferCommandPool{};
 		VkCommandPool m_ComputeCommandPool{};
 
+		// Pools of the threads that record in parallel, indexed by thread and command list type
+		Array<Array<ThreadCommandPool_Vk, 3>, RenderSettings::MAX_RECORDING_THREADS> m_ThreadCommandPools{};
+
 		Map<PipelineHandle, PipelineFrameData_Vk> m_PipelineFrameData{};
 	};
 }
@@ -16,6 +16,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <mutex>
+
 namespace CKE {
 	// Primary interface with the GPU
 	class RenderDevice
@@ -65,18 +67,42 @@ namespace CKE {
 		// Destroys a buffer associated with the given handle
 		void DestroyBuffer(BufferHandle bufferHandle);
 
-		// -- DEPRECATED --
-		// Returns a pointer to the mapped memory space of the given buffer
+		// Returns a pointer to the mapped memory of a buffer, the copy of the current frame for per frame buffers
+		// The data written to it is read by the GPU without any copy
 		//
 		// Pre-Requisites:
-		//   The buffer must be permanently mapped
+		//   The buffer must be CPU_GPU, those are permanently mapped
 		void* GetBufferMappedPtr(BufferHandle bufferHandle);
 
 		// -- DEPRECATED --
 		BufferHandle CreateBuffer_DEPR(BufferDesc bufferDesc, void* pInitialData, u64 dataByteSize);
 
-		// -- DEPRECATED --
-		void UploadBufferData_DEPR(BufferHandle bufferHandle, void* pData, u64 dataByteSize, u32 offsetInBuffer);
+		// Uploads
+		// Data of GPU-only resources is written to a persistently mapped upload buffer and the copies to
+		// the resources are submitted together by SubmitUploads(). The upload buffer has a region for each
+		// frame in flight, a region is reused once the GPU has finished the frame that followed its copies
+		// Data bigger than a region is copied from a staging buffer of its own and waited for right away
+		//
+		// Uploads can be requested from any thread, also while another one is recording or submitting
+		// the frame (e.g. the render thread while resources are installed). When the active region is full
+		// or the data needs a staging buffer, the caller submits the copies itself and waits for the
+		// graphics queue, which is shared with the frame submits through the queue mutex
+		//-----------------------------------------------------------------------------
+
+		// Writes data to a buffer, per frame buffers only get the data in the copy of the current frame
+		// CPU_GPU buffers are written directly, GPU buffers get it with the next SubmitUploads()
+		// Thread-safe, it may block until the graphics queue is idle (see above)
+		void UploadBufferData(BufferHandle bufferHandle, void const* pData, u64 dataByteSize, u64 offsetInBuffer);
+
+		// Copies data to the texture regions, the buffer offsets of the regions are relative to the data
+		// The range is moved from an undefined layout to Shader_ReadOnly with the copies
+		// Thread-safe, it may block until the graphics queue is idle (see above)
+		void UploadTextureData(TextureHandle textureHandle, TextureRange const& range, void const* pData, u64 dataByteSize,
+		                       Span<VkBufferImageCopy const> regions);
+
+		// Submits the copies of the uploads requested since the last call to the graphics queue
+		// Must be called once per frame, before the submit that signals the in-flight fence of the frame
+		void SubmitUploads();
 
 		// Textures and Samplers
 		//-----------------------------------------------------------------------------
@@ -180,6 +206,15 @@ namespace CKE {
 		//   Requested cmdList count is lower than the max amount
 		ComputeCommandList GetComputeCmdList();
 
+		// Returns an available command list for this frame from the pool of the given thread,
+		// threads with a different index can request and record their lists at the same time
+		//
+		// Asserts:
+		//   Thread index is lower than RenderSettings::MAX_RECORDING_THREADS
+		GraphicsCommandList GetGraphicsCmdList(u32 threadIdx);
+		TransferCommandList GetTransferCmdList(u32 threadIdx);
+		ComputeCommandList  GetComputeCmdList(u32 threadIdx);
+
 		// Submit a command list to the graphics queue
 		void SubmitGraphicsCommandList(GraphicsCommandList& cmdList, CmdListSubmitInfo submitInfo);
 
@@ -281,6 +316,9 @@ namespace CKE {
 		// Submit a list of command buffers to a given queue
 		void SubmitCommandBuffers(Vector<VkCommandBuffer> const& cmdBuffers, VkQueue queue, CmdListSubmitInfo submitInfo);
 
+		// Blocks the calling thread until the queue is idle, the queue is locked while waiting
+		void WaitQueueIdle(VkQueue queue);
+
 		// Create all of the command pools that will be used
 		void CreateDefaultCommandPools();
 
@@ -295,6 +333,13 @@ namespace CKE {
 		//Create an internal per-frame command list using the given description
 		void CreateCommandList(CommandListDesc desc);
 
+		// Returns the next command buffer of the pool of a recording thread in the current frame,
+		// allocating a new one if all of them are in use
+		VkCommandBuffer GetNextThreadCmdBuffer(CommandListType type, u32 threadIdx);
+
+		// Destroy the command pools of the recording threads
+		void DestroyThreadCommandPools();
+
 		// Auxiliary
 		//-----------------------------------------------------------------------------
 
@@ -303,9 +348,9 @@ namespace CKE {
 		// Auxiliary function to create a buffer
 		void CreateBufferInternal(BufferDesc bufferDesc, Buffer* pBuffer);
 
-		// Copy any data to a buffer in CPU-GPU or GPU-Only memory.
-		// TODO: The implementation is a bit sketchy but it works for now
-		void CopyDataToBuffer(BufferDesc bufferDesc, void* pInitialData, u32 dataSizeInBytes, Buffer& buffer);
+		// Copy any data to a buffer in CPU-GPU or GPU-Only memory
+		// Mapped buffers are written directly, the rest get the data through the upload buffer
+		void CopyDataToBuffer(void const* pData, u64 dataSizeInBytes, u64 offsetInBuffer, Buffer& buffer);
 
 		// Returns a suitable memory type for the given requirements
 		u32 FindMemoryType(u32 typeFilter, VkMemoryPropertyFlags properties);
@@ -313,6 +358,35 @@ namespace CKE {
 		// Just a shortcut to retrieve the current frame data structure
 		FrameData_Vk& GetCurrentFrameData();
 
+		// Uploads
+		// The functions that use the active region must be called with the upload mutex locked
+		//-----------------------------------------------------------------------------
+
+		// Creates the upload buffer, its regions and their command pools
+		void CreateUploadBuffer();
+		void DestroyUploadBuffer();
+
+		// Copies the data to upload memory, returns the buffer to copy it from and the offset of the data
+		// Data that doesn't fit in a region gets a staging buffer of its own, released by FinishUpload
+		BufferHandle StageUpload(void const* pData, u64 dataByteSize, u64& uploadOffset);
+
+		// Must be called after recording the copies from the buffer returned by StageUpload
+		// The copies from a staging buffer are submitted and waited for before destroying it
+		void FinishUpload(BufferHandle srcBuffer);
+
+		// Returns the offset in the upload buffer of a new allocation in the active region
+		// If the region is full its copies are submitted and waited for, so it can be reused
+		u64 AllocateUpload(u64 dataByteSize);
+
+		// Returns the command buffer of the active region that is recording the copies, begins one if needed
+		VkCommandBuffer GetUploadCmdBuffer();
+
+		// Ends the command buffer that is recording the copies of the region and submits it
+		void SubmitUploadCmdBuffer(UploadRegion_Vk& region);
+
+		// Waits until the GPU has finished with the copies of the region and makes all of its memory available
+		void ReclaimUploadRegion(UploadRegion_Vk& region);
+
 		// Descriptors
 		//-----------------------------------------------------------------------------
 
@@ -335,6 +409,10 @@ namespace CKE {
 
 		RenderResourcesDB m_ResourcesDB{};
 
+		// Passes recorded in parallel create and bind descriptor sets and samplers from several threads
+		// The rest of the resources can only be created or destroyed from a single thread
+		std::mutex m_DescriptorMutex;
+
 		VulkanInstance   m_VulkanInstance{};
 		VkPhysicalDevice m_PhysicalDevice{};
 		VkDevice         m_Device{};
@@ -343,6 +421,19 @@ namespace CKE {
 
 		u32                      m_CurrFrameInFlightIdx = 0;
 		FrameArray<FrameData_Vk> m_Frame{};
+		u64                      m_FrameCount = 0;         // Frames presented since the device was initialized
+		u64                      m_NumFramesCompleted = 0; // Frames whose in-flight fence has been waited
+
+		// Upload buffer, it stays mapped for the whole lifetime of the device
+		std::mutex                  m_UploadMutex;
+		BufferHandle                m_UploadBuffer{};
+		u8*                         m_pUploadBufferData = nullptr;
+		FrameArray<UploadRegion_Vk> m_UploadRegions{};
+		u32                         m_ActiveUploadRegion = 0; // Region that receives the new uploads
+
+		// Submits, presents and waits on the queues are externally synchronized in Vulkan and the uploads
+		// can submit from any thread, all of them lock it. Never lock the upload mutex while holding it
+		std::mutex m_QueueMutex;
 
 		QueueFamilyIndices m_QueueFamilyIndices{};
 		VkQueue            m_GraphicsQueue{};
@@ -80,10 +80,14 @@ namespace CKE {
 			vkDepthAttach.clearValue.depthStencil = {1.0f, 0};
 		}
 
+		VkRenderingFlags flags = 0;
+		if (renderingInfo.m_Suspending) { flags |= VK_RENDERING_SUSPENDING_BIT; }
+		if (renderingInfo.m_Resuming) { flags |= VK_RENDERING_RESUMING_BIT; }
+
 		// Render Info
 		VkRenderingInfo vkRenderingInfo{
 			.sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
-			.flags = 0,
+			.flags = flags,
 			.renderArea = VkRect2D{
 				.offset = VkOffset2D{0, 0}, .extent = {renderingInfo.m_RenderArea.x, renderingInfo.m_RenderArea.y}
 			},
@@ -157,11 +161,15 @@ namespace CKE {
 	void GraphicsCommandList::BindDescriptor(PipelineHandle pipeline, DescriptorSetHandle set) {
 		Pipeline&       pPipeline = m_pDevice->m_ResourcesDB.GetPipeline(pipeline);
 		PipelineLayout* layout = m_pDevice->m_ResourcesDB.GetPipelineLayout(pPipeline.m_PipelineLayout);
-		DescriptorSet&  descriptorSets = m_pDevice->m_ResourcesDB.GetDescriptorSet(set, m_pDevice->m_CurrFrameInFlightIdx);
+		DescriptorSet   descriptorSet{};
+		{
+			std::lock_guard lock{m_pDevice->m_DescriptorMutex};
+			descriptorSet = m_pDevice->m_ResourcesDB.GetDescriptorSet(set, m_pDevice->m_CurrFrameInFlightIdx);
+		}
 		vkCmdBindDescriptorSets(m_CmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
 		                        layout->m_vkPipelineLayout,
-		                        descriptorSets.m_LayoutIndex, 1,
-		                        &descriptorSets.m_DescriptorSet, 0, 0);
+		                        descriptorSet.m_LayoutIndex, 1,
+		                        &descriptorSet.m_DescriptorSet, 0, 0);
 	}
 
 	void GraphicsCommandList::PushConstant(PipelineHandle pipeline, u64 size, void* data) {
@@ -325,11 +333,15 @@ namespace CKE {
 	void ComputeCommandList::BindComputeDescriptor(PipelineHandle pipeline, DescriptorSetHandle set) {
 		Pipeline&       pPipeline = m_pDevice->m_ResourcesDB.GetPipeline(pipeline);
 		PipelineLayout* layout = m_pDevice->m_ResourcesDB.GetPipelineLayout(pPipeline.m_PipelineLayout);
-		DescriptorSet&  descriptorSets = m_pDevice->m_ResourcesDB.GetDescriptorSet(set, m_pDevice->m_CurrFrameInFlightIdx);
+		DescriptorSet   descriptorSet{};
+		{
+			std::lock_guard lock{m_pDevice->m_DescriptorMutex};
+			descriptorSet = m_pDevice->m_ResourcesDB.GetDescriptorSet(set, m_pDevice->m_CurrFrameInFlightIdx);
+		}
 		vkCmdBindDescriptorSets(m_CmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
 		                        layout->m_vkPipelineLayout,
-		                        descriptorSets.m_LayoutIndex, 1,
-		                        &descriptorSets.m_DescriptorSet, 0, 0);
+		                        descriptorSet.m_LayoutIndex, 1,
+		                        &descriptorSet.m_DescriptorSet, 0, 0);
 	}
 
 	void ComputeCommandList::SetComputePipeline(PipelineHandle pipeline) {
@@ -461,6 +461,11 @@ namespace CKE {
 		m_LastCmdIdxGraphics = 0;
 		m_LastCmdIdxTransfer = 0;
 		m_LastCmdIdxCompute = 0;
+		for (auto& threadPools : m_ThreadCommandPools) {
+			for (ThreadCommandPool_Vk& pool : threadPools) {
+				pool.m_LastCmdIdx = 0;
+			}
+		}
 	}
 
 	void FrameData_Vk::Destroy(RenderDevice& device) { }
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "Buffer.h"
 
@@ -38,6 +39,8 @@ namespace CKE {
 		// that can be queried every frame
 		CreateDefaultCommandPools();
 		CreateDefaultCommandLists();
+
+		CreateUploadBuffer();
 	}
 
 	void RenderDevice::Shutdown() {
@@ -47,7 +50,9 @@ namespace CKE {
 			frame.Destroy(*this);
 		}
 
+		DestroyUploadBuffer();
 		DestroyDefaultCommandPools();
+		DestroyThreadCommandPools();
 		vkDestroyDevice(m_Device, nullptr);
 
 		m_VulkanInstance.Shutdown();
@@ -148,7 +153,7 @@ namespace CKE {
 		// This is a weird case when we minimize the window
 		if (newSize == Int2(0, 0)) { return; }
 
-		vkDeviceWaitIdle(m_Device);
+		WaitForDevice();
 
 		DestroySwapChainViews();
 		CreateSwapChain(newSize);
@@ -505,6 +510,43 @@ namespace CKE {
 		}
 	}
 
+	VkCommandBuffer RenderDevice::GetNextThreadCmdBuffer(CommandListType type, u32 threadIdx) {
+		CKE_ASSERT(threadIdx < RenderSettings::MAX_RECORDING_THREADS);
+		ThreadCommandPool_Vk& pool = GetCurrentFrameData().m_ThreadCommandPools[threadIdx][static_cast<u32>(type)];
+
+		if (pool.m_CommandPool == VK_NULL_HANDLE) {
+			VkCommandPoolCreateInfo poolInfo{};
+			poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+			poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+			if (type == CommandListType::Graphics)
+				poolInfo.queueFamilyIndex = m_QueueFamilyIndices.GetGraphicsIdx();
+			else if (type == CommandListType::Transfer)
+				poolInfo.queueFamilyIndex = m_QueueFamilyIndices.GetTransferIdx();
+			else if (type == CommandListType::Compute)
+				poolInfo.queueFamilyIndex = m_QueueFamilyIndices.GetComputeIdx();
+
+			if (vkCreateCommandPool(m_Device, &poolInfo, nullptr, &pool.m_CommandPool) != VK_SUCCESS) {
+				std::cout << "Error creating command pool" << std::endl;
+			}
+		}
+
+		if (pool.m_LastCmdIdx == pool.m_CommandBuffers.size()) {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			allocInfo.commandPool = pool.m_CommandPool;
+
+			VkCommandBuffer cmdBuffer{};
+			if (vkAllocateCommandBuffers(m_Device, &allocInfo, &cmdBuffer) != VK_SUCCESS) {
+				std::cout << "Error creating command buffer" << std::endl;
+			}
+			pool.m_CommandBuffers.push_back(cmdBuffer);
+		}
+
+		return pool.m_CommandBuffers[pool.m_LastCmdIdx++];
+	}
+
 	void RenderDevice::CreateBufferInternal(BufferDesc bufferDesc, Buffer* pBuffer) {
 		// Create Buffer
 
@@ -558,28 +600,28 @@ namespace CKE {
 		}
 	}
 
-	void RenderDevice::CopyDataToBuffer(BufferDesc bufferDesc, void* pInitialData, u32 dataSizeInBytes, Buffer& buffer) {
-		// If the memory is in GPU-only memory space, it should have the transfer dst bit.
-		// We copy the supplied initial data by using a staging buffer
-		if (bufferDesc.m_MemoryAccess == MemoryAccess::GPU) {
-			BufferDesc stagingBufferDesc{};
-			stagingBufferDesc.m_Usage = BufferUsage::TransferSrc;
-			stagingBufferDesc.m_MemoryAccess = MemoryAccess::CPU_GPU;
-			stagingBufferDesc.m_SizeInBytes = dataSizeInBytes;
-			BufferHandle stagingBufferHandle = CreateBuffer_DEPR(stagingBufferDesc, pInitialData, dataSizeInBytes);
-
-			TransferCommandList transferCmdList = GetTransferCmdList();
-			transferCmdList.Begin();
-			transferCmdList.CopyBuffer(stagingBufferHandle, buffer.m_DBHandle, stagingBufferDesc.m_SizeInBytes);
-			transferCmdList.End();
-			SubmitTransferCommandList(transferCmdList, {});
-			WaitTransferQueueIdle();
+	void RenderDevice::CopyDataToBuffer(void const* pData, u64 dataSizeInBytes, u64 offsetInBuffer, Buffer& buffer) {
+		CKE_ASSERT(offsetInBuffer + dataSizeInBytes <= buffer.m_Size);
 
-			DestroyBuffer(stagingBufferHandle);
-		}
-		else {
-			memcpy(buffer.m_pMapped, pInitialData, dataSizeInBytes);
+		if (buffer.m_pMapped != nullptr) {
+			memcpy(static_cast<u8*>(buffer.m_pMapped) + offsetInBuffer, pData, dataSizeInBytes);
+			return;
 		}
+
+		// GPU-only memory, the buffer must have the transfer dst usage
+		std::lock_guard    lock{m_UploadMutex};
+		u64                uploadOffset = 0;
+		BufferHandle const srcBuffer = StageUpload(pData, dataSizeInBytes, uploadOffset);
+
+		VkBufferCopy const copyRegion{
+			.srcOffset = uploadOffset,
+			.dstOffset = offsetInBuffer,
+			.size = dataSizeInBytes,
+		};
+		vkCmdCopyBuffer(GetUploadCmdBuffer(), m_ResourcesDB.GetBuffer(srcBuffer)->m_vkBuffer,
+		                buffer.m_vkBuffer, 1, &copyRegion);
+
+		FinishUpload(srcBuffer);
 	}
 
 	BufferHandle RenderDevice::CreateBuffer_DEPR(BufferDesc bufferDesc, void* pInitialData, u64 dataByteSize) {
@@ -603,7 +645,7 @@ namespace CKE {
 			}
 
 			if (pInitialData != nullptr) {
-				CopyDataToBuffer(bufferDesc, pInitialData, dataByteSize, *pBuffer);
+				CopyDataToBuffer(pInitialData, dataByteSize, 0, *pBuffer);
 			}
 		}
 		else if (bufferDesc.m_UpdateFrequency == UpdateFrequency::PerFrame) {
@@ -631,7 +673,7 @@ namespace CKE {
 				// We have to copy the initial data to all of the buffers
 				// just in case.
 				if (pInitialData != nullptr) {
-					CopyDataToBuffer(bufferDesc, pInitialData, dataByteSize, *pBuffer);
+					CopyDataToBuffer(pInitialData, dataByteSize, 0, *pBuffer);
 				}
 			}
 		}
@@ -760,6 +802,13 @@ namespace CKE {
 			GetImageAvailableSemaphore()).m_vkSemaphore;
 
 		vkWaitForFences(m_Device, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+		{
+			// Must be updated before the fence is reset, the upload regions guarded by it stop waiting for it
+			std::lock_guard lock{m_UploadMutex};
+			if (m_FrameCount >= RenderSettings::MAX_FRAMES_IN_FLIGHT) {
+				m_NumFramesCompleted = m_FrameCount - RenderSettings::MAX_FRAMES_IN_FLIGHT + 1;
+			}
+		}
 		VkResult result = vkAcquireNextImageKHR(m_Device, m_SwapChain.m_vkSwapChain, UINT64_MAX,
 		                                        imageAvailableSemaphore, VK_NULL_HANDLE,
 		                                        &m_SwapChain.m_CurrentTextureIdx);
@@ -779,6 +828,12 @@ namespace CKE {
 			PipelineFrameData_Vk& pipelineFrameData = newFrameData.GetPipelineState(handle);
 			vkResetDescriptorPool(m_Device, pipelineFrameData.m_DescriptorPool, 0);
 		}
+		// The frame fence has been waited, so none of the lists of the recording threads are in use
+		for (auto& threadPools : newFrameData.m_ThreadCommandPools) {
+			for (ThreadCommandPool_Vk& pool : threadPools) {
+				if (pool.m_CommandPool != VK_NULL_HANDLE) { vkResetCommandPool(m_Device, pool.m_CommandPool, 0); }
+			}
+		}
 		newFrameData.ResetForNewFrame();
 		m_ResourcesDB.DestroyAllDescriptorSets(m_CurrFrameInFlightIdx);
 	}
@@ -796,18 +851,27 @@ namespace CKE {
 		presentInfo.pImageIndices = &m_SwapChain.m_CurrentTextureIdx;
 		presentInfo.pResults = nullptr;
 
-		VkResult const result = vkQueuePresentKHR(m_PresentQueue, &presentInfo);
+		VkResult result = VK_SUCCESS;
+		{
+			std::lock_guard lock{m_QueueMutex};
+			result = vkQueuePresentKHR(m_PresentQueue, &presentInfo);
+		}
 
 		// Resize SwapChain backbuffer if needed
 		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_SwapChain.
 			m_FrameBufferResized) {
-			vkQueueWaitIdle(m_PresentQueue);
+			WaitQueueIdle(m_PresentQueue);
 			m_SwapChain.m_FrameBufferResized = false;
 			RecreateSwapChain(m_SwapChain.m_NewFramebufferSize);
 		}
 
 		// Advance frame idx counter
 		m_CurrFrameInFlightIdx = (m_CurrFrameInFlightIdx + 1) % RenderSettings::MAX_FRAMES_IN_FLIGHT;
+		m_ResourcesDB.UpdateFrameIdx(m_CurrFrameInFlightIdx);
+		{
+			std::lock_guard lock{m_UploadMutex};
+			m_FrameCount++;
+		}
 	}
 
 	void RenderDevice::DestroySwapChainViews() {
@@ -862,16 +926,6 @@ namespace CKE {
 		return b;
 	}
 
-	void RenderDevice::UploadBufferData_DEPR(BufferHandle bufferHandle, void* pData, u64 dataByteSize,
-	                                         u32          offsetInBuffer) {
-		Buffer* buffer = m_ResourcesDB.GetBuffer(bufferHandle);
-		CKE_ASSERT(buffer->m_Size >= dataByteSize);
-		// The buffer must be a CPU mapped buffer to be able to upload data to it this way
-		CKE_ASSERT(buffer->m_pMapped != nullptr);
-		CKE_ASSERT(offsetInBuffer + dataByteSize <= buffer->m_Size);
-		memcpy((u8*)buffer->m_pMapped + offsetInBuffer, pData, dataByteSize);
-	}
-
 	void* RenderDevice::GetBufferMappedPtr(BufferHandle bufferHandle) {
 		void* ptr = m_ResourcesDB.GetBuffer(bufferHandle)->m_pMapped;
 		CKE_ASSERT(ptr != nullptr);
@@ -960,6 +1014,7 @@ namespace CKE {
 	}
 
 	SamplerHandle RenderDevice::CreateSampler(SamplerDesc desc) {
+		std::lock_guard lock{m_DescriptorMutex};
 		TextureSampler* pSampler = m_ResourcesDB.CreateTextureSampler();
 
 		VkSamplerCreateInfo createInfo{};
@@ -1138,6 +1193,18 @@ namespace CKE {
 		return ComputeCommandList{this, cmdBuff};
 	}
 
+	GraphicsCommandList RenderDevice::GetGraphicsCmdList(u32 threadIdx) {
+		return GraphicsCommandList{this, GetNextThreadCmdBuffer(CommandListType::Graphics, threadIdx)};
+	}
+
+	TransferCommandList RenderDevice::GetTransferCmdList(u32 threadIdx) {
+		return TransferCommandList{this, GetNextThreadCmdBuffer(CommandListType::Transfer, threadIdx)};
+	}
+
+	ComputeCommandList RenderDevice::GetComputeCmdList(u32 threadIdx) {
+		return ComputeCommandList{this, GetNextThreadCmdBuffer(CommandListType::Compute, threadIdx)};
+	}
+
 	void RenderDevice::SubmitGraphicsCommandList(GraphicsCommandList& cmdList, CmdListSubmitInfo submitInfo) {
 		Vector<GraphicsCommandList> v = {cmdList};
 		SubmitGraphicsCommandLists(v, submitInfo);
@@ -1161,6 +1228,18 @@ namespace CKE {
 		}
 	}
 
+	void RenderDevice::DestroyThreadCommandPools() {
+		for (FrameData_Vk& frame : m_Frame) {
+			for (auto& threadPools : frame.m_ThreadCommandPools) {
+				for (ThreadCommandPool_Vk& pool : threadPools) {
+					if (pool.m_CommandPool == VK_NULL_HANDLE) { continue; }
+					vkDestroyCommandPool(m_Device, pool.m_CommandPool, nullptr);
+					pool = ThreadCommandPool_Vk{};
+				}
+			}
+		}
+	}
+
 	void RenderDevice::CreateDefaultCommandLists() {
 		for (int i = 0; i < RenderSettings::GRAPHICS_CMDLIST_COUNT_PERFRAME; ++i) {
 			CreateCommandList({CommandListType::Graphics, true});
@@ -1275,6 +1354,8 @@ namespace CKE {
 	DescriptorSetHandle RenderDevice::CreateDescriptorSetForFrame(PipelineHandle                          pipelineHandle,
 	                                                              u32                                     layoutIndex,
 	                                                              Vector<DescriptorSetBuilder::Bindings>& shaderBindings) {
+		std::lock_guard lock{m_DescriptorMutex};
+
 		Pipeline&          pPipeline = m_ResourcesDB.GetPipeline(pipelineHandle);
 		PipelineLayout*    pPipelineLayout = m_ResourcesDB.GetPipelineLayout(pPipeline.m_PipelineLayout);
 		PipelineFrameData_Vk& pipelineFrameData = GetCurrentFrameData().GetPipelineState(pipelineHandle);
@@ -1384,15 +1465,15 @@ namespace CKE {
 	}
 
 	void RenderDevice::WaitGraphicsQueueIdle() {
-		vkQueueWaitIdle(m_GraphicsQueue);
+		WaitQueueIdle(m_GraphicsQueue);
 	}
 
 	void RenderDevice::WaitTransferQueueIdle() {
-		vkQueueWaitIdle(m_TransferQueue);
+		WaitQueueIdle(m_TransferQueue);
 	}
 
 	void RenderDevice::WaitComputeQueueIdle() {
-		vkQueueWaitIdle(m_ComputeQueue);
+		WaitQueueIdle(m_ComputeQueue);
 	}
 
 	QueueFamilyIndices RenderDevice::GetQueueFamilyIndices() {
@@ -1442,12 +1523,20 @@ namespace CKE {
 		vkSubmitInfo.commandBufferCount = cmdBuffers.size();
 		vkSubmitInfo.pCommandBuffers = cmdBuffers.data();
 
+		std::lock_guard lock{m_QueueMutex};
 		if (vkQueueSubmit(queue, 1, &vkSubmitInfo, fence) != VK_SUCCESS) {
 			std::cout << "Error submitting command buffer to queue" << std::endl;
 		}
 	}
 
+	void RenderDevice::WaitQueueIdle(VkQueue queue) {
+		std::lock_guard lock{m_QueueMutex};
+		vkQueueWaitIdle(queue);
+	}
+
 	void RenderDevice::WaitForDevice() {
+		// Waiting for the device accesses all of its queues
+		std::lock_guard lock{m_QueueMutex};
 		vkDeviceWaitIdle(m_Device);
 	}
 
@@ -1456,6 +1545,244 @@ namespace CKE {
 	}
 }
 
+namespace CKE {
+	void RenderDevice::UploadBufferData(BufferHandle bufferHandle, void const* pData, u64 dataByteSize,
+	                                    u64          offsetInBuffer) {
+		CKE_ASSERT(pData != nullptr);
+		CopyDataToBuffer(pData, dataByteSize, offsetInBuffer, *m_ResourcesDB.GetBuffer(bufferHandle));
+	}
+
+	void RenderDevice::UploadTextureData(TextureHandle textureHandle, TextureRange const& range, void const* pData,
+	                                     u64           dataByteSize, Span<VkBufferImageCopy const> regions) {
+		CKE_ASSERT(pData != nullptr);
+
+		std::lock_guard    lock{m_UploadMutex};
+		u64                uploadOffset = 0;
+		BufferHandle const srcBuffer = StageUpload(pData, dataByteSize, uploadOffset);
+
+		VkCommandBuffer     cmdBuffer = GetUploadCmdBuffer();
+		GraphicsCommandList graphicsCmdList{this, cmdBuffer};
+		TransferCommandList transferCmdList{this, cmdBuffer};
+
+		graphicsCmdList.Barrier(TextureBarrierDescription{
+			.m_SrcStage = PipelineStage::AllCommands,
+			.m_SrcAccessMask = AccessMask::None,
+			.m_DstStage = PipelineStage::Transfer,
+			.m_DstAccessMask = AccessMask::Transfer_Write,
+			.m_OldLayout = TextureLayout::Undefined,
+			.m_NewLayout = TextureLayout::Transfer_Dst,
+			.m_Texture = textureHandle,
+			.m_AspectMask = range.m_AspectMask,
+			.m_Range = range,
+		});
+
+		for (VkBufferImageCopy copyRegion : regions) {
+			CKE_ASSERT(copyRegion.bufferOffset < dataByteSize);
+			copyRegion.bufferOffset += uploadOffset;
+			transferCmdList.CopyBufferToTexture(srcBuffer, textureHandle, copyRegion);
+		}
+
+		// The copies are made visible to the rest of the frame when the region is submitted
+		graphicsCmdList.Barrier(TextureBarrierDescription{
+			.m_SrcStage = PipelineStage::Transfer,
+			.m_SrcAccessMask = AccessMask::Transfer_Write,
+			.m_DstStage = PipelineStage::AllCommands,
+			.m_DstAccessMask = AccessMask::None,
+			.m_OldLayout = TextureLayout::Transfer_Dst,
+			.m_NewLayout = TextureLayout::Shader_ReadOnly,
+			.m_Texture = textureHandle,
+			.m_AspectMask = range.m_AspectMask,
+			.m_Range = range,
+		});
+
+		FinishUpload(srcBuffer);
+	}
+
+	void RenderDevice::SubmitUploads() {
+		std::lock_guard lock{m_UploadMutex};
+		UploadRegion_Vk& region = m_UploadRegions[m_ActiveUploadRegion];
+		SubmitUploadCmdBuffer(region);
+
+		if (region.m_Head == region.m_Begin && region.m_NextCmdIdx == 0) { return; }
+
+		// The frame that is being recorded is submitted after the copies, once its fence
+		// is signaled the GPU is done with the region
+		region.m_IsInFlight = true;
+		region.m_GuardFrame = m_FrameCount;
+		region.m_GuardFence = GetInFlightFence();
+		m_ActiveUploadRegion = (m_ActiveUploadRegion + 1) % RenderSettings::MAX_FRAMES_IN_FLIGHT;
+	}
+
+	void RenderDevice::CreateUploadBuffer() {
+		// With a single region the uploads after SubmitUploads() would wait for a fence that isn't submitted yet
+		static_assert(RenderSettings::MAX_FRAMES_IN_FLIGHT > 1);
+
+		BufferDesc uploadBufferDesc{};
+		uploadBufferDesc.m_Name = "Upload Buffer";
+		uploadBufferDesc.m_Usage = BufferUsage::TransferSrc;
+		uploadBufferDesc.m_MemoryAccess = MemoryAccess::CPU_GPU;
+		uploadBufferDesc.m_UpdateFrequency = UpdateFrequency::Static;
+		uploadBufferDesc.m_SizeInBytes = static_cast<u32>(
+			RenderSettings::UPLOAD_REGION_SIZE * RenderSettings::MAX_FRAMES_IN_FLIGHT);
+		m_UploadBuffer = CreateBuffer(uploadBufferDesc);
+		m_pUploadBufferData = static_cast<u8*>(GetBufferMappedPtr(m_UploadBuffer));
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		poolInfo.queueFamilyIndex = m_QueueFamilyIndices.GetGraphicsIdx();
+
+		for (u32 i = 0; i < RenderSettings::MAX_FRAMES_IN_FLIGHT; ++i) {
+			UploadRegion_Vk& region = m_UploadRegions[i];
+			region.m_Begin = RenderSettings::UPLOAD_REGION_SIZE * i;
+			region.m_End = region.m_Begin + RenderSettings::UPLOAD_REGION_SIZE;
+			region.m_Head = region.m_Begin;
+
+			if (vkCreateCommandPool(m_Device, &poolInfo, nullptr, &region.m_CommandPool) != VK_SUCCESS) {
+				std::cout << "Error creating command pool" << std::endl;
+			}
+		}
+		m_ActiveUploadRegion = 0;
+	}
+
+	void RenderDevice::DestroyUploadBuffer() {
+		for (UploadRegion_Vk& region : m_UploadRegions) {
+			vkDestroyCommandPool(m_Device, region.m_CommandPool, nullptr);
+			region = UploadRegion_Vk{};
+		}
+		DestroyBuffer(m_UploadBuffer);
+		m_UploadBuffer = BufferHandle{};
+		m_pUploadBufferData = nullptr;
+	}
+
+	BufferHandle RenderDevice::StageUpload(void const* pData, u64 dataByteSize, u64& uploadOffset) {
+		if (dataByteSize <= RenderSettings::UPLOAD_REGION_SIZE) {
+			uploadOffset = AllocateUpload(dataByteSize);
+			memcpy(m_pUploadBufferData + uploadOffset, pData, dataByteSize);
+			return m_UploadBuffer;
+		}
+
+		// Bigger than a whole region (e.g. all of the mips of a big texture), it gets its own buffer
+		if (dataByteSize > std::numeric_limits<u32>::max()) {
+			std::cout << "ERROR: Upload of " << dataByteSize << " bytes is bigger than the biggest buffer" << std::endl;
+			CKE_UNREACHABLE_CODE();
+		}
+
+		BufferDesc stagingBufferDesc{};
+		stagingBufferDesc.m_Name = "Staging Buffer";
+		stagingBufferDesc.m_Usage = BufferUsage::TransferSrc;
+		stagingBufferDesc.m_MemoryAccess = MemoryAccess::CPU_GPU;
+		stagingBufferDesc.m_UpdateFrequency = UpdateFrequency::Static;
+		stagingBufferDesc.m_SizeInBytes = static_cast<u32>(dataByteSize);
+		BufferHandle const stagingBuffer = CreateBuffer(stagingBufferDesc);
+		memcpy(GetBufferMappedPtr(stagingBuffer), pData, dataByteSize);
+
+		uploadOffset = 0;
+		return stagingBuffer;
+	}
+
+	void RenderDevice::FinishUpload(BufferHandle srcBuffer) {
+		if (srcBuffer == m_UploadBuffer) { return; }
+
+		// Submitted with the earlier copies of the region to keep their order, then the staging buffer can go
+		SubmitUploadCmdBuffer(m_UploadRegions[m_ActiveUploadRegion]);
+		WaitQueueIdle(m_GraphicsQueue);
+		DestroyBuffer(srcBuffer);
+	}
+
+	u64 RenderDevice::AllocateUpload(u64 dataByteSize) {
+		// Aligned so that the copies to any texture format start at a multiple of the texel size
+		constexpr u64 UPLOAD_ALIGNMENT = 16;
+
+		// Writing it to the region would overflow into the next one, StageUpload gives it its own buffer
+		if (dataByteSize > RenderSettings::UPLOAD_REGION_SIZE) {
+			std::cout << "ERROR: Upload of " << dataByteSize << " bytes doesn't fit in an upload region" << std::endl;
+			CKE_UNREACHABLE_CODE();
+		}
+
+		UploadRegion_Vk& region = m_UploadRegions[m_ActiveUploadRegion];
+		if (region.m_IsInFlight) { ReclaimUploadRegion(region); }
+
+		u64 offset = (region.m_Head + UPLOAD_ALIGNMENT - 1) & ~(UPLOAD_ALIGNMENT - 1);
+		if (offset + dataByteSize > region.m_End) {
+			// Too much data for a single frame, the copies are flushed so the region can be reused
+			SubmitUploadCmdBuffer(region);
+			WaitQueueIdle(m_GraphicsQueue);
+			ReclaimUploadRegion(region);
+			offset = region.m_Begin;
+		}
+
+		region.m_Head = offset + dataByteSize;
+		return offset;
+	}
+
+	VkCommandBuffer RenderDevice::GetUploadCmdBuffer() {
+		UploadRegion_Vk& region = m_UploadRegions[m_ActiveUploadRegion];
+		if (region.m_IsRecording) { return region.m_CommandBuffers[region.m_NextCmdIdx - 1]; }
+
+		if (region.m_NextCmdIdx == region.m_CommandBuffers.size()) {
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+			allocInfo.commandPool = region.m_CommandPool;
+
+			VkCommandBuffer cmdBuffer{};
+			if (vkAllocateCommandBuffers(m_Device, &allocInfo, &cmdBuffer) != VK_SUCCESS) {
+				std::cout << "Error creating command buffer" << std::endl;
+			}
+			region.m_CommandBuffers.push_back(cmdBuffer);
+		}
+
+		VkCommandBuffer cmdBuffer = region.m_CommandBuffers[region.m_NextCmdIdx++];
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+		region.m_IsRecording = true;
+		return cmdBuffer;
+	}
+
+	void RenderDevice::SubmitUploadCmdBuffer(UploadRegion_Vk& region) {
+		if (!region.m_IsRecording) { return; }
+
+		VkCommandBuffer cmdBuffer = region.m_CommandBuffers[region.m_NextCmdIdx - 1];
+
+		// The commands submitted after the copies see the uploaded data
+		VkMemoryBarrier2 const memoryBarrier{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+			.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+			.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+			.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+			.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+		};
+		VkDependencyInfo const dependencyInfo{
+			.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+			.memoryBarrierCount = 1,
+			.pMemoryBarriers = &memoryBarrier,
+		};
+		vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+		vkEndCommandBuffer(cmdBuffer);
+
+		SubmitCommandBuffers({cmdBuffer}, m_GraphicsQueue, {});
+		region.m_IsRecording = false;
+	}
+
+	void RenderDevice::ReclaimUploadRegion(UploadRegion_Vk& region) {
+		// Frames that have already completed may have their fence reset and reused by a newer frame
+		if (region.m_IsInFlight && region.m_GuardFrame >= m_NumFramesCompleted) {
+			WaitForFence(region.m_GuardFence);
+		}
+
+		vkResetCommandPool(m_Device, region.m_CommandPool, 0);
+		region.m_NextCmdIdx = 0;
+		region.m_Head = region.m_Begin;
+		region.m_IsInFlight = false;
+	}
+}
+
 
 namespace CKE {
 	VkSurfaceFormatKHR SwapchainInitialConfig::SelectSwapSurfaceFormat(
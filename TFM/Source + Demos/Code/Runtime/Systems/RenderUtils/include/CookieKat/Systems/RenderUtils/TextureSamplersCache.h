@@ -1,6 +1,8 @@
 #pragma once
 #include "CookieKat/Systems/RenderAPI/RenderDevice.h"
 
+#include <mutex>
+
 namespace CKE {
 	// Auxiliary class that helps to avoid creating multiple identical samplers
 	// by maintaining a cache of already created ones
@@ -10,6 +12,7 @@ namespace CKE {
 		void Initialize(RenderDevice* pDevice);
 
 		// Creates a new sampler or returns an existing one with the given configuration
+		// Thread safe, passes that are recorded in parallel share the cache
 		SamplerHandle CreateSampler(SamplerDesc desc);
 
 		// Deletes all of the existing samplers in the cache
@@ -24,5 +27,6 @@ namespace CKE {
 
 		RenderDevice*           m_pDevice{};
 		Vector<DescSamplerPair> m_CachedSamplers{};
+		std::mutex              m_Mutex;
 	};
 }
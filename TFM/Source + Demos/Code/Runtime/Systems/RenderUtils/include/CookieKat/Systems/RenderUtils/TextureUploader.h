@@ -3,22 +3,26 @@
 
 namespace CKE {
 	// Auxiliary class that facilitates uploading different texture data to the GPU
-	// Creates a staging buffer on initialization
+	// The data goes through the upload buffer of the device, the textures can be used in the next frame
 	class TextureUploader
 	{
 	public:
-		void Initialize(RenderDevice* pDevice, u32 stagingBufferSize);
-		void Shutdown();
+		void Initialize(RenderDevice* pDevice);
 
 		void UploadColorTexture2D(TextureHandle targetTexture, void* pTextureData, UInt2 texSize, u32 pixelByteSize);
 		void UploadTexture2D(TextureHandle     targetTexture, void* pTextureData, UInt2 texSize, u32 pixelByteSize,
 			TextureAspectMask aspectType);
+
+		// Uploads all the mips of a texture, the data contains the mips one after the other starting from mip 0
+		void UploadTexture2DMips(TextureHandle targetTexture, void* pMipChainData, UInt2 texSize, u32 pixelByteSize,
+		                         u32 numMips, TextureAspectMask aspectType);
+
+		// Returns the size of a mip chain with all its mips packed one after the other
+		static u64 GetMipChainSizeInBytes(UInt2 texSize, u32 pixelByteSize, u32 numMips);
 		void UploadTextureCubeMap(TextureHandle targetTexture, void* pTextureData, UInt2 texFaceSize);
 		void UploadTextureCubeMap(TextureHandle targetTexture, void* pTexFaceData[6], UInt2 texFaceSize);
 
 	private:
-		BufferHandle  m_StagingBuffer{};
 		RenderDevice* m_pDevice = nullptr;
-		u32           m_StagingBufferSize{};
 	};
 }
@@ -2,21 +2,11 @@
 #include "CookieKat/Systems/RenderUtils/TextureUploader.h"
 #include "CookieKat/Systems/RenderUtils/TextureSamplersCache.h"
 
-namespace CKE {
-	void TextureUploader::Initialize(RenderDevice* pDevice, u32 stagingBufferSize) {
-		// Create and fill staging buffer
-		BufferDesc stagingBufferDesc{};
-		stagingBufferDesc.m_Usage = BufferUsage::TransferSrc;
-		stagingBufferDesc.m_MemoryAccess = MemoryAccess::CPU_GPU;
-		stagingBufferDesc.m_SizeInBytes = stagingBufferSize;
-		m_StagingBuffer = pDevice->CreateBuffer(stagingBufferDesc);
+#include <algorithm>
 
+namespace CKE {
+	void TextureUploader::Initialize(RenderDevice* pDevice) {
 		m_pDevice = pDevice;
-		m_StagingBufferSize = stagingBufferSize;
-	}
-
-	void TextureUploader::Shutdown() {
-		m_pDevice->DestroyBuffer(m_StagingBuffer);
 	}
 
 	void TextureUploader::UploadColorTexture2D(TextureHandle targetTexture, void* pTextureData,
@@ -29,91 +19,59 @@ namespace CKE {
 	void TextureUploader::UploadTexture2D(TextureHandle targetTexture, void* pTextureData,
 	                                      UInt2         texSize,
 	                                      u32           pixelByteSize, TextureAspectMask aspectType) {
-		CKE_ASSERT(pTextureData != nullptr);
-		u32 textureByteSize = texSize.x * texSize.y * pixelByteSize;
-		CKE_ASSERT(textureByteSize <= m_StagingBufferSize);
-
-		m_pDevice->UploadBufferData_DEPR(m_StagingBuffer, pTextureData, textureByteSize, 0);
+		UploadTexture2DMips(targetTexture, pTextureData, texSize, pixelByteSize, 1, aspectType);
+	}
 
-		// Set image layout to Transfer Dst
-		//-----------------------------------------------------------------------------
+	u64 TextureUploader::GetMipChainSizeInBytes(UInt2 texSize, u32 pixelByteSize, u32 numMips) {
+		u64 sizeInBytes = 0;
+		for (u32 mip = 0; mip < numMips; ++mip) {
+			u64 const mipWidth = std::max(texSize.x >> mip, 1u);
+			u64 const mipHeight = std::max(texSize.y >> mip, 1u);
+			sizeInBytes += mipWidth * mipHeight * pixelByteSize;
+		}
+		return sizeInBytes;
+	}
 
-		GraphicsCommandList graphicsCmdList = m_pDevice->GetGraphicsCmdList();
+	void TextureUploader::UploadTexture2DMips(TextureHandle targetTexture, void* pMipChainData,
+	                                          UInt2         texSize, u32 pixelByteSize, u32 numMips,
+	                                          TextureAspectMask aspectType) {
+		CKE_ASSERT(pMipChainData != nullptr);
+		CKE_ASSERT(numMips > 0);
+		u64 const textureByteSize = GetMipChainSizeInBytes(texSize, pixelByteSize, numMips);
 
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::AllCommands,
-			.m_SrcAccessMask = AccessMask::None,
-			.m_DstStage = PipelineStage::Transfer,
-			.m_DstAccessMask = AccessMask::Transfer_Write,
-			.m_OldLayout = TextureLayout::Undefined,
-			.m_NewLayout = TextureLayout::Transfer_Dst,
-			.m_Texture = targetTexture,
+		TextureRange const mipsRange{
 			.m_AspectMask = aspectType,
-		});
-		graphicsCmdList.End();
-
-		SemaphoreHandle imageLayoutToTransfer = m_pDevice->CreateSemaphoreGPU();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {
-			                                     .m_SignalSemaphores = {imageLayoutToTransfer}
-		                                     });
-
-		// Copy data from staging buffer to image
-		//-----------------------------------------------------------------------------
-
-		TransferCommandList transferCtx = m_pDevice->GetTransferCmdList();
-
-		VkBufferImageCopy copyRegion{
-			.bufferOffset = 0,
-			.bufferRowLength = 0,
-			.bufferImageHeight = 0,
-			.imageSubresource = {
-				.aspectMask = ConversionsVK::GetVkImageAspectFlags(aspectType),
-				.mipLevel = 0,
-				.baseArrayLayer = 0,
-				.layerCount = 1,
-			},
-			.imageOffset = {0, 0, 0},
-			.imageExtent = VkExtent3D{texSize.x, texSize.y, 1},
+			.m_BaseMip = 0,
+			.m_MipCount = numMips,
+			.m_BaseLayer = 0,
+			.m_LayerCount = 1
 		};
 
-		transferCtx.Begin();
-		transferCtx.CopyBufferToTexture(m_StagingBuffer, targetTexture, copyRegion);
-		transferCtx.End();
-		FenceHandle const transferFinished = m_pDevice->CreateFence(false);
-		m_pDevice->SubmitTransferCommandList(transferCtx, {
-			                                     .m_WaitSemaphores = {
-				                                     {
-					                                     imageLayoutToTransfer,
-					                                     PipelineStage::Transfer
-				                                     }
-			                                     },
-			                                     .m_SignalSemaphores = {},
-			                                     .m_SignalFence = transferFinished
-		                                     });
+		Vector<VkBufferImageCopy> copyRegions{};
+		copyRegions.reserve(numMips);
+		u64 mipOffset = 0;
+		for (u32 mip = 0; mip < numMips; ++mip) {
+			u32 const mipWidth = std::max(texSize.x >> mip, 1u);
+			u32 const mipHeight = std::max(texSize.y >> mip, 1u);
 
-		// Set image layout to shader read only
-		//-----------------------------------------------------------------------------
+			copyRegions.push_back(VkBufferImageCopy{
+				.bufferOffset = mipOffset,
+				.bufferRowLength = 0,
+				.bufferImageHeight = 0,
+				.imageSubresource = {
+					.aspectMask = ConversionsVK::GetVkImageAspectFlags(aspectType),
+					.mipLevel = mip,
+					.baseArrayLayer = 0,
+					.layerCount = 1,
+				},
+				.imageOffset = {0, 0, 0},
+				.imageExtent = VkExtent3D{mipWidth, mipHeight, 1},
+			});
 
-		m_pDevice->WaitForFence(transferFinished);
-		m_pDevice->ResetFence(transferFinished);
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::Transfer,
-			.m_SrcAccessMask = AccessMask::Transfer_Write,
-			.m_DstStage = PipelineStage::AllCommands,
-			.m_DstAccessMask = AccessMask::None,
-			.m_OldLayout = TextureLayout::Transfer_Dst,
-			.m_NewLayout = TextureLayout::Shader_ReadOnly,
-			.m_Texture = targetTexture,
-			.m_AspectMask = aspectType,
-		});
-		graphicsCmdList.End();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {.m_SignalFence = transferFinished});
-		m_pDevice->WaitForFence(transferFinished);
+			mipOffset += static_cast<u64>(mipWidth) * mipHeight * pixelByteSize;
+		}
 
-		m_pDevice->DestroyFence(transferFinished);
-		m_pDevice->DestroySemaphore(imageLayoutToTransfer);
+		m_pDevice->UploadTextureData(targetTexture, mipsRange, pMipChainData, textureByteSize, copyRegions);
 	}
 
 	void TextureUploader::UploadTextureCubeMap(TextureHandle targetTexture, void* pTextureData,
@@ -121,101 +79,35 @@ namespace CKE {
 		CKE_ASSERT(pTextureData != nullptr);
 		// Assume a pixel size of 32 bits
 		constexpr u32 pixelByteSize = 4;
-		u32           textureByteSize = texFaceSize.x * texFaceSize.y * pixelByteSize * 6;
-		CKE_ASSERT(textureByteSize <= m_StagingBufferSize);
-
-		m_pDevice->UploadBufferData_DEPR(m_StagingBuffer, pTextureData, textureByteSize, 0);
+		u64 const     textureByteSize = static_cast<u64>(texFaceSize.x) * texFaceSize.y * pixelByteSize * 6;
 
-		// Set image layout to Transfer Dst
-		//-----------------------------------------------------------------------------
-
-		GraphicsCommandList graphicsCmdList = m_pDevice->GetGraphicsCmdList();
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::AllCommands,
-			.m_SrcAccessMask = AccessMask::None,
-			.m_DstStage = PipelineStage::Transfer,
-			.m_DstAccessMask = AccessMask::Transfer_Write,
-			.m_OldLayout = TextureLayout::Undefined,
-			.m_NewLayout = TextureLayout::Transfer_Dst,
-			.m_Texture = targetTexture,
+		TextureRange const facesRange{
 			.m_AspectMask = TextureAspectMask::Color,
-			.m_Range = TextureRange{
-				.m_AspectMask = TextureAspectMask::Color,
-				.m_BaseMip = 0,
-				.m_MipCount = 1,
-				.m_BaseLayer = 0,
-				.m_LayerCount = 6
-			}
-		});
-		graphicsCmdList.End();
-		SemaphoreHandle imageLayoutTransfer = m_pDevice->CreateSemaphoreGPU();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {
-			                                     .m_SignalSemaphores = {imageLayoutTransfer}
-		                                     });
-
-		// Copy data from staging buffer to image
-		//-----------------------------------------------------------------------------
-
-		TransferCommandList transferCtx = m_pDevice->GetTransferCmdList();
+			.m_BaseMip = 0,
+			.m_MipCount = 1,
+			.m_BaseLayer = 0,
+			.m_LayerCount = 6
+		};
 
-		transferCtx.Begin();
-		for (i32 i = 0; i < 6; ++i) {
-			VkBufferImageCopy copyRegion{
-				.bufferOffset = texFaceSize.x * i * pixelByteSize,
+		// The faces are next to each other in the rows of the data
+		Array<VkBufferImageCopy, 6> copyRegions{};
+		for (u32 i = 0; i < 6; ++i) {
+			copyRegions[i] = VkBufferImageCopy{
+				.bufferOffset = static_cast<u64>(texFaceSize.x) * i * pixelByteSize,
 				.bufferRowLength = texFaceSize.x * 6,
 				.bufferImageHeight = texFaceSize.y,
 				.imageSubresource = {
 					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
 					.mipLevel = 0,
-					.baseArrayLayer = (u32)i,
+					.baseArrayLayer = i,
 					.layerCount = 1,
 				},
 				.imageOffset = {0, 0, 0},
 				.imageExtent = VkExtent3D{texFaceSize.x, texFaceSize.y, 1},
 			};
-
-			transferCtx.CopyBufferToTexture(m_StagingBuffer, targetTexture, copyRegion);
 		}
-		transferCtx.End();
-		FenceHandle const transferFinished = m_pDevice->CreateFence(false);
-		m_pDevice->SubmitTransferCommandList(transferCtx, {
-			                                     .m_WaitSemaphores = {
-				                                     {imageLayoutTransfer, PipelineStage::Transfer}
-			                                     },
-			                                     .m_SignalSemaphores = {},
-			                                     .m_SignalFence = transferFinished
-		                                     });
-
-		// Set image layout to shader read only
-		//-----------------------------------------------------------------------------
 
-		m_pDevice->WaitForFence(transferFinished);
-		m_pDevice->ResetFence(transferFinished);
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::Transfer,
-			.m_SrcAccessMask = AccessMask::Transfer_Write,
-			.m_DstStage = PipelineStage::AllCommands,
-			.m_DstAccessMask = AccessMask::None,
-			.m_OldLayout = TextureLayout::Transfer_Dst,
-			.m_NewLayout = TextureLayout::Shader_ReadOnly,
-			.m_Texture = targetTexture,
-			.m_AspectMask = TextureAspectMask::Color,
-			.m_Range = TextureRange{
-				.m_AspectMask = TextureAspectMask::Color,
-				.m_BaseMip = 0,
-				.m_MipCount = 1,
-				.m_BaseLayer = 0,
-				.m_LayerCount = 6
-			}
-		});
-		graphicsCmdList.End();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {.m_SignalFence = transferFinished});
-		m_pDevice->WaitForFence(transferFinished);
-
-		m_pDevice->DestroyFence(transferFinished);
-		m_pDevice->DestroySemaphore(imageLayoutTransfer);
+		m_pDevice->UploadTextureData(targetTexture, facesRange, pTextureData, textureByteSize, copyRegions);
 	}
 
 	void TextureUploader::UploadTextureCubeMap(TextureHandle targetTexture, void* pTexFaceData[6],
@@ -223,105 +115,34 @@ namespace CKE {
 		CKE_ASSERT(pTexFaceData != nullptr);
 		// Assume a pixel size of 32 bits
 		constexpr u32 pixelByteSize = 4;
-		u32           faceByteSize = texFaceSize.x * texFaceSize.y * pixelByteSize;
-		u32           textureByteSize = faceByteSize * 6;
-		CKE_ASSERT(textureByteSize <= m_StagingBufferSize);
+		u64 const     faceByteSize = static_cast<u64>(texFaceSize.x) * texFaceSize.y * pixelByteSize;
 
-		for (int i = 0; i < 6; ++i) {
-			m_pDevice->UploadBufferData_DEPR(m_StagingBuffer, pTexFaceData[i], faceByteSize,
-			                                 faceByteSize * i);
-		}
-
-		// Set image layout to Transfer Dst
-		//-----------------------------------------------------------------------------
-
-		GraphicsCommandList graphicsCmdList = m_pDevice->GetGraphicsCmdList();
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::AllCommands,
-			.m_SrcAccessMask = AccessMask::None,
-			.m_DstStage = PipelineStage::Transfer,
-			.m_DstAccessMask = AccessMask::Transfer_Write,
-			.m_OldLayout = TextureLayout::Undefined,
-			.m_NewLayout = TextureLayout::Transfer_Dst,
-			.m_Texture = targetTexture,
-			.m_AspectMask = TextureAspectMask::Color,
-			.m_Range = TextureRange{
+		// Each face comes from its own memory, so each one is a separate upload
+		for (u32 i = 0; i < 6; ++i) {
+			TextureRange const faceRange{
 				.m_AspectMask = TextureAspectMask::Color,
 				.m_BaseMip = 0,
 				.m_MipCount = 1,
-				.m_BaseLayer = 0,
-				.m_LayerCount = 6
-			}
-		});
-		graphicsCmdList.End();
-		SemaphoreHandle imageLayoutTransfer = m_pDevice->CreateSemaphoreGPU();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {
-			                                     .m_SignalSemaphores = {imageLayoutTransfer}
-		                                     });
-
-		// Copy data from staging buffer to image
-		//-----------------------------------------------------------------------------
-
-		TransferCommandList transferCtx = m_pDevice->GetTransferCmdList();
-
-		transferCtx.Begin();
-		for (i32 i = 0; i < 6; ++i) {
-			VkBufferImageCopy copyRegion{
-				.bufferOffset = texFaceSize.x * texFaceSize.y * pixelByteSize * i,
+				.m_BaseLayer = i,
+				.m_LayerCount = 1
+			};
+			VkBufferImageCopy const copyRegion{
+				.bufferOffset = 0,
 				.bufferRowLength = 0,
 				.bufferImageHeight = 0,
 				.imageSubresource = {
 					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
 					.mipLevel = 0,
-					.baseArrayLayer = (u32)i,
+					.baseArrayLayer = i,
 					.layerCount = 1,
 				},
 				.imageOffset = {0, 0, 0},
 				.imageExtent = VkExtent3D{texFaceSize.x, texFaceSize.y, 1},
 			};
 
-			transferCtx.CopyBufferToTexture(m_StagingBuffer, targetTexture, copyRegion);
+			m_pDevice->UploadTextureData(targetTexture, faceRange, pTexFaceData[i], faceByteSize,
+			                             Span<VkBufferImageCopy const>{&copyRegion, 1});
 		}
-		transferCtx.End();
-		FenceHandle const transferFinished = m_pDevice->CreateFence(false);
-		m_pDevice->SubmitTransferCommandList(transferCtx, {
-			                                     .m_WaitSemaphores = {
-				                                     {imageLayoutTransfer, PipelineStage::Transfer}
-			                                     },
-			                                     .m_SignalSemaphores = {},
-			                                     .m_SignalFence = transferFinished
-		                                     });
-
-		// Set image layout to shader read only
-		//-----------------------------------------------------------------------------
-
-		m_pDevice->WaitForFence(transferFinished);
-		m_pDevice->ResetFence(transferFinished);
-		graphicsCmdList.Begin();
-		graphicsCmdList.Barrier(TextureBarrierDescription{
-			.m_SrcStage = PipelineStage::Transfer,
-			.m_SrcAccessMask = AccessMask::Transfer_Write,
-			.m_DstStage = PipelineStage::AllCommands,
-			.m_DstAccessMask = AccessMask::None,
-			.m_OldLayout = TextureLayout::Transfer_Dst,
-			.m_NewLayout = TextureLayout::Shader_ReadOnly,
-			.m_Texture = targetTexture,
-			.m_AspectMask = TextureAspectMask::Color,
-			.m_Range = TextureRange{
-				.m_AspectMask = TextureAspectMask::Color,
-				.m_BaseMip = 0,
-				.m_MipCount = 1,
-				.m_BaseLayer = 0,
-				.m_LayerCount = 6
-			}
-		});
-		graphicsCmdList.End();
-		m_pDevice->SubmitGraphicsCommandList(graphicsCmdList, {.m_SignalFence = transferFinished});
-		m_pDevice->WaitForFence(transferFinished);
-
-		m_pDevice->DestroyFence(transferFinished);
-		m_pDevice->DestroySemaphore(imageLayoutTransfer);
 	}
 }
 
@@ -331,6 +152,7 @@ namespace CKE {
 	}
 
 	SamplerHandle TextureSamplersCache::CreateSampler(SamplerDesc desc) {
+		std::lock_guard lock{m_Mutex};
 		for (DescSamplerPair& pair : m_CachedSamplers) {
 			if (pair.m_Desc.IsEqual(desc)) {
 				return pair.m_SamplerHandle;
@@ -346,6 +168,7 @@ namespace CKE {
 	}
 
 	void TextureSamplersCache::ClearCache() {
+		std::lock_guard lock{m_Mutex};
 		for (DescSamplerPair& pair : m_CachedSamplers) {
 			m_pDevice->DestroySampler(pair.m_SamplerHandle);
 		}
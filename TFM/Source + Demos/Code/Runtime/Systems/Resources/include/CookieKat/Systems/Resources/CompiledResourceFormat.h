@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Serialization/SectionedArchive.h"
+
+#include "CookieKat/Systems/Resources/IResource.h"
+
+namespace CKE {
+	// Compiled resources are sectioned archives with the ResourceHeader and the data of the resource in
+	// separate sections, so the header and the dependencies can be read without parsing the data
+	//
+	// Each section has its own version, a loader only reads data that was written with its current
+	// version, older files are detected and have to be compiled again
+	class CompiledResourceFormat
+	{
+	public:
+		static constexpr u32 HEADER_SECTION = MakeSectionID("HEAD");
+		static constexpr u32 HEADER_VERSION = 1;
+		static constexpr u32 DATA_SECTION = MakeSectionID("DATA");
+
+		// Writes a compiled resource, returns false if the file couldn't be written
+		static bool WriteToFile(char const* path, ResourceHeader header, BinaryOutputArchive const& data, u32 dataVersion);
+
+		// Reads the header of a compiled resource, the data section isn't touched
+		// Returns false if the file isn't a compiled resource or its header has another version
+		static bool ReadHeader(Span<u8 const> fileData, ResourceHeader& header);
+	};
+}
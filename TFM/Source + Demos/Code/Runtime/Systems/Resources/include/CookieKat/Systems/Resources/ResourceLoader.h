@@ -5,6 +5,7 @@
 
 #include "CookieKat/Systems/Resources/ResourceID.h"
 #include "CookieKat/Systems/Resources/IResource.h"
+#include "CookieKat/Systems/Resources/CompiledResourceFormat.h"
 
 namespace CKE {
 	class InstallDependencies;
@@ -28,18 +29,30 @@ namespace CKE {
 
 		//-----------------------------------------------------------------------------
 
-		inline ResourceID GetResourceID() { return m_ID; }
+		inline ResourceID  GetResourceID() { return m_ID; }
+		inline Path const& GetAssetPath() const { return m_AssetPath; }
 
 		//-----------------------------------------------------------------------------
 
 		inline void AddDependency(Path const& dependencyPath) { m_Dependencies.emplace_back(dependencyPath); }
 
+		//-----------------------------------------------------------------------------
+
+		// Memory used by the resource once it is installed, it is counted against the memory budget
+		// of the resource system. Should be set during the install
+		inline void SetMemoryUsage(u64 cpuSizeInBytes, u64 gpuSizeInBytes) {
+			m_CPUSizeInBytes = cpuSizeInBytes;
+			m_GPUSizeInBytes = gpuSizeInBytes;
+		}
+
 	private:
 		friend class ResourceSystem;
 		ResourceID   m_ID;                  // Runtime identifier in the database
 		Path         m_AssetPath;           // Unique Asset identifier and path of the resource in the file system
 		IResource*   m_pResource = nullptr; // Ptr to the resource
 		Vector<Path> m_Dependencies;        // Resources that *are used* by this resource
+		u64          m_CPUSizeInBytes = 0;
+		u64          m_GPUSizeInBytes = 0;
 	};
 
 	//-----------------------------------------------------------------------------
@@ -53,13 +66,25 @@ namespace CKE {
 		// Handles loading the resource
 		virtual LoadResult Load(LoaderContext& ctx, Vector<u8>& binarySrc) const { return LoadResult::Successful; }
 
+		// Handles loading the resource straight from the mapped file instead of a copy of it
+		// Only used for the resources where LoadsFromMappedFile returns true, the loader can keep
+		// the file mapped (e.g. until it has been installed) by moving it into the resource
+		virtual LoadResult LoadMapped(LoaderContext& ctx, MappedFile file) const { return LoadResult::Failed; }
+
+		// Returns true if the resource must be loaded with LoadMapped
+		virtual bool LoadsFromMappedFile(Path const& resourcePath) const { return false; }
+
+		// Reads the dependencies of a resource without loading it
+		// Returns false if the loader can't do it without loading the whole resource
+		virtual bool ReadDependencies(Span<u8 const> fileData, Vector<Path>& dependencies) const { return false; }
+
 		// Allows Post-Loading logic for the resource if necessary
 		virtual LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) { return LoadResult::Successful; }
 
 		// Allows Pre-Unloading logic for the resource if necessary
 		virtual LoadResult Uninstall(LoaderContext& ctx) { return LoadResult::Successful; }
 
-		// Handles unloading the resource
+		// Handles unloading the resource, it must free the memory of the resource
 		virtual LoadResult Unload(LoaderContext& ctx) const { return LoadResult::Successful; }
 
 		//-----------------------------------------------------------------------------
@@ -75,27 +100,59 @@ namespace CKE {
 	class CompiledResourcesLoader : public ResourceLoader
 	{
 	public:
+		// Loads the resource from the data section of the compiled file
 		virtual LoadResult LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const = 0;
 
+		// Version of the data that the compiler writes for the loaded types
+		// It must be increased with every change to their layout, so old files are detected instead of misread
+		virtual u32 GetDataVersion() const = 0;
+
+		bool ReadDependencies(Span<u8 const> fileData, Vector<Path>& dependencies) const override;
+
 	private:
-		virtual LoadResult Load(LoaderContext& ctx, Vector<u8>& binarySrc) const override;
+		// Compiled resources are read straight from the mapped file, the data section
+		// can be read in place (e.g. spans of the compressed texture data)
+		bool       LoadsFromMappedFile(Path const& resourcePath) const override { return true; }
+		LoadResult LoadMapped(LoaderContext& ctx, MappedFile file) const override;
 	};
 }
 
 namespace CKE {
-	inline LoadResult CompiledResourcesLoader::Load(LoaderContext& ctx, Vector<u8>& binarySrc) const {
-		BinaryInputArchive ar;
-		ar.ReadFromBlob(binarySrc);
-
+	inline bool CompiledResourcesLoader::ReadDependencies(Span<u8 const> fileData, Vector<Path>& dependencies) const {
 		ResourceHeader header;
-		ar << header;
+		if (!CompiledResourceFormat::ReadHeader(fileData, header)) { return false; }
+		dependencies = std::move(header.m_DependencyPaths);
+		return true;
+	}
+
+	inline LoadResult CompiledResourcesLoader::LoadMapped(LoaderContext& ctx, MappedFile file) const {
+		SectionedArchiveReader reader;
+		if (!reader.Open(Span<u8 const>{file.GetData(), file.GetSizeInBytes()})) {
+			printf("ERROR: [%s] is not a compiled resource or was compiled with an older format\n",
+			       ctx.GetAssetPath().c_str());
+			return LoadResult::Failed;
+		}
+
+		ResourceHeader     header;
+		BinaryInputArchive headerArchive;
+		if (!reader.ReadSection(CompiledResourceFormat::HEADER_SECTION, CompiledResourceFormat::HEADER_VERSION,
+		                        headerArchive)) {
+			printf("ERROR: The header of [%s] was compiled with another version\n", ctx.GetAssetPath().c_str());
+			return LoadResult::Failed;
+		}
+		headerArchive << header;
 
 		for (Path& dependency : header.m_DependencyPaths) {
 			ctx.AddDependency(dependency);
 		}
 
-		LoadCompiledResource(ctx, ar);
-
-		return LoadResult::Successful;
+		// The archive reads from the mapped file, the loader must copy what it keeps
+		BinaryInputArchive dataArchive;
+		if (!reader.ReadSection(CompiledResourceFormat::DATA_SECTION, GetDataVersion(), dataArchive)) {
+			printf("ERROR: The data of [%s] was compiled with another version, it must be compiled again\n",
+			       ctx.GetAssetPath().c_str());
+			return LoadResult::Failed;
+		}
+		return LoadCompiledResource(ctx, dataArchive);
 	}
 }
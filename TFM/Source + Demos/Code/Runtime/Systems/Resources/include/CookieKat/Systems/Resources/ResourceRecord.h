@@ -6,12 +6,36 @@
 #include "CookieKat/Systems/Resources/IResource.h"
 
 namespace CKE {
+	class ResourceLoader;
+}
+
+namespace CKE {
+	enum class ResourceLoadState : u8
+	{
+		Unloaded,   // The resource hasn't been requested
+		Loading,    // The file is being read and loaded in a task
+		Installing, // Loaded, waiting for its dependencies to be installed and for its own install
+		Loaded,     // Installed and ready to be used
+		Failed,     // The file or one of its dependencies couldn't be loaded, it is never installed
+	};
+
 	struct ResourceRecord
 	{
-		ResourceID   m_ID;                  // Runtime identifier in the database
-		Path         m_Path;                // Unique identifier and resource path in the file system
-		IResource*   m_pResource = nullptr; // Ptr to the resource
-		Vector<Path> m_Dependencies;        // Resources that *are used* by this resource
-		Vector<Path> m_Users;               // Resources that *use* this resource
+		ResourceID         m_ID;                  // Runtime identifier in the database
+		Path               m_Path;                // Unique identifier and resource path in the file system
+		IResource*         m_pResource = nullptr; // Ptr to the resource
+		ResourceLoader*    m_pLoader = nullptr;   // Loader that loaded the resource and has to unload it
+		Vector<Path>       m_Dependencies;        // Resources that *are used* by this resource
+		Vector<ResourceID> m_DependencyIDs;       // IDs of the dependencies, this resource holds a reference to each
+		ResourceLoadState  m_LoadState = ResourceLoadState::Unloaded;
+
+		// Number of load requests and resources that use this resource
+		// When it reaches 0 the resource is kept cached until it is evicted
+		u32 m_RefCount = 0;
+		u64 m_ReleaseFrame = 0; // Frame in which the last reference was released
+
+		// Memory usage reported by the loader once the resource is installed
+		u64 m_CPUSizeInBytes = 0;
+		u64 m_GPUSizeInBytes = 0;
 	};
 }
@@ -2,6 +2,7 @@
 
 #include "CookieKat/Core/Containers/Containers.h"
 #include "CookieKat/Core/FileSystem/FileSystem.h"
+#include "CookieKat/Core/Memory/Memory.h"
 
 #include "CookieKat/Systems/EngineSystem/IEngineSystem.h"
 #include "CookieKat/Systems/Resources/ResourceID.h"
@@ -9,9 +10,26 @@
 #include "CookieKat/Systems/Resources/ResourceTypeID.h"
 #include "CookieKat/Systems/Resources/ResourceLoader.h"
 #include "CookieKat/Systems/Resources/ResourceRecord.h"
+#include "CookieKat/Systems/Resources/InstallDependencies.h"
 #include "CookieKat/Systems/TaskSystem/TaskSystem.h"
 
+#include <chrono>
+#include <mutex>
+
 namespace CKE {
+	// Memory used by a group of installed resources
+	struct ResourceMemoryStats
+	{
+		u64 m_NumResources = 0;
+		u64 m_CPUSizeInBytes = 0;
+		u64 m_GPUSizeInBytes = 0;
+		u64 m_UnreferencedSizeInBytes = 0; // CPU + GPU memory of the resources that can be evicted
+
+		inline u64 GetTotalSizeInBytes() const { return m_CPUSizeInBytes + m_GPUSizeInBytes; }
+	};
+
+	//-----------------------------------------------------------------------------
+
 	class ResourceSystem : public IEngineSystem
 	{
 	public:
@@ -24,10 +42,31 @@ namespace CKE {
 		// Resource Management
 		//-----------------------------------------------------------------------------
 
+		// Requests the load of a resource and returns its ID without waiting for it
+		// The file is read and loaded in the task system, its dependencies are requested in parallel
+		// and the resource is installed by Update on the main thread after all of them are installed
+		//
+		// Every load adds a reference to the resource that must be released with UnloadResource
+		ResourceID LoadResourceAsync(Path resourcePath);
+
+		// Loads a resource and waits until it has been installed, only from the main thread
+		// If the load fails the resource is left in the failed state, it can be checked with HasFailed
 		ResourceID LoadResource(Path resourcePath);
-		void       UnloadResource(ResourceID resourceID);
+
+		// Releases a reference to the resource
+		// Resources without references stay cached, so loading them again is free, until
+		// Update evicts them to keep the resident memory within the budget
+		void UnloadResource(ResourceID resourceID);
+
 		IResource* GetResource(ResourceID resourceID);
 
+		// Reads the dependencies of a resource without loading it, only the header of compiled
+		// resources is read. Returns false if the file doesn't exist or its loader can't read them
+		bool ReadResourceDependencies(Path const& resourcePath, Vector<Path>& dependencies);
+
+		template <typename T>
+			requires std::is_base_of_v<IResource, T>
+		TResourceID<T> LoadResourceAsync(Path resourcePath);
 		template <typename T>
 			requires std::is_base_of_v<IResource, T>
 		TResourceID<T> LoadResource(Path resourcePath);
@@ -35,6 +74,45 @@ namespace CKE {
 			requires std::is_base_of_v<IResource, T>
 		T* GetResource(ResourceID resourceID);
 
+		// Async Loading
+		//-----------------------------------------------------------------------------
+
+		ResourceLoadState GetLoadState(ResourceID resourceID);
+		inline bool       IsLoaded(ResourceID resourceID) { return GetLoadState(resourceID) == ResourceLoadState::Loaded; }
+		inline bool       HasFailed(ResourceID resourceID) { return GetLoadState(resourceID) == ResourceLoadState::Failed; }
+
+		// Blocks until the resource has been installed or its load has failed, only from the main thread
+		// While waiting the calling thread installs resources and executes load tasks
+		// Returns false if the load has failed
+		bool WaitForResource(ResourceID resourceID);
+
+		// Blocks until all of the requested resources have been installed or have failed, only from the main thread
+		void WaitForAllResources();
+
+		// Installs the loaded resources whose dependencies are already installed, only from the main thread
+		// Stops once the install budget of the frame is spent, at least one resource is installed per call
+		void Update();
+
+		inline void SetInstallBudget(f32 budgetMs) { m_InstallBudgetMs = budgetMs; }
+
+		// Memory Budget
+		//-----------------------------------------------------------------------------
+
+		// Update evicts unreferenced resources, least recently released first, while the memory of
+		// all of the installed resources is over the budget. Referenced resources are never evicted
+		inline void SetMemoryBudget(u64 budgetInBytes) { m_MemoryBudgetInBytes = budgetInBytes; }
+		inline u64  GetMemoryBudget() const { return m_MemoryBudgetInBytes; }
+
+		// Unloads all of the unreferenced resources right away, only from the main thread
+		// The GPU must not be using them anymore (e.g. after waiting for the device to be idle)
+		void EvictUnreferencedResources();
+
+		// Memory used by all of the installed resources
+		ResourceMemoryStats GetMemoryStats();
+
+		// Memory used by the installed resources of each type, indexed by the extension of the type
+		Map<String, ResourceMemoryStats> GetMemoryStatsPerType();
+
 		// Resource Loaders
 		//-----------------------------------------------------------------------------
 
@@ -49,13 +127,63 @@ namespace CKE {
 		void        SetBasePath(Path const& path) { m_BaseDataPath = path; }
 
 	private:
+		// In flight load of a resource, from the request until it is installed
+		struct LoadRequest : public ITaskSet
+		{
+			ResourceSystem*                       m_pResourceSystem = nullptr;
+			ResourceLoader*                       m_pLoader = nullptr;
+			LoaderContext                         m_Context{};
+			InstallDependencies                   m_InstallDependencies{}; // IDs of the dependencies
+			std::chrono::system_clock::time_point m_RequestTime{};
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override;
+		};
+
 		void GetResourceLoader(Path resourcePath, ResourceLoader*& pLoader);
 
+		// Reads and loads the resource and requests its dependencies, runs in a task
+		void ExecuteLoad(LoadRequest& request);
+
+		// Installs the first queued resource whose dependencies are installed
+		// Returns false if there isn't any resource ready to be installed
+		bool InstallNextResource();
+
+		// Destroys the requests of the failed loads once their tasks have finished
+		// and evicts the failed resources that don't have references anymore
+		void ReleaseFailedLoads();
+
+		// Releases a reference to the resource, the mutex must be locked
+		void ReleaseReference(ResourceRecord& record);
+
+		// Installed or failed resources whose request has been destroyed, the mutex must be locked
+		bool CanBeEvicted(ResourceRecord const& record) const;
+
+		// Unloads an installed or failed resource without references and releases its dependencies
+		void EvictResource(ResourceID resourceID);
+
+		// Evicts the oldest unreferenced resources until the resident memory is within the budget
+		void EvictOverBudget();
+
 	private:
 		static constexpr u32 MAX_LOADED_RESOURCES = 25'000;
 
+		// Frames that a resource stays resident after its release, the frames in flight can still be using it
+		static constexpr u64 EVICTION_FRAME_DELAY = 3;
+
 		TaskSystem* m_pTaskSystem = nullptr;
 
+		// Protects the resources database and the load requests, the loads run in parallel in the task system
+		std::mutex                m_Mutex;
+		Vector<UPtr<LoadRequest>> m_LoadRequests; // All of the requests that haven't been installed
+		Vector<LoadRequest*>      m_InstallQueue; // Loaded requests in the order they finished loading
+		Vector<LoadRequest*>      m_FailedLoads;  // Failed requests, destroyed on the main thread
+		f32                       m_InstallBudgetMs = 4.0f;
+		u64                       m_FrameIndex = 0;
+
+		Vector<ResourceID> m_UnreferencedResources;              // Eviction candidates in the order they were released
+		u64                m_ResidentSizeInBytes = 0;            // CPU + GPU memory of the installed resources
+		u64                m_MemoryBudgetInBytes = 1024ull << 20; // 1 GiB
+
 		Map<ResourceTypeID, ResourceLoader*> m_pResourceLoaders;
 		Map<ResourceID, ResourceRecord>      m_pResourceDatabase;
 		Map<Path, ResourceID>                m_PathToResourceID;
@@ -74,7 +202,13 @@ namespace CKE {
 	template <typename T>
 		requires std::is_base_of_v<IResource, T>
 	T* ResourceSystem::GetResource(ResourceID resourceID) {
-		return static_cast<T*>(m_pResourceDatabase[resourceID].m_pResource);
+		return static_cast<T*>(GetResource(resourceID));
+	}
+
+	template <typename T>
+		requires std::is_base_of_v<IResource, T>
+	TResourceID<T> ResourceSystem::LoadResourceAsync(Path resourcePath) {
+		return TResourceID<T>{LoadResourceAsync(resourcePath)};
 	}
 
 	template <typename T>
@@ -0,0 +1,24 @@
+#include "CompiledResourceFormat.h"
+
+namespace CKE {
+	bool CompiledResourceFormat::WriteToFile(char const* path, ResourceHeader header, BinaryOutputArchive const& data,
+	                                         u32 dataVersion) {
+		BinaryOutputArchive headerArchive{};
+		headerArchive << header;
+
+		SectionedArchiveWriter writer;
+		writer.AddSection(HEADER_SECTION, HEADER_VERSION, headerArchive);
+		writer.AddSection(DATA_SECTION, dataVersion, data);
+		return writer.WriteToFile(path);
+	}
+
+	bool CompiledResourceFormat::ReadHeader(Span<u8 const> fileData, ResourceHeader& header) {
+		SectionedArchiveReader reader;
+		if (!reader.Open(fileData)) { return false; }
+
+		BinaryInputArchive headerArchive{};
+		if (!reader.ReadSection(HEADER_SECTION, HEADER_VERSION, headerArchive)) { return false; }
+		headerArchive << header;
+		return true;
+	}
+}
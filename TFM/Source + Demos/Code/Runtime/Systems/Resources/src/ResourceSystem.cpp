@@ -5,9 +5,22 @@
 
 #include "CookieKat/Systems/Resources/InstallDependencies.h"
 
+#include <algorithm>
 #include <chrono>
+#include <thread>
 
 namespace CKE {
+	namespace {
+		void AddToMemoryStats(ResourceMemoryStats& stats, ResourceRecord const& record) {
+			stats.m_NumResources++;
+			stats.m_CPUSizeInBytes += record.m_CPUSizeInBytes;
+			stats.m_GPUSizeInBytes += record.m_GPUSizeInBytes;
+			if (record.m_RefCount == 0) {
+				stats.m_UnreferencedSizeInBytes += record.m_CPUSizeInBytes + record.m_GPUSizeInBytes;
+			}
+		}
+	}
+
 	void ResourceSystem::Initialize(TaskSystem* pTaskSystem) {
 		// Generate possible runtime resource IDs
 		for (u64 i = 1; i <= MAX_LOADED_RESOURCES; ++i) {
@@ -17,7 +30,10 @@ namespace CKE {
 		m_pTaskSystem = pTaskSystem;
 	}
 
-	void ResourceSystem::Shutdown() { }
+	void ResourceSystem::Shutdown() {
+		// Finish the loads that are still running, they access the loaders and the database
+		WaitForAllResources();
+	}
 
 	void ResourceSystem::GetResourceLoader(Path resourcePath, ResourceLoader*& pLoader) {
 		u64                  i = resourcePath.find_last_of('.');
@@ -32,139 +48,440 @@ namespace CKE {
 		pLoader = loaderPair->second;
 	}
 
+	ResourceID ResourceSystem::LoadResourceAsync(Path resourcePath) {
+		LoadRequest* pRequest = nullptr;
+		ResourceID   resourceID{};
+		{
+			std::lock_guard lock{m_Mutex};
+
+			// Check if its already loaded or loading and return if so
+			//-----------------------------------------------------------------------------
+
+			auto const pathIt = m_PathToResourceID.find(resourcePath);
+			if (pathIt != m_PathToResourceID.end()) {
+				ResourceRecord& record = m_pResourceDatabase[pathIt->second];
+				if (record.m_RefCount == 0) { std::erase(m_UnreferencedResources, record.m_ID); }
+				record.m_RefCount++;
+				return record.m_ID;
+			}
+
+			// Create a record
+			//-----------------------------------------------------------------------------
+
+			CKE_ASSERT(m_AvailableResourceIDs.size() > 0); // If this isn't true then we ran out of IDs
+
+			// Get file extension from path and search the loader for the given type
+			ResourceLoader* pLoader;
+			GetResourceLoader(resourcePath, pLoader);
+			CKE_ASSERT(pLoader != nullptr); // We haven't found a loader for the given resource type
+
+			ResourceRecord record{};
+			record.m_Path = resourcePath;
+			record.m_ID = m_AvailableResourceIDs.front();
+			record.m_pLoader = pLoader;
+			record.m_LoadState = ResourceLoadState::Loading;
+			record.m_RefCount = 1;
+			m_AvailableResourceIDs.pop();
+
+			m_PathToResourceID.insert({resourcePath, record.m_ID});
+			m_pResourceDatabase.insert({record.m_ID, record});
+
+			// Create the load request
+			//-----------------------------------------------------------------------------
+
+			auto request = std::make_unique<LoadRequest>();
+			request->m_pResourceSystem = this;
+			request->m_pLoader = pLoader;
+			request->m_Context.m_AssetPath = record.m_Path;
+			request->m_Context.m_ID = record.m_ID;
+			request->m_RequestTime = std::chrono::system_clock::now();
+			pRequest = request.get();
+			resourceID = record.m_ID;
+			m_LoadRequests.emplace_back(std::move(request));
+		}
+
+		// The load runs outside of the lock, it can request more resources
+		// The request can be installed and destroyed from now on, so it must not be accessed
+		if (m_pTaskSystem != nullptr) { m_pTaskSystem->ScheduleTask(pRequest); }
+		else { ExecuteLoad(*pRequest); }
+
+		return resourceID;
+	}
+
 	ResourceID ResourceSystem::LoadResource(Path resourcePath) {
-		auto startTime = std::chrono::system_clock::now();
+		ResourceID resourceID = LoadResourceAsync(resourcePath);
+		WaitForResource(resourceID);
+		return resourceID;
+	}
 
-		// Check if its already loaded and return if so
-		//-----------------------------------------------------------------------------
+	bool ResourceSystem::ReadResourceDependencies(Path const& resourcePath, Vector<Path>& dependencies) {
+		ResourceLoader* pLoader;
+		GetResourceLoader(resourcePath, pLoader);
 
-		if (m_PathToResourceID.contains(resourcePath)) {
-			// std::cout <<
-			//		"WARNING: Trying to load an already loaded resource, the existing one has been returned instead of loading a new one.\n";
-			return m_PathToResourceID[resourcePath];
-		}
+		// Only the pages of the file that are read are loaded
+		MappedFile file = g_FileSystem.MapFile(m_BaseDataPath + resourcePath);
+		if (!file.IsValid()) { return false; }
+		return pLoader->ReadDependencies(Span<u8 const>{file.GetData(), file.GetSizeInBytes()}, dependencies);
+	}
 
-		// Create a record
+	void ResourceSystem::LoadRequest::ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) {
+		m_pResourceSystem->ExecuteLoad(*this);
+	}
+
+	void ResourceSystem::ExecuteLoad(LoadRequest& request) {
+		LoaderContext& loaderContext = request.m_Context;
+
+		// Load binary data and resource
 		//-----------------------------------------------------------------------------
 
-		CKE_ASSERT(m_AvailableResourceIDs.size() > 0); // If this isn't true then we ran out of IDs
+		String const fullPath = m_BaseDataPath + loaderContext.m_AssetPath;
 
-		ResourceRecord record{};
-		record.m_Path = resourcePath;
-		record.m_ID = m_AvailableResourceIDs.front();
-		m_AvailableResourceIDs.pop();
+		LoadResult result;
+		if (request.m_pLoader->LoadsFromMappedFile(loaderContext.m_AssetPath)) {
+			MappedFile file = g_FileSystem.MapFile(fullPath);
+			result = file.IsValid() ? request.m_pLoader->LoadMapped(loaderContext, std::move(file)) : LoadResult::Failed;
+		}
+		else {
+			Blob blob = g_FileSystem.ReadBinaryFile(fullPath);
+			result = request.m_pLoader->Load(loaderContext, blob);
+		}
 
-		m_PathToResourceID.insert({resourcePath, record.m_ID});
+		// Missing files or stale compiled files, the waiters see the failed state and it is never installed
+		if (result == LoadResult::Failed) {
+			std::lock_guard lock{m_Mutex};
+			m_pResourceDatabase[loaderContext.m_ID].m_LoadState = ResourceLoadState::Failed;
+			m_FailedLoads.push_back(&request);
+			return;
+		}
+		CKE_ASSERT(loaderContext.GetResource() != nullptr);
 
-		// Get file extension from path and search the loader for the given type
+		// Request all of the dependencies, they load in parallel
+		// The resource keeps the reference of each request until it is evicted
 		//-----------------------------------------------------------------------------
 
-		ResourceLoader* pLoader;
-		GetResourceLoader(resourcePath, pLoader);
-		CKE_ASSERT(pLoader != nullptr); // We haven't found a loader for the given resource type
+		for (Path const& dependencyPath : loaderContext.m_Dependencies) {
+			ResourceID dependencyID = LoadResourceAsync(dependencyPath);
+			request.m_InstallDependencies.m_DependencyIDs.emplace_back(dependencyID);
+		}
 
-		// Load binary data
-		//-----------------------------------------------------------------------------
+		std::lock_guard lock{m_Mutex};
+
+		// The install waits for the dependencies on the main thread
+		m_pResourceDatabase[loaderContext.m_ID].m_LoadState = ResourceLoadState::Installing;
+		m_InstallQueue.push_back(&request);
+	}
 
-		String const fullPath = m_BaseDataPath + resourcePath;
-		Blob         blob = g_FileSystem.ReadBinaryFile(fullPath);
+	bool ResourceSystem::InstallNextResource() {
+		LoadRequest* pRequest = nullptr;
+		bool         dependencyFailed = false;
+		{
+			std::lock_guard lock{m_Mutex};
+
+			// Resources are installed after all of their dependencies
+			auto const readyIt = std::find_if(m_InstallQueue.begin(), m_InstallQueue.end(),
+			                                  [this](LoadRequest const* pQueued) {
+				                                  for (ResourceID id : pQueued->m_InstallDependencies.m_DependencyIDs) {
+					                                  ResourceLoadState const state = m_pResourceDatabase[id].m_LoadState;
+					                                  if (state != ResourceLoadState::Loaded &&
+						                                  state != ResourceLoadState::Failed) {
+						                                  return false;
+					                                  }
+				                                  }
+				                                  return true;
+			                                  });
+			if (readyIt == m_InstallQueue.end()) { return false; }
+
+			pRequest = *readyIt;
+			m_InstallQueue.erase(readyIt);
+
+			for (ResourceID id : pRequest->m_InstallDependencies.m_DependencyIDs) {
+				if (m_pResourceDatabase[id].m_LoadState == ResourceLoadState::Failed) { dependencyFailed = true; }
+			}
+		}
 
-		// Load Resource and dependencies
-		//-----------------------------------------------------------------------------
+		// The task can still be finishing after queueing the request
+		if (m_pTaskSystem != nullptr) { m_pTaskSystem->WaitForTask(pRequest); }
 
-		LoaderContext loaderContext{};
-		loaderContext.m_AssetPath = record.m_Path;
-		loaderContext.m_ID = record.m_ID;
-		pLoader->Load(loaderContext, blob);
-		CKE_ASSERT(loaderContext.GetResource() != nullptr);
-		record.m_Dependencies = loaderContext.m_Dependencies;
-		record.m_pResource = loaderContext.m_pResource;
+		LoaderContext& loaderContext = pRequest->m_Context;
 
-		// Load and install dependencies
-		InstallDependencies installDependencies{};
-		for (Path const& dependencyPath : record.m_Dependencies) {
-			ResourceID dependencyID = LoadResource(dependencyPath);
+		// The resource can't be installed without its dependencies, so it fails as well
+		if (dependencyFailed) {
+			pRequest->m_pLoader->Unload(loaderContext);
 
-			// Add user to child resource
-			ResourceRecord& dependencyRecord = m_pResourceDatabase[dependencyID];
-			dependencyRecord.m_Users.push_back(record.m_Path);
+			g_LoggingSystem.Log(LogLevel::Error, LogChannel::Assets, "Failed to load {}, a dependency failed\n",
+			                    loaderContext.m_AssetPath);
 
-			// Save install dependencies 
-			installDependencies.m_DependencyIDs.emplace_back(dependencyID);
+			std::lock_guard lock{m_Mutex};
+			ResourceRecord& record = m_pResourceDatabase[loaderContext.m_ID];
+			record.m_DependencyIDs = pRequest->m_InstallDependencies.m_DependencyIDs; // Released on eviction
+			record.m_LoadState = ResourceLoadState::Failed;
+			std::erase_if(m_LoadRequests, [pRequest](UPtr<LoadRequest> const& request) {
+				return request.get() == pRequest;
+			});
+			return true;
 		}
 
 		// Install parent resource
-		pLoader->Install(loaderContext, installDependencies);
-
-		// Insert it into the database (We insert it last because we copy it as value)
-		m_pResourceDatabase.insert({record.m_ID, record});
+		pRequest->m_pLoader->Install(loaderContext, pRequest->m_InstallDependencies);
+
+		{
+			std::lock_guard lock{m_Mutex};
+			ResourceRecord& record = m_pResourceDatabase[loaderContext.m_ID];
+			record.m_pResource = loaderContext.m_pResource;
+			record.m_Dependencies = loaderContext.m_Dependencies;
+			record.m_DependencyIDs = pRequest->m_InstallDependencies.m_DependencyIDs;
+			record.m_LoadState = ResourceLoadState::Loaded;
+			record.m_CPUSizeInBytes = loaderContext.m_CPUSizeInBytes;
+			record.m_GPUSizeInBytes = loaderContext.m_GPUSizeInBytes;
+			m_ResidentSizeInBytes += record.m_CPUSizeInBytes + record.m_GPUSizeInBytes;
+		}
 
 		// Time to load tracking
 		auto endTime = std::chrono::system_clock::now();
 		auto elapsed =
-				std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-		g_LoggingSystem.Log(LogLevel::Info, LogChannel::Assets, "Loaded {} / Time: {}ms\n", record.m_Path,
+				std::chrono::duration_cast<std::chrono::milliseconds>(endTime - pRequest->m_RequestTime);
+		g_LoggingSystem.Log(LogLevel::Info, LogChannel::Assets, "Loaded {} / Time: {}ms\n", loaderContext.m_AssetPath,
 		                    elapsed.count());
 
-		return record.m_ID;
+		std::lock_guard lock{m_Mutex};
+		std::erase_if(m_LoadRequests, [pRequest](UPtr<LoadRequest> const& request) {
+			return request.get() == pRequest;
+		});
+		return true;
+	}
+
+	void ResourceSystem::Update() {
+		{
+			std::lock_guard lock{m_Mutex};
+			m_FrameIndex++;
+		}
+
+		auto const startTime = std::chrono::system_clock::now();
+		while (InstallNextResource()) {
+			std::chrono::duration<f32, std::milli> const elapsed = std::chrono::system_clock::now() - startTime;
+			if (elapsed.count() >= m_InstallBudgetMs) { break; }
+		}
+
+		ReleaseFailedLoads();
+		EvictOverBudget();
+	}
+
+	ResourceLoadState ResourceSystem::GetLoadState(ResourceID resourceID) {
+		std::lock_guard lock{m_Mutex};
+		auto const recordIt = m_pResourceDatabase.find(resourceID);
+		if (recordIt == m_pResourceDatabase.end()) { return ResourceLoadState::Unloaded; }
+		return recordIt->second.m_LoadState;
+	}
+
+	bool ResourceSystem::WaitForResource(ResourceID resourceID) {
+		CKE_ASSERT(GetLoadState(resourceID) != ResourceLoadState::Unloaded);
+		while (true) {
+			ResourceLoadState const state = GetLoadState(resourceID);
+			if (state == ResourceLoadState::Loaded) { return true; }
+			if (state == ResourceLoadState::Failed) { return false; }
+
+			if (InstallNextResource()) { continue; }
+
+			// Nothing can be installed yet, help with one of the loads that are still running
+			LoadRequest* pLoadingRequest = nullptr;
+			{
+				std::lock_guard lock{m_Mutex};
+				for (UPtr<LoadRequest>& request : m_LoadRequests) {
+					if (m_pResourceDatabase[request->m_Context.m_ID].m_LoadState == ResourceLoadState::Loading) {
+						pLoadingRequest = request.get();
+						break;
+					}
+				}
+			}
+
+			if (pLoadingRequest != nullptr && m_pTaskSystem != nullptr) { m_pTaskSystem->WaitForTask(pLoadingRequest); }
+			else { std::this_thread::yield(); }
+		}
+	}
+
+	void ResourceSystem::WaitForAllResources() {
+		while (true) {
+			ReleaseFailedLoads();
+
+			ResourceID pendingID{};
+			{
+				std::lock_guard lock{m_Mutex};
+				if (m_LoadRequests.empty()) { return; }
+				pendingID = m_LoadRequests.back()->m_Context.m_ID;
+			}
+			WaitForResource(pendingID);
+		}
+	}
+
+	void ResourceSystem::ReleaseFailedLoads() {
+		while (true) {
+			LoadRequest* pRequest = nullptr;
+			{
+				std::lock_guard lock{m_Mutex};
+				if (m_FailedLoads.empty()) { break; }
+				pRequest = m_FailedLoads.back();
+				m_FailedLoads.pop_back();
+			}
+
+			// The task can still be finishing after marking the resource as failed
+			if (m_pTaskSystem != nullptr) { m_pTaskSystem->WaitForTask(pRequest); }
+
+			g_LoggingSystem.Log(LogLevel::Error, LogChannel::Assets, "Failed to load {}\n",
+			                    pRequest->m_Context.m_AssetPath);
+
+			std::lock_guard lock{m_Mutex};
+			std::erase_if(m_LoadRequests, [pRequest](UPtr<LoadRequest> const& request) {
+				return request.get() == pRequest;
+			});
+		}
+
+		// Failed resources don't use any memory, there is no reason to keep them cached
+		while (true) {
+			ResourceID evictedID{};
+			{
+				std::lock_guard lock{m_Mutex};
+				auto const candidateIt = std::find_if(m_UnreferencedResources.begin(), m_UnreferencedResources.end(),
+				                                      [this](ResourceID id) {
+					                                      ResourceRecord const& record = m_pResourceDatabase[id];
+					                                      return record.m_LoadState == ResourceLoadState::Failed &&
+							                                      CanBeEvicted(record);
+				                                      });
+				if (candidateIt == m_UnreferencedResources.end()) { return; }
+				evictedID = *candidateIt;
+			}
+			EvictResource(evictedID);
+		}
 	}
 
 	void ResourceSystem::UnloadResource(ResourceID resourceID) {
-		//CKE_ASSERT(m_pResourceDatabase.contains(resourceID));
-		//ResourceRecord& record = m_pResourceDatabase[resourceID];
-		//if(!record.m_Users.empty()) {
-		//	g_LoggingSystem.Log(LogLevel::Warning, LogChannel::Assets, "Trying to unload a resource with users");
-		//	return;
-		//}
-
-		//// Update path to ID link
-		//Path path{};
-		//for (auto& [p, id] : m_PathToResourceID) {
-		//	if (id == resourceID) {
-		//		m_PathToResourceID.erase(p);
-		//		path = p;
-		//		break;
-		//	}
-		//}
-
-		//// Get Loader
-		//ResourceLoader* pLoader;
-		//GetResourceLoader(path, pLoader);
-		//CKE_ASSERT(pLoader != nullptr); // We haven't found a loader for the given resource type
-
-		//pLoader->Uninstall(record);
-		//CKE_ASSERT(record.GetResource() != nullptr);
-
-		//for (Path& dependencyPath : record.m_Dependencies) {
-		//	ResourceID dependencyID = LoadResource(dependencyPath);
-		//	ResourceRecord& dependencyRecord = m_pResourceDatabase[dependencyID];
-
-		//	// Remove this user from the dependency
-		//	Vector<Path>& deps = dependencyRecord.m_Users;
-		//	for (int i = 0; i < deps.size(); ++i) {
-		//		if (deps[i] == path) {
-		//			deps[i] = deps.back();
-		//			deps.pop_back();
-		//		}
-		//	}
-
-		//	// If there are no more users of the dependency, unload it
-		//	if(deps.empty()) {
-		//		UnloadResource(dependencyID);
-		//	}
-		//}
-
-		//// Unload parent resource
-		//pLoader->Unload(record);
-
-		//// Return the ID as available
-		//m_AvailableResourceIDs.push(resourceID);
-		//resourceID.m_ID = 0;
+		std::lock_guard lock{m_Mutex};
+		CKE_ASSERT(m_pResourceDatabase.contains(resourceID)); // The resource has already been evicted
+		ReleaseReference(m_pResourceDatabase[resourceID]);
+	}
+
+	void ResourceSystem::ReleaseReference(ResourceRecord& record) {
+		CKE_ASSERT(record.m_RefCount > 0); // More unloads than loads of the resource
+		record.m_RefCount--;
+		if (record.m_RefCount == 0) {
+			record.m_ReleaseFrame = m_FrameIndex;
+			m_UnreferencedResources.push_back(record.m_ID);
+		}
+	}
+
+	bool ResourceSystem::CanBeEvicted(ResourceRecord const& record) const {
+		if (record.m_LoadState == ResourceLoadState::Loaded) { return true; }
+		if (record.m_LoadState != ResourceLoadState::Failed) { return false; }
+
+		// The ID can't be reused while a request still refers to it
+		return std::none_of(m_LoadRequests.begin(), m_LoadRequests.end(), [&record](UPtr<LoadRequest> const& request) {
+			return request->m_Context.m_ID == record.m_ID;
+		});
+	}
+
+	void ResourceSystem::EvictResource(ResourceID resourceID) {
+		LoaderContext      loaderContext{};
+		ResourceLoader*    pLoader = nullptr;
+		Vector<ResourceID> dependencyIDs;
+		bool               installed = false;
+		{
+			std::lock_guard lock{m_Mutex};
+			ResourceRecord& record = m_pResourceDatabase[resourceID];
+			CKE_ASSERT(record.m_RefCount == 0 && CanBeEvicted(record));
+			installed = record.m_LoadState == ResourceLoadState::Loaded;
+
+			loaderContext.m_ID = record.m_ID;
+			loaderContext.m_AssetPath = record.m_Path;
+			loaderContext.m_pResource = record.m_pResource;
+			loaderContext.m_Dependencies = record.m_Dependencies;
+			pLoader = record.m_pLoader;
+			dependencyIDs = std::move(record.m_DependencyIDs);
+
+			// From now on a new load of the same path creates a new record
+			m_ResidentSizeInBytes -= record.m_CPUSizeInBytes + record.m_GPUSizeInBytes;
+			std::erase(m_UnreferencedResources, resourceID);
+			m_PathToResourceID.erase(record.m_Path);
+			m_pResourceDatabase.erase(resourceID);
+			m_AvailableResourceIDs.push(resourceID);
+		}
+
+		// The failed resources have already been unloaded, only their dependencies are released
+		if (installed) {
+			pLoader->Uninstall(loaderContext);
+			pLoader->Unload(loaderContext);
+
+			g_LoggingSystem.Log(LogLevel::Info, LogChannel::Assets, "Unloaded {}\n", loaderContext.m_AssetPath);
+		}
+
+		// The dependencies without other users become eviction candidates
+		std::lock_guard lock{m_Mutex};
+		for (ResourceID dependencyID : dependencyIDs) {
+			ReleaseReference(m_pResourceDatabase[dependencyID]);
+		}
+	}
+
+	void ResourceSystem::EvictOverBudget() {
+		while (true) {
+			ResourceID evictedID{};
+			{
+				std::lock_guard lock{m_Mutex};
+				if (m_ResidentSizeInBytes <= m_MemoryBudgetInBytes) { return; }
+
+				auto const candidateIt = std::find_if(m_UnreferencedResources.begin(), m_UnreferencedResources.end(),
+				                                      [this](ResourceID id) {
+					                                      ResourceRecord const& record = m_pResourceDatabase[id];
+					                                      return record.m_LoadState == ResourceLoadState::Loaded &&
+							                                      record.m_ReleaseFrame + EVICTION_FRAME_DELAY <=
+							                                      m_FrameIndex;
+				                                      });
+				if (candidateIt == m_UnreferencedResources.end()) { return; }
+				evictedID = *candidateIt;
+			}
+			EvictResource(evictedID);
+		}
+	}
+
+	void ResourceSystem::EvictUnreferencedResources() {
+		while (true) {
+			ResourceID evictedID{};
+			{
+				std::lock_guard lock{m_Mutex};
+				auto const candidateIt = std::find_if(m_UnreferencedResources.begin(), m_UnreferencedResources.end(),
+				                                      [this](ResourceID id) {
+					                                      return CanBeEvicted(m_pResourceDatabase[id]);
+				                                      });
+				if (candidateIt == m_UnreferencedResources.end()) { return; }
+				evictedID = *candidateIt;
+			}
+			EvictResource(evictedID);
+		}
+	}
+
+	ResourceMemoryStats ResourceSystem::GetMemoryStats() {
+		std::lock_guard     lock{m_Mutex};
+		ResourceMemoryStats stats{};
+		for (auto const& [id, record] : m_pResourceDatabase) {
+			if (record.m_LoadState == ResourceLoadState::Loaded) { AddToMemoryStats(stats, record); }
+		}
+		return stats;
+	}
+
+	Map<String, ResourceMemoryStats> ResourceSystem::GetMemoryStatsPerType() {
+		std::lock_guard                  lock{m_Mutex};
+		Map<String, ResourceMemoryStats> statsPerType{};
+		for (auto const& [id, record] : m_pResourceDatabase) {
+			if (record.m_LoadState != ResourceLoadState::Loaded) { continue; }
+			String const extension = record.m_Path.substr(record.m_Path.find_last_of('.') + 1);
+			AddToMemoryStats(statsPerType[extension], record);
+		}
+		return statsPerType;
 	}
 
 	IResource* ResourceSystem::GetResource(ResourceID resourceID) {
-		IResource* res = m_pResourceDatabase[resourceID].m_pResource;
-		CKE_ASSERT(res != nullptr);
+		std::lock_guard lock{m_Mutex};
+		auto const      recordIt = m_pResourceDatabase.find(resourceID);
+		CKE_ASSERT(recordIt != m_pResourceDatabase.end()); // The resource has been evicted, a reference must be kept
+		IResource* res = recordIt->second.m_pResource;
+		CKE_ASSERT(res != nullptr); // The resource isn't loaded, async loads must be checked with IsLoaded
 		return res;
 	}
 
@@ -0,0 +1,318 @@
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/FileSystem/FileSystem.h"
+#include "CookieKat/Core/Memory/Memory.h"
+#include "CookieKat/Systems/Resources/ResourceSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace CKE;
+
+namespace {
+	class TestResource : public IResource
+	{
+	public:
+		Path m_Name;
+	};
+
+	// Text resources, the first line is the name and the rest of lines are dependency paths
+	class TestResourceLoader : public ResourceLoader
+	{
+	public:
+		LoadResult Load(LoaderContext& ctx, Vector<u8>& binarySrc) const override {
+			std::istringstream stream{String{binarySrc.begin(), binarySrc.end()}};
+
+			auto pResource = New<TestResource>();
+			std::getline(stream, pResource->m_Name);
+			Path dependency;
+			while (std::getline(stream, dependency)) {
+				if (!dependency.empty()) { ctx.AddDependency(dependency); }
+			}
+
+			ctx.SetResource(pResource);
+			return LoadResult::Successful;
+		}
+
+		LoadResult Install(LoaderContext& ctx, InstallDependencies& dependencies) override {
+			m_InstallOrder.push_back(ctx.GetResource<TestResource>()->m_Name);
+			ctx.SetMemoryUsage(CPU_SIZE, GPU_SIZE);
+			return LoadResult::Successful;
+		}
+
+		LoadResult Unload(LoaderContext& ctx) const override {
+			TestResource* pResource = ctx.GetResource<TestResource>();
+			m_UnloadOrder.push_back(pResource->m_Name);
+			Delete(pResource);
+			return LoadResult::Successful;
+		}
+
+		Vector<ResourceTypeID> GetLoadableTypes() override { return {ResourceTypeID{"tres"}}; }
+
+		static constexpr u64 CPU_SIZE = 100;
+		static constexpr u64 GPU_SIZE = 1000;
+
+		Vector<Path>         m_InstallOrder;
+		mutable Vector<Path> m_UnloadOrder;
+	};
+
+	// Compiled resources, the data section only has the name
+	class TestCompiledResourceLoader : public CompiledResourcesLoader
+	{
+	public:
+		static constexpr u32 DATA_VERSION = 2;
+
+		LoadResult LoadCompiledResource(LoaderContext& ctx, BinaryInputArchive& ar) const override {
+			auto pResource = New<TestResource>();
+			ar << pResource->m_Name;
+			ctx.SetResource(pResource);
+			return LoadResult::Successful;
+		}
+
+		u32 GetDataVersion() const override { return DATA_VERSION; }
+
+		LoadResult Unload(LoaderContext& ctx) const override {
+			TestResource* pResource = ctx.GetResource<TestResource>();
+			Delete(pResource);
+			return LoadResult::Successful;
+		}
+
+		Vector<ResourceTypeID> GetLoadableTypes() override { return {ResourceTypeID{"tcres"}}; }
+	};
+
+	class ResourceSystemTest : public testing::Test
+	{
+	protected:
+		void SetUp() override {
+			WriteResource("ResourceSystem_A.tres", "A\nResourceSystem_B.tres\nResourceSystem_C.tres");
+			WriteResource("ResourceSystem_B.tres", "B");
+			WriteResource("ResourceSystem_C.tres", "C\nResourceSystem_B.tres");
+
+			m_ResourceSystem.SetBasePath("");
+			m_ResourceSystem.RegisterLoader(&m_Loader);
+			m_ResourceSystem.RegisterLoader(&m_CompiledLoader);
+		}
+
+		void TearDown() override {
+			m_ResourceSystem.Shutdown();
+			m_ResourceSystem.EvictUnreferencedResources();
+			m_ResourceSystem.UnRegisterLoader(&m_Loader);
+			m_ResourceSystem.UnRegisterLoader(&m_CompiledLoader);
+			for (Path const& path : m_Paths) { g_FileSystem.RemoveFile(path); }
+		}
+
+		void WriteResource(Path const& path, String const& contents) {
+			g_FileSystem.WriteTextFile(path, contents);
+			m_Paths.push_back(path);
+		}
+
+		void WriteCompiledResource(Path const& path, String name, Vector<Path> const& dependencies, u32 dataVersion) {
+			ResourceHeader header{};
+			header.m_ResourcePath = path;
+			header.m_DependencyPaths = dependencies;
+
+			BinaryOutputArchive data{};
+			data << name;
+			ASSERT_TRUE(CompiledResourceFormat::WriteToFile(path.c_str(), header, data, dataVersion));
+			m_Paths.push_back(path);
+		}
+
+		ResourceSystem             m_ResourceSystem;
+		TestResourceLoader         m_Loader;
+		TestCompiledResourceLoader m_CompiledLoader;
+		Vector<Path>               m_Paths;
+	};
+}
+
+TEST_F(ResourceSystemTest, LoadResource_InstallsDependenciesFirst) {
+	m_ResourceSystem.Initialize(nullptr);
+
+	ResourceID const idA = m_ResourceSystem.LoadResource("ResourceSystem_A.tres");
+	EXPECT_TRUE(m_ResourceSystem.IsLoaded(idA));
+	EXPECT_EQ(m_ResourceSystem.GetResource<TestResource>(idA)->m_Name, "A");
+
+	// B is shared by A and C, it must be loaded only once and before both of them
+	ASSERT_EQ(m_Loader.m_InstallOrder.size(), 3);
+	EXPECT_EQ(m_Loader.m_InstallOrder[0], "B");
+	EXPECT_EQ(m_Loader.m_InstallOrder[1], "C");
+	EXPECT_EQ(m_Loader.m_InstallOrder[2], "A");
+
+	m_ResourceSystem.UnloadResource(idA);
+}
+
+TEST_F(ResourceSystemTest, LoadResourceAsync_InstallsOnUpdate) {
+	m_ResourceSystem.Initialize(nullptr);
+
+	ResourceID const idC = m_ResourceSystem.LoadResourceAsync("ResourceSystem_C.tres");
+	EXPECT_FALSE(m_ResourceSystem.IsLoaded(idC));
+	EXPECT_TRUE(m_Loader.m_InstallOrder.empty());
+
+	// Requesting a resource that is already in flight returns the same ID
+	EXPECT_EQ(m_ResourceSystem.LoadResourceAsync("ResourceSystem_C.tres"), idC);
+
+	while (!m_ResourceSystem.IsLoaded(idC)) { m_ResourceSystem.Update(); }
+	ASSERT_EQ(m_Loader.m_InstallOrder.size(), 2);
+	EXPECT_EQ(m_Loader.m_InstallOrder[0], "B");
+	EXPECT_EQ(m_Loader.m_InstallOrder[1], "C");
+
+	// Each load adds a reference
+	m_ResourceSystem.UnloadResource(idC);
+	m_ResourceSystem.UnloadResource(idC);
+}
+
+TEST_F(ResourceSystemTest, WaitForAllResources_WithTaskSystem) {
+	TaskSystem taskSystem;
+	taskSystem.Initialize();
+	m_ResourceSystem.Initialize(&taskSystem);
+
+	ResourceID const idA = m_ResourceSystem.LoadResourceAsync("ResourceSystem_A.tres");
+	ResourceID const idB = m_ResourceSystem.LoadResourceAsync("ResourceSystem_B.tres");
+	m_ResourceSystem.WaitForAllResources();
+
+	EXPECT_TRUE(m_ResourceSystem.IsLoaded(idA));
+	EXPECT_TRUE(m_ResourceSystem.IsLoaded(idB));
+	EXPECT_EQ(m_Loader.m_InstallOrder.size(), 3);
+	EXPECT_EQ(m_Loader.m_InstallOrder.back(), "A");
+
+	m_ResourceSystem.UnloadResource(idA);
+	m_ResourceSystem.UnloadResource(idB);
+	m_ResourceSystem.Shutdown();
+	taskSystem.Shutdown();
+}
+
+TEST_F(ResourceSystemTest, UnloadResource_KeepsResourceCachedWithinBudget) {
+	m_ResourceSystem.Initialize(nullptr);
+
+	ResourceID const idA = m_ResourceSystem.LoadResource("ResourceSystem_A.tres");
+	m_ResourceSystem.UnloadResource(idA);
+	for (u32 i = 0; i < 10; ++i) { m_ResourceSystem.Update(); }
+	EXPECT_TRUE(m_Loader.m_UnloadOrder.empty());
+
+	// Loading it again reuses the cached resource
+	EXPECT_EQ(m_ResourceSystem.LoadResource("ResourceSystem_A.tres"), idA);
+	EXPECT_EQ(m_Loader.m_InstallOrder.size(), 3);
+	m_ResourceSystem.UnloadResource(idA);
+}
+
+TEST_F(ResourceSystemTest, Update_EvictsUnreferencedResourcesOverBudget) {
+	m_ResourceSystem.Initialize(nullptr);
+	m_ResourceSystem.SetMemoryBudget(0);
+
+	ResourceID const idB = m_ResourceSystem.LoadResource("ResourceSystem_B.tres");
+	ResourceID const idA = m_ResourceSystem.LoadResource("ResourceSystem_A.tres");
+	m_ResourceSystem.UnloadResource(idA);
+
+	// The resource is kept for a few frames in case the GPU is still using it
+	m_ResourceSystem.Update();
+	EXPECT_TRUE(m_Loader.m_UnloadOrder.empty());
+
+	for (u32 i = 0; i < 10; ++i) { m_ResourceSystem.Update(); }
+
+	// A releases C when evicted, B is still referenced by the first load
+	ASSERT_EQ(m_Loader.m_UnloadOrder.size(), 2);
+	EXPECT_EQ(m_Loader.m_UnloadOrder[0], "A");
+	EXPECT_EQ(m_Loader.m_UnloadOrder[1], "C");
+	EXPECT_EQ(m_ResourceSystem.GetLoadState(idA), ResourceLoadState::Unloaded);
+	EXPECT_TRUE(m_ResourceSystem.IsLoaded(idB));
+
+	m_ResourceSystem.UnloadResource(idB);
+	for (u32 i = 0; i < 10; ++i) { m_ResourceSystem.Update(); }
+	EXPECT_EQ(m_Loader.m_UnloadOrder.size(), 3);
+	EXPECT_EQ(m_ResourceSystem.GetMemoryStats().m_NumResources, 0);
+}
+
+TEST_F(ResourceSystemTest, EvictUnreferencedResources_UnloadsDependencies) {
+	m_ResourceSystem.Initialize(nullptr);
+
+	ResourceID const idA = m_ResourceSystem.LoadResource("ResourceSystem_A.tres");
+	m_ResourceSystem.UnloadResource(idA);
+	m_ResourceSystem.EvictUnreferencedResources();
+
+	ASSERT_EQ(m_Loader.m_UnloadOrder.size(), 3);
+	EXPECT_EQ(m_Loader.m_UnloadOrder[0], "A");
+	EXPECT_EQ(m_Loader.m_UnloadOrder[1], "C");
+	EXPECT_EQ(m_Loader.m_UnloadOrder[2], "B");
+
+	// The resource can be loaded again after being evicted
+	ResourceID const idC = m_ResourceSystem.LoadResource("ResourceSystem_C.tres");
+	EXPECT_EQ(m_ResourceSystem.GetResource<TestResource>(idC)->m_Name, "C");
+	m_ResourceSystem.UnloadResource(idC);
+}
+
+TEST_F(ResourceSystemTest, GetMemoryStats_CountsInstalledResources) {
+	m_ResourceSystem.Initialize(nullptr);
+
+	ResourceID const idC = m_ResourceSystem.LoadResource("ResourceSystem_C.tres");
+
+	ResourceMemoryStats const stats = m_ResourceSystem.GetMemoryStats();
+	EXPECT_EQ(stats.m_NumResources, 2);
+	EXPECT_EQ(stats.m_CPUSizeInBytes, 2 * TestResourceLoader::CPU_SIZE);
+	EXPECT_EQ(stats.m_GPUSizeInBytes, 2 * TestResourceLoader::GPU_SIZE);
+	EXPECT_EQ(stats.m_UnreferencedSizeInBytes, 0);
+
+	m_ResourceSystem.UnloadResource(idC);
+
+	Map<String, ResourceMemoryStats> statsPerType = m_ResourceSystem.GetMemoryStatsPerType();
+	ASSERT_EQ(statsPerType.size(), 1);
+	EXPECT_EQ(statsPerType["tres"].m_NumResources, 2);
+	EXPECT_EQ(statsPerType["tres"].m_UnreferencedSizeInBytes, TestResourceLoader::CPU_SIZE + TestResourceLoader::GPU_SIZE);
+}
+
+TEST_F(ResourceSystemTest, LoadResource_CompiledResource) {
+	m_ResourceSystem.Initialize(nullptr);
+	WriteCompiledResource("ResourceSystem_D.tcres", "D", {"ResourceSystem_C.tres"},
+	                      TestCompiledResourceLoader::DATA_VERSION);
+
+	ResourceID const idD = m_ResourceSystem.LoadResource("ResourceSystem_D.tcres");
+	EXPECT_EQ(m_ResourceSystem.GetResource<TestResource>(idD)->m_Name, "D");
+	ASSERT_EQ(m_Loader.m_InstallOrder.size(), 2);
+	EXPECT_EQ(m_Loader.m_InstallOrder[1], "C");
+
+	m_ResourceSystem.UnloadResource(idD);
+}
+
+TEST_F(ResourceSystemTest, LoadResource_FailsWithMismatchedVersion) {
+	TaskSystem taskSystem;
+	taskSystem.Initialize();
+	m_ResourceSystem.Initialize(&taskSystem);
+	WriteCompiledResource("ResourceSystem_Old.tcres", "Old", {"ResourceSystem_C.tres"},
+	                      TestCompiledResourceLoader::DATA_VERSION - 1);
+	WriteResource("ResourceSystem_E.tres", "E\nResourceSystem_Old.tcres\nResourceSystem_B.tres");
+
+	// The stale file is never installed, and neither is the resource that depends on it
+	ResourceID const idE = m_ResourceSystem.LoadResource("ResourceSystem_E.tres");
+	ResourceID const idOld = m_ResourceSystem.LoadResourceAsync("ResourceSystem_Old.tcres");
+	EXPECT_TRUE(m_ResourceSystem.HasFailed(idE));
+	EXPECT_TRUE(m_ResourceSystem.HasFailed(idOld));
+	EXPECT_FALSE(m_ResourceSystem.WaitForResource(idOld));
+	EXPECT_EQ(m_Loader.m_InstallOrder, (Vector<Path>{"B"}));
+	EXPECT_EQ(m_Loader.m_UnloadOrder, (Vector<Path>{"E"}));
+	EXPECT_EQ(m_ResourceSystem.GetMemoryStats().m_NumResources, 1);
+
+	// Failed resources are evicted as soon as they don't have references
+	m_ResourceSystem.UnloadResource(idE);
+	m_ResourceSystem.UnloadResource(idOld);
+	m_ResourceSystem.Update();
+	EXPECT_EQ(m_ResourceSystem.GetLoadState(idE), ResourceLoadState::Unloaded);
+	EXPECT_EQ(m_ResourceSystem.GetLoadState(idOld), ResourceLoadState::Unloaded);
+	EXPECT_EQ(m_ResourceSystem.GetMemoryStats().m_UnreferencedSizeInBytes,
+	          TestResourceLoader::CPU_SIZE + TestResourceLoader::GPU_SIZE);
+
+	m_ResourceSystem.Shutdown();
+	taskSystem.Shutdown();
+}
+
+TEST_F(ResourceSystemTest, ReadResourceDependencies_OnlyReadsTheHeader) {
+	// The data was written with an older version, it can't be loaded but its header can be read
+	WriteCompiledResource("ResourceSystem_Old.tcres", "Old", {"ResourceSystem_A.tres", "ResourceSystem_B.tres"},
+	                      TestCompiledResourceLoader::DATA_VERSION - 1);
+
+	Vector<Path> dependencies;
+	ASSERT_TRUE(m_ResourceSystem.ReadResourceDependencies("ResourceSystem_Old.tcres", dependencies));
+	EXPECT_EQ(dependencies, (Vector<Path>{"ResourceSystem_A.tres", "ResourceSystem_B.tres"}));
+
+	// The text resources can only find their dependencies by loading them
+	EXPECT_FALSE(m_ResourceSystem.ReadResourceDependencies("ResourceSystem_A.tres", dependencies));
+	EXPECT_FALSE(m_ResourceSystem.ReadResourceDependencies("ResourceSystem_Missing.tcres", dependencies));
+	EXPECT_TRUE(m_Loader.m_InstallOrder.empty());
+}
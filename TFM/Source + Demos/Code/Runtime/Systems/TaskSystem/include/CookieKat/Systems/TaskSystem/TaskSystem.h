@@ -3,6 +3,8 @@
 #include "CookieKat/Systems/EngineSystem/IEngineSystem.h"
 #include "TaskScheduler.h"
 
+#include <algorithm>
+
 namespace CKE
 {
 	using ITaskSet = enki::ITaskSet;
@@ -20,13 +22,31 @@ namespace CKE
 		void Initialize();
 		void Shutdown();
 
+		// Resets the frame arenas of the frame that is reused, no tasks can be running
+		// Tasks that span several frames must not use frame memory
+		void EndFrame();
+
 		// Tasks
 		//-----------------------------------------------------------------------------
 
 		inline void ScheduleTask(ITaskSet* taskSet) { m_TaskScheduler.AddTaskSetToPipe(taskSet); }
 		inline void WaitForTask(ITaskSet* taskSet) { m_TaskScheduler.WaitforTask(taskSet); }
 
+		// Returns the number of threads that execute tasks, including the main thread
+		inline u32 GetNumThreads() const { return m_TaskScheduler.GetNumTaskThreads(); }
+
+		// Returns the minimum range of a task set of the given size so it is split in a few
+		// partitions per thread, enough to balance the load without too much scheduling overhead
+		inline u32 GetMinRangeForEvenSplit(u32 setSize) const
+		{
+			constexpr u32 PARTITIONS_PER_THREAD = 4;
+			u32 numPartitions = GetNumThreads() * PARTITIONS_PER_THREAD;
+			return std::max(1u, setSize / numPartitions);
+		}
+
 	private:
+		// Temporary memory of each thread per frame, see g_FrameAllocator
+		static constexpr u64 FRAME_ARENA_SIZE = 4 * 1024 * 1024;
 
 		enki::TaskScheduler m_TaskScheduler;
 	};
@@ -2,6 +2,7 @@
 
 #include "CookieKat/Core/Profilling/Profilling.h"
 #include "CookieKat/Core/Containers/String.h"
+#include "CookieKat/Core/Memory/FrameAllocator.h"
 
 #include "TaskScheduler.h"
 #include "CookieKat/Core/Platform/PlatformTime.h"
@@ -16,10 +17,13 @@ namespace CKE
 	{
 		String name = std::format("Worker {}", threadNum);
 		OPTICK_START_THREAD(name.c_str());
+
+		FrameAllocator::RegisterThread(threadNum);
 	}
 
 	static void OnThreadStop(u32 threadNum)
 	{
+		FrameAllocator::UnregisterThread();
 		OPTICK_STOP_THREAD();
 	}
 
@@ -32,10 +36,22 @@ namespace CKE
 		config.profilerCallbacks.threadStop = OnThreadStop;
 
 		m_TaskScheduler.Initialize(config);
+
+		// The main thread is always the thread 0 of the scheduler
+		g_FrameAllocator.Initialize(GetNumThreads(), FRAME_ARENA_SIZE);
+		FrameAllocator::RegisterThread(0);
 	}
 
 	void TaskSystem::Shutdown()
 	{
 		m_TaskScheduler.WaitforAllAndShutdown();
+
+		FrameAllocator::UnregisterThread();
+		g_FrameAllocator.Shutdown();
+	}
+
+	void TaskSystem::EndFrame()
+	{
+		g_FrameAllocator.EndFrame();
 	}
 }
\ No newline at end of file
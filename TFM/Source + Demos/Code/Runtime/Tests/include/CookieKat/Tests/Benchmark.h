@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CookieKat/Core/Platform/PrimitiveTypes.h"
+
+#include <chrono>
+#include <iostream>
+
+// Helpers shared by the benchmarks of the module tests
+// They print their results with the same prefix so they stand out in the gtest output
+//-----------------------------------------------------------------------------
+
+namespace CKE::Tests
+{
+	// Runs the function once and returns the elapsed time in nanoseconds
+	template <typename Func>
+	u64 MeasureNs(Func&& func) {
+		auto start = std::chrono::high_resolution_clock::now();
+		func();
+		auto end = std::chrono::high_resolution_clock::now();
+		return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	// Prints the total time and the time per operation
+	inline void PrintBenchmarkResult(const char* benchName, u64 numOperations, u64 elapsedNs) {
+		std::cout << "[ BENCH    ] " << benchName << " - "
+				<< numOperations << " ops in " << elapsedNs / 1'000'000.0 << "ms ("
+				<< static_cast<f64>(elapsedNs) / numOperations << "ns/op)" << std::endl;
+	}
+
+	// Prints the total time and the throughput of processing the given amount of bytes
+	inline void PrintThroughputResult(const char* benchName, u64 sizeInBytes, u64 elapsedNs) {
+		std::cout << "[ BENCH    ] " << benchName << " - "
+				<< sizeInBytes / (1024.0 * 1024.0) << "MB in " << elapsedNs / 1'000'000.0 << "ms ("
+				<< static_cast<f64>(sizeInBytes) / elapsedNs << "GB/s)" << std::endl;
+	}
+}
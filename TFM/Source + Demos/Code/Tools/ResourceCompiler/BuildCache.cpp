@@ -0,0 +1,67 @@
+#include "BuildCache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace CKE {
+	void BuildCache::Load(String const& manifestPath) {
+		std::lock_guard lock{m_Mutex};
+		m_InputHashes.clear();
+
+		std::ifstream ifs(manifestPath);
+		if (!ifs.is_open()) { return; }
+
+		u64    inputHash = 0;
+		String assetPath;
+		while (ifs >> std::hex >> inputHash && std::getline(ifs >> std::ws, assetPath)) {
+			m_InputHashes[assetPath] = inputHash;
+		}
+	}
+
+	bool BuildCache::Save(String const& manifestPath) const {
+		std::lock_guard lock{m_Mutex};
+
+		// Sorted so the manifest doesn't change if the assets don't
+		Vector<Pair<String, u64>> entries(m_InputHashes.begin(), m_InputHashes.end());
+		std::sort(entries.begin(), entries.end());
+
+		std::ofstream ofs(manifestPath);
+		if (!ofs.is_open()) {
+			std::cout << "Failed to write the build cache [" << manifestPath << "]" << std::endl;
+			return false;
+		}
+		for (auto const& [assetPath, inputHash] : entries) {
+			ofs << std::hex << inputHash << " " << assetPath << "\n";
+		}
+		return ofs.good();
+	}
+
+	bool BuildCache::IsUpToDate(String const& assetPath, u64 inputHash) const {
+		std::lock_guard lock{m_Mutex};
+		auto const      it = m_InputHashes.find(assetPath);
+		return it != m_InputHashes.end() && it->second == inputHash;
+	}
+
+	void BuildCache::SetInputHash(String const& assetPath, u64 inputHash) {
+		std::lock_guard lock{m_Mutex};
+		m_InputHashes[assetPath] = inputHash;
+	}
+
+	void BuildCache::Invalidate(String const& assetPath) {
+		std::lock_guard lock{m_Mutex};
+		m_InputHashes.erase(assetPath);
+	}
+
+	u64 BuildCache::Hash(Span<u8 const> data, u64 hash) {
+		for (u8 byte : data) {
+			hash = hash ^ byte;
+			hash = hash * 1099511628211;
+		}
+		return hash;
+	}
+
+	u64 BuildCache::Hash(u64 value, u64 hash) {
+		return Hash(Span<u8 const>{reinterpret_cast<u8 const*>(&value), sizeof(u64)}, hash);
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CookieKat/Core/Containers/Containers.h"
+#include "CookieKat/Core/Containers/String.h"
+
+#include <mutex>
+
+namespace CKE {
+	// Hashes of the inputs of the compiled assets, persisted between runs of the compiler in a manifest
+	// Assets whose inputs have the same hash as the last time they were compiled are skipped
+	//
+	// The manifest is a text file with one "<input hash> <asset path>" line per asset
+	class BuildCache
+	{
+	public:
+		// Loads the manifest, a missing or invalid manifest results in an empty cache
+		void Load(String const& manifestPath);
+		bool Save(String const& manifestPath) const;
+
+		// Returns true if the asset was compiled with the same inputs
+		bool IsUpToDate(String const& assetPath, u64 inputHash) const;
+
+		// Records the inputs of an asset after compiling it, can be called from multiple threads
+		void SetInputHash(String const& assetPath, u64 inputHash);
+
+		// Forgets an asset so it is compiled again, e.g. after it failed to compile
+		void Invalidate(String const& assetPath);
+
+		// FNV-1a hash, the hash of the previous data can be passed to hash multiple inputs together
+		static u64 Hash(Span<u8 const> data, u64 hash = FNV_OFFSET_BASIS);
+		static u64 Hash(u64 value, u64 hash = FNV_OFFSET_BASIS);
+
+		static constexpr u64 FNV_OFFSET_BASIS = 14695981039346656037u;
+
+	private:
+		mutable std::mutex m_Mutex;
+		Map<String, u64>   m_InputHashes;
+	};
+}
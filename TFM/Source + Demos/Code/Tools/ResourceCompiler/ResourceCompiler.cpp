@@ -1,29 +1,215 @@
 #include "ResourceCompiler.h"
+#include "BuildCache.h"
 
 #include "CookieKat/Core/Containers/String.h"
 #include "CookieKat/Core/FileSystem/FileSystem.h"
+#include "CookieKat/Core/FileSystem/PackArchive.h"
+#include "CookieKat/Core/Compression/Compression.h"
 #include "CookieKat/Core/Serialization/BinarySerialization.h"
 #include "CookieKat/Core/Serialization/Archive.h"
 
 #include "CookieKat/Systems/Resources/ResourceID.h"
+#include "CookieKat/Systems/Resources/CompiledResourceFormat.h"
+#include "CookieKat/Systems/TaskSystem/TaskSystem.h"
 #include "CookieKat/Engine/Resources/Resources/PipelineResource.h"
 #include "CookieKat/Engine/Resources/Loaders/PipelineLoader.h"
+#include "CookieKat/Engine/Resources/Loaders/MaterialLoader.h"
+#include "CookieKat/Engine/Resources/Loaders/TextureLoader.h"
 #include "CookieKat/Engine/Resources/Resources/RenderMaterialResource.h"
+#include "CookieKat/Engine/Resources/Resources/MeshResource.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
 
 #include <rapidjson/document.h>
 #include <stb_image.h>
-#include <lodepng.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
 
 //-----------------------------------------------------------------------------
 
 namespace CKE {
+	namespace {
+		inline f32 SRGBToLinear(u8 value) {
+			f32 const c = value / 255.0f;
+			return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+		}
+
+		inline u8 LinearToSRGB(f32 value) {
+			f32 const c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+			return static_cast<u8>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+		}
+
+		// Returns the number of mips of a full mip chain down to 1x1
+		inline u32 GetNumMips(u32 width, u32 height) {
+			return std::bit_width(std::max(width, height));
+		}
+
+		// Returns the RGBA8 image followed by all of its mips, each one downsampled from the previous one
+		// with a box filter. The color of SRGB images is averaged in linear space so the mips keep their brightness
+		Vector<u8> GenerateMipChain(u8 const* pImage, u32 width, u32 height, u32 numMips, bool isSRGB) {
+			Array<f32, 256> srgbToLinear{};
+			for (u32 i = 0; i < 256; ++i) { srgbToLinear[i] = SRGBToLinear(static_cast<u8>(i)); }
+
+			Vector<u8> mipChain(static_cast<u64>(width) * height * 4);
+			memcpy(mipChain.data(), pImage, mipChain.size());
+
+			u64 srcOffset = 0;
+			u32 srcWidth = width;
+			u32 srcHeight = height;
+			for (u32 mip = 1; mip < numMips; ++mip) {
+				u32 const dstWidth = std::max(srcWidth / 2, 1u);
+				u32 const dstHeight = std::max(srcHeight / 2, 1u);
+				u64 const dstOffset = mipChain.size();
+				mipChain.resize(dstOffset + static_cast<u64>(dstWidth) * dstHeight * 4);
+
+				u8 const* pSrc = mipChain.data() + srcOffset;
+				u8*       pDst = mipChain.data() + dstOffset;
+				for (u32 y = 0; y < dstHeight; ++y) {
+					u32 const y0 = std::min(y * 2, srcHeight - 1);
+					u32 const y1 = std::min(y * 2 + 1, srcHeight - 1);
+					for (u32 x = 0; x < dstWidth; ++x) {
+						u32 const x0 = std::min(x * 2, srcWidth - 1);
+						u32 const x1 = std::min(x * 2 + 1, srcWidth - 1);
+						u8 const* pTexels[4] = {
+							pSrc + (static_cast<u64>(y0) * srcWidth + x0) * 4,
+							pSrc + (static_cast<u64>(y0) * srcWidth + x1) * 4,
+							pSrc + (static_cast<u64>(y1) * srcWidth + x0) * 4,
+							pSrc + (static_cast<u64>(y1) * srcWidth + x1) * 4,
+						};
+
+						u8* pTexel = pDst + (static_cast<u64>(y) * dstWidth + x) * 4;
+						for (u32 c = 0; c < 4; ++c) {
+							// Alpha is always linear
+							if (isSRGB && c < 3) {
+								f32 sum = 0.0f;
+								for (u8 const* pSrcTexel : pTexels) { sum += srgbToLinear[pSrcTexel[c]]; }
+								pTexel[c] = LinearToSRGB(sum * 0.25f);
+							}
+							else {
+								u32 sum = 0;
+								for (u8 const* pSrcTexel : pTexels) { sum += pSrcTexel[c]; }
+								pTexel[c] = static_cast<u8>((sum + 2) / 4);
+							}
+						}
+					}
+				}
+
+				srcOffset = dstOffset;
+				srcWidth = dstWidth;
+				srcHeight = dstHeight;
+			}
+
+			return mipChain;
+		}
+
+		// Batch Compilation
+		//-----------------------------------------------------------------------------
+
+		// How to compile each type of asset definition
+		struct AssetTypeInfo
+		{
+			char const*         m_AssetType;
+			char const*         m_Extension;         // Of the compiled resource
+			u32                 m_DataVersion;       // Of the compiled resource, part of the input hash
+			Vector<char const*> m_InputMembers;      // Members of the definition with the paths of the source files
+			Vector<char const*> m_DependencyMembers; // Members of the definition with the paths of other resources
+		};
+
+		AssetTypeInfo const s_AssetTypes[] = {
+			{"Texture", ".tex", TextureLoader::DATA_VERSION, {"TexturePath"}, {}},
+			{
+				"CubeMap", ".cubeMap", CubeMapLoader::DATA_VERSION,
+				{
+					"N_Positive_Path", "N_Negative_Path", "Y_Positive_Path",
+					"Y_Negative_Path", "Z_Positive_Path", "Z_Negative_Path"
+				},
+				{}
+			},
+			{
+				"Material", ".mat", MaterialLoader::DATA_VERSION, {},
+				{"AlbedoTextureID", "RoughnessTextureID", "MetalicTextureID", "NormalTextureID"}
+			},
+			{"Pipeline", ".pipeline", PipelineLoader::DATA_VERSION, {"VertexShader", "FragmentShader"}, {}},
+			{"Mesh", ".mesh", MeshFileHeader::VERSION, {"MeshPath"}, {}},
+		};
+
+		// Asset definition found in the data directory
+		struct AssetBuildInfo
+		{
+			String         m_BaseName;           // Path of the definition without the extension
+			String         m_AssetType;
+			String         m_ResourcePath;       // Relative to the data directory, as other resources reference it
+			u64            m_InputHash = 0;      // Definition, source files and versions of the compilers
+			Vector<String> m_DependencyPaths;    // Resources referenced by the asset
+			u32            m_Level = 0;          // Assets are compiled after all of the assets of lower levels
+			bool           m_NeedsCompile = false;
+		};
+
+		// Reads the type, the inputs and the dependencies of an asset from its definition
+		bool ReadAssetBuildInfo(std::filesystem::path const& definitionPath, std::filesystem::path const& dataDirectory,
+		                        AssetBuildInfo& asset) {
+			Blob const          definition = g_FileSystem.ReadBinaryFile(definitionPath.string());
+			rapidjson::Document doc;
+			doc.Parse(reinterpret_cast<char const*>(definition.data()), definition.size());
+			if (doc.HasParseError() || !doc.IsObject() || !doc.HasMember("AssetType") || !doc["AssetType"].IsString()) {
+				std::cout << "Invalid asset definition [" << definitionPath.string() << "]" << std::endl;
+				return false;
+			}
+
+			asset.m_AssetType = doc["AssetType"].GetString();
+			auto const typeIt = std::find_if(std::begin(s_AssetTypes), std::end(s_AssetTypes),
+			                                 [&asset](AssetTypeInfo const& type) {
+				                                 return asset.m_AssetType == type.m_AssetType;
+			                                 });
+			if (typeIt == std::end(s_AssetTypes)) {
+				std::cout << "Asset type [" << asset.m_AssetType << "] of [" << definitionPath.string()
+						<< "] not supported" << std::endl;
+				return false;
+			}
+
+			std::filesystem::path basePath = definitionPath;
+			basePath.replace_extension();
+			asset.m_BaseName = basePath.string();
+			asset.m_ResourcePath = std::filesystem::relative(basePath, dataDirectory).generic_string() +
+					typeIt->m_Extension;
+
+			// The source files are hashed with their paths, so moving or deleting one changes the hash too
+			u64 hash = BuildCache::Hash(ResourceCompiler::VERSION);
+			hash = BuildCache::Hash(typeIt->m_DataVersion, hash);
+			hash = BuildCache::Hash(definition, hash);
+			for (char const* pMember : typeIt->m_InputMembers) {
+				if (!doc.HasMember(pMember) || !doc[pMember].IsString()) { continue; }
+				String const inputPath = doc[pMember].GetString();
+				hash = BuildCache::Hash(Span<u8 const>{reinterpret_cast<u8 const*>(inputPath.data()), inputPath.size()}, hash);
+				if (std::filesystem::exists(inputPath)) { hash = BuildCache::Hash(g_FileSystem.ReadBinaryFile(inputPath), hash); }
+			}
+			asset.m_InputHash = hash;
+
+			for (char const* pMember : typeIt->m_DependencyMembers) {
+				if (doc.HasMember(pMember) && doc[pMember].IsString()) {
+					asset.m_DependencyPaths.emplace_back(doc[pMember].GetString());
+				}
+			}
+			return true;
+		}
+	}
+
+	//-----------------------------------------------------------------------------
+
 	void ResourceCompiler::Initialize(const char* inputBasePath, const char* outputBasePath) {
 		m_CompilerData.m_InputBasePath = inputBasePath;
 		m_CompilerData.m_OutputBasePath = outputBasePath;
 		m_MaterialCompiler.Initialize();
 	}
 
-	void ResourceCompiler::CompileMaterial(String const& fileBaseName) {
+	bool ResourceCompiler::CompileMaterial(String const& fileBaseName) {
 		String pInputPath = String(fileBaseName).append(".ckadef");
 		String pResourcePath = String(fileBaseName).append(".mat");
 
@@ -40,7 +226,7 @@ namespace CKE {
 
 		if (doc["AssetType"].GetString() != String("Material")) {
 			std::cout << "Input file is not a material definition" << std::endl;
-			return;
+			return false;
 		}
 
 		String albedoID = doc["AlbedoTextureID"].GetString();
@@ -61,8 +247,6 @@ namespace CKE {
 		header.m_DependencyPaths.push_back(metalicID);
 		header.m_DependencyPaths.push_back(normalID);
 
-		ar << header;
-
 		RenderMaterialResource material{};
 		material.m_AlbedoTexture = TResourceID<RenderTextureResource>{0};
 		material.m_RoughnessTexture = TResourceID<RenderTextureResource>{1};
@@ -71,10 +255,10 @@ namespace CKE {
 
 		ar << material;
 
-		ar.WriteToFile(pResourcePath.c_str());
+		return CompiledResourceFormat::WriteToFile(pResourcePath.c_str(), header, ar, MaterialLoader::DATA_VERSION);
 	}
 
-	void ResourceCompiler::CompilePipeline(String const& fileBaseName) {
+	bool ResourceCompiler::CompilePipeline(String const& fileBaseName) {
 		String pInputPath = String(fileBaseName).append(".ckadef");
 		String pOutputPath = String(fileBaseName).append(".pipeline");
 
@@ -91,7 +275,7 @@ namespace CKE {
 
 		if (doc["AssetType"].GetString() != String("Pipeline")) {
 			std::cout << "Input file is not a material definition" << std::endl;
-			return;
+			return false;
 		}
 
 		//String pipelineType = doc["PipelineType"].GetString();
@@ -109,19 +293,26 @@ namespace CKE {
 
 		bool enableDebugInfo = false;
 
-		String compileCmdVert = "glslangValidator.exe -V " + vertPath +
-				" -o tempShader.vert";
+		// The temporary files are named after the output, so pipelines can be compiled in parallel
+		String const tempVertPath = pOutputPath + ".vert.tmp";
+		String const tempFragPath = pOutputPath + ".frag.tmp";
+		String       compileCmdVert = "glslangValidator.exe -V " + vertPath +
+				" -o " + tempVertPath;
 		String compileCmdFrag = "glslangValidator.exe -V " + fragPath +
-				" -o tempShader.frag";
-		system(compileCmdVert.c_str());
-		system(compileCmdFrag.c_str());
+				" -o " + tempFragPath;
+		bool const compiled = system(compileCmdVert.c_str()) == 0 && system(compileCmdFrag.c_str()) == 0;
 
-		Blob   vertBlob = g_FileSystem.ReadBinaryFile("tempShader.vert");
-		Blob   fragBlob = g_FileSystem.ReadBinaryFile("tempShader.frag");
+		Blob   vertBlob = compiled ? g_FileSystem.ReadBinaryFile(tempVertPath) : Blob{};
+		Blob   fragBlob = compiled ? g_FileSystem.ReadBinaryFile(tempFragPath) : Blob{};
 		String vertShaderSource = String(vertBlob.begin(), vertBlob.end());
 		String fragShaderSource = String(fragBlob.begin(), fragBlob.end());
-		g_FileSystem.RemoveFile("tempShader.vert");
-		g_FileSystem.RemoveFile("tempShader.frag");
+		g_FileSystem.RemoveFile(tempVertPath);
+		g_FileSystem.RemoveFile(tempFragPath);
+
+		if (!compiled) {
+			std::cout << "Failed to compile the shaders of [" << pInputPath << "]" << std::endl;
+			return false;
+		}
 
 		// Compile
 		//-----------------------------------------------------------------------------
@@ -136,11 +327,11 @@ namespace CKE {
 		pipelineResource.m_VertShaderSource = vertBlob;
 		pipelineResource.m_FragShaderSource = fragBlob;
 
-		archive << header << pipelineResource;
-		archive.WriteToFile(pOutputPath.c_str());
+		archive << pipelineResource;
+		return CompiledResourceFormat::WriteToFile(pOutputPath.c_str(), header, archive, PipelineLoader::DATA_VERSION);
 	}
 
-	void ResourceCompiler::CompileTexture(String const& fileBaseName) {
+	bool ResourceCompiler::CompileTexture(String const& fileBaseName) {
 		String pInputPath = String(fileBaseName).append(".ckadef");
 		String pResourcePath = String(fileBaseName).append(".tex");
 
@@ -157,7 +348,7 @@ namespace CKE {
 
 		if (doc["AssetType"].GetString() != String("Texture")) {
 			std::cout << "Input file is not a material definition" << std::endl;
-			return;
+			return false;
 		}
 
 		String path = doc["TexturePath"].GetString();
@@ -172,8 +363,6 @@ namespace CKE {
 		header.m_ResourceType = 3; // TODO: Replace with Type System
 		header.m_ResourcePath = pResourcePath;
 
-		ar << header;
-
 		RenderTextureResource tex{};
 
 		// Load image binary data
@@ -184,28 +373,35 @@ namespace CKE {
 		i32   height = 0;
 		void* pRawTextureBytes = stbi_load_from_memory(imageBlob.data(), imageByteSize,
 		                                               &width, &height, &numChannels, 4);
-		tex.m_Data.resize(width * height * 4);
-		memcpy(tex.m_Data.data(), pRawTextureBytes, width * height * 4);
-
-		Vector<u8> compressedTexture{};
-		compressedTexture.reserve(width * height * 4);
-		if (lodepng::encode(compressedTexture, tex.m_Data, width, height));
-		tex.m_Data = compressedTexture;
-
-		stbi_image_free(pRawTextureBytes);
+		if (pRawTextureBytes == nullptr) {
+			std::cout << "Failed to load the image [" << path << "]" << std::endl;
+			return false;
+		}
 
 		if (format == "SRGB") { tex.m_Desc.m_Format = TextureFormat::R8G8B8A8_SRGB; }
 		else if (format == "UNORM") { tex.m_Desc.m_Format = TextureFormat::R8G8B8A8_UNORM; }
 
 		tex.m_Desc.m_Size.x = width;
 		tex.m_Desc.m_Size.y = height;
+		tex.m_Desc.m_MipLevels = GetNumMips(width, height);
+
+		// Store the pixels in the layout that gets copied to the GPU, only compressed with
+		// a codec that can be decompressed at memory speed
+		Vector<u8> mipChain = GenerateMipChain(static_cast<u8 const*>(pRawTextureBytes), width, height,
+		                                       tex.m_Desc.m_MipLevels,
+		                                       tex.m_Desc.m_Format == TextureFormat::R8G8B8A8_SRGB);
+		tex.m_Data = Compression::Compress(mipChain);
 
+		stbi_image_free(pRawTextureBytes);
+
+		// The compressed mips are most of the file
+		ar.Reserve(sizeof(u64) + tex.m_Data.size() + sizeof(TextureDesc));
 		ar << tex;
 
-		ar.WriteToFile(pResourcePath.c_str());
+		return CompiledResourceFormat::WriteToFile(pResourcePath.c_str(), header, ar, TextureLoader::DATA_VERSION);
 	}
 
-	void ResourceCompiler::CompileCubeMap(String const& fileBaseName) {
+	bool ResourceCompiler::CompileCubeMap(String const& fileBaseName) {
 		String pInputPath = String(fileBaseName).append(".ckadef");
 		String pResourcePath = String(fileBaseName).append(".cubeMap");
 
@@ -222,7 +418,7 @@ namespace CKE {
 
 		if (doc["AssetType"].GetString() != String("CubeMap")) {
 			std::cout << "Input file is not a material definition" << std::endl;
-			return;
+			return false;
 		}
 
 		Array<String, 6> cubeMapPaths;
@@ -239,30 +435,25 @@ namespace CKE {
 
 		BinaryOutputArchive ar{};
 
-		// Write Asset Header
+		// Asset Header
 		ResourceHeader header{};
 		header.m_ResourceType = 3; // TODO: Replace with Type System
 		header.m_ResourcePath = pResourcePath;
-		ar << header;
 
 		// Load All of the 6 faces and save them to the converted file
-		i32   numChannels = 0, width = 0, height = 0;
-		Vector<u8> uncompressedTexture{};
+		i32 numChannels = 0, width = 0, height = 0;
 
 		RenderCubeMapResource tex{};
 		for (i32 i = 0; i < 6; ++i) {
 			String const& path = cubeMapPaths[i];
-			Vector<u8>& faceData = tex.m_Faces[i];
-			
+
 			Blob  imageBlob = g_FileSystem.ReadBinaryFile(path);
 			void* pRawTextureBytes = stbi_load_from_memory(imageBlob.data(), imageBlob.size(),
 			                                               &width, &height, &numChannels, 4);
-			uncompressedTexture.resize(width * height * 4);
 
-			memcpy(uncompressedTexture.data(), pRawTextureBytes, width * height * 4);
-
-			faceData.reserve(width * height * 4);
-			lodepng::encode(faceData, uncompressedTexture, width, height);
+			tex.m_Faces[i] = Compression::Compress(Span<u8 const>{
+				static_cast<u8 const*>(pRawTextureBytes), static_cast<u64>(width) * height * 4
+			});
 
 			stbi_image_free(pRawTextureBytes);
 		}
@@ -272,6 +463,247 @@ namespace CKE {
 
 		ar << tex;
 
-		ar.WriteToFile(pResourcePath.c_str());
+		return CompiledResourceFormat::WriteToFile(pResourcePath.c_str(), header, ar, CubeMapLoader::DATA_VERSION);
+	}
+
+	bool ResourceCompiler::CompileMesh(String const& fileBaseName) {
+		String pInputPath = String(fileBaseName).append(".ckadef");
+		String pResourcePath = String(fileBaseName).append(".mesh");
+
+		// Open Json Asset Definition
+		//-----------------------------------------------------------------------------
+
+		Blob                assetDefBlob = g_FileSystem.ReadBinaryFile(pInputPath);
+		rapidjson::Document doc;
+		String const        assetDefJson = String(assetDefBlob.begin(), assetDefBlob.end());
+		doc.Parse(assetDefJson.c_str());
+
+		// Parse Asset Definition
+		//-----------------------------------------------------------------------------
+
+		if (doc["AssetType"].GetString() != String("Mesh")) {
+			std::cout << "Input file is not a mesh definition" << std::endl;
+			return false;
+		}
+
+		String path = doc["MeshPath"].GetString();
+
+		// Import source mesh
+		//-----------------------------------------------------------------------------
+
+		Assimp::Importer importer;
+		aiScene const*   aiScene = importer.ReadFile(path.c_str(),
+		                                             aiProcess_CalcTangentSpace |
+		                                             aiProcess_Triangulate |
+		                                             aiProcess_JoinIdenticalVertices |
+		                                             aiProcess_SortByPType);
+		if (aiScene == nullptr || aiScene->mNumMeshes == 0) {
+			std::cout << "Failed to import the mesh [" << path << "]" << std::endl;
+			return false;
+		}
+
+		// All of the meshes share the same vertex and index streams, each one is a submesh
+		Vector<Vertex_3P3N3T2Tc> vertices;
+		Vector<u32>              indices;
+		Vector<SubMesh>          subMeshes;
+		AABB                     bounds{};
+
+		for (u32 m = 0; m < aiScene->mNumMeshes; ++m) {
+			auto const aiMesh = aiScene->mMeshes[m];
+			if (!(aiMesh->mPrimitiveTypes & aiPrimitiveType_TRIANGLE)) { continue; }
+
+			u32 const baseVertex = static_cast<u32>(vertices.size());
+			for (u64 i = 0; i < aiMesh->mNumVertices; ++i) {
+				aiVector3D const& pos = aiMesh->mVertices[i];
+				aiVector3D const& normal = aiMesh->mNormals[i];
+				aiVector3D const  tangent = aiMesh->HasTangentsAndBitangents() ? aiMesh->mTangents[i] : aiVector3D{};
+				aiVector3D const  texCoord = aiMesh->HasTextureCoords(0) ? aiMesh->mTextureCoords[0][i] : aiVector3D{};
+
+				vertices.emplace_back(Vec3(pos.x, pos.y, pos.z),
+				                      Vec3(normal.x, normal.y, normal.z),
+				                      Vec3(tangent.x, tangent.y, tangent.z),
+				                      Vec2(texCoord.x, texCoord.y));
+				bounds.AddPoint(Vec3(pos.x, pos.y, pos.z));
+			}
+
+			SubMesh subMesh{static_cast<u32>(indices.size()), 0};
+			for (u64 i = 0; i < aiMesh->mNumFaces; ++i) {
+				for (u64 j = 0; j < aiMesh->mFaces[i].mNumIndices; ++j) {
+					indices.push_back(baseVertex + aiMesh->mFaces[i].mIndices[j]);
+				}
+			}
+			subMesh.m_NumIndices = static_cast<u32>(indices.size()) - subMesh.m_FirstIndex;
+			subMeshes.push_back(subMesh);
+		}
+
+		// Write to file
+		//-----------------------------------------------------------------------------
+
+		auto AlignOffset = [](u64 offset) {
+			u64 const alignment = MeshFileHeader::STREAM_ALIGNMENT;
+			return (offset + alignment - 1) / alignment * alignment;
+		};
+
+		MeshFileHeader header{};
+		header.m_NumVertices = static_cast<u32>(vertices.size());
+		header.m_NumIndices = static_cast<u32>(indices.size());
+		header.m_NumSubMeshes = static_cast<u32>(subMeshes.size());
+		header.m_SubMeshesOffset = sizeof(MeshFileHeader);
+		header.m_VertexDataOffset = AlignOffset(header.m_SubMeshesOffset + subMeshes.size() * sizeof(SubMesh));
+		header.m_IndexDataOffset = AlignOffset(header.m_VertexDataOffset + vertices.size() * sizeof(Vertex_3P3N3T2Tc));
+		header.m_BoundsMin = bounds.m_Min;
+		header.m_BoundsMax = bounds.m_Max;
+
+		Blob fileData(header.m_IndexDataOffset + indices.size() * sizeof(u32), 0);
+		memcpy(fileData.data(), &header, sizeof(MeshFileHeader));
+		memcpy(fileData.data() + header.m_SubMeshesOffset, subMeshes.data(), subMeshes.size() * sizeof(SubMesh));
+		memcpy(fileData.data() + header.m_VertexDataOffset, vertices.data(),
+		       vertices.size() * sizeof(Vertex_3P3N3T2Tc));
+		memcpy(fileData.data() + header.m_IndexDataOffset, indices.data(), indices.size() * sizeof(u32));
+
+		g_FileSystem.WriteBinaryFile(pResourcePath, fileData.data(), fileData.size());
+		return true;
+	}
+
+	void ResourceCompiler::PackResources(String const& dataDirectory, String const& archivePath, bool compress) {
+		// Only the compiled resources are packed, the source assets stay out of the archive
+		static String const s_PackedExtensions[] = {".tex", ".cubeMap", ".mat", ".pipeline", ".mesh"};
+
+		PackArchiveBuilder builder;
+		u64                totalSizeInBytes = 0;
+		for (auto const& dirEntry : std::filesystem::recursive_directory_iterator(dataDirectory)) {
+			if (!dirEntry.is_regular_file()) { continue; }
+
+			String const extension = dirEntry.path().extension().string();
+			if (std::find(std::begin(s_PackedExtensions), std::end(s_PackedExtensions), extension) ==
+				std::end(s_PackedExtensions)) { continue; }
+
+			String const filePath = dirEntry.path().string();
+			String const relativePath = std::filesystem::relative(dirEntry.path(), dataDirectory).generic_string();
+			Blob const   file = g_FileSystem.ReadBinaryFile(filePath);
+			totalSizeInBytes += file.size();
+			builder.AddFile(relativePath, file, compress);
+		}
+
+		if (builder.WriteToFile(archivePath)) {
+			std::cout << "Packed " << builder.GetNumFiles() << " files (" << totalSizeInBytes << " bytes) into "
+					<< archivePath << "\n";
+		}
+	}
+
+	bool ResourceCompiler::CompileDirectory(String const& dataDirectory, bool forceRebuild) {
+		std::filesystem::path const dataPath{dataDirectory};
+		String const                manifestPath = (dataPath / BUILD_CACHE_FILE_NAME).string();
+
+		BuildCache cache;
+		if (!forceRebuild) { cache.Load(manifestPath); }
+
+		// Find the assets and their inputs
+		//-----------------------------------------------------------------------------
+
+		Vector<AssetBuildInfo> assets;
+		bool                   succeeded = true;
+		for (auto const& dirEntry : std::filesystem::recursive_directory_iterator(dataPath)) {
+			if (!dirEntry.is_regular_file() || dirEntry.path().extension() != ".ckadef") { continue; }
+
+			AssetBuildInfo asset{};
+			if (ReadAssetBuildInfo(dirEntry.path(), dataPath, asset)) { assets.emplace_back(std::move(asset)); }
+			else { succeeded = false; }
+		}
+
+		// Each asset is compiled after the assets it references, e.g. materials after their textures
+		// References are only paths, so an asset doesn't have to be compiled again when its dependencies change
+		//-----------------------------------------------------------------------------
+
+		Map<String, u64> resourcePathToAsset;
+		for (u64 i = 0; i < assets.size(); ++i) { resourcePathToAsset[assets[i].m_ResourcePath] = i; }
+
+		bool levelsChanged = true;
+		for (u64 iteration = 0; levelsChanged && iteration < assets.size(); ++iteration) {
+			levelsChanged = false;
+			for (AssetBuildInfo& asset : assets) {
+				for (String const& dependencyPath : asset.m_DependencyPaths) {
+					auto const it = resourcePathToAsset.find(dependencyPath);
+					if (it != resourcePathToAsset.end() && assets[it->second].m_Level >= asset.m_Level) {
+						asset.m_Level = assets[it->second].m_Level + 1;
+						levelsChanged = true;
+					}
+				}
+			}
+		}
+
+		u32 numLevels = 0;
+		u32 numToCompile = 0;
+		for (AssetBuildInfo& asset : assets) {
+			bool const outputExists = std::filesystem::exists(dataPath / asset.m_ResourcePath);
+			asset.m_NeedsCompile = !outputExists || !cache.IsUpToDate(asset.m_ResourcePath, asset.m_InputHash);
+			if (asset.m_NeedsCompile) { numToCompile++; }
+			numLevels = std::max(numLevels, asset.m_Level + 1);
+		}
+
+		std::cout << "Compiling " << numToCompile << " of " << assets.size() << " assets, "
+				<< assets.size() - numToCompile << " are up to date\n";
+
+		// Compile the assets of each level in parallel
+		//-----------------------------------------------------------------------------
+
+		struct CompileTaskSet : public ITaskSet
+		{
+			ResourceCompiler*             m_pCompiler = nullptr;
+			BuildCache*                   m_pCache = nullptr;
+			Vector<AssetBuildInfo const*> m_Assets;
+			std::atomic<u32>              m_NumFailed{0};
+
+			void ExecuteRange(enki::TaskSetPartition range, uint32_t threadNum) override {
+				for (u32 i = range.start; i < range.end; ++i) {
+					AssetBuildInfo const& asset = *m_Assets[i];
+					if (m_pCompiler->CompileAsset(asset.m_AssetType, asset.m_BaseName)) {
+						m_pCache->SetInputHash(asset.m_ResourcePath, asset.m_InputHash);
+						std::cout << "Compiled [" << asset.m_ResourcePath << "]\n";
+					}
+					else {
+						m_pCache->Invalidate(asset.m_ResourcePath);
+						m_NumFailed++;
+					}
+				}
+			}
+		};
+
+		TaskSystem taskSystem;
+		taskSystem.Initialize();
+
+		for (u32 level = 0; level < numLevels; ++level) {
+			CompileTaskSet taskSet{};
+			taskSet.m_pCompiler = this;
+			taskSet.m_pCache = &cache;
+			for (AssetBuildInfo const& asset : assets) {
+				if (asset.m_NeedsCompile && asset.m_Level == level) { taskSet.m_Assets.push_back(&asset); }
+			}
+			if (taskSet.m_Assets.empty()) { continue; }
+
+			// Assets take long to compile, each one is a partition so they are balanced between the threads
+			taskSet.m_SetSize = static_cast<u32>(taskSet.m_Assets.size());
+			taskSet.m_MinRange = 1;
+			taskSystem.ScheduleTask(&taskSet);
+			taskSystem.WaitForTask(&taskSet);
+
+			if (taskSet.m_NumFailed > 0) { succeeded = false; }
+		}
+
+		taskSystem.Shutdown();
+
+		cache.Save(manifestPath);
+		return succeeded;
+	}
+
+	bool ResourceCompiler::CompileAsset(String const& assetType, String const& fileBaseName) {
+		if (assetType == "Texture") { return CompileTexture(fileBaseName); }
+		if (assetType == "CubeMap") { return CompileCubeMap(fileBaseName); }
+		if (assetType == "Material") { return CompileMaterial(fileBaseName); }
+		if (assetType == "Pipeline") { return CompilePipeline(fileBaseName); }
+		if (assetType == "Mesh") { return CompileMesh(fileBaseName); }
+
+		std::cout << "Asset type [" << assetType << "] not supported" << std::endl;
+		return false;
 	}
 };
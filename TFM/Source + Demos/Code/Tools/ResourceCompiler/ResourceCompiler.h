@@ -17,12 +17,39 @@ namespace CKE {
 	class ResourceCompiler
 	{
 	public:
+		// Version of the compilers, increase it when the output of any of them changes
+		// so all of the assets are compiled again by CompileDirectory
+		static constexpr u32 VERSION = 1;
+
+		// Manifest of the BuildCache, stored in the compiled data directory
+		static constexpr char const* BUILD_CACHE_FILE_NAME = ".ckbuildcache";
+
 		void Initialize(const char* inputBasePath, const char* outputBasePath);
 
-		void CompileMaterial(String const& fileBaseName);
-		void CompilePipeline(String const& fileBaseName);
-		void CompileTexture(String const& fileBaseName);
-		void CompileCubeMap(String const& fileBaseName);
+		// Compile a single asset definition (.ckadef), return false if it couldn't be compiled
+		// They only touch the files of the asset, so different assets can be compiled in parallel
+		bool CompileMaterial(String const& fileBaseName);
+		bool CompilePipeline(String const& fileBaseName);
+		bool CompileTexture(String const& fileBaseName);
+		bool CompileCubeMap(String const& fileBaseName);
+
+		// Imports the source mesh and writes it in the runtime layout (see MeshFileHeader)
+		bool CompileMesh(String const& fileBaseName);
+
+		// Compiles all of the asset definitions of a directory and its subdirectories on the task system
+		// Assets are compiled after the assets they reference, and the ones whose definition, source files
+		// and compiler versions haven't changed since the last build are skipped, unless forceRebuild is set
+		// Returns false if any asset couldn't be compiled
+		bool CompileDirectory(String const& dataDirectory, bool forceRebuild);
+
+		// Packs the compiled resources of a directory (and its subdirectories) into a single archive
+		// The files are stored with their path relative to the directory, so the archive has to be
+		// mounted at the base data path of the resource system
+		void PackResources(String const& dataDirectory, String const& archivePath, bool compress);
+
+	private:
+		// Compiles an asset with the compiler of its type (the AssetType of the definition)
+		bool CompileAsset(String const& assetType, String const& fileBaseName);
 
 	private:
 		MaterialCompiler m_MaterialCompiler{};
@@ -16,8 +16,15 @@ int main(int argc, char* argv[])
 
 	String fileType = "Unnamed";
 	String inputBaseName = "Unnamed";
-	app.add_option("-t,--type", fileType, "Type of resource: [texture, material, pipeline]");
-	app.add_option("-i,--input", inputBaseName, "File name of the .ckedef asset file without the extension");
+	String outputPath = "Data.pak";
+	bool   compress = false;
+	bool   forceRebuild = false;
+	app.add_option("-t,--type", fileType, "Type of resource: [texture, cubemap, material, pipeline, mesh, pack, all]");
+	app.add_option("-i,--input", inputBaseName,
+	               "File name of the .ckedef asset file without the extension, or the data directory to pack/compile");
+	app.add_option("-o,--output", outputPath, "Path of the archive created by pack");
+	app.add_flag("-c,--compress", compress, "Compress the packed files that get meaningfully smaller");
+	app.add_flag("-f,--force", forceRebuild, "Compile all of the assets, even the ones that are up to date");
 
 	//-----------------------------------------------------------------------------
 
@@ -54,6 +61,28 @@ int main(int argc, char* argv[])
 		compiler.CompileCubeMap(inputBaseName);
 		std::cout << "CubeMap Compiled\n";
 	}
+	else if (fileType == "mesh")
+	{
+		std::cout << "Compiling Mesh...\n";
+		compiler.CompileMesh(inputBaseName);
+		std::cout << "Mesh Compiled\n";
+	}
+	else if (fileType == "pack")
+	{
+		std::cout << "Packing Resources...\n";
+		compiler.PackResources(inputBaseName, outputPath, compress);
+		std::cout << "Resources Packed\n";
+	}
+	else if (fileType == "all")
+	{
+		std::cout << "Compiling Assets...\n";
+		if (!compiler.CompileDirectory(inputBaseName, forceRebuild))
+		{
+			std::cout << "Some assets failed to compile\n";
+			return 1;
+		}
+		std::cout << "Assets Compiled\n";
+	}
 	else
 	{
 		std::cout << "Resource type [ " << fileType << " ] not supported\n";